@@ -0,0 +1,793 @@
+// sentinel-bench: micro and macro benchmarks over sentinel-core.
+//
+// Every case runs --repeat times after an untimed setup; the result is one
+// JSON document (stdout, or --out <file>) with min/median/max seconds and
+// throughput per case, so two commits can be compared by diffing their runs.
+// Progress goes to stderr. Scratch trees, baselines and reports live under
+// --work-dir (a fresh temp directory by default) and are removed afterwards
+// unless --keep is given.
+#include "commands/arg_parser.h"
+#include "commands/common.h"
+#include "core/config.h"
+#include "core/fsutil.h"
+#include "reports/cli_report.h"
+#include "reports/columnar_report.h"
+#include "reports/csv_report.h"
+#include "reports/html_report.h"
+#include "reports/json_report.h"
+#include "reports/report_model.h"
+#include "scanner/hash.h"
+#include "scanner/scanner.h"
+#include "tree_gen.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr std::uint64_t kKiB = 1024;
+constexpr std::uint64_t kMiB = 1024 * kKiB;
+
+struct Options {
+    bool quick = false;
+    bool keep = false;
+    int repeat = 3;
+    std::string filter;
+    std::string work_dir;
+    std::string out;
+    std::vector<std::size_t> entries{1000000, 10000000};
+    std::size_t report_changes = 100000;
+    std::string tree_preset;  // Empty: "small" with --quick, else "mixed".
+    std::uint64_t seed = 1;
+};
+
+struct Result {
+    std::string group;
+    std::string name;
+    std::vector<double> runs;
+    std::uint64_t bytes = 0;
+    std::uint64_t items = 0;
+};
+
+// Keeps digests and sizes observable so the optimizer cannot drop the work.
+volatile std::size_t g_sink = 0;
+
+using bench::fill_random;
+using bench::splitmix64;
+
+std::string size_label(std::uint64_t bytes) {
+    if (bytes >= kMiB && bytes % kMiB == 0) {
+        return std::to_string(bytes / kMiB) + "MiB";
+    }
+    if (bytes >= kKiB && bytes % kKiB == 0) {
+        return std::to_string(bytes / kKiB) + "KiB";
+    }
+    return std::to_string(bytes) + "B";
+}
+
+std::string count_label(std::size_t count) {
+    if (count >= 1000000 && count % 1000000 == 0) {
+        return std::to_string(count / 1000000) + "M";
+    }
+    if (count >= 1000 && count % 1000 == 0) {
+        return std::to_string(count / 1000) + "k";
+    }
+    return std::to_string(count);
+}
+
+bool write_file(const fs::path& path, const std::string& data) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(data.data(), static_cast<std::streamsize>(data.size()));
+    return static_cast<bool>(out);
+}
+
+class Suite {
+public:
+    explicit Suite(const Options& options) : options_(options) {}
+
+    bool selected(const std::string& group, const std::string& name) const {
+        return options_.filter.empty() || (group + "/" + name).find(options_.filter) != std::string::npos;
+    }
+
+    // Times `body` --repeat times; `setup` runs untimed before each repetition.
+    void run(const std::string& group,
+             const std::string& name,
+             std::uint64_t bytes,
+             std::uint64_t items,
+             const std::function<void()>& body,
+             const std::function<void()>& setup = {}) {
+        if (!selected(group, name)) {
+            return;
+        }
+        Result result{group, name, {}, bytes, items};
+        for (int i = 0; i < options_.repeat; ++i) {
+            if (setup) {
+                setup();
+            }
+            const auto start = std::chrono::steady_clock::now();
+            body();
+            result.runs.push_back(
+                std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+        }
+        std::vector<double> sorted = result.runs;
+        std::sort(sorted.begin(), sorted.end());
+        const double median = sorted[sorted.size() / 2];
+        std::cerr << "  " << group << "/" << name << ": " << median * 1000.0 << " ms";
+        if (bytes != 0 && median > 0.0) {
+            std::cerr << ", " << static_cast<double>(bytes) / median / static_cast<double>(kMiB) << " MiB/s";
+        }
+        if (items != 0 && median > 0.0) {
+            std::cerr << ", " << static_cast<double>(items) / median << " items/s";
+        }
+        std::cerr << "\n";
+        results_.push_back(std::move(result));
+    }
+
+    const std::vector<Result>& results() const { return results_; }
+
+private:
+    const Options& options_;
+    std::vector<Result> results_;
+};
+
+// --- hashing ---------------------------------------------------------------
+
+void bench_hash(Suite& suite, const Options& options, const fs::path& work) {
+    const std::uint64_t volume = options.quick ? 16 * kMiB : 256 * kMiB;
+    for (const std::uint64_t size : {std::uint64_t{64}, kKiB, 64 * kKiB, kMiB}) {
+        const std::string name = "sha256_bytes/" + size_label(size);
+        if (!suite.selected("hash", name)) {
+            continue;
+        }
+        std::string buffer(static_cast<std::size_t>(size), '\0');
+        fill_random(buffer, size);
+        const std::uint64_t calls = volume / size;
+        suite.run("hash", name, calls * size, calls, [&]() {
+            for (std::uint64_t i = 0; i < calls; ++i) {
+                g_sink += hash::sha256_bytes(buffer.data(), buffer.size())[0];
+            }
+        });
+    }
+
+    // File hashing reads through the page cache after the first repetition;
+    // this measures the read + digest path, not the disk.
+    const fs::path dir = work / "hash-files";
+    struct FileCase {
+        std::uint64_t size;
+        std::size_t count;
+    };
+    const std::vector<FileCase> cases = options.quick
+        ? std::vector<FileCase>{{4 * kKiB, 512}, {kMiB, 8}, {8 * kMiB, 1}}
+        : std::vector<FileCase>{{4 * kKiB, 4096}, {kMiB, 64}, {64 * kMiB, 2}};
+    for (const FileCase& file_case : cases) {
+        const std::string name = "sha256_file/" + size_label(file_case.size) + "x" + count_label(file_case.count);
+        if (!suite.selected("hash", name)) {
+            continue;
+        }
+        std::error_code ec;
+        fs::remove_all(dir, ec);
+        fs::create_directories(dir, ec);
+        std::string data(static_cast<std::size_t>(file_case.size), '\0');
+        std::vector<std::string> paths;
+        for (std::size_t i = 0; i < file_case.count; ++i) {
+            fill_random(data, i + 1);
+            paths.push_back((dir / ("f" + std::to_string(i) + ".bin")).string());
+            write_file(paths.back(), data);
+        }
+        suite.run("hash", name, file_case.size * file_case.count, file_case.count, [&]() {
+            for (const std::string& path : paths) {
+                g_sink += hash::sha256_file(path, file_case.size).size();
+            }
+        });
+        fs::remove_all(dir, ec);
+    }
+}
+
+// --- snapshot --------------------------------------------------------------
+
+struct TreeShape {
+    std::string name;
+    std::size_t files;
+    std::uint64_t file_size;
+    std::size_t per_dir;  // Files per leaf directory.
+    std::size_t depth;    // Directory levels between a group root and its files.
+};
+
+// Groups of `per_dir` files, each under root/g<N>/l0/.../l<depth-1>.
+std::uint64_t build_tree(const fs::path& root, const TreeShape& shape) {
+    std::error_code ec;
+    fs::remove_all(root, ec);
+    std::string data(static_cast<std::size_t>(shape.file_size), '\0');
+    std::uint64_t bytes = 0;
+    fs::path dir;
+    for (std::size_t i = 0; i < shape.files; ++i) {
+        if (i % shape.per_dir == 0) {
+            dir = root / ("g" + std::to_string(i / shape.per_dir));
+            for (std::size_t level = 0; level < shape.depth; ++level) {
+                dir /= "l" + std::to_string(level);
+            }
+            fs::create_directories(dir, ec);
+        }
+        fill_random(data, i + 1);
+        write_file(dir / ("file" + std::to_string(i) + ".dat"), data);
+        bytes += shape.file_size;
+    }
+    return bytes;
+}
+
+void bench_snapshot(Suite& suite, const Options& options, const fs::path& work) {
+    const std::size_t many = options.quick ? 2000 : 20000;
+    const std::vector<TreeShape> shapes = {
+        {"small_files", many, kKiB, 100, 1},
+        {"huge_files", 4, options.quick ? 8 * kMiB : 128 * kMiB, 4, 0},
+        {"deep", many / 4, 4 * kKiB, 50, 48},
+        {"wide", many, kKiB, many, 0},
+    };
+    for (const TreeShape& shape : shapes) {
+        const std::string name = "build_snapshot/" + shape.name;
+        if (!suite.selected("snapshot", name)) {
+            continue;
+        }
+        const fs::path root = work / ("tree-" + shape.name);
+        const std::uint64_t bytes = build_tree(root, shape);
+        const std::string target = config::normalize_path_string(root);
+        suite.run("snapshot", name, bytes, shape.files, [&]() {
+            core::ScanStats stats;
+            g_sink += scanner::build_snapshot(target, &stats).size();
+        });
+        std::error_code ec;
+        fs::remove_all(root, ec);
+    }
+}
+
+// --- baseline and compare --------------------------------------------------
+
+scanner::FileMap synthetic_map(std::size_t count, std::uint64_t seed) {
+    scanner::FileMap map;
+    map.reserve(count);
+    std::uint64_t state = seed;
+    char hex[17];
+    for (std::size_t i = 0; i < count; ++i) {
+        core::FileEntry entry;
+        entry.path = "/bench/root/d" + std::to_string(i % 997) + "/s" + std::to_string((i / 997) % 101) +
+                     "/file_" + std::to_string(i) + ".dat";
+        entry.hash.reserve(64);
+        for (int part = 0; part < 4; ++part) {
+            std::snprintf(hex, sizeof(hex), "%016llx", static_cast<unsigned long long>(splitmix64(state)));
+            entry.hash += hex;
+        }
+        entry.size = splitmix64(state) % (4 * kMiB);
+        entry.mtime = static_cast<std::time_t>(1700000000 + (splitmix64(state) % 10000000));
+        std::string key = entry.path;
+        map.emplace(std::move(key), std::move(entry));
+    }
+    return map;
+}
+
+void bench_baseline(Suite& suite, const Options& options) {
+    const std::vector<std::size_t> sizes =
+        options.quick ? std::vector<std::size_t>{10000, 100000} : options.entries;
+    for (const std::size_t count : sizes) {
+        const std::string label = count_label(count);
+        if (!suite.selected("baseline", "save/" + label) && !suite.selected("baseline", "load/" + label) &&
+            !suite.selected("compare", "compare/" + label)) {
+            continue;
+        }
+        std::cerr << "  (building " << label << " synthetic entries)\n";
+        const scanner::FileMap baseline = synthetic_map(count, count);
+        std::uint64_t file_bytes = 0;
+
+        auto fresh_data_dir = []() {
+            std::error_code ec;
+            fs::remove_all(config::DATA_DIR, ec);
+            fs::create_directories(config::DATA_DIR, ec);
+        };
+        suite.run("baseline", "save/" + label, 0, count, [&]() {
+            if (!scanner::save_baseline(baseline, "/bench/root")) {
+                std::cerr << "save_baseline failed: " << scanner::baseline_last_error() << "\n";
+            }
+        }, fresh_data_dir);
+
+        if (suite.selected("baseline", "load/" + label)) {
+            std::error_code ec;
+            if (!fs::exists(config::BASELINE_DB, ec)) {
+                fresh_data_dir();
+                scanner::save_baseline(baseline, "/bench/root");
+            }
+            file_bytes = fs::file_size(config::BASELINE_DB, ec);
+            scanner::FileMap loaded;
+            suite.run("baseline", "load/" + label, ec ? 0 : file_bytes, count, [&]() {
+                if (!scanner::load_baseline(loaded)) {
+                    std::cerr << "load_baseline failed: " << scanner::baseline_last_error() << "\n";
+                }
+                g_sink += loaded.size();
+            }, [&]() { scanner::FileMap().swap(loaded); });
+        }
+
+        if (suite.selected("compare", "compare/" + label)) {
+            // 1% modified, 0.5% deleted, 0.5% added.
+            scanner::FileMap current = baseline;
+            std::size_t index = 0;
+            for (auto it = current.begin(); it != current.end(); ++index) {
+                if (index % 200 == 0) {
+                    it = current.erase(it);
+                    continue;
+                }
+                if (index % 100 == 1) {
+                    it->second.hash[0] = it->second.hash[0] == '0' ? '1' : '0';
+                }
+                ++it;
+            }
+            scanner::FileMap extra = synthetic_map(count / 200, count + 1);
+            for (auto& item : extra) {
+                item.second.path += ".new";
+                current.emplace(item.second.path, std::move(item.second));
+            }
+            std::optional<scanner::ScanResult> result;
+            suite.run("compare", "compare/" + label, 0, baseline.size() + current.size(), [&]() {
+                result = scanner::compare(baseline, current, true);
+                g_sink += result->stats.modified;
+            }, [&]() { result.reset(); });
+        }
+    }
+}
+
+// --- reports ---------------------------------------------------------------
+
+void bench_reports(Suite& suite, const Options& options) {
+    const std::size_t changes = options.quick ? 5000 : options.report_changes;
+    const std::string label = count_label(changes);
+    const char* writers[] = {"model", "cli", "html", "json", "csv", "columnar"};
+    bool any = false;
+    for (const char* writer : writers) {
+        any = any || suite.selected("report", std::string(writer) + "/" + label);
+    }
+    if (!any) {
+        return;
+    }
+
+    scanner::ScanResult result;
+    const scanner::FileMap entries = synthetic_map(changes, 7);
+    std::size_t index = 0;
+    for (const auto& item : entries) {
+        scanner::FileMap& bucket = index % 3 == 0 ? result.added : (index % 3 == 1 ? result.modified : result.deleted);
+        bucket.emplace(item.first, item.second);
+        ++index;
+    }
+    result.stats.scanned = changes;
+    result.stats.added = result.added.size();
+    result.stats.modified = result.modified.size();
+    result.stats.deleted = result.deleted.size();
+
+    const std::string scan_id = fsutil::timestamp() + "_bench";
+    suite.run("report", "model/" + label, 0, changes, [&]() {
+        g_sink += reports::build_report_model(result, scan_id).changes.size();
+    });
+    const reports::ReportModel model = reports::build_report_model(result, scan_id);
+    const std::pair<const char*, std::string (*)(const reports::ReportModel&)> outputs[] = {
+        {"cli", reports::write_cli},
+        {"html", reports::write_html},
+        {"json", reports::write_json},
+        {"csv", reports::write_csv},
+        {"columnar", reports::write_columnar},
+    };
+    for (const auto& output : outputs) {
+        const std::string name = std::string(output.first) + "/" + label;
+        if (!suite.selected("report", name)) {
+            continue;
+        }
+        // One untimed write first, for the output size behind the throughput.
+        const std::string path = output.second(model);
+        std::error_code ec;
+        const std::uintmax_t size = path.empty() ? 0 : fs::file_size(path, ec);
+        if (path.empty() || ec) {
+            std::cerr << "  report/" << name << ": writer produced no file, skipped\n";
+            continue;
+        }
+        suite.run("report", name, size, changes, [&]() { g_sink += output.second(model).size(); });
+    }
+}
+
+// --- generated trees -------------------------------------------------------
+
+// Snapshot of a seeded tree (with its ignore rule in place), then a 1% churn
+// step and a scan/compare against that snapshot.
+void bench_generated(Suite& suite, const Options& options, const fs::path& work) {
+    bench::TreeProfile profile;
+    std::string error;
+    const std::string preset = options.tree_preset.empty() ? (options.quick ? "small" : "mixed") : options.tree_preset;
+    if (!bench::profile_preset(preset, profile, &error)) {
+        std::cerr << error << "\n";
+        return;
+    }
+    const std::string snapshot_name = "snapshot/" + preset;
+    const std::string churn_name = "scan_compare/" + preset;
+    if (!suite.selected("generated", snapshot_name) && !suite.selected("generated", churn_name)) {
+        return;
+    }
+
+    const fs::path root = work / ("gen-" + preset);
+    std::error_code ec;
+    fs::remove_all(root, ec);
+    std::cerr << "  (generating " << preset << " tree, seed " << options.seed << ")\n";
+    bench::GenerateStats generated;
+    if (!bench::generate_tree(root.string(), profile, options.seed, generated, &error)) {
+        std::cerr << error << "\n";
+        return;
+    }
+    {
+        std::ofstream rules(config::IGNORE_FILE, std::ios::trunc);
+        rules << bench::kIgnoreRule << "\n";
+    }
+    const std::string target = config::normalize_path_string(root);
+
+    scanner::FileMap baseline;
+    suite.run("generated", snapshot_name, generated.bytes, generated.files, [&]() {
+        core::ScanStats stats;
+        baseline = scanner::build_snapshot(target, &stats);
+        g_sink += baseline.size();
+    });
+
+    if (suite.selected("generated", churn_name)) {
+        if (baseline.empty()) {
+            baseline = scanner::build_snapshot(target);
+        }
+        bench::MutationMix mix;
+        bench::MutationStats churn;
+        if (!bench::mutate_tree(root.string(), mix, profile.sizes, options.seed + 1, churn, &error)) {
+            std::cerr << error << "\n";
+        } else {
+            suite.run("generated", churn_name, generated.bytes, generated.files, [&]() {
+                const scanner::ScanResult result = scanner::scan_compare(target, baseline, true);
+                g_sink += result.stats.added + result.stats.modified + result.stats.deleted;
+            });
+        }
+    }
+    fs::remove(config::IGNORE_FILE, ec);
+    fs::remove_all(root, ec);
+}
+
+// --- driver ----------------------------------------------------------------
+
+void print_usage() {
+    std::cerr
+        << "Usage:\n"
+        << "  sentinel-bench [run] [--quick] [--filter <text>] [--repeat N] [--entries N,N,...]\n"
+        << "                 [--report-changes N] [--tree-preset <name>] [--seed N]\n"
+        << "                 [--work-dir <dir>] [--out <file>] [--keep]\n"
+        << "  sentinel-bench gen --dir <path> [--preset small|mixed|source|media] [--seed N] [--files N]\n"
+        << "                 [--depth N] [--fanout N] [--sizes MIN-MAX:W,...] [--ignore-ratio R]\n"
+        << "                 [--ignore-file <path>]\n"
+        << "  sentinel-bench mutate --dir <path> [--seed N] [--percent P] [--mix add:W,modify:W,delete:W,rename:W]\n"
+        << "                 [--preset <name>] [--sizes MIN-MAX:W,...]\n";
+}
+
+bool check_known(const commands::ParsedArgs& parsed,
+                 const commands::StringSet& switches,
+                 const commands::StringSet& values) {
+    if (!parsed.positionals.empty()) {
+        std::cerr << "Unexpected argument: " << parsed.positionals.front() << "\n";
+        return false;
+    }
+    for (const std::string& key : parsed.switches) {
+        if (switches.count(key) == 0) {
+            std::cerr << "Unknown switch for " << parsed.command << ": --" << key << "\n";
+            return false;
+        }
+    }
+    for (const auto& item : parsed.options) {
+        if (values.count(item.first) == 0) {
+            std::cerr << "Unknown option for " << parsed.command << ": --" << item.first << "\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+bool parse_count_list(const std::string& text, std::vector<std::size_t>& values) {
+    values.clear();
+    std::stringstream in(text);
+    std::string token;
+    while (std::getline(in, token, ',')) {
+        int value = 0;
+        if (!commands::parse_positive_int(token, value)) {
+            return false;
+        }
+        values.push_back(static_cast<std::size_t>(value));
+    }
+    return !values.empty();
+}
+
+bool parse_u64(const std::string& text, std::uint64_t& value) {
+    if (text.empty() || text.find_first_not_of("0123456789") != std::string::npos || text.size() > 19) {
+        return false;
+    }
+    value = std::stoull(text);
+    return true;
+}
+
+bool parse_fraction(const std::string& text, double low, double high, double& value) {
+    std::istringstream in(text);
+    in >> value;
+    return !in.fail() && in.eof() && value >= low && value <= high;
+}
+
+// Reads the option `name` through `parse`; absent options leave `value` alone.
+template <typename Parse>
+bool read_option(const commands::ParsedArgs& parsed, const char* name, const char* expected, Parse parse) {
+    const auto text = commands::option_value(parsed, name);
+    if (!text.has_value() || parse(*text)) {
+        return true;
+    }
+    std::cerr << "--" << name << " expects " << expected << ".\n";
+    return false;
+}
+
+bool parse_run_options(const commands::ParsedArgs& parsed, Options& options) {
+    if (!check_known(parsed, {"quick", "keep"},
+                     {"filter", "repeat", "entries", "report-changes", "tree-preset", "seed", "work-dir", "out"})) {
+        return false;
+    }
+    options.quick = commands::has_switch(parsed, "quick");
+    options.keep = commands::has_switch(parsed, "keep");
+    options.filter = commands::option_value(parsed, "filter").value_or("");
+    options.work_dir = commands::option_value(parsed, "work-dir").value_or("");
+    options.out = commands::option_value(parsed, "out").value_or("");
+    options.tree_preset = commands::option_value(parsed, "tree-preset").value_or("");
+    bench::TreeProfile probe;
+    std::string error;
+    if (!options.tree_preset.empty() && !bench::profile_preset(options.tree_preset, probe, &error)) {
+        std::cerr << error << "\n";
+        return false;
+    }
+    int changes = static_cast<int>(options.report_changes);
+    const bool ok =
+        read_option(parsed, "repeat", "a positive integer",
+                    [&](const std::string& text) { return commands::parse_positive_int(text, options.repeat); }) &&
+        read_option(parsed, "entries", "comma-separated positive counts",
+                    [&](const std::string& text) { return parse_count_list(text, options.entries); }) &&
+        read_option(parsed, "report-changes", "a positive integer",
+                    [&](const std::string& text) { return commands::parse_positive_int(text, changes); }) &&
+        read_option(parsed, "seed", "an unsigned integer",
+                    [&](const std::string& text) { return parse_u64(text, options.seed); });
+    options.report_changes = static_cast<std::size_t>(changes);
+    return ok;
+}
+
+// Preset first, then the shape options override it field by field.
+bool parse_tree_profile(const commands::ParsedArgs& parsed, bench::TreeProfile& profile) {
+    std::string error;
+    if (!bench::profile_preset(commands::option_value(parsed, "preset").value_or("mixed"), profile, &error)) {
+        std::cerr << error << "\n";
+        return false;
+    }
+    int files = static_cast<int>(profile.files);
+    int depth = static_cast<int>(profile.depth);
+    int fan_out = static_cast<int>(profile.fan_out);
+    const bool ok =
+        read_option(parsed, "files", "a positive integer",
+                    [&](const std::string& text) { return commands::parse_positive_int(text, files); }) &&
+        read_option(parsed, "depth", "a non-negative integer",
+                    [&](const std::string& text) {
+                        return text == "0" ? (depth = 0, true) : commands::parse_positive_int(text, depth);
+                    }) &&
+        read_option(parsed, "fanout", "a positive integer",
+                    [&](const std::string& text) { return commands::parse_positive_int(text, fan_out); }) &&
+        read_option(parsed, "ignore-ratio", "a fraction between 0 and 1",
+                    [&](const std::string& text) { return parse_fraction(text, 0.0, 1.0, profile.ignore_ratio); });
+    if (!ok) {
+        return false;
+    }
+    if (const auto sizes = commands::option_value(parsed, "sizes")) {
+        if (!bench::parse_size_histogram(*sizes, profile.sizes, &error)) {
+            std::cerr << error << "\n";
+            return false;
+        }
+    }
+    profile.files = static_cast<std::size_t>(files);
+    profile.depth = static_cast<std::size_t>(depth);
+    profile.fan_out = static_cast<std::size_t>(fan_out);
+    return true;
+}
+
+int run_gen(const commands::ParsedArgs& parsed) {
+    if (!check_known(parsed, {},
+                     {"dir", "preset", "seed", "files", "depth", "fanout", "sizes", "ignore-ratio", "ignore-file"})) {
+        return 1;
+    }
+    const auto dir = commands::option_value(parsed, "dir");
+    bench::TreeProfile profile;
+    std::uint64_t seed = 1;
+    if (!dir.has_value() || dir->empty()) {
+        std::cerr << "gen requires --dir <path>.\n";
+        return 1;
+    }
+    if (!parse_tree_profile(parsed, profile) ||
+        !read_option(parsed, "seed", "an unsigned integer",
+                     [&](const std::string& text) { return parse_u64(text, seed); })) {
+        return 1;
+    }
+
+    bench::GenerateStats stats;
+    std::string error;
+    const auto start = std::chrono::steady_clock::now();
+    if (!bench::generate_tree(*dir, profile, seed, stats, &error)) {
+        std::cerr << error << "\n";
+        return 1;
+    }
+    if (const auto rules = commands::option_value(parsed, "ignore-file")) {
+        std::ofstream out(*rules, std::ios::trunc);
+        out << bench::kIgnoreRule << "\n";
+        if (!out) {
+            std::cerr << "Failed to write " << *rules << "\n";
+            return 1;
+        }
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "{\"command\": \"gen\", \"root\": \"" << commands::json_escape(*dir)
+              << "\", \"profile\": \"" << profile.name << "\", \"seed\": " << seed
+              << ", \"files\": " << stats.files << ", \"directories\": " << stats.directories
+              << ", \"ignored\": " << stats.ignored << ", \"bytes\": " << stats.bytes
+              << ", \"seconds\": " << seconds << "}\n";
+    return 0;
+}
+
+int run_mutate(const commands::ParsedArgs& parsed) {
+    if (!check_known(parsed, {}, {"dir", "seed", "percent", "mix", "preset", "sizes"})) {
+        return 1;
+    }
+    const auto dir = commands::option_value(parsed, "dir");
+    if (!dir.has_value() || dir->empty()) {
+        std::cerr << "mutate requires --dir <path>.\n";
+        return 1;
+    }
+    bench::TreeProfile profile;
+    bench::MutationMix mix;
+    std::uint64_t seed = 1;
+    std::string error;
+    if (!parse_tree_profile(parsed, profile) ||
+        !read_option(parsed, "seed", "an unsigned integer",
+                     [&](const std::string& text) { return parse_u64(text, seed); }) ||
+        !read_option(parsed, "percent", "a percentage between 0 and 100",
+                     [&](const std::string& text) { return parse_fraction(text, 0.0, 100.0, mix.percent); })) {
+        return 1;
+    }
+    if (const auto text = commands::option_value(parsed, "mix")) {
+        if (!bench::parse_mutation_mix(*text, mix, &error)) {
+            std::cerr << error << "\n";
+            return 1;
+        }
+    }
+
+    bench::MutationStats stats;
+    const auto start = std::chrono::steady_clock::now();
+    if (!bench::mutate_tree(*dir, mix, profile.sizes, seed, stats, &error)) {
+        std::cerr << error << "\n";
+        return 1;
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "{\"command\": \"mutate\", \"root\": \"" << commands::json_escape(*dir) << "\", \"seed\": " << seed
+              << ", \"percent\": " << mix.percent << ", \"added\": " << stats.added
+              << ", \"modified\": " << stats.modified << ", \"deleted\": " << stats.deleted
+              << ", \"renamed\": " << stats.renamed << ", \"bytes_written\": " << stats.bytes_written
+              << ", \"seconds\": " << seconds << "}\n";
+    return 0;
+}
+
+std::string results_json(const Options& options, const std::vector<Result>& results) {
+    std::ostringstream out;
+    out.precision(9);
+    out << "{\n"
+        << "  \"tool\": \"sentinel-bench\",\n"
+        << "  \"version\": \"" << commands::json_escape(config::VERSION) << "\",\n"
+        << "  \"started\": \"" << commands::json_escape(fsutil::timestamp()) << "\",\n"
+        << "  \"hardware_threads\": " << std::thread::hardware_concurrency() << ",\n"
+        << "  \"quick\": " << (options.quick ? "true" : "false") << ",\n"
+        << "  \"repeat\": " << options.repeat << ",\n"
+        << "  \"seed\": " << options.seed << ",\n"
+        << "  \"results\": [";
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const Result& result = results[i];
+        std::vector<double> sorted = result.runs;
+        std::sort(sorted.begin(), sorted.end());
+        const double median = sorted[sorted.size() / 2];
+        out << (i == 0 ? "\n" : ",\n")
+            << "    {\"group\": \"" << result.group << "\", \"name\": \"" << commands::json_escape(result.name)
+            << "\", \"runs\": " << sorted.size()
+            << ", \"seconds\": {\"min\": " << sorted.front() << ", \"median\": " << median
+            << ", \"max\": " << sorted.back() << "}"
+            << ", \"bytes\": " << result.bytes << ", \"items\": " << result.items;
+        if (median > 0.0) {
+            out << ", \"bytes_per_second\": " << static_cast<double>(result.bytes) / median
+                << ", \"items_per_second\": " << static_cast<double>(result.items) / median;
+        }
+        out << "}";
+    }
+    out << "\n  ]\n}\n";
+    return out.str();
+}
+
+int run_suite(const commands::ParsedArgs& parsed) {
+    Options options;
+    if (!parse_run_options(parsed, options)) {
+        print_usage();
+        return 1;
+    }
+
+    std::error_code ec;
+    const fs::path work = options.work_dir.empty()
+        ? fs::temp_directory_path(ec) / ("sentinel-bench-" + fsutil::timestamp())
+        : fs::path(options.work_dir);
+    std::string error;
+    if (!config::set_output_root((work / "out").string(), &error)) {
+        std::cerr << "Cannot use work directory " << work.string() << ": " << error << "\n";
+        return 1;
+    }
+    fsutil::ensure_dirs();
+    std::cerr << "sentinel-bench " << config::VERSION << (options.quick ? " (quick)" : "")
+              << ", work dir " << work.string() << "\n";
+
+    Suite suite(options);
+    bench_hash(suite, options, work);
+    bench_snapshot(suite, options, work);
+    bench_generated(suite, options, work);
+    bench_baseline(suite, options);
+    bench_reports(suite, options);
+
+    const std::string json = results_json(options, suite.results());
+    int code = 0;
+    if (options.out.empty()) {
+        std::cout << json;
+    } else {
+        std::ofstream out(options.out, std::ios::binary | std::ios::trunc);
+        out << json;
+        if (!out) {
+            std::cerr << "Failed to write " << options.out << "\n";
+            code = 1;
+        }
+    }
+    if (!options.keep) {
+        fs::remove_all(work, ec);
+    }
+    return code;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::vector<char*> args(argv, argv + argc);
+    static char run_command[] = "run";
+    if (argc < 2 || std::string(argv[1]).rfind("--", 0) == 0) {
+        args.insert(args.begin() + 1, run_command);
+    }
+    const commands::ParsedArgs parsed = commands::parse_args(static_cast<int>(args.size()), args.data());
+    if (!parsed.error.empty()) {
+        std::cerr << parsed.error << "\n";
+        print_usage();
+        return 1;
+    }
+    if (parsed.command == "run") {
+        return run_suite(parsed);
+    }
+    if (parsed.command == "gen") {
+        return run_gen(parsed) == 0 ? 0 : (print_usage(), 1);
+    }
+    if (parsed.command == "mutate") {
+        return run_mutate(parsed) == 0 ? 0 : (print_usage(), 1);
+    }
+    std::cerr << "Unknown command: " << parsed.command << "\n";
+    print_usage();
+    return 1;
+}
@@ -0,0 +1,409 @@
+#include "tree_gen.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <sstream>
+#include <system_error>
+#include <unordered_set>
+
+namespace fs = std::filesystem;
+
+namespace bench {
+
+namespace {
+
+constexpr std::uint64_t kKiB = 1024;
+constexpr std::uint64_t kMiB = 1024 * kKiB;
+constexpr std::size_t kChunk = static_cast<std::size_t>(kMiB);
+
+void set_error(std::string* error, const std::string& message) {
+    if (error != nullptr) {
+        *error = message;
+    }
+}
+
+// Mixes a base seed with an ordinal so per-file streams never overlap.
+std::uint64_t derive_seed(std::uint64_t seed, std::uint64_t ordinal) {
+    std::uint64_t state = seed ^ (ordinal * 0xd1b54a32d192ed03ULL);
+    return splitmix64(state);
+}
+
+// Uniform in [0, 1).
+double next_unit(std::uint64_t& state) {
+    return static_cast<double>(splitmix64(state) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+std::uint64_t next_below(std::uint64_t& state, std::uint64_t bound) {
+    return bound == 0 ? 0 : splitmix64(state) % bound;
+}
+
+std::uint64_t draw_size(std::uint64_t& state, const std::vector<SizeBucket>& sizes) {
+    double total = 0.0;
+    for (const SizeBucket& bucket : sizes) {
+        total += bucket.weight;
+    }
+    double pick = next_unit(state) * total;
+    const SizeBucket* chosen = sizes.empty() ? nullptr : &sizes.back();
+    for (const SizeBucket& bucket : sizes) {
+        if (pick < bucket.weight) {
+            chosen = &bucket;
+            break;
+        }
+        pick -= bucket.weight;
+    }
+    if (chosen == nullptr) {
+        return 0;
+    }
+    return chosen->min + next_below(state, chosen->max - chosen->min + 1);
+}
+
+// Streams `size` seeded bytes into `path` a chunk at a time.
+bool write_random_file(const fs::path& path, std::uint64_t size, std::uint64_t seed, std::string& chunk) {
+    std::FILE* file = std::fopen(path.string().c_str(), "wb");
+    if (file == nullptr) {
+        return false;
+    }
+    bool ok = true;
+    std::uint64_t written = 0;
+    std::uint64_t block = 0;
+    while (ok && written < size) {
+        const std::size_t count = static_cast<std::size_t>(std::min<std::uint64_t>(kChunk, size - written));
+        chunk.resize(count);
+        fill_random(chunk, derive_seed(seed, block++));
+        ok = std::fwrite(chunk.data(), 1, count, file) == count;
+        written += count;
+    }
+    return std::fclose(file) == 0 && ok;
+}
+
+bool parse_scaled_size(const std::string& text, std::uint64_t& value) {
+    if (text.empty()) {
+        return false;
+    }
+    std::size_t digits = 0;
+    value = 0;
+    while (digits < text.size() && text[digits] >= '0' && text[digits] <= '9') {
+        value = value * 10 + static_cast<std::uint64_t>(text[digits] - '0');
+        ++digits;
+    }
+    if (digits == 0) {
+        return false;
+    }
+    const std::string suffix = text.substr(digits);
+    if (suffix.empty() || suffix == "B") {
+        return true;
+    }
+    if (suffix == "K" || suffix == "k") {
+        value *= kKiB;
+    } else if (suffix == "M" || suffix == "m") {
+        value *= kMiB;
+    } else if (suffix == "G" || suffix == "g") {
+        value *= kMiB * kKiB;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool parse_weight(const std::string& text, double& value) {
+    std::istringstream in(text);
+    in >> value;
+    return !in.fail() && in.eof() && value >= 0.0;
+}
+
+std::vector<std::string> split(const std::string& text, char separator) {
+    std::vector<std::string> parts;
+    std::string part;
+    std::istringstream in(text);
+    while (std::getline(in, part, separator)) {
+        parts.push_back(part);
+    }
+    return parts;
+}
+
+} // namespace
+
+std::uint64_t splitmix64(std::uint64_t& state) {
+    std::uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+void fill_random(std::string& data, std::uint64_t seed) {
+    std::uint64_t state = seed;
+    std::size_t offset = 0;
+    while (offset < data.size()) {
+        const std::uint64_t value = splitmix64(state);
+        const std::size_t count = std::min<std::size_t>(8, data.size() - offset);
+        for (std::size_t i = 0; i < count; ++i) {
+            data[offset + i] = static_cast<char>((value >> (8 * i)) & 0xff);
+        }
+        offset += count;
+    }
+}
+
+bool profile_preset(const std::string& name, TreeProfile& profile, std::string* error) {
+    profile = TreeProfile{};
+    profile.name = name;
+    std::string sizes;
+    if (name == "small") {
+        profile.files = 10000;
+        profile.depth = 3;
+        profile.fan_out = 8;
+        sizes = "0-4K:90,4K-64K:10";
+    } else if (name == "mixed") {
+        profile.files = 50000;
+        profile.depth = 4;
+        profile.fan_out = 10;
+        sizes = "0-4K:75,4K-128K:24,128K-2M:1";
+        profile.ignore_ratio = 0.02;
+    } else if (name == "source") {
+        profile.files = 100000;
+        profile.depth = 6;
+        profile.fan_out = 6;
+        sizes = "0-4K:60,4K-64K:39,64K-1M:1";
+        profile.ignore_ratio = 0.10;
+    } else if (name == "media") {
+        profile.files = 200;
+        profile.depth = 2;
+        profile.fan_out = 8;
+        sizes = "1M-16M:80,16M-64M:20";
+    } else {
+        set_error(error, "Unknown tree profile '" + name + "' (expected small, mixed, source or media).");
+        return false;
+    }
+    return parse_size_histogram(sizes, profile.sizes, error);
+}
+
+bool parse_size_histogram(const std::string& text, std::vector<SizeBucket>& buckets, std::string* error) {
+    buckets.clear();
+    for (const std::string& item : split(text, ',')) {
+        const std::size_t colon = item.find(':');
+        const std::size_t dash = item.find('-');
+        SizeBucket bucket;
+        if (colon == std::string::npos || dash == std::string::npos || dash > colon ||
+            !parse_scaled_size(item.substr(0, dash), bucket.min) ||
+            !parse_scaled_size(item.substr(dash + 1, colon - dash - 1), bucket.max) ||
+            !parse_weight(item.substr(colon + 1), bucket.weight) || bucket.min > bucket.max) {
+            set_error(error, "Invalid size bucket '" + item + "' (expected MIN-MAX:WEIGHT, e.g. 4K-1M:25).");
+            return false;
+        }
+        buckets.push_back(bucket);
+    }
+    double total = 0.0;
+    for (const SizeBucket& bucket : buckets) {
+        total += bucket.weight;
+    }
+    if (buckets.empty() || total <= 0.0) {
+        set_error(error, "Size histogram needs at least one bucket with a positive weight.");
+        return false;
+    }
+    return true;
+}
+
+bool generate_tree(const std::string& root,
+                   const TreeProfile& profile,
+                   std::uint64_t seed,
+                   GenerateStats& stats,
+                   std::string* error) {
+    stats = GenerateStats{};
+    std::error_code ec;
+    if (fs::exists(root, ec) && !fs::is_empty(root, ec)) {
+        set_error(error, "Refusing to generate into a non-empty directory: " + root);
+        return false;
+    }
+    fs::create_directories(root, ec);
+    if (ec) {
+        set_error(error, "Failed to create " + root + ": " + ec.message());
+        return false;
+    }
+
+    std::uint64_t state = seed;
+    std::unordered_set<std::string> created;
+    std::string chunk;
+    std::string relative;
+    for (std::size_t i = 0; i < profile.files; ++i) {
+        relative.clear();
+        for (std::size_t level = 0; level < profile.depth; ++level) {
+            relative += 'd';
+            relative += std::to_string(next_below(state, std::max<std::size_t>(1, profile.fan_out)));
+            relative += '/';
+        }
+        const fs::path dir = fs::path(root) / relative;
+        if (!relative.empty() && created.insert(relative).second) {
+            fs::create_directories(dir, ec);
+            if (ec) {
+                set_error(error, "Failed to create " + dir.string() + ": " + ec.message());
+                return false;
+            }
+            ++stats.directories;
+        }
+
+        const bool ignored = next_unit(state) < profile.ignore_ratio;
+        const std::uint64_t size = draw_size(state, profile.sizes);
+        const fs::path path = dir / ("f" + std::to_string(i) + (ignored ? ".tmp" : ".dat"));
+        if (!write_random_file(path, size, derive_seed(seed, i), chunk)) {
+            set_error(error, "Failed to write " + path.string());
+            return false;
+        }
+        ++stats.files;
+        stats.ignored += ignored ? 1 : 0;
+        stats.bytes += size;
+    }
+    return true;
+}
+
+bool parse_mutation_mix(const std::string& text, MutationMix& mix, std::string* error) {
+    mix.add = mix.modify = mix.remove = mix.rename = 0.0;
+    for (const std::string& item : split(text, ',')) {
+        const std::size_t colon = item.find(':');
+        double weight = 0.0;
+        if (colon == std::string::npos || !parse_weight(item.substr(colon + 1), weight)) {
+            set_error(error, "Invalid mutation weight '" + item + "' (expected OP:WEIGHT).");
+            return false;
+        }
+        const std::string op = item.substr(0, colon);
+        if (op == "add") {
+            mix.add = weight;
+        } else if (op == "modify") {
+            mix.modify = weight;
+        } else if (op == "delete") {
+            mix.remove = weight;
+        } else if (op == "rename") {
+            mix.rename = weight;
+        } else {
+            set_error(error, "Unknown mutation '" + op + "' (expected add, modify, delete or rename).");
+            return false;
+        }
+    }
+    if (mix.add + mix.modify + mix.remove + mix.rename <= 0.0) {
+        set_error(error, "Mutation mix needs at least one positive weight.");
+        return false;
+    }
+    return true;
+}
+
+bool mutate_tree(const std::string& root,
+                 const MutationMix& mix,
+                 const std::vector<SizeBucket>& sizes,
+                 std::uint64_t seed,
+                 MutationStats& stats,
+                 std::string* error) {
+    stats = MutationStats{};
+    std::error_code ec;
+    if (!fs::is_directory(root, ec)) {
+        set_error(error, "Not a directory: " + root);
+        return false;
+    }
+
+    // Sorted listing so the seed, not directory order, decides what changes.
+    std::vector<fs::path> files;
+    for (fs::recursive_directory_iterator it(root, ec), end; !ec && it != end; it.increment(ec)) {
+        if (it->is_regular_file(ec)) {
+            files.push_back(it->path());
+        }
+    }
+    if (ec) {
+        set_error(error, "Failed to list " + root + ": " + ec.message());
+        return false;
+    }
+    std::sort(files.begin(), files.end());
+    std::vector<fs::path> dirs;
+    for (const fs::path& file : files) {
+        dirs.push_back(file.parent_path());
+    }
+    std::sort(dirs.begin(), dirs.end());
+    dirs.erase(std::unique(dirs.begin(), dirs.end()), dirs.end());
+    if (dirs.empty()) {
+        dirs.push_back(fs::path(root));
+    }
+
+    // Operation counts by largest remainder, so they always sum to the total.
+    const std::size_t total = static_cast<std::size_t>(
+        std::llround(mix.percent / 100.0 * static_cast<double>(std::max<std::size_t>(files.size(), 1))));
+    const double weights[4] = {mix.add, mix.modify, mix.remove, mix.rename};
+    const double weight_sum = weights[0] + weights[1] + weights[2] + weights[3];
+    std::size_t counts[4] = {0, 0, 0, 0};
+    std::size_t assigned = 0;
+    double remainders[4] = {0.0, 0.0, 0.0, 0.0};
+    for (int op = 0; op < 4; ++op) {
+        const double exact = static_cast<double>(total) * weights[op] / weight_sum;
+        counts[op] = static_cast<std::size_t>(exact);
+        remainders[op] = exact - static_cast<double>(counts[op]);
+        assigned += counts[op];
+    }
+    while (assigned < total) {
+        const int op = static_cast<int>(std::max_element(remainders, remainders + 4) - remainders);
+        ++counts[op];
+        remainders[op] = -1.0;
+        ++assigned;
+    }
+    // Modify, delete and rename each need distinct existing files.
+    std::size_t existing_ops = counts[1] + counts[2] + counts[3];
+    if (existing_ops > files.size()) {
+        const double scale = static_cast<double>(files.size()) / static_cast<double>(existing_ops);
+        for (int op = 1; op < 4; ++op) {
+            counts[op] = static_cast<std::size_t>(static_cast<double>(counts[op]) * scale);
+        }
+        existing_ops = counts[1] + counts[2] + counts[3];
+    }
+
+    std::uint64_t state = seed;
+    for (std::size_t i = 0; i < existing_ops; ++i) {
+        const std::size_t j = i + static_cast<std::size_t>(next_below(state, files.size() - i));
+        std::swap(files[i], files[j]);
+    }
+
+    std::string chunk;
+    std::uint64_t ordinal = 0;
+    std::size_t next = 0;
+    for (std::size_t k = 0; k < counts[1]; ++k, ++next) {
+        const fs::path& path = files[next];
+        const std::uintmax_t old_size = fs::file_size(path, ec);
+        std::uint64_t size = (ec || next_unit(state) < 0.5) ? draw_size(state, sizes) : old_size;
+        if (size == 0 && old_size == 0) {
+            size = 1;
+        }
+        if (!write_random_file(path, size, derive_seed(seed ^ 0x6d6f64ULL, ordinal++), chunk)) {
+            set_error(error, "Failed to rewrite " + path.string());
+            return false;
+        }
+        ++stats.modified;
+        stats.bytes_written += size;
+    }
+    for (std::size_t k = 0; k < counts[2]; ++k, ++next) {
+        if (!fs::remove(files[next], ec) || ec) {
+            set_error(error, "Failed to delete " + files[next].string());
+            return false;
+        }
+        ++stats.deleted;
+    }
+    for (std::size_t k = 0; k < counts[3]; ++k, ++next) {
+        const fs::path& from = files[next];
+        const fs::path& dir = dirs[static_cast<std::size_t>(next_below(state, dirs.size()))];
+        fs::path to = dir / (from.stem().string() + "_r" + std::to_string(seed) + "_" + std::to_string(k) +
+                             from.extension().string());
+        fs::rename(from, to, ec);
+        if (ec) {
+            set_error(error, "Failed to rename " + from.string() + ": " + ec.message());
+            return false;
+        }
+        ++stats.renamed;
+    }
+    for (std::size_t k = 0; k < counts[0]; ++k) {
+        const fs::path& dir = dirs[static_cast<std::size_t>(next_below(state, dirs.size()))];
+        const std::uint64_t size = draw_size(state, sizes);
+        const fs::path path = dir / ("n" + std::to_string(seed) + "_" + std::to_string(k) + ".dat");
+        if (!write_random_file(path, size, derive_seed(seed ^ 0x616464ULL, k), chunk)) {
+            set_error(error, "Failed to write " + path.string());
+            return false;
+        }
+        ++stats.added;
+        stats.bytes_written += size;
+    }
+    return true;
+}
+
+} // namespace bench
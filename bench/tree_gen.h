@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace bench {
+
+// splitmix64: the generator's only source of randomness, so a seed fully
+// determines a tree and a mutation on every platform.
+std::uint64_t splitmix64(std::uint64_t& state);
+// Deterministic pseudo-random bytes for `data.size()` bytes.
+void fill_random(std::string& data, std::uint64_t seed);
+
+// File sizes are drawn from weighted [min, max] buckets.
+struct SizeBucket {
+    std::uint64_t min = 0;
+    std::uint64_t max = 0;
+    double weight = 0.0;
+};
+
+// Shape of a generated tree. Every file sits `depth` directories below the
+// root; each directory level has `fan_out` possible children, created only
+// when a file lands under them.
+struct TreeProfile {
+    std::string name;
+    std::size_t files = 0;
+    std::size_t depth = 0;
+    std::size_t fan_out = 1;
+    std::vector<SizeBucket> sizes;
+    // Fraction of files named "*.tmp", the rule written by --ignore-file.
+    double ignore_ratio = 0.0;
+};
+
+// Rule that matches exactly the ignore-ratio files of a generated tree.
+constexpr const char* kIgnoreRule = "*.tmp";
+
+// Presets and their rough footprint: small (10k files, ~50 MB), mixed (50k,
+// ~1.4 GB), source (100k, ~2 GB, 10% ignored), media (200, ~3 GB).
+bool profile_preset(const std::string& name, TreeProfile& profile, std::string* error = nullptr);
+// "0-4K:70,4K-1M:25,1M-64M:5": bounds take K/M/G suffixes, weights are relative.
+bool parse_size_histogram(const std::string& text, std::vector<SizeBucket>& buckets, std::string* error = nullptr);
+
+struct GenerateStats {
+    std::size_t files = 0;
+    std::size_t directories = 0;
+    std::size_t ignored = 0;
+    std::uint64_t bytes = 0;
+};
+
+// Writes the tree described by `profile` under `root`, which must not exist
+// or be empty. The same profile and seed always yield the same paths, sizes
+// and contents.
+bool generate_tree(const std::string& root,
+                   const TreeProfile& profile,
+                   std::uint64_t seed,
+                   GenerateStats& stats,
+                   std::string* error = nullptr);
+
+// Share of each operation in a mutation step; weights are relative.
+struct MutationMix {
+    double percent = 1.0;  // Of the files present before the step.
+    double add = 25.0;
+    double modify = 50.0;
+    double remove = 15.0;
+    double rename = 10.0;
+};
+
+// "add:25,modify:50,delete:15,rename:10"; missing operations get weight 0.
+bool parse_mutation_mix(const std::string& text, MutationMix& mix, std::string* error = nullptr);
+
+struct MutationStats {
+    std::size_t added = 0;
+    std::size_t modified = 0;
+    std::size_t deleted = 0;
+    std::size_t renamed = 0;
+    std::uint64_t bytes_written = 0;
+};
+
+// Applies one churn step to an existing tree: picks files from the sorted
+// listing with `seed`, rewrites modified ones with different content, and
+// sizes new and modified files from `sizes`. Deterministic for a given tree.
+bool mutate_tree(const std::string& root,
+                 const MutationMix& mix,
+                 const std::vector<SizeBucket>& sizes,
+                 std::uint64_t seed,
+                 MutationStats& stats,
+                 std::string* error = nullptr);
+
+} // namespace bench
@@ -7,6 +7,8 @@
 #include "core/logger.h"
 #include "core/runtime_settings.h"
 #include <iostream>
+#include <string>
+#include <vector>
 
 namespace cli {
 
@@ -43,10 +45,17 @@ int parse(int argc, char* argv[]) {
         }
     }
 
+    std::vector<std::string> rotation_warnings;
+    logger::set_rotation(core::load_log_rotation(&rotation_warnings));
+    for (const std::string& warning : rotation_warnings) {
+        std::cerr << "[WARN] Log rotation: " << warning << "\n";
+    }
+
     fsutil::ensure_dirs();
     logger::init();
 
     const commands::ExitCode code = commands::dispatch(parsed);
+    logger::shutdown();
     return static_cast<int>(code);
 }
 
@@ -15,13 +15,19 @@ bool is_boolean_option(const std::string& key) {
            key == "fail-fast" ||
            key == "fix" ||
            key == "overwrite" ||
+           key == "compress" ||
            key == "all" ||
            key == "dry-run" ||
+           key == "reconcile" ||
+           key == "follow" ||
            key == "strict" ||
            key == "quiet" ||
            key == "no-advice" ||
            key == "no-reports" ||
-           key == "hash-only";
+           key == "hash-only" ||
+           key == "profile" ||
+           key == "memory-report" ||
+           key == "resume";
 }
 
 } // namespace
@@ -1,82 +1,447 @@
 #include "baseline_ops.h"
 #include "scan_ops.h"
 #include "../core/config.h"
+#include "../core/fsutil.h"
 #include "../core/logger.h"
+#include "../scanner/baseline_convert.h"
+#include "../scanner/baseline_index.h"
+#include "../scanner/baseline_stream.h"
+#include "../scanner/history.h"
+#include "../scanner/scanner.h"
 #include <algorithm>
 #include <filesystem>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <limits>
+#include <optional>
+#include <thread>
 
 namespace fs = std::filesystem;
 
 namespace commands {
 
-ExitCode handle_list_baseline(const ParsedArgs& parsed) {
-    if (!reject_positionals(parsed)) {
-        return ExitCode::UsageError;
+namespace {
+
+const char* change_label(char op) {
+    switch (op) {
+        case '+': return "added";
+        case '~': return "modified";
+        default: return "deleted";
     }
+}
 
-    const bool as_json = has_switch(parsed, "json");
-    BaselineView baseline;
-    const ExitCode load_code = load_baseline(baseline, as_json);
-    if (load_code != ExitCode::Ok) {
-        if (as_json) {
+std::string snapshot_json(const history::Snapshot& snapshot) {
+    return std::string("{\"id\": ") + std::to_string(snapshot.seq) +
+           ", \"created\": \"" + json_escape(fsutil::format_time(snapshot.created)) + "\"" +
+           ", \"epoch\": " + std::to_string(snapshot.created) +
+           ", \"root\": \"" + json_escape(snapshot.root) + "\"}";
+}
+
+std::string snapshot_text(const history::Snapshot& snapshot) {
+    return "#" + std::to_string(snapshot.seq) + " (" + fsutil::format_time(snapshot.created) +
+           ", " + (snapshot.keyframe ? "keyframe" : "delta") + ")";
+}
+
+bool optional_limit(const ParsedArgs& parsed, std::size_t& limit) {
+    limit = std::numeric_limits<std::size_t>::max();
+    if (!option_value(parsed, "limit").has_value()) {
+        return true;
+    }
+    int value = 0;
+    if (!parse_positive_option(parsed, "limit", 0, value)) {
+        return false;
+    }
+    limit = static_cast<std::size_t>(value);
+    return true;
+}
+
+enum class ListingFormat {
+    Text,
+    Json,
+    Ndjson
+};
+
+struct ListingPage {
+    std::string prefix;
+    std::string after;
+    std::size_t limit = 50;
+};
+
+bool parse_listing_format(const ParsedArgs& parsed, ListingFormat& format) {
+    const auto value = option_value(parsed, "output");
+    if (!value.has_value()) {
+        return true;
+    }
+    if (*value == "text") {
+        format = ListingFormat::Text;
+    } else if (*value == "json") {
+        format = ListingFormat::Json;
+    } else if (*value == "ndjson") {
+        format = ListingFormat::Ndjson;
+    } else {
+        logger::error("Invalid value for --output: " + *value + " (expected text, json or ndjson)");
+        return false;
+    }
+    return true;
+}
+
+// Writes list-baseline output as entries arrive so nothing is buffered.
+class ListingPrinter {
+public:
+    ListingPrinter(ListingFormat format, const ListingPage& page) : format_(format), page_(page) {}
+
+    void begin(const std::string& root, std::size_t total) {
+        if (format_ == ListingFormat::Ndjson) {
+            std::cout << "{\"type\": \"baseline\", \"root\": \"" << json_escape(root)
+                      << "\", \"total\": " << total << "}\n";
+            return;
+        }
+        if (format_ == ListingFormat::Json) {
             std::cout << "{\n"
-                      << "  \"command\": \"list-baseline\",\n"
-                      << "  \"exit_code\": " << static_cast<int>(load_code) << "\n"
+                      << "  \"root\": \"" << json_escape(root) << "\",\n"
+                      << "  \"total\": " << total << ",\n"
+                      << "  \"items\": [\n";
+            return;
+        }
+        std::cout << "Baseline Root: " << root << "\n"
+                  << "Tracked Files: " << total << "\n";
+        if (!page_.prefix.empty()) {
+            std::cout << "Prefix       : " << page_.prefix << "\n";
+        }
+        if (!page_.after.empty()) {
+            std::cout << "After        : " << page_.after << "\n";
+        }
+        std::cout << "Showing up to: " << page_.limit << "\n\n";
+    }
+
+    void item(const core::FileEntry& entry) {
+        ++count_;
+        if (format_ == ListingFormat::Ndjson) {
+            std::cout << "{\"type\": \"entry\", \"path\": \"" << json_escape(entry.path)
+                      << "\", \"hash\": \"" << entry.hash
+                      << "\", \"size\": " << entry.size
+                      << ", \"mtime\": " << entry.mtime << "}\n";
+            return;
+        }
+        if (format_ == ListingFormat::Json) {
+            if (count_ > 1) {
+                std::cout << ",\n";
+            }
+            std::cout << "    {\n"
+                      << "      \"path\": \"" << json_escape(entry.path) << "\",\n"
+                      << "      \"size\": " << entry.size << ",\n"
+                      << "      \"mtime\": " << entry.mtime << "\n"
+                      << "    }";
+            return;
+        }
+        std::cout << std::setw(4) << count_ << "  "
+                  << entry.path << "  (" << entry.size << " bytes)\n";
+    }
+
+    // `next_cursor` is empty when the listing is exhausted.
+    void finish(const std::string& next_cursor) {
+        const std::string cursor_json =
+            next_cursor.empty() ? "null" : "\"" + json_escape(next_cursor) + "\"";
+        if (format_ == ListingFormat::Ndjson) {
+            std::cout << "{\"type\": \"page\", \"returned\": " << count_
+                      << ", \"next_cursor\": " << cursor_json << "}\n";
+            return;
+        }
+        if (format_ == ListingFormat::Json) {
+            if (count_ > 0) {
+                std::cout << "\n";
+            }
+            std::cout << "  ],\n"
+                      << "  \"next_cursor\": " << cursor_json << "\n"
                       << "}\n";
+            return;
+        }
+        if (!next_cursor.empty()) {
+            std::cout << "\nMore entries available. Continue with: --after \"" << next_cursor << "\"\n";
         }
-        return load_code;
     }
 
-    int limit = 50;
-    if (!parse_positive_option(parsed, "limit", 50, limit)) {
-        return ExitCode::UsageError;
+private:
+    ListingFormat format_;
+    const ListingPage& page_;
+    std::size_t count_ = 0;
+};
+
+// Pulls path-ordered entries from `next`, applies the prefix/cursor window and
+// stops at the first record past the prefix range. Returns the next cursor.
+template <typename NextEntry>
+std::string page_through(const ListingPage& page, ListingPrinter& printer, NextEntry next) {
+    core::FileEntry entry;
+    std::string last;
+    std::size_t emitted = 0;
+    while (next(entry)) {
+        if (!page.after.empty() && entry.path <= page.after) {
+            continue;
+        }
+        if (!page.prefix.empty() && entry.path.compare(0, page.prefix.size(), page.prefix) != 0) {
+            if (entry.path > page.prefix) {
+                break;
+            }
+            continue;
+        }
+        if (emitted == page.limit) {
+            return last;
+        }
+        printer.item(entry);
+        last = entry.path;
+        ++emitted;
+    }
+    return "";
+}
+
+bool parse_convert_format(const ParsedArgs& parsed, baseline_convert::Format& format) {
+    const auto value = option_value(parsed, "format");
+    if (value.has_value() && !baseline_convert::parse_format(*value, format)) {
+        logger::error("Invalid value for --format: " + *value + " (expected text, binary, ndjson or csv)");
+        return false;
     }
+    return true;
+}
 
-    std::vector<const core::FileEntry*> entries;
-    entries.reserve(baseline.files.size());
-    for (const auto& item : baseline.files) {
-        entries.push_back(&item.second);
+// Normalised --prefix; existing directories get a trailing '/' so siblings
+// sharing a name prefix are excluded.
+std::string prefix_option(const ParsedArgs& parsed) {
+    const auto value = option_value(parsed, "prefix");
+    if (!value.has_value()) {
+        return "";
+    }
+    std::string prefix = normalize_path(*value);
+    if (is_directory_path(*value) && !prefix.empty() && prefix.back() != '/') {
+        prefix.push_back('/');
     }
-    std::sort(entries.begin(), entries.end(),
-              [](const core::FileEntry* left, const core::FileEntry* right) {
-                  return left->path < right->path;
-              });
+    return prefix;
+}
+
+unsigned worker_threads() {
+    return std::max(1u, std::thread::hardware_concurrency());
+}
 
+void print_baseline_entry(const core::FileEntry& entry, bool as_json) {
     if (as_json) {
         std::cout << "{\n"
-                  << "  \"root\": \"" << json_escape(baseline.root) << "\",\n"
-                  << "  \"total\": " << entries.size() << ",\n"
-                  << "  \"items\": [\n";
-        const std::size_t count =
-            std::min<std::size_t>(entries.size(), static_cast<std::size_t>(limit));
-        for (std::size_t i = 0; i < count; ++i) {
-            std::cout << "    {\n"
-                      << "      \"path\": \"" << json_escape(entries[i]->path) << "\",\n"
-                      << "      \"size\": " << entries[i]->size << ",\n"
-                      << "      \"mtime\": " << entries[i]->mtime << "\n"
-                      << "    }";
-            if (i + 1 < count) {
+                  << "  \"path\": \"" << json_escape(entry.path) << "\",\n"
+                  << "  \"hash\": \"" << entry.hash << "\",\n"
+                  << "  \"size\": " << entry.size << ",\n"
+                  << "  \"mtime\": " << entry.mtime << "\n"
+                  << "}\n";
+        return;
+    }
+
+    std::cout << "Path : " << entry.path << "\n"
+              << "Hash : " << entry.hash << "\n"
+              << "Size : " << entry.size << " bytes\n"
+              << "MTime: " << entry.mtime << "\n";
+}
+
+ExitCode report_show_miss(const std::string& query_path, bool as_json) {
+    if (as_json) {
+        std::cout << "{\n"
+                  << "  \"command\": \"show-baseline\",\n"
+                  << "  \"query\": \"" << json_escape(query_path) << "\",\n"
+                  << "  \"exit_code\": "
+                  << static_cast<int>(ExitCode::OperationFailed) << ",\n"
+                  << "  \"error\": \"entry_not_found\"\n"
+                  << "}\n";
+    } else {
+        logger::error("No baseline entry found for: " + query_path);
+    }
+    return ExitCode::OperationFailed;
+}
+
+ExitCode report_show_ambiguous(const std::string& query_path,
+                               const std::vector<std::string>& matches,
+                               bool as_json) {
+    const std::size_t max_print = std::min<std::size_t>(matches.size(), 10);
+    if (as_json) {
+        std::cout << "{\n"
+                  << "  \"command\": \"show-baseline\",\n"
+                  << "  \"query\": \"" << json_escape(query_path) << "\",\n"
+                  << "  \"exit_code\": " << static_cast<int>(ExitCode::UsageError)
+                  << ",\n"
+                  << "  \"error\": \"multiple_matches\",\n"
+                  << "  \"matches\": [\n";
+        for (std::size_t i = 0; i < max_print; ++i) {
+            std::cout << "    \"" << json_escape(matches[i]) << "\"";
+            if (i + 1 < max_print) {
                 std::cout << ",";
             }
             std::cout << "\n";
         }
         std::cout << "  ]\n}\n";
+    } else {
+        logger::warning("Multiple entries matched. Please provide a more specific path.");
+        for (std::size_t i = 0; i < max_print; ++i) {
+            std::cout << " - " << matches[i] << "\n";
+        }
+    }
+    return ExitCode::UsageError;
+}
+
+bool baseline_path_matches(const std::string& path, const std::string& query_path) {
+    if (baseline_index::is_glob(query_path)) {
+        return baseline_index::glob_match(path, query_path);
+    }
+    return path.find(query_path) != std::string::npos;
+}
+
+// Answers show-baseline from the on-disk index without materialising the
+// baseline. Returns nothing when no usable index exists so the caller falls
+// back to a full load (which also reports seal and missing-file errors).
+std::optional<ExitCode> show_from_index(const std::string& query_path, bool as_json) {
+    if (!baseline_index::exists()) {
+        return std::nullopt;
+    }
+
+    std::string digest;
+    if (!scanner::verify_baseline(&digest)) {
+        return std::nullopt;
+    }
+
+    baseline_index::Index index;
+    std::string error;
+    if (!index.open(digest, &error)) {
+        if (!as_json) {
+            logger::warning(error);
+        }
+        return std::nullopt;
+    }
+
+    const std::string warning = scanner::baseline_last_warning();
+    if (!as_json && !warning.empty()) {
+        logger::warning(warning);
+    }
+
+    core::FileEntry entry;
+    const std::optional<std::size_t> exact = index.find_exact(normalize_path(query_path));
+    if (exact.has_value() && index.record(*exact, entry)) {
+        print_baseline_entry(entry, as_json);
         return ExitCode::Ok;
     }
 
-    std::cout << "Baseline Root: " << baseline.root << "\n"
-              << "Tracked Files: " << entries.size() << "\n"
-              << "Showing up to: " << limit << "\n\n";
+    std::size_t total = 0;
+    const std::vector<std::size_t> ids =
+        baseline_index::is_glob(query_path) ? index.find_glob(query_path, 10, total)
+                                            : index.find_substring(query_path, 10, total);
+    if (total == 0) {
+        return report_show_miss(query_path, as_json);
+    }
+    if (total > 1) {
+        std::vector<std::string> matches;
+        for (const std::size_t id : ids) {
+            if (index.record(id, entry)) {
+                matches.push_back(entry.path);
+            }
+        }
+        return report_show_ambiguous(query_path, matches, as_json);
+    }
 
-    const std::size_t count =
-        std::min<std::size_t>(entries.size(), static_cast<std::size_t>(limit));
-    for (std::size_t i = 0; i < count; ++i) {
-        std::cout << std::setw(4) << (i + 1) << "  "
-                  << entries[i]->path << "  (" << entries[i]->size << " bytes)\n";
+    if (!index.record(ids.front(), entry)) {
+        return std::nullopt;
     }
+    print_baseline_entry(entry, as_json);
+    return ExitCode::Ok;
+}
+
+} // namespace
+
+ExitCode handle_list_baseline(const ParsedArgs& parsed) {
+    if (!reject_positionals(parsed)) {
+        return ExitCode::UsageError;
+    }
+
+    ListingFormat format = has_switch(parsed, "json") ? ListingFormat::Json : ListingFormat::Text;
+    if (!parse_listing_format(parsed, format)) {
+        return ExitCode::UsageError;
+    }
+
+    int limit = 50;
+    if (!parse_positive_option(parsed, "limit", 50, limit)) {
+        return ExitCode::UsageError;
+    }
+
+    ListingPage page;
+    page.limit = static_cast<std::size_t>(limit);
+    page.after = option_value(parsed, "after").value_or("");
+    page.prefix = prefix_option(parsed);
+
+    const bool quiet = format != ListingFormat::Text;
+    const auto fail = [&](ExitCode code) {
+        if (format == ListingFormat::Json) {
+            std::cout << "{\n"
+                      << "  \"command\": \"list-baseline\",\n"
+                      << "  \"exit_code\": " << static_cast<int>(code) << "\n"
+                      << "}\n";
+        } else if (format == ListingFormat::Ndjson) {
+            std::cout << "{\"type\": \"error\", \"command\": \"list-baseline\", \"exit_code\": "
+                      << static_cast<int>(code) << "}\n";
+        }
+        return code;
+    };
+
+    std::string digest;
+    const ExitCode verify_code = verify_baseline(digest, quiet);
+    if (verify_code != ExitCode::Ok) {
+        return fail(verify_code);
+    }
+
+    scanner::BaselineReader reader;
+    if (!reader.open(config::BASELINE_DB)) {
+        return fail(ExitCode::BaselineMissing);
+    }
+
+    ListingPrinter printer(format, page);
+
+    if (!reader.path_sorted() || !reader.count().has_value()) {
+        // Legacy unsorted baselines have to be materialised and sorted first.
+        BaselineView baseline;
+        const ExitCode load_code = load_baseline(baseline, quiet);
+        if (load_code != ExitCode::Ok) {
+            return fail(load_code);
+        }
+        std::vector<const core::FileEntry*> entries;
+        entries.reserve(baseline.files.size());
+        for (const auto& item : baseline.files) {
+            entries.push_back(&item.second);
+        }
+        std::sort(entries.begin(), entries.end(),
+                  [](const core::FileEntry* left, const core::FileEntry* right) {
+                      return left->path < right->path;
+                  });
+
+        std::size_t position = 0;
+        printer.begin(baseline.root, entries.size());
+        printer.finish(page_through(page, printer, [&](core::FileEntry& out) {
+            if (position >= entries.size()) {
+                return false;
+            }
+            out = *entries[position++];
+            return true;
+        }));
+        return ExitCode::Ok;
+    }
+
+    baseline_index::Index index;
+    if (baseline_index::exists() && index.open(digest)) {
+        // Jump straight to the first candidate instead of reading the prefix of the file.
+        const std::string& start = page.after > page.prefix ? page.after : page.prefix;
+        std::size_t id = index.lower_bound(start);
+        printer.begin(reader.root(), index.size());
+        printer.finish(page_through(page, printer, [&](core::FileEntry& out) {
+            return id < index.size() && index.record(id++, out);
+        }));
+        return ExitCode::Ok;
+    }
+
+    printer.begin(reader.root(), *reader.count());
+    printer.finish(page_through(page, printer, [&](core::FileEntry& out) {
+        return reader.next(out);
+    }));
     return ExitCode::Ok;
 }
 
@@ -87,6 +452,11 @@ ExitCode handle_show_baseline(const ParsedArgs& parsed) {
     }
 
     const bool as_json = has_switch(parsed, "json");
+    const std::optional<ExitCode> indexed = show_from_index(query_path, as_json);
+    if (indexed.has_value()) {
+        return *indexed;
+    }
+
     BaselineView baseline;
     const ExitCode load_code = load_baseline(baseline, as_json);
     if (load_code != ExitCode::Ok) {
@@ -104,74 +474,76 @@ ExitCode handle_show_baseline(const ParsedArgs& parsed) {
     auto it = baseline.files.find(normalized_query);
 
     if (it == baseline.files.end()) {
-        std::vector<const core::FileEntry*> matches;
+        std::vector<std::string> matches;
         for (const auto& item : baseline.files) {
-            if (item.first.find(query_path) != std::string::npos) {
-                matches.push_back(&item.second);
+            if (baseline_path_matches(item.first, query_path)) {
+                matches.push_back(item.first);
             }
         }
 
         if (matches.empty()) {
-            if (as_json) {
-                std::cout << "{\n"
-                          << "  \"command\": \"show-baseline\",\n"
-                          << "  \"query\": \"" << json_escape(query_path) << "\",\n"
-                          << "  \"exit_code\": "
-                          << static_cast<int>(ExitCode::OperationFailed) << ",\n"
-                          << "  \"error\": \"entry_not_found\"\n"
-                          << "}\n";
-            } else {
-                logger::error("No baseline entry found for: " + query_path);
-            }
-            return ExitCode::OperationFailed;
+            return report_show_miss(query_path, as_json);
         }
-
         if (matches.size() > 1) {
-            if (as_json) {
-                std::cout << "{\n"
-                          << "  \"command\": \"show-baseline\",\n"
-                          << "  \"query\": \"" << json_escape(query_path) << "\",\n"
-                          << "  \"exit_code\": " << static_cast<int>(ExitCode::UsageError)
-                          << ",\n"
-                          << "  \"error\": \"multiple_matches\",\n"
-                          << "  \"matches\": [\n";
-                const std::size_t max_print =
-                    std::min<std::size_t>(matches.size(), 10);
-                for (std::size_t i = 0; i < max_print; ++i) {
-                    std::cout << "    \"" << json_escape(matches[i]->path) << "\"";
-                    if (i + 1 < max_print) {
-                        std::cout << ",";
-                    }
-                    std::cout << "\n";
-                }
-                std::cout << "  ]\n}\n";
-            } else {
-                logger::warning("Multiple entries matched. Please provide a more specific path.");
-                for (std::size_t i = 0; i < std::min<std::size_t>(matches.size(), 10); ++i) {
-                    std::cout << " - " << matches[i]->path << "\n";
-                }
-            }
-            return ExitCode::UsageError;
+            std::sort(matches.begin(), matches.end());
+            return report_show_ambiguous(query_path, matches, as_json);
+        }
+
+        it = baseline.files.find(matches[0]);
+    }
+
+    print_baseline_entry(it->second, as_json);
+    return ExitCode::Ok;
+}
+
+ExitCode handle_index_baseline(const ParsedArgs& parsed) {
+    if (!reject_positionals(parsed)) {
+        return ExitCode::UsageError;
+    }
+
+    const bool as_json = has_switch(parsed, "json");
+    const auto fail = [&](ExitCode code, const std::string& message) {
+        if (as_json) {
+            std::cout << "{\n"
+                      << "  \"command\": \"index-baseline\",\n"
+                      << "  \"exit_code\": " << static_cast<int>(code) << ",\n"
+                      << "  \"error\": \"" << json_escape(message) << "\"\n"
+                      << "}\n";
+        } else {
+            logger::error(message);
         }
+        return code;
+    };
+
+    std::string digest;
+    if (!scanner::verify_baseline(&digest)) {
+        const std::string detail = scanner::baseline_last_error();
+        const bool missing = detail.find("Baseline file not found") != std::string::npos;
+        return fail(missing ? ExitCode::BaselineMissing : ExitCode::OperationFailed, detail);
+    }
+
+    std::string error;
+    if (!baseline_index::build(digest, &error)) {
+        return fail(ExitCode::OperationFailed, error);
+    }
 
-        it = baseline.files.find(matches[0]->path);
+    baseline_index::Index index;
+    std::size_t records = 0;
+    if (index.open(digest)) {
+        records = index.size();
     }
 
-    const core::FileEntry& entry = it->second;
     if (as_json) {
         std::cout << "{\n"
-                  << "  \"path\": \"" << json_escape(entry.path) << "\",\n"
-                  << "  \"hash\": \"" << entry.hash << "\",\n"
-                  << "  \"size\": " << entry.size << ",\n"
-                  << "  \"mtime\": " << entry.mtime << "\n"
+                  << "  \"command\": \"index-baseline\",\n"
+                  << "  \"index\": \"" << json_escape(config::BASELINE_INDEX) << "\",\n"
+                  << "  \"records\": " << records << ",\n"
+                  << "  \"exit_code\": 0\n"
                   << "}\n";
-        return ExitCode::Ok;
+    } else {
+        logger::success("Baseline index written: " + config::BASELINE_INDEX + " (" +
+                        std::to_string(records) + " records)");
     }
-
-    std::cout << "Path : " << entry.path << "\n"
-              << "Hash : " << entry.hash << "\n"
-              << "Size : " << entry.size << " bytes\n"
-              << "MTime: " << entry.mtime << "\n";
     return ExitCode::Ok;
 }
 
@@ -181,6 +553,18 @@ ExitCode handle_export_baseline(const ParsedArgs& parsed) {
         return ExitCode::UsageError;
     }
 
+    baseline_convert::Format format = has_switch(parsed, "compress")
+                                          ? baseline_convert::Format::Binary
+                                          : baseline_convert::Format::Text;
+    if (!parse_convert_format(parsed, format)) {
+        return ExitCode::UsageError;
+    }
+    if (has_switch(parsed, "compress") && format != baseline_convert::Format::Binary) {
+        logger::error("--compress only applies to --format binary.");
+        return ExitCode::UsageError;
+    }
+    const std::string prefix = prefix_option(parsed);
+
     std::error_code ec;
     if (!fs::exists(config::BASELINE_DB, ec)) {
         logger::error("Baseline file not found: " + config::BASELINE_DB);
@@ -198,15 +582,30 @@ ExitCode handle_export_baseline(const ParsedArgs& parsed) {
         fs::create_directories(dest_path.parent_path(), ec);
     }
 
-    const fs::copy_options options =
-        overwrite ? fs::copy_options::overwrite_existing : fs::copy_options::none;
-    fs::copy_file(config::BASELINE_DB, destination, options, ec);
-    if (ec) {
-        logger::error("Failed to export baseline: " + ec.message());
-        return ExitCode::OperationFailed;
+    if (format == baseline_convert::Format::Text && prefix.empty()) {
+        const fs::copy_options options =
+            overwrite ? fs::copy_options::overwrite_existing : fs::copy_options::none;
+        fs::copy_file(config::BASELINE_DB, destination, options, ec);
+        if (ec) {
+            logger::error("Failed to export baseline: " + ec.message());
+            return ExitCode::OperationFailed;
+        }
+
+        logger::success("Baseline exported to: " + destination);
+        return ExitCode::Ok;
     }
 
+    baseline_convert::Stats stats;
+    std::string error;
+    if (!baseline_convert::export_baseline(config::BASELINE_DB, destination, format, prefix,
+                                           worker_threads(), &stats, &error)) {
+        logger::error("Failed to export baseline: " + error);
+        return ExitCode::OperationFailed;
+    }
     logger::success("Baseline exported to: " + destination);
+    logger::info("Exported " + std::to_string(stats.records) + " records as " +
+                 baseline_convert::format_name(format) + " (" +
+                 std::to_string(stats.bytes_written) + " bytes)");
     return ExitCode::Ok;
 }
 
@@ -222,6 +621,11 @@ ExitCode handle_import_baseline(const ParsedArgs& parsed) {
         return ExitCode::UsageError;
     }
 
+    baseline_convert::Format format = baseline_convert::detect_format(source);
+    if (!parse_convert_format(parsed, format)) {
+        return ExitCode::UsageError;
+    }
+
     const bool force = has_switch(parsed, "force");
     const bool baseline_exists = fs::exists(config::BASELINE_DB, ec);
     if (baseline_exists && !force) {
@@ -229,31 +633,29 @@ ExitCode handle_import_baseline(const ParsedArgs& parsed) {
         return ExitCode::UsageError;
     }
 
+    // The source is converted into a staged, path-sorted baseline first, so the
+    // current baseline stays untouched until the import is known to be valid.
+    const std::string staged_path = config::BASELINE_DB + ".import";
+    baseline_convert::Stats stats;
+    std::string error;
+    if (!baseline_convert::import_baseline(source, format, staged_path, worker_threads(),
+                                           &stats, &error)) {
+        fs::remove(staged_path, ec);
+        logger::error("Imported baseline is invalid: " + error);
+        return ExitCode::OperationFailed;
+    }
+
     const std::string backup_path = config::BASELINE_DB + ".bak";
     if (baseline_exists) {
         fs::copy_file(config::BASELINE_DB, backup_path, fs::copy_options::overwrite_existing, ec);
         if (ec) {
+            fs::remove(staged_path, ec);
             logger::error("Failed to create backup baseline: " + ec.message());
             return ExitCode::OperationFailed;
         }
     }
 
-    fs::copy_file(source, config::BASELINE_DB, fs::copy_options::overwrite_existing, ec);
-    if (ec) {
-        logger::error("Failed to import baseline: " + ec.message());
-        return ExitCode::OperationFailed;
-    }
-
-    BaselineView loaded;
-    if (load_baseline(loaded) != ExitCode::Ok) {
-        if (baseline_exists) {
-            fs::copy_file(backup_path, config::BASELINE_DB, fs::copy_options::overwrite_existing, ec);
-        }
-        logger::error("Imported baseline is invalid.");
-        return ExitCode::OperationFailed;
-    }
-
-    if (!scanner::save_baseline(loaded.files, loaded.root)) {
+    if (!scanner::install_baseline(staged_path)) {
         if (baseline_exists) {
             fs::copy_file(backup_path, config::BASELINE_DB, fs::copy_options::overwrite_existing, ec);
         }
@@ -261,13 +663,200 @@ ExitCode handle_import_baseline(const ParsedArgs& parsed) {
         logger::error(detail.empty() ? "Failed to re-seal imported baseline." : detail);
         return ExitCode::OperationFailed;
     }
+    const std::string warning = scanner::baseline_last_warning();
+    if (!warning.empty()) {
+        logger::warning(warning);
+    }
 
     fs::remove(backup_path, ec);
     logger::success("Baseline imported successfully.");
-    if (!loaded.root.empty()) {
-        logger::info("Imported baseline target: " + loaded.root);
+    logger::info("Imported " + std::to_string(stats.records) + " records from " +
+                 baseline_convert::format_name(format) + " source" +
+                 (stats.path_sorted ? "" : " (re-sorted)"));
+
+    scanner::BaselineReader reader;
+    if (reader.open(config::BASELINE_DB) && !reader.root().empty()) {
+        logger::info("Imported baseline target: " + reader.root());
+    } else {
+        logger::warning("Imported baseline has no target root; target checks are skipped.");
+    }
+    return ExitCode::Ok;
+}
+
+ExitCode handle_baseline_at(const ParsedArgs& parsed) {
+    std::string reference;
+    if (!require_single_positional(parsed, "<timestamp>", reference)) {
+        return ExitCode::UsageError;
+    }
+
+    std::size_t limit = 0;
+    if (!optional_limit(parsed, limit)) {
+        return ExitCode::UsageError;
+    }
+
+    const bool as_json = has_switch(parsed, "json");
+    history::Snapshot snapshot;
+    history::SnapshotCursor cursor;
+    std::string error;
+    if (!history::resolve(reference, snapshot, &error) ||
+        !cursor.open(snapshot, &error, history::Verify::Upfront)) {
+        if (as_json) {
+            std::cout << "{\n"
+                      << "  \"command\": \"baseline-at\",\n"
+                      << "  \"query\": \"" << json_escape(reference) << "\",\n"
+                      << "  \"exit_code\": " << static_cast<int>(ExitCode::OperationFailed) << ",\n"
+                      << "  \"error\": \"" << json_escape(error) << "\"\n"
+                      << "}\n";
+        } else {
+            logger::error("Baseline history lookup failed: " + error);
+        }
+        return ExitCode::OperationFailed;
+    }
+
+    std::size_t shown = 0;
+    core::FileEntry entry;
+    if (as_json) {
+        std::cout << "{\n"
+                  << "  \"command\": \"baseline-at\",\n"
+                  << "  \"query\": \"" << json_escape(reference) << "\",\n"
+                  << "  \"snapshot\": " << snapshot_json(snapshot) << ",\n"
+                  << "  \"items\": [\n";
+        while (shown < limit && cursor.next(entry)) {
+            std::cout << (shown == 0 ? "" : ",\n")
+                      << "    {\"path\":\"" << json_escape(entry.path)
+                      << "\",\"hash\":\"" << entry.hash
+                      << "\",\"size\":" << entry.size
+                      << ",\"mtime\":" << entry.mtime << "}";
+            ++shown;
+        }
+        std::cout << (shown == 0 ? "" : "\n")
+                  << "  ],\n"
+                  << "  \"count\": " << shown;
+        if (!cursor.error().empty()) {
+            std::cout << ",\n  \"error\": \"" << json_escape(cursor.error()) << "\"";
+        }
+        std::cout << "\n}\n";
+        return cursor.error().empty() ? ExitCode::Ok : ExitCode::OperationFailed;
+    }
+
+    std::cout << "Snapshot     : " << snapshot_text(snapshot) << "\n"
+              << "Baseline Root: " << snapshot.root << "\n\n";
+    while (shown < limit && cursor.next(entry)) {
+        ++shown;
+        std::cout << std::setw(6) << shown << "  " << entry.path
+                  << "  (" << entry.size << " bytes, " << entry.hash << ")\n";
+    }
+    std::cout << "\nEntries shown: " << shown << "\n";
+    if (!cursor.error().empty()) {
+        logger::error("Baseline history lookup failed: " + cursor.error());
+        return ExitCode::OperationFailed;
     }
     return ExitCode::Ok;
 }
 
+ExitCode handle_diff_baselines(const ParsedArgs& parsed) {
+    if (parsed.positionals.size() != 2) {
+        logger::error("Expected two snapshot references: <from> <to>");
+        return ExitCode::UsageError;
+    }
+
+    std::size_t limit = 0;
+    if (!optional_limit(parsed, limit)) {
+        return ExitCode::UsageError;
+    }
+
+    const bool as_json = has_switch(parsed, "json");
+    history::Snapshot from;
+    history::Snapshot to;
+    std::string error;
+    if (!history::resolve(parsed.positionals[0], from, &error) ||
+        !history::resolve(parsed.positionals[1], to, &error)) {
+        if (as_json) {
+            std::cout << "{\n"
+                      << "  \"command\": \"diff-baselines\",\n"
+                      << "  \"exit_code\": " << static_cast<int>(ExitCode::OperationFailed) << ",\n"
+                      << "  \"error\": \"" << json_escape(error) << "\"\n"
+                      << "}\n";
+        } else {
+            logger::error("Baseline history lookup failed: " + error);
+        }
+        return ExitCode::OperationFailed;
+    }
+
+    std::size_t added = 0;
+    std::size_t modified = 0;
+    std::size_t deleted = 0;
+    std::size_t shown = 0;
+
+    if (as_json) {
+        std::cout << "{\n"
+                  << "  \"command\": \"diff-baselines\",\n"
+                  << "  \"from\": " << snapshot_json(from) << ",\n"
+                  << "  \"to\": " << snapshot_json(to) << ",\n"
+                  << "  \"changes\": [\n";
+    } else {
+        std::cout << "From: " << snapshot_text(from) << "\n"
+                  << "To  : " << snapshot_text(to) << "\n\n";
+    }
+
+    const bool ok = history::diff(from, to,
+        [&](char op, const core::FileEntry& before, const core::FileEntry& after) {
+            if (op == '+') {
+                ++added;
+            } else if (op == '~') {
+                ++modified;
+            } else {
+                ++deleted;
+            }
+            if (shown >= limit) {
+                return true;
+            }
+            const core::FileEntry& entry = op == '-' ? before : after;
+            if (as_json) {
+                std::cout << (shown == 0 ? "" : ",\n")
+                          << "    {\"type\":\"" << change_label(op)
+                          << "\",\"path\":\"" << json_escape(entry.path)
+                          << "\",\"hash\":\"" << entry.hash
+                          << "\",\"size\":" << entry.size
+                          << ",\"mtime\":" << entry.mtime;
+                if (op == '~') {
+                    std::cout << ",\"previous_hash\":\"" << before.hash
+                              << "\",\"previous_size\":" << before.size
+                              << ",\"previous_mtime\":" << before.mtime;
+                }
+                std::cout << "}";
+            } else {
+                std::cout << (op == '+' ? "[NEW] " : op == '~' ? "[MODIFIED] " : "[DELETED] ")
+                          << entry.path << "\n";
+            }
+            ++shown;
+            return true;
+        },
+        &error);
+
+    if (as_json) {
+        std::cout << (shown == 0 ? "" : "\n")
+                  << "  ],\n"
+                  << "  \"stats\": {\"added\": " << added
+                  << ", \"modified\": " << modified
+                  << ", \"deleted\": " << deleted << "}";
+        if (!ok) {
+            std::cout << ",\n  \"error\": \"" << json_escape(error) << "\"";
+        }
+        std::cout << "\n}\n";
+    } else {
+        if (!ok) {
+            logger::error("Baseline history diff failed: " + error);
+        }
+        std::cout << "\nSummary: added=" << added
+                  << " modified=" << modified
+                  << " deleted=" << deleted << "\n";
+    }
+
+    if (!ok) {
+        return ExitCode::OperationFailed;
+    }
+    return (added + modified + deleted) > 0 ? ExitCode::ChangesDetected : ExitCode::Ok;
+}
+
 } // namespace commands
@@ -6,7 +6,10 @@ namespace commands {
 
 ExitCode handle_list_baseline(const ParsedArgs& parsed);
 ExitCode handle_show_baseline(const ParsedArgs& parsed);
+ExitCode handle_index_baseline(const ParsedArgs& parsed);
 ExitCode handle_export_baseline(const ParsedArgs& parsed);
 ExitCode handle_import_baseline(const ParsedArgs& parsed);
+ExitCode handle_baseline_at(const ParsedArgs& parsed);
+ExitCode handle_diff_baselines(const ParsedArgs& parsed);
 
 } // namespace commands
@@ -4,14 +4,34 @@
 #include "../core/config.h"
 #include "../core/logger.h"
 #include "../core/metadata.h"
+#include "../core/profiler.h"
 #include <filesystem>
 #include <iostream>
+#include <sstream>
 
 namespace fs = std::filesystem;
 
 namespace commands {
 
-namespace { } // namespace
+namespace {
+
+std::string histogram_json(const core::Histogram& histogram) {
+    std::ostringstream out;
+    out << "{\"count\": " << histogram.count() << ", \"min\": " << histogram.min()
+        << ", \"mean\": " << histogram.mean() << ", \"p50\": " << histogram.percentile(0.50)
+        << ", \"p90\": " << histogram.percentile(0.90) << ", \"p99\": " << histogram.percentile(0.99)
+        << ", \"p999\": " << histogram.percentile(0.999) << ", \"max\": " << histogram.max()
+        << ", \"buckets\": [";
+    const std::vector<core::Histogram::Bucket> buckets = histogram.buckets();
+    for (std::size_t i = 0; i < buckets.size(); ++i) {
+        out << (i == 0 ? "" : ", ") << "[" << buckets[i].low << ", " << buckets[i].high << ", "
+            << buckets[i].count << "]";
+    }
+    out << "]}";
+    return out.str();
+}
+
+} // namespace
 
 
 bool has_changes(const scanner::ScanResult& result) {
@@ -59,12 +79,56 @@ core::OutputPaths default_outputs() {
     outputs.html_report = "N/A";
     outputs.json_report = "N/A";
     outputs.csv_report = "N/A";
+    outputs.columnar_report = "N/A";
     outputs.log_file = config::LOG_FILE;
     outputs.baseline = config::BASELINE_DB;
     outputs.baseline_seal = config::BASELINE_SEAL_FILE;
     return outputs;
 }
 
+std::string profile_json(const core::ScanProfile& profile) {
+    std::ostringstream out;
+    out << "{";
+    bool first = true;
+    for (std::size_t i = 0; i < core::kPhaseCount; ++i) {
+        const core::PhaseStats& phase = profile.phases[i];
+        if (phase.calls == 0) {
+            continue;
+        }
+        out << (first ? "" : ", ") << "\"" << profiler::phase_name(static_cast<core::Phase>(i))
+            << "\": {\"seconds\": " << phase.seconds
+            << ", \"calls\": " << phase.calls
+            << ", \"files\": " << phase.files
+            << ", \"bytes\": " << phase.bytes
+            << ", \"syscalls\": " << phase.syscalls
+            << ", \"errors\": " << phase.errors << "}";
+        first = false;
+    }
+    out << "}";
+    return out.str();
+}
+
+std::string distribution_json(const core::ScanDistribution& distribution) {
+    std::ostringstream out;
+    out << "{\"hash_latency_us\": " << histogram_json(distribution.hash_micros)
+        << ", \"file_size_bytes\": " << histogram_json(distribution.file_bytes)
+        << ", \"throughput\": {\"interval_seconds\": " << distribution.throughput.interval()
+        << ", \"peak_bytes_per_second\": " << distribution.throughput.peak_rate()
+        << ", \"mean_bytes_per_second\": " << distribution.throughput.mean_rate() << ", \"bytes\": [";
+    const std::vector<std::uint64_t>& series = distribution.throughput.bytes();
+    for (std::size_t i = 0; i < series.size(); ++i) {
+        out << (i == 0 ? "" : ", ") << series[i];
+    }
+    out << "]}, \"slowest\": [";
+    for (std::size_t i = 0; i < distribution.slowest.size(); ++i) {
+        const core::SlowFile& file = distribution.slowest[i];
+        out << (i == 0 ? "" : ", ") << "{\"path\": \"" << json_escape(file.path) << "\", \"size\": " << file.size
+            << ", \"seconds\": " << file.seconds << "}";
+    }
+    out << "]}";
+    return out.str();
+}
+
 void print_scan_json(const std::string& command, const ScanOutcome& outcome, ExitCode code) {
     const scanner::ScanResult& result = outcome.result;
     const bool changed = has_changes(result);
@@ -84,31 +148,39 @@ void print_scan_json(const std::string& command, const ScanOutcome& outcome, Exi
               << "    \"cli\": \"" << json_escape(outcome.outputs.cli_report) << "\",\n"
               << "    \"html\": \"" << json_escape(outcome.outputs.html_report) << "\",\n"
               << "    \"json\": \"" << json_escape(outcome.outputs.json_report) << "\",\n"
-              << "    \"csv\": \"" << json_escape(outcome.outputs.csv_report) << "\"\n"
-              << "  }\n"
-              << "}\n";
+              << "    \"csv\": \"" << json_escape(outcome.outputs.csv_report) << "\",\n"
+              << "    \"columnar\": \"" << json_escape(outcome.outputs.columnar_report) << "\"\n"
+              << "  }";
+    if (result.stats.profile.enabled) {
+        std::cout << ",\n  \"profile\": " << profile_json(result.stats.profile)
+                  << ",\n  \"distribution\": " << distribution_json(result.stats.distribution);
+    }
+    std::cout << "\n}\n";
 }
 
 void print_usage_lines() {
     std::cout
         << "Usage:\n"
-        << "  sentinel-c --init <path> [--force] [--quiet] [--no-advice] [--json] [--output-root <path>]\n"
-        << "  sentinel-c --scan <path> [--report-formats list] [--strict] [--hash-only] [--quiet] [--no-advice] [--no-reports] [--json] [--output-root <path>]\n"
-        << "  sentinel-c --update <path> [--report-formats list] [--strict] [--hash-only] [--quiet] [--no-advice] [--no-reports] [--json] [--output-root <path>]\n"
-        << "  sentinel-c --status <path> [--hash-only] [--quiet] [--no-advice] [--json] [--output-root <path>]\n"
-        << "  sentinel-c --verify <path> [--reports] [--report-formats list] [--strict] [--hash-only] [--quiet] [--no-advice] [--json] [--output-root <path>]\n"
-        << "  sentinel-c --watch <path> [--interval N] [--cycles N] [--reports] [--report-formats list] [--fail-fast] [--hash-only] [--quiet] [--no-advice] [--json] [--output-root <path>]\n"
+        << "  sentinel-c --init <path> [--force] [--resume] [--profile] [--memory-report] [--memory-limit <size>] [--trace-out <file>] [--quiet] [--no-advice] [--json] [--output-root <path>]\n"
+        << "  sentinel-c --scan <path> [--report-formats list] [--strict] [--hash-only] [--profile] [--memory-report] [--memory-limit <size>] [--time-budget <sec>] [--full-every N] [--trace-out <file>] [--metrics-file <path>] [--quiet] [--no-advice] [--no-reports] [--json | --output text|json|ndjson] [--output-root <path>]\n"
+        << "  sentinel-c --update <path> [--report-formats list] [--strict] [--hash-only] [--resume] [--profile] [--memory-report] [--memory-limit <size>] [--time-budget <sec>] [--full-every N] [--trace-out <file>] [--metrics-file <path>] [--quiet] [--no-advice] [--no-reports] [--json | --output text|json|ndjson] [--output-root <path>]\n"
+        << "  sentinel-c --status <path> [--hash-only] [--profile] [--memory-report] [--memory-limit <size>] [--time-budget <sec>] [--full-every N] [--trace-out <file>] [--metrics-file <path>] [--quiet] [--no-advice] [--json | --output text|json|ndjson] [--output-root <path>]\n"
+        << "  sentinel-c --verify <path> [--reports] [--report-formats list] [--strict] [--hash-only] [--profile] [--memory-report] [--memory-limit <size>] [--time-budget <sec>] [--full-every N] [--trace-out <file>] [--metrics-file <path>] [--quiet] [--no-advice] [--json | --output text|json|ndjson] [--output-root <path>]\n"
+        << "  sentinel-c --watch <path> [--interval N] [--cycles N] [--reports] [--report-formats list] [--fail-fast] [--hash-only] [--profile] [--memory-report] [--trace-out <file>] [--metrics-file <path>] [--metrics-port N] [--quiet] [--no-advice] [--json] [--output-root <path>]\n"
         << "  sentinel-c --doctor [--fix] [--quiet] [--no-advice] [--json] [--output-root <path>]\n"
         << "  sentinel-c --guard [--fix] [--quiet] [--no-advice] [--json] [--output-root <path>]\n"
         << "  sentinel-c --set-destination <path> [--json] [--quiet]\n"
         << "  sentinel-c --show-destination [--json] [--quiet] [--output-root <path>]\n"
-        << "  sentinel-c --list-baseline [--limit N] [--json] [--output-root <path>]\n"
-        << "  sentinel-c --show-baseline <path> [--json] [--output-root <path>]\n"
-        << "  sentinel-c --export-baseline <file> [--overwrite] [--output-root <path>]\n"
-        << "  sentinel-c --import-baseline <file> [--force] [--output-root <path>]\n"
-        << "  sentinel-c --purge-reports [--days N | --all] [--dry-run] [--output-root <path>]\n"
-        << "  sentinel-c --tail-log [--lines N] [--output-root <path>]\n"
-        << "  sentinel-c --report-index [--type all|cli|html|json|csv] [--limit N] [--json] [--output-root <path>]\n"
+        << "  sentinel-c --list-baseline [--prefix <dir>] [--after <path>] [--limit N] [--json | --output text|json|ndjson] [--output-root <path>]\n"
+        << "  sentinel-c --show-baseline <path|glob> [--json] [--output-root <path>]\n"
+        << "  sentinel-c --index-baseline [--json] [--output-root <path>]\n"
+        << "  sentinel-c --export-baseline <file> [--format text|binary|ndjson|csv] [--prefix <dir>] [--overwrite] [--compress] [--output-root <path>]\n"
+        << "  sentinel-c --import-baseline <file> [--format text|binary|ndjson|csv] [--force] [--output-root <path>]\n"
+        << "  sentinel-c --baseline-at <timestamp> [--limit N] [--json] [--output-root <path>]\n"
+        << "  sentinel-c --diff-baselines <from> <to> [--limit N] [--json] [--output-root <path>]\n"
+        << "  sentinel-c --purge-reports [--days N | --since <time> --until <time> | --all] [--dry-run] [--output-root <path>]\n"
+        << "  sentinel-c --tail-log [--lines N] [--follow | --at <time>] [--output-root <path>]\n"
+        << "  sentinel-c --report-index [--type all|cli|html|json|csv|columnar] [--limit N] [--reconcile] [--json] [--output-root <path>]\n"
         << "  sentinel-c --prompt-mode [--target <path>] [--interval N] [--cycles N] [--reports] [--report-formats list] [--strict] [--hash-only] [--quiet] [--no-advice] [--output-root <path>]\n"
         << "  sentinel-c --version [--json]\n"
         << "  sentinel-c --about\n"
@@ -190,27 +262,27 @@ void print_explain() {
         << "-----------------------------------------------\n\n"
         << "1. --init <path>\n"
         << "   Purpose: create a trusted baseline snapshot.\n"
-        << "   Sub-flags: --force, --quiet, --no-advice, --json\n"
+        << "   Sub-flags: --force, --resume, --profile, --memory-report, --memory-limit <size>, --trace-out <file>, --quiet, --no-advice, --json\n"
         << "   Example: sentinel-c --init C:\\\\Work\\\\Target --force\n\n"
         << "2. --scan <path>\n"
         << "   Purpose: compare current state with baseline and generate reports.\n"
-        << "   Sub-flags: --report-formats <list>, --strict, --hash-only, --quiet, --no-advice, --no-reports, --json\n"
+        << "   Sub-flags: --report-formats <list>, --strict, --hash-only, --profile, --memory-report, --memory-limit <size>, --time-budget <sec>, --full-every <n>, --trace-out <file>, --metrics-file <path>, --quiet, --no-advice, --no-reports, --json, --output text|json|ndjson\n"
         << "   Example: sentinel-c --scan C:\\\\Work\\\\Target --report-formats cli,html,csv --strict\n\n"
         << "3. --update <path>\n"
         << "   Purpose: scan, then refresh baseline after approved changes.\n"
-        << "   Sub-flags: --report-formats <list>, --strict, --hash-only, --quiet, --no-advice, --no-reports, --json\n"
+        << "   Sub-flags: --report-formats <list>, --strict, --hash-only, --resume, --profile, --memory-report, --memory-limit <size>, --time-budget <sec>, --full-every <n>, --trace-out <file>, --metrics-file <path>, --quiet, --no-advice, --no-reports, --json, --output text|json|ndjson\n"
         << "   Example: sentinel-c --update C:\\\\Work\\\\Target --report-formats all\n\n"
         << "4. --status <path>\n"
         << "   Purpose: CI-friendly integrity check with exit codes.\n"
-        << "   Sub-flags: --hash-only, --quiet, --no-advice, --json\n"
+        << "   Sub-flags: --hash-only, --profile, --memory-report, --memory-limit <size>, --time-budget <sec>, --full-every <n>, --trace-out <file>, --metrics-file <path>, --quiet, --no-advice, --json, --output text|json|ndjson\n"
         << "   Example: sentinel-c --status C:\\\\Work\\\\Target\n\n"
         << "5. --verify <path>\n"
         << "   Purpose: strict verification flow, optional report emission.\n"
-        << "   Sub-flags: --reports, --report-formats <list>, --strict, --hash-only, --quiet, --no-advice, --json\n"
+        << "   Sub-flags: --reports, --report-formats <list>, --strict, --hash-only, --profile, --memory-report, --memory-limit <size>, --time-budget <sec>, --full-every <n>, --trace-out <file>, --metrics-file <path>, --quiet, --no-advice, --json, --output text|json|ndjson\n"
         << "   Example: sentinel-c --verify C:\\\\Work\\\\Target --report-formats json,csv\n\n"
         << "6. --watch <path>\n"
         << "   Purpose: repeated monitoring loops.\n"
-        << "   Sub-flags: --interval <sec>, --cycles <n>, --reports, --report-formats <list>, --fail-fast, --hash-only, --quiet, --no-advice, --json\n"
+        << "   Sub-flags: --interval <sec>, --cycles <n>, --reports, --report-formats <list>, --fail-fast, --hash-only, --profile, --memory-report, --trace-out <file>, --metrics-file <path>, --metrics-port <n>, --quiet, --no-advice, --json\n"
         << "   Example: sentinel-c --watch C:\\\\Work\\\\Target --interval 10 --cycles 12\n\n"
         << "7. --doctor\n"
         << "   Purpose: check operational health of directories, log/report access, hash engine.\n"
@@ -218,25 +290,33 @@ void print_explain() {
         << "   Example: sentinel-c --doctor --fix\n\n"
         << "   Related: --guard for security-focused hardening and baseline tamper checks.\n\n"
         << "8. --list-baseline\n"
-        << "   Purpose: list tracked baseline entries.\n"
-        << "   Sub-flags: --limit <n>, --json\n"
-        << "   Example: sentinel-c --list-baseline --limit 20\n\n"
-        << "9. --show-baseline <path>\n"
-        << "   Purpose: inspect one baseline record.\n"
+        << "   Purpose: list tracked baseline entries in path order, one page at a time.\n"
+        << "   Sub-flags: --prefix <dir>, --after <path>, --limit <n>, --json, --output text|json|ndjson\n"
+        << "   Example: sentinel-c --list-baseline --prefix C:\\\\Work\\\\Target\\\\src --limit 20\n"
+        << "   Paging: pass the reported next cursor back as --after <path>.\n\n"
+        << "9. --show-baseline <path|glob>\n"
+        << "   Purpose: inspect one baseline record (exact path, substring, or '*'/'?' glob).\n"
         << "   Sub-flags: --json\n"
-        << "   Example: sentinel-c --show-baseline C:\\\\Work\\\\Target\\\\a.txt\n\n"
+        << "   Example: sentinel-c --show-baseline C:\\\\Work\\\\Target\\\\a.txt\n"
+        << "   Related: --index-baseline builds an on-disk index so lookups skip loading the baseline.\n\n"
         << "10. --purge-reports\n"
         << "    Purpose: maintenance cleanup of report artifacts.\n"
-        << "    Sub-flags: --days <n>, --all, --dry-run\n"
+        << "    Sub-flags: --days <n>, --since <time>, --until <time>, --all, --dry-run\n"
         << "    Example: sentinel-c --purge-reports --days 30 --dry-run\n\n"
         << "Additional utility flags:\n"
         << "  - --set-destination <path> [--json] [--quiet]\n"
         << "  - --show-destination [--json] [--quiet]\n"
         << "  - --guard [--fix] [--quiet] [--no-advice] [--json]\n"
-        << "  - --export-baseline <file> [--overwrite]\n"
-        << "  - --import-baseline <file> [--force]\n"
-        << "  - --tail-log [--lines N]\n"
-        << "  - --report-index [--type all|cli|html|json|csv] [--limit N] [--json]\n"
+        << "  - --export-baseline <file> [--format text|binary|ndjson|csv] [--prefix <dir>] [--overwrite] [--compress]\n"
+        << "  - --import-baseline <file> [--format text|binary|ndjson|csv] [--force]\n"
+        << "      --compress is short for --format binary; import detects the format when --format is omitted.\n"
+        << "  - --index-baseline [--json]\n"
+        << "  - --baseline-at <timestamp> [--limit N] [--json]\n"
+        << "  - --diff-baselines <from> <to> [--limit N] [--json]\n"
+        << "      Snapshot references: latest, #<id>, epoch seconds, or \"YYYY-MM-DD[ HH:MM[:SS]]\"\n"
+        << "  - --tail-log [--lines N] [--follow | --at <time>]\n"
+        << "      Activity logs rotate per settings.ini (log_rotate_size, log_rotate_age, log_compress, log_keep_segments).\n"
+        << "  - --report-index [--type all|cli|html|json|csv|columnar] [--limit N] [--reconcile] [--json]\n"
         << "  - --output-root <path> (set logs/reports/baseline destination for current command)\n"
         << "  - --prompt-mode [--target <path>] [--interval N] [--cycles N] [--reports] [--report-formats list] [--strict] [--hash-only]\n"
         << "      Prompt keywords: banner, clear, exit; prompt set command: set destination <path>\n"
@@ -50,6 +50,11 @@ std::string json_escape(const std::string& value);
 std::string normalize_path(const std::string& path);
 bool is_directory_path(const std::string& path);
 core::OutputPaths default_outputs();
+// Single-line JSON object keyed by phase name; phases never entered are left out.
+std::string profile_json(const core::ScanProfile& profile);
+// Single-line JSON object: hash latency and file size percentiles with their
+// non-empty buckets, the throughput series and the slowest files.
+std::string distribution_json(const core::ScanDistribution& distribution);
 
 void print_scan_json(const std::string& command, const ScanOutcome& outcome, ExitCode code);
 void print_no_command_hint();
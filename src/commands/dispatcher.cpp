@@ -49,7 +49,7 @@ ExitCode dispatch(const ParsedArgs& parsed) {
     }
 
     if (command == "--init") {
-        if (!validate_known_options(parsed, {"force", "json", "quiet", "no-advice"}, {"output-root"})) {
+        if (!validate_known_options(parsed, {"force", "json", "quiet", "no-advice", "profile", "memory-report", "resume"}, {"trace-out", "memory-limit", "output-root"})) {
             return ExitCode::UsageError;
         }
         return handle_init(parsed);
@@ -57,8 +57,8 @@ ExitCode dispatch(const ParsedArgs& parsed) {
 
     if (command == "--scan") {
         if (!validate_known_options(parsed,
-                                    {"json", "strict", "quiet", "no-advice", "no-reports", "hash-only"},
-                                    {"report-formats", "output-root"})) {
+                                    {"json", "strict", "quiet", "no-advice", "no-reports", "hash-only", "profile", "memory-report"},
+                                    {"output", "report-formats", "trace-out", "metrics-file", "memory-limit", "time-budget", "full-every", "output-root"})) {
             return ExitCode::UsageError;
         }
         return handle_scan_mode(parsed, ScanMode::Scan);
@@ -66,15 +66,16 @@ ExitCode dispatch(const ParsedArgs& parsed) {
 
     if (command == "--update") {
         if (!validate_known_options(parsed,
-                                    {"json", "strict", "quiet", "no-advice", "no-reports", "hash-only"},
-                                    {"report-formats", "output-root"})) {
+                                    {"json", "strict", "quiet", "no-advice", "no-reports", "hash-only", "profile", "memory-report", "resume"},
+                                    {"output", "report-formats", "trace-out", "metrics-file", "memory-limit", "time-budget", "full-every", "output-root"})) {
             return ExitCode::UsageError;
         }
         return handle_scan_mode(parsed, ScanMode::Update);
     }
 
     if (command == "--status") {
-        if (!validate_known_options(parsed, {"json", "quiet", "no-advice", "hash-only"}, {"output-root"})) {
+        if (!validate_known_options(parsed, {"json", "quiet", "no-advice", "hash-only", "profile", "memory-report"},
+                                    {"output", "trace-out", "metrics-file", "memory-limit", "time-budget", "full-every", "output-root"})) {
             return ExitCode::UsageError;
         }
         return handle_scan_mode(parsed, ScanMode::Status);
@@ -82,8 +83,8 @@ ExitCode dispatch(const ParsedArgs& parsed) {
 
     if (command == "--verify") {
         if (!validate_known_options(parsed,
-                                    {"reports", "json", "strict", "quiet", "no-advice", "hash-only"},
-                                    {"report-formats", "output-root"})) {
+                                    {"reports", "json", "strict", "quiet", "no-advice", "hash-only", "profile", "memory-report"},
+                                    {"output", "report-formats", "trace-out", "metrics-file", "memory-limit", "time-budget", "full-every", "output-root"})) {
             return ExitCode::UsageError;
         }
         return handle_scan_mode(parsed, ScanMode::Verify);
@@ -91,8 +92,9 @@ ExitCode dispatch(const ParsedArgs& parsed) {
 
     if (command == "--watch") {
         if (!validate_known_options(parsed,
-                                    {"reports", "fail-fast", "json", "strict", "quiet", "no-advice", "hash-only"},
-                                    {"interval", "cycles", "report-formats", "output-root"})) {
+                                    {"reports", "fail-fast", "json", "strict", "quiet", "no-advice", "hash-only", "profile", "memory-report"},
+                                    {"interval", "cycles", "report-formats", "trace-out", "metrics-file", "metrics-port",
+                                     "output-root"})) {
             return ExitCode::UsageError;
         }
         return handle_watch(parsed);
@@ -127,7 +129,8 @@ ExitCode dispatch(const ParsedArgs& parsed) {
     }
 
     if (command == "--list-baseline") {
-        if (!validate_known_options(parsed, {"json"}, {"limit", "output-root"})) {
+        if (!validate_known_options(parsed, {"json"},
+                                    {"limit", "prefix", "after", "output", "output-root"})) {
             return ExitCode::UsageError;
         }
         return handle_list_baseline(parsed);
@@ -140,36 +143,58 @@ ExitCode dispatch(const ParsedArgs& parsed) {
         return handle_show_baseline(parsed);
     }
 
+    if (command == "--index-baseline") {
+        if (!validate_known_options(parsed, {"json"}, {"output-root"})) {
+            return ExitCode::UsageError;
+        }
+        return handle_index_baseline(parsed);
+    }
+
     if (command == "--export-baseline") {
-        if (!validate_known_options(parsed, {"overwrite"}, {"output-root"})) {
+        if (!validate_known_options(parsed, {"overwrite", "compress"},
+                                    {"format", "prefix", "output-root"})) {
             return ExitCode::UsageError;
         }
         return handle_export_baseline(parsed);
     }
 
     if (command == "--import-baseline") {
-        if (!validate_known_options(parsed, {"force"}, {"output-root"})) {
+        if (!validate_known_options(parsed, {"force"}, {"format", "output-root"})) {
             return ExitCode::UsageError;
         }
         return handle_import_baseline(parsed);
     }
 
+    if (command == "--baseline-at") {
+        if (!validate_known_options(parsed, {"json"}, {"limit", "output-root"})) {
+            return ExitCode::UsageError;
+        }
+        return handle_baseline_at(parsed);
+    }
+
+    if (command == "--diff-baselines") {
+        if (!validate_known_options(parsed, {"json"}, {"limit", "output-root"})) {
+            return ExitCode::UsageError;
+        }
+        return handle_diff_baselines(parsed);
+    }
+
     if (command == "--purge-reports") {
-        if (!validate_known_options(parsed, {"all", "dry-run"}, {"days", "output-root"})) {
+        if (!validate_known_options(parsed, {"all", "dry-run"}, {"days", "since", "until", "output-root"})) {
             return ExitCode::UsageError;
         }
         return handle_purge_reports(parsed);
     }
 
     if (command == "--tail-log") {
-        if (!validate_known_options(parsed, {}, {"lines", "output-root"})) {
+        if (!validate_known_options(parsed, {"follow"}, {"lines", "at", "output-root"})) {
             return ExitCode::UsageError;
         }
         return handle_tail_log(parsed);
     }
 
     if (command == "--report-index") {
-        if (!validate_known_options(parsed, {"json"}, {"limit", "type", "output-root"})) {
+        if (!validate_known_options(parsed, {"json", "reconcile"}, {"limit", "type", "output-root"})) {
             return ExitCode::UsageError;
         }
         return handle_report_index(parsed);
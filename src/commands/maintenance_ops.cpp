@@ -2,8 +2,10 @@
 #include "advisor.h"
 #include "../core/config.h"
 #include "../core/fsutil.h"
+#include "../core/log_segments.h"
 #include "../core/logger.h"
 #include "../core/runtime_settings.h"
+#include "../reports/report_manifest.h"
 #include "../scanner/hash.h"
 #include "../scanner/scanner.h"
 #include <algorithm>
@@ -13,7 +15,12 @@
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <iterator>
+#include <limits>
+#include <optional>
 #include <sstream>
+#include <string_view>
+#include <thread>
 #include <vector>
 
 namespace fs = std::filesystem;
@@ -23,26 +30,10 @@ namespace commands {
 namespace {
 
 
-struct ReportItem {
-    std::string type;
-    std::string path;
-    std::uintmax_t size = 0;
-    std::time_t modified = 0;
-};
-
 bool starts_with(const std::string& value, const std::string& prefix) {
     return value.rfind(prefix, 0) == 0;
 }
 
-std::chrono::system_clock::time_point to_system_clock(const fs::file_time_type& file_time) {
-    using namespace std::chrono;
-    const auto system_now = std::chrono::system_clock::now();
-    const auto file_now = fs::file_time_type::clock::now();
-    return std::chrono::time_point_cast<std::chrono::system_clock::duration>(
-        file_time - file_now + system_now
-    );
-}
-
 std::string format_time(std::time_t timestamp) {
     if (timestamp <= 0) {
         return "-";
@@ -58,24 +49,48 @@ std::string format_time(std::time_t timestamp) {
     return out.str();
 }
 
-std::string report_dir_for_type(const std::string& type) {
-    if (type == "cli") {
-        return config::REPORT_CLI_DIR;
+// Loads the report manifest, building it from the report directories the
+// first time (installs that predate the manifest).
+bool load_report_manifest(std::vector<reports::ManifestEntry>& entries, bool announce) {
+    std::error_code ec;
+    if (fs::exists(config::REPORT_MANIFEST, ec)) {
+        std::string error;
+        if (reports::manifest_load(entries, &error)) {
+            return true;
+        }
+        logger::error(error);
+        return false;
     }
-    if (type == "html") {
-        return config::REPORT_HTML_DIR;
+    reports::ReconcileStats stats;
+    std::string error;
+    if (!reports::manifest_reconcile(entries, stats, &error)) {
+        logger::error(error);
+        return false;
     }
-    if (type == "json") {
-        return config::REPORT_JSON_DIR;
+    if (announce) {
+        logger::info("Report manifest built from report directories (" + std::to_string(entries.size()) +
+                     " reports).");
     }
-    if (type == "csv") {
-        return config::REPORT_CSV_DIR;
+    return true;
+}
+
+bool parse_time_option(const ParsedArgs& parsed, const std::string& key, std::optional<std::time_t>& out) {
+    const auto raw = option_value(parsed, key);
+    if (!raw.has_value()) {
+        return true;
     }
-    return "";
+    std::time_t value = 0;
+    if (!fsutil::parse_time(*raw, value)) {
+        logger::error("Invalid --" + key + " value. Use epoch seconds or YYYY-MM-DD[ HH:MM[:SS]].");
+        return false;
+    }
+    out = value;
+    return true;
 }
 
 bool is_valid_report_type(const std::string& type) {
-    return type == "all" || type == "cli" || type == "html" || type == "json" || type == "csv";
+    return type == "all" || type == "cli" || type == "html" || type == "json" || type == "csv" ||
+           type == "columnar";
 }
 
 std::string latest_log_file_path() {
@@ -147,6 +162,209 @@ bool others_writable(const std::string& path) {
 }
 #endif
 
+constexpr std::size_t kTailBlockSize = 64 * 1024;
+constexpr int kFollowPollMs = 500;
+
+// Returns the last `count` lines of `in` by reading fixed-size blocks
+// backwards from EOF, so cost depends on the lines shown, not the file size.
+// `end` receives the file size the result was taken from.
+std::string read_last_lines(std::ifstream& in, std::size_t count, std::uint64_t& end) {
+    in.seekg(0, std::ios::end);
+    const std::streamoff size = in.tellg();
+    end = size > 0 ? static_cast<std::uint64_t>(size) : 0;
+    if (end == 0 || count == 0) {
+        return "";
+    }
+
+    std::string tail;
+    std::uint64_t position = end;
+    std::size_t newlines = 0;
+    std::vector<char> block(kTailBlockSize);
+    while (position > 0) {
+        const std::size_t chunk = static_cast<std::size_t>(std::min<std::uint64_t>(block.size(), position));
+        position -= chunk;
+        in.seekg(static_cast<std::streamoff>(position));
+        in.read(block.data(), static_cast<std::streamsize>(chunk));
+        if (in.gcount() != static_cast<std::streamsize>(chunk)) {
+            break;
+        }
+        for (std::size_t i = chunk; i-- > 0;) {
+            // A newline that ends the file does not start another line.
+            if (block[i] != '\n' || position + i + 1 == end) {
+                continue;
+            }
+            if (++newlines == count) {
+                tail.insert(0, block.data() + i + 1, chunk - i - 1);
+                return tail;
+            }
+        }
+        tail.insert(0, block.data(), chunk);
+    }
+    return tail;
+}
+
+std::size_t count_lines(const std::string& text) {
+    const std::size_t newlines = static_cast<std::size_t>(std::count(text.begin(), text.end(), '\n'));
+    return newlines + (!text.empty() && text.back() != '\n' ? 1 : 0);
+}
+
+// In-memory counterpart of read_last_lines() for archived segments.
+std::string last_lines_of(const std::string& text, std::size_t count) {
+    std::size_t position = text.size();
+    if (position > 0 && text[position - 1] == '\n') {
+        --position;
+    }
+    while (count > 0 && position > 0) {
+        const std::size_t newline = text.rfind('\n', position - 1);
+        if (newline == std::string::npos) {
+            return text;
+        }
+        if (--count == 0) {
+            return text.substr(newline + 1);
+        }
+        position = newline;
+    }
+    return count > 0 ? text : text.substr(position + 1);
+}
+
+// "[YYYY-MM-DD HH:MM:SS] ..." as written by the logger.
+bool line_time(std::string_view line, std::time_t& out) {
+    if (line.size() < 21 || line[0] != '[' || line[20] != ']') {
+        return false;
+    }
+    return fsutil::parse_time(std::string(line.substr(1, 19)), out);
+}
+
+// One readable piece of activity log: an archived segment or a live log file.
+struct LogPiece {
+    core::LogSegment segment;
+    bool archived = false;
+};
+
+bool read_piece(const LogPiece& piece, std::string& text, std::string& error) {
+    if (piece.archived) {
+        return core::read_log_segment(piece.segment, text, &error);
+    }
+    std::ifstream in(piece.segment.path, std::ios::binary);
+    if (!in.is_open()) {
+        error = "Log file not found: " + piece.segment.path;
+        return false;
+    }
+    text.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    return true;
+}
+
+// Archived segments from the index plus every live log, with the time range
+// of a live log taken from its first and last lines.
+std::vector<LogPiece> collect_log_pieces(std::string& error) {
+    std::vector<LogPiece> pieces;
+    std::vector<core::LogSegment> segments;
+    if (!core::load_log_segments(segments, &error)) {
+        return pieces;
+    }
+    for (core::LogSegment& segment : segments) {
+        pieces.push_back(LogPiece{std::move(segment), true});
+    }
+
+    std::error_code ec;
+    for (const auto& entry : fs::directory_iterator(config::LOG_DIR, ec)) {
+        const std::string name = entry.path().filename().generic_string();
+        if (!entry.is_regular_file(ec) || !starts_with(name, "sentinel-c_activity_log_") ||
+            entry.path().extension() != ".log") {
+            ec.clear();
+            continue;
+        }
+        std::ifstream in(entry.path(), std::ios::binary);
+        std::string first_line;
+        std::uint64_t end = 0;
+        LogPiece piece;
+        if (!std::getline(in, first_line) || !line_time(first_line, piece.segment.first)) {
+            continue;
+        }
+        in.clear();
+        const std::string last_line = read_last_lines(in, 1, end);
+        if (!line_time(last_line, piece.segment.last)) {
+            piece.segment.last = piece.segment.first;
+        }
+        piece.segment.path = normalize_path(entry.path().generic_string());
+        piece.segment.source = name;
+        piece.segment.raw_bytes = end;
+        pieces.push_back(std::move(piece));
+    }
+    // Segments of one log come before its live remainder at equal start times.
+    std::stable_sort(pieces.begin(), pieces.end(), [](const LogPiece& a, const LogPiece& b) {
+        return a.segment.first < b.segment.first;
+    });
+    return pieces;
+}
+
+// Prints up to `count` lines starting at the first record stamped at or after
+// `at`. The index picks the first piece whose range reaches `at`; output then
+// continues through later pieces of the same log only.
+ExitCode print_log_from(std::time_t at, std::size_t count) {
+    std::string error;
+    const std::vector<LogPiece> pieces = collect_log_pieces(error);
+    if (!error.empty()) {
+        logger::error(error);
+        return ExitCode::OperationFailed;
+    }
+    const auto start = std::find_if(pieces.begin(), pieces.end(),
+                                    [at](const LogPiece& piece) { return piece.segment.last >= at; });
+    if (start == pieces.end()) {
+        logger::info("No log records at or after " + fsutil::format_time(at) + ".");
+        return ExitCode::Ok;
+    }
+
+    std::string out;
+    bool reached = false;
+    for (auto it = start; it != pieces.end() && count > 0; ++it) {
+        if (it->segment.source != start->segment.source) {
+            continue;
+        }
+        std::string text;
+        if (!read_piece(*it, text, error)) {
+            logger::error(error);
+            return ExitCode::OperationFailed;
+        }
+        std::size_t position = 0;
+        while (position < text.size() && count > 0) {
+            std::size_t newline = text.find('\n', position);
+            newline = newline == std::string::npos ? text.size() : newline + 1;
+            const std::string_view line(text.data() + position, newline - position);
+            std::time_t stamp = 0;
+            if (!reached && line_time(line, stamp) && stamp >= at) {
+                reached = true;
+            }
+            if (reached) {
+                out.append(line.data(), line.size());
+                --count;
+            }
+            position = newline;
+        }
+    }
+    std::cout << out;
+    if (!out.empty() && out.back() != '\n') {
+        std::cout << "\n";
+    }
+    return ExitCode::Ok;
+}
+
+// Archived segments cut from the live log `source`, in seal order.
+std::vector<core::LogSegment> segments_of(const std::string& source) {
+    std::vector<core::LogSegment> segments;
+    core::load_log_segments(segments);
+    segments.erase(std::remove_if(segments.begin(), segments.end(),
+                                  [&source](const core::LogSegment& segment) { return segment.source != source; }),
+                   segments.end());
+    return segments;
+}
+
+std::uintmax_t file_size_or_zero(const std::string& path) {
+    std::error_code ec;
+    const std::uintmax_t size = fs::file_size(path, ec);
+    return ec ? 0 : size;
+}
+
 } // namespace
 
 ExitCode handle_set_destination(const ParsedArgs& parsed) {
@@ -250,60 +468,89 @@ ExitCode handle_purge_reports(const ParsedArgs& parsed) {
     const bool remove_all = has_switch(parsed, "all");
     const bool dry_run = has_switch(parsed, "dry-run");
     const bool has_days = option_value(parsed, "days").has_value();
-    if (remove_all && has_days) {
-        logger::error("Use either --all or --days <n>, not both.");
+    const bool has_range = option_value(parsed, "since").has_value() || option_value(parsed, "until").has_value();
+    if (remove_all && (has_days || has_range)) {
+        logger::error("Use either --all or --days <n> / --since / --until, not both.");
+        return ExitCode::UsageError;
+    }
+    if (has_days && has_range) {
+        logger::error("Use either --days <n> or --since / --until, not both.");
         return ExitCode::UsageError;
     }
 
     int days = 30;
-    if (!remove_all && !parse_positive_option(parsed, "days", 30, days)) {
+    if (!remove_all && !has_range && !parse_positive_option(parsed, "days", 30, days)) {
         return ExitCode::UsageError;
     }
+    std::optional<std::time_t> since;
+    std::optional<std::time_t> until;
+    if (!parse_time_option(parsed, "since", since) || !parse_time_option(parsed, "until", until)) {
+        return ExitCode::UsageError;
+    }
+    if (since.has_value() && until.has_value() && *since >= *until) {
+        logger::error("--since must be earlier than --until.");
+        return ExitCode::UsageError;
+    }
+    if (!remove_all && !has_range) {
+        until = std::time(nullptr) - static_cast<std::time_t>(days) * 24 * 60 * 60;
+    }
 
-    const auto cutoff = std::chrono::system_clock::now() - std::chrono::hours(24 * days);
-    const std::vector<std::string> report_dirs = {
-        config::REPORT_CLI_DIR,
-        config::REPORT_HTML_DIR,
-        config::REPORT_JSON_DIR,
-        config::REPORT_CSV_DIR
-    };
+    std::vector<reports::ManifestEntry> entries;
+    if (!load_report_manifest(entries, !dry_run)) {
+        return ExitCode::OperationFailed;
+    }
 
     std::uintmax_t matched = 0;
     std::uintmax_t removed = 0;
-
-    for (const std::string& dir : report_dirs) {
-        std::error_code ec;
-        if (!fs::exists(dir, ec)) {
+    std::vector<std::string> forgotten;
+    std::vector<reports::ManifestEntry> kept;
+    for (const reports::ManifestEntry& entry : entries) {
+        const bool in_range = remove_all || ((!since.has_value() || entry.written >= *since) &&
+                                             (!until.has_value() || entry.written < *until));
+        if (!in_range) {
+            if (!dry_run) {
+                kept.push_back(entry);
+            }
             continue;
         }
 
-        for (const auto& entry : fs::directory_iterator(dir, ec)) {
-            if (ec || !entry.is_regular_file()) {
-                ec.clear();
-                continue;
-            }
-
-            bool should_remove = remove_all;
-            if (!remove_all) {
-                const auto last_write = to_system_clock(entry.last_write_time(ec));
-                if (!ec && last_write < cutoff) {
-                    should_remove = true;
-                }
+        // Never delete outside this output root's report folders, even if a
+        // copied or edited manifest points elsewhere; just stop listing it.
+        if (!starts_with(entry.path, reports::report_dir(entry.type) + "/")) {
+            if (!dry_run) {
+                forgotten.push_back(entry.path);
             }
+            continue;
+        }
 
-            if (!should_remove) {
-                continue;
-            }
+        ++matched;
+        if (dry_run) {
+            continue;
+        }
+        std::error_code ec;
+        if (fs::remove(entry.path, ec)) {
+            ++removed;
+            forgotten.push_back(entry.path);
+        } else if (!ec) {
+            // Already gone; only the manifest still listed it.
+            forgotten.push_back(entry.path);
+        } else {
+            kept.push_back(entry);
+        }
+    }
 
-            ++matched;
-            if (!dry_run) {
-                fs::remove(entry.path(), ec);
-                if (!ec) {
-                    ++removed;
-                } else {
-                    ec.clear();
-                }
-            }
+    if (!forgotten.empty()) {
+        std::string error;
+        bool ok = true;
+        if (kept.size() < forgotten.size()) {
+            // Mostly emptied: compacting beats appending one removal per report.
+            ok = reports::manifest_write(kept, &error);
+        } else {
+            ok = reports::manifest_forget(forgotten, &error);
+        }
+        if (!ok) {
+            logger::warning("Report manifest not updated: " + error +
+                            ". Run --report-index --reconcile to repair it.");
         }
     }
 
@@ -324,28 +571,130 @@ ExitCode handle_tail_log(const ParsedArgs& parsed) {
     if (!parse_positive_option(parsed, "lines", 40, lines)) {
         return ExitCode::UsageError;
     }
+    const bool follow = has_switch(parsed, "follow");
+    std::optional<std::time_t> at;
+    if (!parse_time_option(parsed, "at", at)) {
+        return ExitCode::UsageError;
+    }
+    if (at.has_value()) {
+        if (follow) {
+            logger::error("--at cannot be combined with --follow.");
+            return ExitCode::UsageError;
+        }
+        return print_log_from(*at, static_cast<std::size_t>(lines));
+    }
 
     const std::string log_path = latest_log_file_path();
-    std::ifstream in(log_path);
+    const std::string log_name = fs::path(log_path).filename().generic_string();
+    std::ifstream in(log_path, std::ios::binary);
     if (!in.is_open()) {
         logger::error("Log file not found: " + log_path);
         return ExitCode::OperationFailed;
     }
 
-    std::vector<std::string> all_lines;
-    std::string line;
-    while (std::getline(in, line)) {
-        all_lines.push_back(line);
+    std::uint64_t end = 0;
+    std::string tail = read_last_lines(in, static_cast<std::size_t>(lines), end);
+    // A freshly rotated log may hold fewer lines than asked for; the rest
+    // comes from the segments sealed off it, newest first.
+    std::size_t have = count_lines(tail);
+    if (have < static_cast<std::size_t>(lines)) {
+        std::vector<core::LogSegment> segments;
+        core::load_log_segments(segments);
+        for (auto it = segments.rbegin(); it != segments.rend() && have < static_cast<std::size_t>(lines); ++it) {
+            std::string text;
+            if (it->source != log_name || !core::read_log_segment(*it, text)) {
+                continue;
+            }
+            std::string older = last_lines_of(text, static_cast<std::size_t>(lines) - have);
+            if (!older.empty() && older.back() != '\n') {
+                older += '\n';
+            }
+            have += count_lines(older);
+            tail.insert(0, older);
+        }
+    }
+    std::cout << tail;
+    if (!tail.empty() && tail.back() != '\n') {
+        std::cout << "\n";
+    }
+    if (!follow) {
+        return ExitCode::Ok;
     }
 
-    const std::size_t start =
-        all_lines.size() > static_cast<std::size_t>(lines)
-            ? all_lines.size() - static_cast<std::size_t>(lines)
-            : 0;
-    for (std::size_t i = start; i < all_lines.size(); ++i) {
-        std::cout << all_lines[i] << "\n";
+    // Poll for appended bytes and pass them through as they arrive; memory
+    // stays at one read block. A rotation shows up as new segments of this log
+    // in the index: the open stream still reads the sealed file, so it is
+    // drained first, segments sealed since come from the archive, and the new
+    // file is followed from its start. A file that shrinks otherwise was
+    // truncated and is followed from its start.
+    std::cout.flush();
+    std::vector<char> block(kTailBlockSize);
+    const auto pump = [&in, &block, &end](std::uint64_t limit) {
+        in.clear();
+        in.seekg(static_cast<std::streamoff>(end));
+        while (end < limit) {
+            const std::size_t want = static_cast<std::size_t>(std::min<std::uint64_t>(block.size(), limit - end));
+            in.read(block.data(), static_cast<std::streamsize>(want));
+            const std::streamsize got = in.gcount();
+            if (got <= 0) {
+                break;
+            }
+            std::cout.write(block.data(), got);
+            end += static_cast<std::uint64_t>(got);
+        }
+        std::cout.flush();
+    };
+
+    std::vector<std::string> sealed;
+    for (const core::LogSegment& segment : segments_of(log_name)) {
+        sealed.push_back(segment.path);
+    }
+    std::uintmax_t index_size = file_size_or_zero(config::LOG_SEGMENT_INDEX);
+    bool reopen = false;
+    while (true) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(kFollowPollMs));
+        const std::uintmax_t index_now = file_size_or_zero(config::LOG_SEGMENT_INDEX);
+        if (index_now != index_size) {
+            index_size = index_now;
+            bool drained = false;
+            for (const core::LogSegment& segment : segments_of(log_name)) {
+                if (std::find(sealed.begin(), sealed.end(), segment.path) != sealed.end()) {
+                    continue;
+                }
+                sealed.push_back(segment.path);
+                std::string text;
+                if (!drained) {
+                    pump(std::numeric_limits<std::uint64_t>::max());
+                    drained = true;
+                } else if (core::read_log_segment(segment, text)) {
+                    std::cout << text;
+                    std::cout.flush();
+                }
+                reopen = true;
+            }
+        }
+        if (reopen) {
+            in.close();
+            in.open(log_path, std::ios::binary);
+            if (!in.is_open()) {
+                continue;
+            }
+            reopen = false;
+            end = 0;
+        }
+
+        std::error_code ec;
+        const std::uint64_t size = fs::file_size(log_path, ec);
+        if (ec) {
+            continue;
+        }
+        if (size < end) {
+            end = 0;
+        }
+        if (size > end) {
+            pump(size);
+        }
     }
-    return ExitCode::Ok;
 }
 
 ExitCode handle_doctor(const ParsedArgs& parsed) {
@@ -381,6 +730,8 @@ ExitCode handle_doctor(const ParsedArgs& parsed) {
                config::REPORT_JSON_DIR);
     push_check("reports_csv_dir", fs::exists(config::REPORT_CSV_DIR, ec) ? "pass" : "fail",
                config::REPORT_CSV_DIR);
+    push_check("reports_columnar_dir", fs::exists(config::REPORT_COLUMNAR_DIR, ec) ? "pass" : "fail",
+               config::REPORT_COLUMNAR_DIR);
 
     {
         std::ofstream log_stream(config::LOG_FILE, std::ios::app);
@@ -391,7 +742,8 @@ ExitCode handle_doctor(const ParsedArgs& parsed) {
     {
         bool report_write_ok = true;
         const std::vector<std::string> dirs = {
-            config::REPORT_CLI_DIR, config::REPORT_HTML_DIR, config::REPORT_JSON_DIR, config::REPORT_CSV_DIR
+            config::REPORT_CLI_DIR, config::REPORT_HTML_DIR, config::REPORT_JSON_DIR, config::REPORT_CSV_DIR,
+            config::REPORT_COLUMNAR_DIR
         };
         for (const std::string& dir : dirs) {
             const fs::path tmp = fs::path(dir) / (".doctor_" + fsutil::timestamp() + ".tmp");
@@ -663,6 +1015,7 @@ ExitCode handle_report_index(const ParsedArgs& parsed) {
     }
 
     const bool as_json = has_switch(parsed, "json");
+    const bool reconcile = has_switch(parsed, "reconcile");
     int limit = 30;
     if (!parse_positive_option(parsed, "limit", 30, limit)) {
         return ExitCode::UsageError;
@@ -678,61 +1031,42 @@ ExitCode handle_report_index(const ParsedArgs& parsed) {
     }
 
     if (!is_valid_report_type(type)) {
-        logger::error("Invalid --type value. Use one of: all, cli, html, json, csv.");
+        logger::error("Invalid --type value. Use one of: all, cli, html, json, csv, columnar.");
         return ExitCode::UsageError;
     }
 
-    std::vector<std::string> types;
-    if (type == "all") {
-        types = {"cli", "html", "json", "csv"};
-    } else {
-        types = {type};
-    }
-
-    std::vector<ReportItem> items;
-    std::error_code ec;
-    for (const std::string& item_type : types) {
-        const std::string dir = report_dir_for_type(item_type);
-        if (dir.empty()) {
-            continue;
+    std::vector<reports::ManifestEntry> items;
+    reports::ReconcileStats reconcile_stats;
+    if (reconcile) {
+        std::string error;
+        if (!reports::manifest_reconcile(items, reconcile_stats, &error)) {
+            logger::error(error);
+            return ExitCode::OperationFailed;
         }
-        if (!fs::exists(dir, ec)) {
-            ec.clear();
-            continue;
+        if (!as_json) {
+            logger::info("Report manifest reconciled: kept=" + std::to_string(reconcile_stats.kept) +
+                         " added=" + std::to_string(reconcile_stats.added) +
+                         " dropped=" + std::to_string(reconcile_stats.dropped));
         }
+    } else if (!load_report_manifest(items, !as_json)) {
+        return ExitCode::OperationFailed;
+    }
 
-        for (const auto& entry : fs::directory_iterator(dir, ec)) {
-            if (ec || !entry.is_regular_file()) {
-                ec.clear();
-                continue;
-            }
-
-            ReportItem item;
-            item.type = item_type;
-            item.path = normalize_path(entry.path().generic_string());
-            item.size = entry.file_size(ec);
-            if (ec) {
-                item.size = 0;
-                ec.clear();
-            }
-
-            const auto last_write = to_system_clock(entry.last_write_time(ec));
-            if (!ec) {
-                item.modified = std::chrono::system_clock::to_time_t(last_write);
-            } else {
-                item.modified = 0;
-                ec.clear();
-            }
-            items.push_back(std::move(item));
-        }
+    if (type != "all") {
+        items.erase(std::remove_if(items.begin(), items.end(),
+                                   [&type](const reports::ManifestEntry& item) { return item.type != type; }),
+                    items.end());
     }
 
-    std::sort(items.begin(), items.end(), [](const ReportItem& left, const ReportItem& right) {
-        if (left.modified != right.modified) {
-            return left.modified > right.modified;
-        }
-        return left.path < right.path;
-    });
+    // Only the newest `limit` entries need ordering.
+    const std::size_t shown = std::min(items.size(), static_cast<std::size_t>(limit));
+    std::partial_sort(items.begin(), items.begin() + static_cast<std::ptrdiff_t>(shown), items.end(),
+                      [](const reports::ManifestEntry& left, const reports::ManifestEntry& right) {
+                          if (left.written != right.written) {
+                              return left.written > right.written;
+                          }
+                          return left.path < right.path;
+                      });
 
     if (items.size() > static_cast<std::size_t>(limit)) {
         items.resize(static_cast<std::size_t>(limit));
@@ -741,14 +1075,20 @@ ExitCode handle_report_index(const ParsedArgs& parsed) {
     if (as_json) {
         std::cout << "{\n"
                   << "  \"type\": \"" << type << "\",\n"
-                  << "  \"count\": " << items.size() << ",\n"
-                  << "  \"items\": [\n";
+                  << "  \"count\": " << items.size() << ",\n";
+        if (reconcile) {
+            std::cout << "  \"reconciled\": {\"kept\": " << reconcile_stats.kept
+                      << ", \"added\": " << reconcile_stats.added
+                      << ", \"dropped\": " << reconcile_stats.dropped << "},\n";
+        }
+        std::cout << "  \"items\": [\n";
         for (std::size_t i = 0; i < items.size(); ++i) {
-            const ReportItem& item = items[i];
+            const reports::ManifestEntry& item = items[i];
             std::cout << "    {\"type\":\"" << item.type
                       << "\",\"path\":\"" << json_escape(item.path)
                       << "\",\"size\":" << item.size
-                      << ",\"modified\":\"" << json_escape(format_time(item.modified)) << "\"}";
+                      << ",\"scan_id\":\"" << json_escape(item.scan_id)
+                      << "\",\"modified\":\"" << json_escape(format_time(item.written)) << "\"}";
             if (i + 1 < items.size()) {
                 std::cout << ",";
             }
@@ -759,12 +1099,12 @@ ExitCode handle_report_index(const ParsedArgs& parsed) {
     }
 
     std::cout << "Recent Reports (" << type << ")\n";
-    std::cout << "Type   Size(bytes)   Modified             Path\n";
-    std::cout << "-----  -----------   -------------------  ----\n";
-    for (const ReportItem& item : items) {
-        std::cout << std::left << std::setw(5) << item.type << "  "
+    std::cout << "Type      Size(bytes)   Modified             Path\n";
+    std::cout << "--------  -----------   -------------------  ----\n";
+    for (const reports::ManifestEntry& item : items) {
+        std::cout << std::left << std::setw(8) << item.type << "  "
                   << std::right << std::setw(11) << item.size << "   "
-                  << std::left << std::setw(19) << format_time(item.modified) << "  "
+                  << std::left << std::setw(19) << format_time(item.written) << "  "
                   << item.path << "\n";
     }
     if (items.empty()) {
@@ -3,16 +3,21 @@
 #include "../core/config.h"
 #include "../core/fsutil.h"
 #include "../core/logger.h"
+#include "../core/memory.h"
+#include "../core/metrics.h"
+#include "../core/profiler.h"
+#include "../core/runtime_settings.h"
 #include "../core/summary.h"
-#include "../reports/cli_report.h"
-#include "../reports/csv_report.h"
-#include "../reports/html_report.h"
-#include "../reports/json_report.h"
+#include "../core/trace.h"
+#include "../reports/report_executor.h"
+#include "../scanner/baseline_stream.h"
+#include "../scanner/rolling_state.h"
+#include "../scanner/scan_journal.h"
 #include <algorithm>
 #include <cctype>
 #include <chrono>
 #include <filesystem>
-#include <future>
+#include <memory>
 #include <iomanip>
 #include <iostream>
 #include <optional>
@@ -23,13 +28,104 @@ namespace commands {
 
 namespace {
 
-struct ReportSelection {
-    bool cli = true;
-    bool html = true;
-    bool json = true;
-    bool csv = true;
+using reports::ReportSelection;
+
+enum class ScanOutput {
+    Text,
+    Json,
+    Ndjson
 };
 
+const char* mode_name(ScanMode mode) {
+    switch (mode) {
+        case ScanMode::Scan: return "scan";
+        case ScanMode::Update: return "update";
+        case ScanMode::Status: return "status";
+        default: return "verify";
+    }
+}
+
+bool parse_scan_output(const ParsedArgs& parsed, ScanOutput& output) {
+    const bool json_switch = has_switch(parsed, "json");
+    output = json_switch ? ScanOutput::Json : ScanOutput::Text;
+
+    const auto value = option_value(parsed, "output");
+    if (!value.has_value()) {
+        return true;
+    }
+    ScanOutput requested = ScanOutput::Text;
+    if (*value == "text") {
+        requested = ScanOutput::Text;
+    } else if (*value == "json") {
+        requested = ScanOutput::Json;
+    } else if (*value == "ndjson") {
+        requested = ScanOutput::Ndjson;
+    } else {
+        logger::error("Invalid value for --output: " + *value + " (expected text, json or ndjson)");
+        return false;
+    }
+    if (json_switch && requested != ScanOutput::Json) {
+        logger::error("Use either --json or --output, not both.");
+        return false;
+    }
+    output = requested;
+    return true;
+}
+
+const char* change_name(scanner::Change change) {
+    switch (change) {
+        case scanner::Change::Added: return "added";
+        case scanner::Change::Modified: return "modified";
+        default: return "deleted";
+    }
+}
+
+// NDJSON records are flushed line by line so consumers see changes while the
+// scan is still hashing.
+void print_ndjson_start(const char* command, const std::string& target) {
+    std::cout << "{\"type\": \"scan\", \"command\": \"" << command
+              << "\", \"target\": \"" << json_escape(target) << "\"}\n"
+              << std::flush;
+}
+
+void print_ndjson_change(scanner::Change change, const core::FileEntry& entry) {
+    std::cout << "{\"type\": \"change\", \"change\": \"" << change_name(change)
+              << "\", \"path\": \"" << json_escape(entry.path)
+              << "\", \"hash\": \"" << entry.hash
+              << "\", \"size\": " << entry.size
+              << ", \"mtime\": " << entry.mtime << "}\n"
+              << std::flush;
+}
+
+// Always the last record. Failed runs carry only the exit code.
+void print_ndjson_summary(const char* command,
+                          const std::string& target,
+                          const ScanOutcome* outcome,
+                          ExitCode code) {
+    std::cout << "{\"type\": \"summary\", \"command\": \"" << command
+              << "\", \"target\": \"" << json_escape(target)
+              << "\", \"exit_code\": " << static_cast<int>(code);
+    if (outcome != nullptr) {
+        const core::ScanStats& stats = outcome->result.stats;
+        std::cout << ", \"changed\": " << (has_changes(outcome->result) ? "true" : "false")
+                  << ", \"scanned\": " << stats.scanned
+                  << ", \"added\": " << stats.added
+                  << ", \"modified\": " << stats.modified
+                  << ", \"deleted\": " << stats.deleted
+                  << ", \"duration\": " << stats.duration
+                  << ", \"outputs\": {\"cli\": \"" << json_escape(outcome->outputs.cli_report)
+                  << "\", \"html\": \"" << json_escape(outcome->outputs.html_report)
+                  << "\", \"json\": \"" << json_escape(outcome->outputs.json_report)
+                  << "\", \"csv\": \"" << json_escape(outcome->outputs.csv_report)
+                  << "\", \"columnar\": \"" << json_escape(outcome->outputs.columnar_report) << "\"}";
+        if (stats.profile.enabled) {
+            std::cout << ", \"profile\": " << profile_json(stats.profile)
+                      << ", \"distribution\": " << distribution_json(stats.distribution);
+        }
+    }
+    std::cout << "}\n" << std::flush;
+}
+
 std::string normalize_compare_key(const std::string& path) {
     std::string normalized = normalize_path(path);
 #ifdef _WIN32
@@ -40,11 +136,15 @@ std::string normalize_compare_key(const std::string& path) {
 }
 
 bool any_enabled(const ReportSelection& selection) {
-    return selection.cli || selection.html || selection.json || selection.csv;
+    return selection.cli || selection.html || selection.json || selection.csv || selection.columnar;
 }
 
 ReportSelection none_enabled() {
-    return ReportSelection{false, false, false, false};
+    return ReportSelection{false, false, false, false, false};
+}
+
+ReportSelection all_enabled() {
+    return ReportSelection{true, true, true, true, true};
 }
 
 bool parse_report_selection(const ParsedArgs& parsed,
@@ -79,7 +179,7 @@ bool parse_report_selection(const ParsedArgs& parsed,
         }
 
         if (token == "all") {
-            selection = ReportSelection{};
+            selection = all_enabled();
             continue;
         }
         if (token == "none") {
@@ -102,128 +202,357 @@ bool parse_report_selection(const ParsedArgs& parsed,
             selection.csv = true;
             continue;
         }
+        if (token == "columnar") {
+            selection.columnar = true;
+            continue;
+        }
 
         error = "Invalid report format '" + token +
-                "'. Use comma-separated values from: cli,html,json,csv,all,none.";
+                "'. Use comma-separated values from: cli,html,json,csv,columnar,all,none.";
         return false;
     }
 
     return true;
 }
 
-std::string safe_report_result(std::future<std::string>& job,
-                               const char* report_name,
-                               bool log_errors) {
-    try {
-        return job.get();
-    } catch (const std::exception& ex) {
-        if (log_errors) {
-            logger::error(std::string("Failed to generate ") + report_name + " report: " + ex.what());
-        }
-    } catch (...) {
-        if (log_errors) {
-            logger::error(std::string("Failed to generate ") + report_name + " report: unknown error");
+// "walk 1.20ms, hash 30.10ms, ..., file p50/p99 0.08/2.10ms" for the
+// one-line watch cycle and --quiet output.
+std::string profile_line(const core::ScanStats& stats) {
+    const core::ScanProfile& profile = stats.profile;
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(2);
+    for (std::size_t i = 0; i < core::kPhaseCount; ++i) {
+        const core::PhaseStats& phase = profile.phases[i];
+        if (phase.calls == 0) {
+            continue;
         }
+        out << (out.tellp() > 0 ? ", " : "") << profiler::phase_name(static_cast<core::Phase>(i)) << " "
+            << phase.seconds * 1000.0 << "ms";
     }
-    return "";
+    const core::Histogram& latency = stats.distribution.hash_micros;
+    if (latency.count() != 0) {
+        out << ", file p50/p99 " << static_cast<double>(latency.percentile(0.50)) / 1000.0 << "/"
+            << static_cast<double>(latency.percentile(0.99)) / 1000.0 << "ms";
+    }
+    return out.str();
 }
 
-void warn_if_missing_report(const std::string& path, const char* report_name, bool log_errors) {
-    if (log_errors && path.empty()) {
-        logger::warning(std::string(report_name) + " report generation returned empty output path.");
+// Problems that do not change the outcome; stdout stays clean in machine modes.
+void warn_nonfatal(bool machine, const std::string& message) {
+    if (machine) {
+        std::cerr << "[WARN] " << message << "\n";
+    } else {
+        logger::warning(message);
     }
 }
 
-void generate_reports_async(const scanner::ScanResult& result,
-                            const std::string& scan_id,
-                            const ReportSelection& selection,
-                            core::OutputPaths& outputs,
-                            bool log_errors) {
-    std::optional<std::future<std::string>> cli_job;
-    std::optional<std::future<std::string>> html_job;
-    std::optional<std::future<std::string>> json_job;
-    std::optional<std::future<std::string>> csv_job;
+// --trace-out <file>: records a Chrome trace for the rest of the command and
+// writes it on the way out. Declared ahead of any ReportExecutor so the report
+// writers it drains land in the trace too.
+class TraceSession {
+public:
+    explicit TraceSession(bool machine) : machine_(machine) {}
+    ~TraceSession() {
+        if (!started_) {
+            return;
+        }
+        std::string error;
+        if (!trace::finish(&error)) {
+            warn_nonfatal(machine_, error);
+        } else if (!machine_) {
+            logger::info("Trace written: " + path_);
+        }
+    }
+    TraceSession(const TraceSession&) = delete;
+    TraceSession& operator=(const TraceSession&) = delete;
 
-    if (selection.cli) {
-        cli_job.emplace(std::async(std::launch::async, [&result, &scan_id]() {
-            return reports::write_cli(result, scan_id);
-        }));
+    bool start(const ParsedArgs& parsed) {
+        const auto value = option_value(parsed, "trace-out");
+        if (!value.has_value()) {
+            return true;
+        }
+        if (value->empty()) {
+            logger::error("--trace-out requires a file path.");
+            return false;
+        }
+        std::string error;
+        if (!trace::start(*value, &error)) {
+            logger::error(error);
+            return false;
+        }
+        path_ = *value;
+        started_ = true;
+        return true;
     }
-    if (selection.html) {
-        html_job.emplace(std::async(std::launch::async, [&result, &scan_id]() {
-            return reports::write_html(result, scan_id);
-        }));
+
+private:
+    bool machine_;
+    bool started_ = false;
+    std::string path_;
+};
+
+// --memory-report: counts heap use per subsystem from here on and prints the
+// table when the command returns (to stderr in machine modes). Declared first
+// so the report writers and sinks it outlives are included.
+class MemoryReport {
+public:
+    MemoryReport(bool requested, bool machine) : requested_(requested), machine_(machine) {
+        memory::enable(requested_);
     }
-    if (selection.json) {
-        json_job.emplace(std::async(std::launch::async, [&result, &scan_id]() {
-            return reports::write_json(result, scan_id);
-        }));
+    ~MemoryReport() {
+        if (!requested_) {
+            return;
+        }
+        memory::enable(false);
+        const memory::Usage usage = memory::capture();
+        if (machine_) {
+            core::print_memory_report(std::cerr, usage);
+        } else {
+            std::cout << "\n";
+            core::print_memory_report(std::cout, usage);
+        }
     }
-    if (selection.csv) {
-        csv_job.emplace(std::async(std::launch::async, [&result, &scan_id]() {
-            return reports::write_csv(result, scan_id);
-        }));
+    MemoryReport(const MemoryReport&) = delete;
+    MemoryReport& operator=(const MemoryReport&) = delete;
+
+private:
+    bool requested_;
+    bool machine_;
+};
+
+// --metrics-file <path> / --metrics-port <port>: Prometheus text for each
+// finished scan or watch cycle, written atomically for a textfile collector
+// and, for watch, served on 127.0.0.1. Phase times need the profiler, so
+// callers enable it whenever a sink is configured.
+class MetricsSink {
+public:
+    explicit MetricsSink(bool machine) : machine_(machine) {}
+
+    bool start(const ParsedArgs& parsed) {
+        if (const auto value = option_value(parsed, "metrics-file")) {
+            if (value->empty()) {
+                logger::error("--metrics-file requires a file path.");
+                return false;
+            }
+            path_ = *value;
+        }
+        if (const auto value = option_value(parsed, "metrics-port")) {
+            int port = 0;
+            if (!parse_positive_int(*value, port) || port > 65535) {
+                logger::error("--metrics-port expects a port number between 1 and 65535.");
+                return false;
+            }
+            auto endpoint = std::make_unique<metrics::Endpoint>();
+            std::string error;
+            if (!endpoint->start(port, &error)) {
+                logger::error(error);
+                return false;
+            }
+            endpoint_ = std::move(endpoint);
+            if (!machine_) {
+                logger::info("Serving metrics at http://127.0.0.1:" + std::to_string(port) + "/metrics");
+            }
+        }
+        return true;
     }
 
-    outputs.cli_report = selection.cli ? safe_report_result(*cli_job, "CLI", log_errors) : "N/A";
-    outputs.html_report = selection.html ? safe_report_result(*html_job, "HTML", log_errors) : "N/A";
-    outputs.json_report = selection.json ? safe_report_result(*json_job, "JSON", log_errors) : "N/A";
-    outputs.csv_report = selection.csv ? safe_report_result(*csv_job, "CSV", log_errors) : "N/A";
+    bool enabled() const { return !path_.empty() || endpoint_ != nullptr; }
 
-    if (selection.cli) {
-        warn_if_missing_report(outputs.cli_report, "CLI", log_errors);
+    void publish(const metrics::Sample& sample) {
+        const std::string text = metrics::render(sample);
+        std::string error;
+        if (!path_.empty() && !metrics::write_textfile(path_, text, &error)) {
+            warn_nonfatal(machine_, error);
+        }
+        if (endpoint_) {
+            endpoint_->publish(text);
+        }
     }
-    if (selection.html) {
-        warn_if_missing_report(outputs.html_report, "HTML", log_errors);
+
+private:
+    bool machine_;
+    std::string path_;
+    std::unique_ptr<metrics::Endpoint> endpoint_;
+};
+
+// --memory-limit <size>: 0 when absent. Below a megabyte the runs would be
+// too small to merge efficiently.
+constexpr std::uint64_t kMinMemoryLimit = std::uint64_t{1} << 20;
+
+bool parse_memory_limit(const ParsedArgs& parsed, std::uint64_t& limit) {
+    limit = 0;
+    const auto value = option_value(parsed, "memory-limit");
+    if (!value.has_value()) {
+        return true;
     }
-    if (selection.json) {
-        warn_if_missing_report(outputs.json_report, "JSON", log_errors);
+    if (!core::parse_byte_size(*value, limit) || limit < kMinMemoryLimit) {
+        logger::error("--memory-limit expects a size of at least 1M, e.g. 512M or 4G: " + *value);
+        return false;
     }
-    if (selection.csv) {
-        warn_if_missing_report(outputs.csv_report, "CSV", log_errors);
+    return true;
+}
+
+// Init and update journal their hashes so an interrupted run can continue
+// with --resume. A journal that cannot be written only costs that, so it is
+// a warning; a journal that cannot be trusted fails the resume.
+bool open_scan_journal(scanner::ScanJournal& journal, const std::string& target, bool resume, bool machine) {
+    std::string error;
+    if (resume && scanner::ScanJournal::exists()) {
+        if (!journal.resume(target, &error)) {
+            logger::error(error);
+            return false;
+        }
+        if (!machine) {
+            logger::info("Resuming: " + std::to_string(journal.carried()) +
+                         " files already hashed by the interrupted run.");
+        }
+        return true;
+    }
+    if (resume) {
+        warn_nonfatal(machine, "No scan journal to resume from; starting a full scan.");
     }
+    if (!journal.start(target, &error)) {
+        warn_nonfatal(machine, error + " (this run cannot be resumed)");
+    }
+    return true;
 }
 
-} // namespace
+void log_rolling_progress(const scanner::RollingState& state) {
+    logger::info("Rolling scan: " + std::to_string(state.queued) + " new or changed files hashed first, " +
+                 std::to_string(state.rotated) + " unchanged files re-verified, " +
+                 std::to_string(state.deferred) + " left for later runs.");
+    if (state.lap_finished) {
+        logger::info(std::string("Rolling scan: verification lap completed") +
+                     (state.full_pass ? " (--full-every)." : "."));
+    } else {
+        logger::info("Rolling scan: lap " + std::to_string(static_cast<int>(state.lap_progress * 100.0)) +
+                     "% verified after " + std::to_string(state.lap_runs) + " run(s).");
+    }
+    if (state.never_verified != 0) {
+        logger::info("Rolling scan: " + std::to_string(state.never_verified) +
+                     " files not re-verified since tracking began.");
+    } else if (state.oldest_verified != 0) {
+        logger::info("Rolling scan: oldest verification " + fsutil::format_time(state.oldest_verified) + ".");
+    }
+}
 
-ExitCode load_baseline(BaselineView& baseline, bool quiet) {
-    if (!scanner::load_baseline(baseline.files, &baseline.root)) {
-        const std::string detail = scanner::baseline_last_error();
-        const bool baseline_missing =
-            detail.find("Baseline file not found") != std::string::npos;
-        const bool baseline_guard_failure =
-            detail.find("seal") != std::string::npos ||
-            detail.find("tamper") != std::string::npos;
-        if (!quiet) {
-            if (!detail.empty()) {
-                logger::error(detail);
-            } else {
-                logger::error("Baseline not found. Run --init <path> first.");
-            }
-            if (baseline_guard_failure) {
-                logger::error("Run --init --force or --update after confirming trusted state.");
-            }
+metrics::Sample metrics_sample(const char* command, const std::string& target, const core::ScanStats& stats) {
+    metrics::Sample sample;
+    sample.command = command;
+    sample.target = target;
+    sample.stats = stats;
+    sample.baseline_load_seconds =
+        stats.profile.phases[static_cast<std::size_t>(core::Phase::BaselineLoad)].seconds;
+    sample.seal_check_seconds = stats.profile.phases[static_cast<std::size_t>(core::Phase::SealCheck)].seconds;
+    sample.finished = std::time(nullptr);
+    return sample;
+}
+
+void log_report_issues(const reports::ReportBatchResult& batch) {
+    for (const std::string& message : batch.errors) {
+        logger::error(message);
+    }
+    for (const std::string& message : batch.warnings) {
+        logger::warning(message);
+    }
+}
+
+// Writes the selected reports for a finished scan and waits for them.
+void generate_reports(const scanner::ScanResult& result,
+                      const std::string& scan_id,
+                      const ReportSelection& selection,
+                      core::OutputPaths& outputs,
+                      bool log_errors) {
+    reports::ReportExecutor executor;
+    // Non-owning: `result` outlives the wait below.
+    const std::shared_ptr<const scanner::ScanResult> view(std::shared_ptr<const scanner::ScanResult>(),
+                                                          &result);
+    const reports::ReportBatchResult batch = executor.submit(view, scan_id, selection).get();
+    outputs.cli_report = batch.cli;
+    outputs.html_report = batch.html;
+    outputs.json_report = batch.json;
+    outputs.csv_report = batch.csv;
+    outputs.columnar_report = batch.columnar;
+    if (log_errors) {
+        log_report_issues(batch);
+    }
+}
+
+ExitCode report_baseline_failure(bool quiet) {
+    const std::string detail = scanner::baseline_last_error();
+    const bool baseline_missing =
+        detail.find("Baseline file not found") != std::string::npos;
+    const bool baseline_guard_failure =
+        detail.find("seal") != std::string::npos ||
+        detail.find("tamper") != std::string::npos;
+    if (!quiet) {
+        if (!detail.empty()) {
+            logger::error(detail);
+        } else {
+            logger::error("Baseline not found. Run --init <path> first.");
         }
         if (baseline_guard_failure) {
-            return ExitCode::OperationFailed;
+            logger::error("Run --init --force or --update after confirming trusted state.");
         }
-        return baseline_missing ? ExitCode::BaselineMissing : ExitCode::OperationFailed;
     }
+    if (baseline_guard_failure) {
+        return ExitCode::OperationFailed;
+    }
+    return baseline_missing ? ExitCode::BaselineMissing : ExitCode::OperationFailed;
+}
+
+void report_baseline_warning(bool quiet) {
     const std::string warning = scanner::baseline_last_warning();
     if (!quiet && !warning.empty()) {
         logger::warning(warning);
     }
+}
+
+} // namespace
+
+ExitCode load_baseline(BaselineView& baseline, bool quiet) {
+    if (!scanner::load_baseline(baseline.files, &baseline.root)) {
+        return report_baseline_failure(quiet);
+    }
+    report_baseline_warning(quiet);
+    return ExitCode::Ok;
+}
+
+ExitCode verify_baseline(std::string& digest, bool quiet) {
+    if (!scanner::verify_baseline(&digest)) {
+        return report_baseline_failure(quiet);
+    }
+    report_baseline_warning(quiet);
     return ExitCode::Ok;
 }
 
 ExitCode compare_target(const std::string& target,
                         ScanOutcome& outcome,
                         bool quiet,
-                        bool consider_mtime) {
+                        bool consider_mtime,
+                        const scanner::ChangeObserver& observer,
+                        bool keep_changes,
+                        const scanner::BoundedScan* bounds,
+                        scanner::ScanJournal* journal,
+                        const scanner::RollingScan* rolling,
+                        scanner::RollingState* rolling_state) {
     BaselineView baseline;
-    const ExitCode baseline_code = load_baseline(baseline, quiet);
-    if (baseline_code != ExitCode::Ok) {
-        return baseline_code;
+    if (bounds == nullptr) {
+        const ExitCode baseline_code = load_baseline(baseline, quiet);
+        if (baseline_code != ExitCode::Ok) {
+            return baseline_code;
+        }
+    } else {
+        // Records stay on disk for the streaming compare; read the seal and header only.
+        std::string digest;
+        const ExitCode baseline_code = verify_baseline(digest, quiet);
+        if (baseline_code != ExitCode::Ok) {
+            return baseline_code;
+        }
+        scanner::BaselineReader reader;
+        if (reader.open(config::BASELINE_DB)) {
+            baseline.root = reader.root();
+        }
     }
 
     if (!baseline.root.empty() &&
@@ -236,10 +565,22 @@ ExitCode compare_target(const std::string& target,
         return ExitCode::TargetMismatch;
     }
 
-    core::ScanStats snapshot_stats;
-    const scanner::FileMap current = scanner::build_snapshot(target, &snapshot_stats);
-    outcome.result = scanner::compare(baseline.files, current, consider_mtime);
-    outcome.result.stats.duration = snapshot_stats.duration;
+    if (bounds == nullptr && rolling != nullptr && rolling_state != nullptr) {
+        outcome.result = scanner::scan_compare_rolling(target, baseline.files, consider_mtime, *rolling,
+                                                       *rolling_state, observer, keep_changes);
+    } else if (bounds == nullptr) {
+        outcome.result =
+            scanner::scan_compare(target, baseline.files, consider_mtime, observer, keep_changes, journal);
+    } else {
+        std::string error;
+        if (!scanner::scan_compare_bounded(target, *bounds, consider_mtime, outcome.result, observer,
+                                           keep_changes, &error)) {
+            if (!quiet) {
+                logger::error(error);
+            }
+            return ExitCode::OperationFailed;
+        }
+    }
     outcome.target = target;
     outcome.outputs = default_outputs();
     return ExitCode::Ok;
@@ -261,6 +602,21 @@ ExitCode handle_init(const ParsedArgs& parsed) {
     const bool quiet = has_switch(parsed, "quiet");
     const bool no_advice = has_switch(parsed, "no-advice");
     const std::string target = normalize_path(raw_target);
+    MemoryReport memory_report(has_switch(parsed, "memory-report"), as_json);
+    std::uint64_t memory_limit = 0;
+    if (!parse_memory_limit(parsed, memory_limit)) {
+        return ExitCode::UsageError;
+    }
+    const bool resume = has_switch(parsed, "resume");
+    if (resume && memory_limit != 0) {
+        logger::error("--resume cannot be combined with --memory-limit.");
+        return ExitCode::UsageError;
+    }
+    profiler::enable(has_switch(parsed, "profile"));
+    TraceSession trace_session(as_json);
+    if (!trace_session.start(parsed)) {
+        return ExitCode::UsageError;
+    }
 
     std::error_code ec;
     const bool baseline_exists = std::filesystem::exists(config::BASELINE_DB, ec);
@@ -270,11 +626,35 @@ ExitCode handle_init(const ParsedArgs& parsed) {
     }
 
     core::ScanStats stats;
-    const scanner::FileMap snapshot = scanner::build_snapshot(target, &stats);
-    if (!scanner::save_baseline(snapshot, target)) {
-        const std::string detail = scanner::baseline_last_error();
-        logger::error(detail.empty() ? ("Failed to save baseline: " + config::BASELINE_DB) : detail);
-        return ExitCode::OperationFailed;
+    if (memory_limit != 0) {
+        const scanner::BoundedScan bounds{memory_limit, config::BASELINE_DB + ".tmp", target};
+        std::string error;
+        if (!scanner::build_snapshot_bounded(target, bounds, &stats, &error)) {
+            logger::error(error);
+            return ExitCode::OperationFailed;
+        }
+        if (!scanner::install_baseline(bounds.staged_baseline)) {
+            const std::string detail = scanner::baseline_last_error();
+            logger::error(detail.empty() ? ("Failed to save baseline: " + config::BASELINE_DB) : detail);
+            return ExitCode::OperationFailed;
+        }
+    } else {
+        scanner::ScanJournal journal;
+        if (!open_scan_journal(journal, target, resume, as_json)) {
+            return ExitCode::OperationFailed;
+        }
+        const scanner::FileMap snapshot = scanner::build_snapshot(target, &stats, &journal);
+        if (!scanner::save_baseline(snapshot, target)) {
+            const std::string detail = scanner::baseline_last_error();
+            logger::error(detail.empty() ? ("Failed to save baseline: " + config::BASELINE_DB) : detail);
+            return ExitCode::OperationFailed;
+        }
+        journal.discard();
+    }
+    stats.profile = profiler::capture();
+
+    if (!as_json && !scanner::baseline_last_warning().empty()) {
+        logger::warning(scanner::baseline_last_warning());
     }
 
     if (as_json) {
@@ -282,10 +662,17 @@ ExitCode handle_init(const ParsedArgs& parsed) {
                   << "  \"command\": \"init\",\n"
                   << "  \"target\": \"" << json_escape(target) << "\",\n"
                   << "  \"files_scanned\": " << stats.scanned << ",\n"
-                  << "  \"baseline\": \"" << json_escape(config::BASELINE_DB) << "\"\n"
-                  << "}\n";
+                  << "  \"baseline\": \"" << json_escape(config::BASELINE_DB) << "\"";
+        if (stats.profile.enabled) {
+            std::cout << ",\n  \"profile\": " << profile_json(stats.profile)
+                      << ",\n  \"distribution\": " << distribution_json(stats.distribution);
+        }
+        std::cout << "\n}\n";
     } else {
         logger::success("Baseline initialized with " + std::to_string(stats.scanned) + " files.");
+        if (stats.resumed != 0) {
+            logger::info(std::to_string(stats.resumed) + " of them were carried over from the interrupted run.");
+        }
         if (!quiet) {
             core::print_summary(target, stats, default_outputs(), true);
         } else {
@@ -310,7 +697,12 @@ ExitCode handle_scan_mode(const ParsedArgs& parsed, ScanMode mode) {
         return ExitCode::UsageError;
     }
 
-    const bool as_json = has_switch(parsed, "json");
+    ScanOutput output = ScanOutput::Text;
+    if (!parse_scan_output(parsed, output)) {
+        return ExitCode::UsageError;
+    }
+    const bool machine = output != ScanOutput::Text;
+    MemoryReport memory_report(has_switch(parsed, "memory-report"), machine);
     const bool requested_reports = has_switch(parsed, "reports");
     const bool no_reports = has_switch(parsed, "no-reports");
     const bool strict = has_switch(parsed, "strict");
@@ -318,6 +710,8 @@ ExitCode handle_scan_mode(const ParsedArgs& parsed, ScanMode mode) {
     const bool no_advice = has_switch(parsed, "no-advice");
     const bool hash_only = has_switch(parsed, "hash-only");
     const std::string target = normalize_path(raw_target);
+    const char* command = mode_name(mode);
+    const bool show_profile = has_switch(parsed, "profile");
 
     ReportSelection report_selection;
     bool explicit_selection = false;
@@ -330,27 +724,44 @@ ExitCode handle_scan_mode(const ParsedArgs& parsed, ScanMode mode) {
         logger::error("Use either --no-reports or --report-formats, not both.");
         return ExitCode::UsageError;
     }
-
-    ScanOutcome outcome;
-    const ExitCode compare_code = compare_target(target, outcome, as_json, !hash_only);
-    if (compare_code != ExitCode::Ok) {
-        if (as_json) {
-            std::cout << "{\n"
-                      << "  \"command\": \""
-                      << (mode == ScanMode::Scan ? "scan" :
-                          mode == ScanMode::Update ? "update" :
-                          mode == ScanMode::Status ? "status" : "verify")
-                      << "\",\n"
-                      << "  \"target\": \"" << json_escape(target) << "\",\n"
-                      << "  \"exit_code\": " << static_cast<int>(compare_code) << "\n"
-                      << "}\n";
-        }
-        return compare_code;
+    std::uint64_t memory_limit = 0;
+    if (!parse_memory_limit(parsed, memory_limit)) {
+        return ExitCode::UsageError;
     }
-
-    if (!as_json && !quiet) {
-        log_changes(outcome.result);
+    const bool resume = has_switch(parsed, "resume");
+    if (resume && memory_limit != 0) {
+        logger::error("--resume cannot be combined with --memory-limit.");
+        return ExitCode::UsageError;
+    }
+    int time_budget = 0;
+    int full_every = 0;
+    if (!parse_positive_option(parsed, "time-budget", 0, time_budget) ||
+        !parse_positive_option(parsed, "full-every", 0, full_every)) {
+        return ExitCode::UsageError;
+    }
+    if (full_every != 0 && time_budget == 0) {
+        logger::error("--full-every needs --time-budget.");
+        return ExitCode::UsageError;
     }
+    if (time_budget != 0 && (memory_limit != 0 || resume)) {
+        logger::error(std::string("--time-budget cannot be combined with ") +
+                      (resume ? "--resume." : "--memory-limit."));
+        return ExitCode::UsageError;
+    }
+    const scanner::RollingScan rolling{static_cast<double>(time_budget), static_cast<std::uint64_t>(full_every)};
+    // Under --memory-limit, update stages the new baseline during the merge.
+    scanner::BoundedScan bounds;
+    bounds.memory_limit = memory_limit;
+    if (mode == ScanMode::Update) {
+        bounds.staged_baseline = config::BASELINE_DB + ".tmp";
+        bounds.root = target;
+    }
+    TraceSession trace_session(machine);
+    MetricsSink metrics_sink(machine);
+    if (!trace_session.start(parsed) || !metrics_sink.start(parsed)) {
+        return ExitCode::UsageError;
+    }
+    profiler::enable(show_profile || metrics_sink.enabled());
 
     bool write_reports = (mode == ScanMode::Scan || mode == ScanMode::Update) || requested_reports;
     if (mode == ScanMode::Status) {
@@ -363,54 +774,129 @@ ExitCode handle_scan_mode(const ParsedArgs& parsed, ScanMode mode) {
         write_reports = any_enabled(report_selection);
     }
 
+    // NDJSON prints changes as they are found; the maps are only kept when a
+    // report still needs them.
+    scanner::ChangeObserver observer;
+    bool keep_changes = true;
+    if (output == ScanOutput::Ndjson) {
+        print_ndjson_start(command, target);
+        observer = print_ndjson_change;
+        keep_changes = write_reports;
+    }
+
+    scanner::ScanJournal journal;
+    const bool journaled = mode == ScanMode::Update && memory_limit == 0 && time_budget == 0;
+    if (journaled && !open_scan_journal(journal, target, resume, machine)) {
+        return ExitCode::OperationFailed;
+    }
+    // A damaged or foreign rotation state only restarts the rotation.
+    scanner::RollingState rolling_state;
+    std::string rolling_error;
+    if (time_budget != 0 && !scanner::load_rolling_state(target, rolling_state, &rolling_error)) {
+        warn_nonfatal(machine, rolling_error);
+    }
+
+    ScanOutcome outcome;
+    const ExitCode compare_code =
+        compare_target(target, outcome, machine, !hash_only, observer, keep_changes,
+                       memory_limit != 0 ? &bounds : nullptr, journaled ? &journal : nullptr,
+                       time_budget != 0 ? &rolling : nullptr, &rolling_state);
+    if (compare_code != ExitCode::Ok) {
+        if (output == ScanOutput::Json) {
+            std::cout << "{\n"
+                      << "  \"command\": \"" << command << "\",\n"
+                      << "  \"target\": \"" << json_escape(target) << "\",\n"
+                      << "  \"exit_code\": " << static_cast<int>(compare_code) << "\n"
+                      << "}\n";
+        } else if (output == ScanOutput::Ndjson) {
+            print_ndjson_summary(command, target, nullptr, compare_code);
+        }
+        return compare_code;
+    }
+    if (time_budget != 0 && !scanner::save_rolling_state(rolling_state, &rolling_error)) {
+        warn_nonfatal(machine, rolling_error);
+    }
+
+    if (!machine && !quiet) {
+        log_changes(outcome.result);
+        if (outcome.result.stats.spill_runs != 0) {
+            logger::info("Snapshot spilled to " + std::to_string(outcome.result.stats.spill_runs) +
+                         " sorted runs to stay within --memory-limit.");
+        }
+        if (outcome.result.stats.resumed != 0) {
+            logger::info(std::to_string(outcome.result.stats.resumed) +
+                         " files carried over from the interrupted run without rehashing.");
+        }
+        if (time_budget != 0) {
+            log_rolling_progress(rolling_state);
+        }
+    }
+
     if (write_reports) {
         const std::string scan_id = fsutil::timestamp();
-        generate_reports_async(outcome.result, scan_id, report_selection, outcome.outputs, !as_json);
+        generate_reports(outcome.result, scan_id, report_selection, outcome.outputs, !machine);
     }
 
     if (mode == ScanMode::Update) {
-        if (!scanner::save_baseline(outcome.result.current, target)) {
+        const bool saved = memory_limit != 0 ? scanner::install_baseline(bounds.staged_baseline)
+                                             : scanner::save_baseline(outcome.result.current, target);
+        if (!saved) {
             const std::string detail = scanner::baseline_last_error();
             logger::error(detail.empty() ? "Scan completed, but baseline update failed." : detail);
             return ExitCode::OperationFailed;
         }
-        if (!as_json) {
+        journal.discard();
+        if (!machine) {
             logger::info("Baseline refreshed.");
+            if (!scanner::baseline_last_warning().empty()) {
+                logger::warning(scanner::baseline_last_warning());
+            }
         }
     }
 
+    outcome.result.stats.profile = profiler::capture();
+    if (metrics_sink.enabled()) {
+        metrics_sink.publish(metrics_sample(command, target, outcome.result.stats));
+    }
+    // The profiler may have run for the metrics only; show it on request.
+    outcome.result.stats.profile.enabled = show_profile;
     const bool changes = has_changes(outcome.result);
     ExitCode code = ExitCode::Ok;
     if ((mode == ScanMode::Status || mode == ScanMode::Verify || strict) && changes) {
         code = ExitCode::ChangesDetected;
     }
 
-    if (!as_json) {
-        if (!quiet) {
-            core::print_summary(target, outcome.result.stats, outcome.outputs, true);
-        } else {
-            std::cout << "Scan: scanned=" << outcome.result.stats.scanned
-                      << " added=" << outcome.result.stats.added
-                      << " modified=" << outcome.result.stats.modified
-                      << " deleted=" << outcome.result.stats.deleted
-                      << " duration=" << std::fixed << std::setprecision(2)
-                      << outcome.result.stats.duration << "s\n";
-        }
-        if (mode == ScanMode::Status) {
-            if (changes) {
-                logger::warning("STATUS: CHANGES_DETECTED");
-            } else {
-                logger::success("STATUS: CLEAN");
-            }
+    if (output == ScanOutput::Json) {
+        print_scan_json(command, outcome, code);
+        return code;
+    }
+    if (output == ScanOutput::Ndjson) {
+        print_ndjson_summary(command, target, &outcome, code);
+        return code;
+    }
+
+    if (!quiet) {
+        core::print_summary(target, outcome.result.stats, outcome.outputs, true);
+    } else {
+        std::cout << "Scan: scanned=" << outcome.result.stats.scanned
+                  << " added=" << outcome.result.stats.added
+                  << " modified=" << outcome.result.stats.modified
+                  << " deleted=" << outcome.result.stats.deleted
+                  << " duration=" << std::fixed << std::setprecision(2)
+                  << outcome.result.stats.duration << "s\n";
+        if (outcome.result.stats.profile.enabled) {
+            std::cout << "Profile: " << profile_line(outcome.result.stats) << "\n";
         }
-        if (!quiet && !no_advice) {
-            print_advice(build_scan_advice(outcome.result, mode, mode == ScanMode::Update));
+    }
+    if (mode == ScanMode::Status) {
+        if (changes) {
+            logger::warning("STATUS: CHANGES_DETECTED");
+        } else {
+            logger::success("STATUS: CLEAN");
         }
-    } else {
-        print_scan_json(mode == ScanMode::Scan ? "scan" :
-                        mode == ScanMode::Update ? "update" :
-                        mode == ScanMode::Status ? "status" : "verify",
-                        outcome, code);
+    }
+    if (!quiet && !no_advice) {
+        print_advice(build_scan_advice(outcome.result, mode, mode == ScanMode::Update));
     }
 
     return code;
@@ -440,6 +926,8 @@ ExitCode handle_watch(const ParsedArgs& parsed) {
     const bool no_advice = has_switch(parsed, "no-advice");
     const bool hash_only = has_switch(parsed, "hash-only");
     const std::string target = normalize_path(raw_target);
+    const bool show_profile = has_switch(parsed, "profile");
+    MemoryReport memory_report(has_switch(parsed, "memory-report"), as_json);
 
     ReportSelection report_selection;
     bool explicit_selection = false;
@@ -452,6 +940,12 @@ ExitCode handle_watch(const ParsedArgs& parsed) {
     if (explicit_selection) {
         emit_reports = any_enabled(report_selection);
     }
+    TraceSession trace_session(as_json);
+    MetricsSink metrics_sink(as_json);
+    if (!trace_session.start(parsed) || !metrics_sink.start(parsed)) {
+        return ExitCode::UsageError;
+    }
+    profiler::enable(show_profile || metrics_sink.enabled());
 
     BaselineView baseline;
     const ExitCode load_code = load_baseline(baseline, as_json);
@@ -482,14 +976,40 @@ ExitCode handle_watch(const ParsedArgs& parsed) {
         return ExitCode::TargetMismatch;
     }
 
+    // Reports of a changed cycle are written while the next cycles scan. If they
+    // fall behind, only the newest waiting batch is kept (see ReportExecutor);
+    // leaving this function, including via --fail-fast, waits for the rest.
+    // Each cycle resets the profiler, so keep the one-time baseline load.
+    const core::ScanProfile load_profile = profiler::capture();
+    std::uint64_t changed_cycles = 0;
+
+    reports::ReportExecutor report_executor;
     bool any_changes = false;
     for (int cycle = 1; cycle <= cycles; ++cycle) {
+        // Reports run behind the scan, so their time lands in whichever cycle
+        // is current when a writer finishes.
+        profiler::reset();
         core::ScanStats snapshot_stats;
         const scanner::FileMap current = scanner::build_snapshot(target, &snapshot_stats);
         scanner::ScanResult result = scanner::compare(baseline.files, current, !hash_only);
         result.stats.duration = snapshot_stats.duration;
+        result.stats.distribution = std::move(snapshot_stats.distribution);
+        result.stats.hash_seconds = snapshot_stats.hash_seconds;
+        result.stats.hash_workers = snapshot_stats.hash_workers;
+        result.stats.profile = profiler::capture();
         const bool changed = has_changes(result);
         any_changes = any_changes || changed;
+        changed_cycles += changed ? 1 : 0;
+        if (metrics_sink.enabled()) {
+            metrics::Sample sample = metrics_sample("watch", target, result.stats);
+            sample.baseline_load_seconds =
+                load_profile.phases[static_cast<std::size_t>(core::Phase::BaselineLoad)].seconds;
+            sample.seal_check_seconds = load_profile.phases[static_cast<std::size_t>(core::Phase::SealCheck)].seconds;
+            sample.cycles = static_cast<std::uint64_t>(cycle);
+            sample.changed_cycles = changed_cycles;
+            metrics_sink.publish(sample);
+        }
+        result.stats.profile.enabled = show_profile;
 
         if (as_json) {
             std::cout << "{"
@@ -499,8 +1019,12 @@ ExitCode handle_watch(const ParsedArgs& parsed) {
                       << "\"added\":" << result.stats.added << ","
                       << "\"modified\":" << result.stats.modified << ","
                       << "\"deleted\":" << result.stats.deleted << ","
-                      << "\"changed\":" << (changed ? "true" : "false")
-                      << "}\n";
+                      << "\"changed\":" << (changed ? "true" : "false");
+            if (result.stats.profile.enabled) {
+                std::cout << ",\"profile\":" << profile_json(result.stats.profile)
+                          << ",\"distribution\":" << distribution_json(result.stats.distribution);
+            }
+            std::cout << "}\n";
         } else if (!quiet) {
             std::cout << "Cycle " << cycle << "/" << cycles
                       << " | scanned=" << result.stats.scanned
@@ -509,6 +1033,9 @@ ExitCode handle_watch(const ParsedArgs& parsed) {
                       << " deleted=" << result.stats.deleted
                       << " duration=" << std::fixed << std::setprecision(2)
                       << result.stats.duration << "s\n";
+            if (result.stats.profile.enabled) {
+                std::cout << "  profile: " << profile_line(result.stats) << "\n";
+            }
         }
 
         if (changed) {
@@ -518,8 +1045,19 @@ ExitCode handle_watch(const ParsedArgs& parsed) {
             if (emit_reports) {
                 const std::string scan_id =
                     fsutil::timestamp() + "_watch_" + std::to_string(cycle);
-                core::OutputPaths watch_outputs = default_outputs();
-                generate_reports_async(result, scan_id, report_selection, watch_outputs, !as_json);
+                report_executor.submit(
+                    std::make_shared<const scanner::ScanResult>(std::move(result)), scan_id,
+                    report_selection, [as_json, cycle](const reports::ReportBatchResult& batch) {
+                        if (as_json) {
+                            return;
+                        }
+                        if (batch.dropped) {
+                            logger::warning("Reports for cycle " + std::to_string(cycle) +
+                                            " skipped; a newer cycle superseded them.");
+                            return;
+                        }
+                        log_report_issues(batch);
+                    });
             }
             if (fail_fast) {
                 return ExitCode::ChangesDetected;
@@ -5,10 +5,25 @@
 namespace commands {
 
 ExitCode load_baseline(BaselineView& baseline, bool quiet = false);
+// Seal check only; records are left on disk for streaming readers.
+ExitCode verify_baseline(std::string& digest, bool quiet = false);
+// `observer` sees changes while the scan runs; with `keep_changes` false the
+// outcome only carries change counts (see scanner::scan_compare). With
+// `bounds` the baseline is streamed from disk and the snapshot kept within
+// its memory limit (see scanner::scan_compare_bounded). A `journal`
+// checkpoints the hashes for --resume (see scanner::ScanJournal). With
+// `rolling` and its `rolling_state` only part of the tree is re-hashed (see
+// scanner::scan_compare_rolling); the caller loads and saves the state.
 ExitCode compare_target(const std::string& target,
                         ScanOutcome& outcome,
                         bool quiet = false,
-                        bool consider_mtime = true);
+                        bool consider_mtime = true,
+                        const scanner::ChangeObserver& observer = {},
+                        bool keep_changes = true,
+                        const scanner::BoundedScan* bounds = nullptr,
+                        scanner::ScanJournal* journal = nullptr,
+                        const scanner::RollingScan* rolling = nullptr,
+                        scanner::RollingState* rolling_state = nullptr);
 
 ExitCode handle_init(const ParsedArgs& parsed);
 ExitCode handle_scan_mode(const ParsedArgs& parsed, ScanMode mode);
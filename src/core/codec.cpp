@@ -0,0 +1,254 @@
+#include "codec.h"
+#include <array>
+#include <cstring>
+#include <vector>
+
+namespace codec {
+
+namespace {
+
+constexpr std::size_t MIN_MATCH = 4;
+constexpr std::size_t MAX_OFFSET = 65535;
+constexpr int HASH_BITS = 16;
+
+std::uint32_t read32(const char* data) {
+    std::uint32_t value = 0;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+std::uint32_t hash_sequence(std::uint32_t sequence) {
+    return (sequence * 2654435761u) >> (32 - HASH_BITS);
+}
+
+void put_length(std::string& out, std::size_t length) {
+    while (length >= 255) {
+        out.push_back(static_cast<char>(255));
+        length -= 255;
+    }
+    out.push_back(static_cast<char>(length));
+}
+
+bool get_length(const unsigned char*& cursor, const unsigned char* end, std::size_t& length) {
+    unsigned char byte = 255;
+    while (byte == 255) {
+        if (cursor >= end) {
+            return false;
+        }
+        byte = *cursor++;
+        length += byte;
+    }
+    return true;
+}
+
+void emit_sequence(std::string& out,
+                   const char* literals,
+                   std::size_t literal_count,
+                   std::size_t offset,
+                   std::size_t match_length) {
+    const std::size_t match_code = match_length - MIN_MATCH;
+    const unsigned char token = static_cast<unsigned char>(
+        ((literal_count >= 15 ? 15 : literal_count) << 4) | (match_code >= 15 ? 15 : match_code));
+    out.push_back(static_cast<char>(token));
+    if (literal_count >= 15) {
+        put_length(out, literal_count - 15);
+    }
+    out.append(literals, literal_count);
+    out.push_back(static_cast<char>(offset & 0xFF));
+    out.push_back(static_cast<char>((offset >> 8) & 0xFF));
+    if (match_code >= 15) {
+        put_length(out, match_code - 15);
+    }
+}
+
+void emit_last_literals(std::string& out, const char* literals, std::size_t literal_count) {
+    out.push_back(static_cast<char>((literal_count >= 15 ? 15 : literal_count) << 4));
+    if (literal_count >= 15) {
+        put_length(out, literal_count - 15);
+    }
+    out.append(literals, literal_count);
+}
+
+const std::array<std::uint32_t, 256>& crc_table() {
+    static const std::array<std::uint32_t, 256> table = [] {
+        std::array<std::uint32_t, 256> values{};
+        for (std::uint32_t i = 0; i < 256; ++i) {
+            std::uint32_t value = i;
+            for (int bit = 0; bit < 8; ++bit) {
+                value = (value & 1u) != 0 ? 0xEDB88320u ^ (value >> 1) : value >> 1;
+            }
+            values[i] = value;
+        }
+        return values;
+    }();
+    return table;
+}
+
+} // namespace
+
+std::string compress(const char* data, std::size_t size) {
+    std::string out;
+    out.reserve(size + size / 255 + 16);
+
+    std::vector<std::uint32_t> table(std::size_t{1} << HASH_BITS, 0);
+    std::size_t anchor = 0;
+    std::size_t pos = 0;
+
+    while (pos + MIN_MATCH <= size) {
+        const std::uint32_t sequence = read32(data + pos);
+        std::uint32_t& slot = table[hash_sequence(sequence)];
+        const std::size_t candidate = slot;
+        slot = static_cast<std::uint32_t>(pos + 1);
+
+        if (candidate != 0) {
+            const std::size_t match = candidate - 1;
+            if (pos - match <= MAX_OFFSET && read32(data + match) == sequence) {
+                std::size_t length = MIN_MATCH;
+                while (pos + length < size && data[match + length] == data[pos + length]) {
+                    ++length;
+                }
+                emit_sequence(out, data + anchor, pos - anchor, pos - match, length);
+                pos += length;
+                anchor = pos;
+                continue;
+            }
+        }
+        ++pos;
+    }
+
+    emit_last_literals(out, data + anchor, size - anchor);
+    return out;
+}
+
+std::string compress(const std::string& input) {
+    return compress(input.data(), input.size());
+}
+
+bool decompress(const char* data, std::size_t size, std::size_t raw_size, std::string& output) {
+    output.assign(raw_size, '\0');
+    const unsigned char* cursor = reinterpret_cast<const unsigned char*>(data);
+    const unsigned char* const end = cursor + size;
+    std::size_t written = 0;
+
+    while (cursor < end) {
+        const unsigned char token = *cursor++;
+
+        std::size_t literal_count = token >> 4;
+        if (literal_count == 15 && !get_length(cursor, end, literal_count)) {
+            return false;
+        }
+        if (literal_count > static_cast<std::size_t>(end - cursor) ||
+            literal_count > raw_size - written) {
+            return false;
+        }
+        std::memcpy(&output[written], cursor, literal_count);
+        cursor += literal_count;
+        written += literal_count;
+
+        if (cursor == end) {
+            break;
+        }
+        if (end - cursor < 2) {
+            return false;
+        }
+        const std::size_t offset = static_cast<std::size_t>(cursor[0]) |
+                                   (static_cast<std::size_t>(cursor[1]) << 8);
+        cursor += 2;
+        std::size_t match_length = token & 0x0F;
+        if (match_length == 15 && !get_length(cursor, end, match_length)) {
+            return false;
+        }
+        match_length += MIN_MATCH;
+        if (offset == 0 || offset > written || match_length > raw_size - written) {
+            return false;
+        }
+
+        char* dest = &output[written];
+        const char* source = dest - offset;
+        if (offset >= match_length) {
+            std::memcpy(dest, source, match_length);
+        } else {
+            // Overlapping copy repeats the last `offset` bytes.
+            for (std::size_t i = 0; i < match_length; ++i) {
+                dest[i] = source[i];
+            }
+        }
+        written += match_length;
+    }
+    return written == raw_size;
+}
+
+std::uint32_t crc32(const char* data, std::size_t size, std::uint32_t crc) {
+    const auto& table = crc_table();
+    crc = ~crc;
+    for (std::size_t i = 0; i < size; ++i) {
+        crc = table[(crc ^ static_cast<unsigned char>(data[i])) & 0xFFu] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+void put_varint(std::string& out, std::uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+bool get_varint(const char*& cursor, const char* end, std::uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (cursor >= end) {
+            return false;
+        }
+        const unsigned char byte = static_cast<unsigned char>(*cursor++);
+        value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void put_u32(std::string& out, std::uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+        out.push_back(static_cast<char>((value >> (i * 8)) & 0xFF));
+    }
+}
+
+void put_u64(std::string& out, std::uint64_t value) {
+    for (int i = 0; i < 8; ++i) {
+        out.push_back(static_cast<char>((value >> (i * 8)) & 0xFF));
+    }
+}
+
+std::uint32_t get_u32(const char* data) {
+    std::uint32_t value = 0;
+    for (int i = 3; i >= 0; --i) {
+        value = (value << 8) | static_cast<unsigned char>(data[i]);
+    }
+    return value;
+}
+
+std::uint64_t get_u64(const char* data) {
+    std::uint64_t value = 0;
+    for (int i = 7; i >= 0; --i) {
+        value = (value << 8) | static_cast<unsigned char>(data[i]);
+    }
+    return value;
+}
+
+int hex_value(char ch) {
+    if (ch >= '0' && ch <= '9') {
+        return ch - '0';
+    }
+    if (ch >= 'a' && ch <= 'f') {
+        return ch - 'a' + 10;
+    }
+    if (ch >= 'A' && ch <= 'F') {
+        return ch - 'A' + 10;
+    }
+    return -1;
+}
+
+} // namespace codec
@@ -0,0 +1,28 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace codec {
+
+// Byte-oriented LZ77 block codec (LZ4-style sequences: token, literals,
+// 16-bit offset, extended lengths). Blocks are self-contained; the caller
+// stores the uncompressed size next to the payload.
+std::string compress(const char* data, std::size_t size);
+std::string compress(const std::string& input);
+// Rejects malformed input instead of reading or writing out of bounds.
+bool decompress(const char* data, std::size_t size, std::size_t raw_size, std::string& output);
+
+// CRC-32 (IEEE 802.3); pass the previous result as `crc` to continue a checksum.
+std::uint32_t crc32(const char* data, std::size_t size, std::uint32_t crc = 0);
+
+void put_varint(std::string& out, std::uint64_t value);
+bool get_varint(const char*& cursor, const char* end, std::uint64_t& value);
+void put_u32(std::string& out, std::uint32_t value);
+void put_u64(std::string& out, std::uint64_t value);
+std::uint32_t get_u32(const char* data);
+std::uint64_t get_u64(const char* data);
+// Value of one hex digit in either case, or -1.
+int hex_value(char ch);
+
+} // namespace codec
@@ -151,10 +151,18 @@ inline std::string REPORT_CLI_DIR;
 inline std::string REPORT_HTML_DIR;
 inline std::string REPORT_JSON_DIR;
 inline std::string REPORT_CSV_DIR;
+inline std::string REPORT_COLUMNAR_DIR;
+inline std::string REPORT_MANIFEST;
 
 inline std::string BASELINE_DB;
 inline std::string BASELINE_SEAL_FILE;
+inline std::string BASELINE_INDEX;
+inline std::string SCAN_JOURNAL;
+inline std::string ROLLING_STATE;
+inline std::string HISTORY_DIR;
 inline std::string LOG_FILE;
+inline std::string LOG_ARCHIVE_DIR;
+inline std::string LOG_SEGMENT_INDEX;
 inline std::string IGNORE_FILE;
 
 inline void rebuild_paths() {
@@ -167,10 +175,18 @@ inline void rebuild_paths() {
     REPORT_HTML_DIR = normalize_path_string(fs::path(REPORT_DIR) / "html");
     REPORT_JSON_DIR = normalize_path_string(fs::path(REPORT_DIR) / "json");
     REPORT_CSV_DIR = normalize_path_string(fs::path(REPORT_DIR) / "csv");
+    REPORT_COLUMNAR_DIR = normalize_path_string(fs::path(REPORT_DIR) / "columnar");
+    REPORT_MANIFEST = normalize_path_string(fs::path(REPORT_DIR) / ".report-manifest");
 
     BASELINE_DB = normalize_path_string(fs::path(DATA_DIR) / ".sentinel-baseline");
     BASELINE_SEAL_FILE = normalize_path_string(fs::path(DATA_DIR) / ".sentinel-baseline.seal");
+    BASELINE_INDEX = normalize_path_string(fs::path(DATA_DIR) / ".sentinel-baseline.idx");
+    SCAN_JOURNAL = normalize_path_string(fs::path(DATA_DIR) / ".sentinel-scan.journal");
+    ROLLING_STATE = normalize_path_string(fs::path(DATA_DIR) / ".sentinel-rolling");
+    HISTORY_DIR = normalize_path_string(fs::path(DATA_DIR) / "history");
     LOG_FILE = normalize_path_string(fs::path(LOG_DIR) / ("sentinel-c_activity_log_" + RUN_ID + ".log"));
+    LOG_ARCHIVE_DIR = normalize_path_string(fs::path(LOG_DIR) / "archive");
+    LOG_SEGMENT_INDEX = normalize_path_string(fs::path(LOG_ARCHIVE_DIR) / "segments.idx");
     IGNORE_FILE = normalize_path_string(fs::path(OUTPUT_ROOT) / ".sentinelignore");
 }
 
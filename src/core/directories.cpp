@@ -13,6 +13,7 @@ void ensure_directories() {
     fs::create_directories(config::REPORT_HTML_DIR);
     fs::create_directories(config::REPORT_JSON_DIR);
     fs::create_directories(config::REPORT_CSV_DIR);
+    fs::create_directories(config::REPORT_COLUMNAR_DIR);
 }
 
 }
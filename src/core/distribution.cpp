@@ -0,0 +1,191 @@
+#include "distribution.h"
+#include <algorithm>
+#include <iterator>
+
+namespace core {
+
+namespace {
+
+// 2^kSubBits buckets per power of two above the first kExact exact values.
+constexpr unsigned kSubBits = 4;
+constexpr std::uint64_t kExact = std::uint64_t{2} << kSubBits;
+constexpr std::size_t kBucketCount = (64 - kSubBits) * (std::size_t{1} << kSubBits) + kExact / 2;
+
+unsigned top_bit(std::uint64_t value) {
+    unsigned bit = 0;
+    while (value >>= 1) {
+        ++bit;
+    }
+    return bit;
+}
+
+std::size_t bucket_index(std::uint64_t value) {
+    if (value < kExact) {
+        return static_cast<std::size_t>(value);
+    }
+    const unsigned shift = top_bit(value) - kSubBits;
+    return static_cast<std::size_t>(shift) * (std::size_t{1} << kSubBits) + static_cast<std::size_t>(value >> shift);
+}
+
+std::uint64_t bucket_low(std::size_t index) {
+    if (index < kExact) {
+        return index;
+    }
+    const std::size_t per_power = std::size_t{1} << kSubBits;
+    const unsigned shift = static_cast<unsigned>(index / per_power - 1);
+    return static_cast<std::uint64_t>(index % per_power + per_power) << shift;
+}
+
+std::uint64_t bucket_high(std::size_t index) {
+    if (index < kExact) {
+        return index;
+    }
+    const unsigned shift = static_cast<unsigned>(index / (std::size_t{1} << kSubBits) - 1);
+    return bucket_low(index) + ((std::uint64_t{1} << shift) - 1);
+}
+
+} // namespace
+
+void Histogram::record(std::uint64_t value) {
+    if (counts_.empty()) {
+        counts_.assign(kBucketCount, 0);
+        min_ = value;
+        max_ = value;
+    }
+    ++counts_[bucket_index(value)];
+    ++count_;
+    min_ = std::min(min_, value);
+    max_ = std::max(max_, value);
+    sum_ += static_cast<double>(value);
+}
+
+void Histogram::merge(const Histogram& other) {
+    if (other.count_ == 0) {
+        return;
+    }
+    if (count_ == 0) {
+        *this = other;
+        return;
+    }
+    for (std::size_t i = 0; i < kBucketCount; ++i) {
+        counts_[i] += other.counts_[i];
+    }
+    count_ += other.count_;
+    min_ = std::min(min_, other.min_);
+    max_ = std::max(max_, other.max_);
+    sum_ += other.sum_;
+}
+
+std::uint64_t Histogram::percentile(double fraction) const {
+    if (count_ == 0) {
+        return 0;
+    }
+    const double wanted = std::clamp(fraction, 0.0, 1.0) * static_cast<double>(count_);
+    const std::uint64_t rank = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(wanted + 0.5));
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < kBucketCount; ++i) {
+        seen += counts_[i];
+        if (seen >= rank) {
+            return std::min(bucket_high(i), max_);
+        }
+    }
+    return max_;
+}
+
+std::vector<Histogram::Bucket> Histogram::buckets() const {
+    std::vector<Bucket> out;
+    for (std::size_t i = 0; i < counts_.size(); ++i) {
+        if (counts_[i] != 0) {
+            out.push_back(Bucket{bucket_low(i), bucket_high(i), counts_[i]});
+        }
+    }
+    return out;
+}
+
+void Timeline::add(double offset_seconds, std::uint64_t bytes) {
+    std::size_t index = static_cast<std::size_t>(std::max(0.0, offset_seconds) / interval_);
+    while (index >= kMaxIntervals) {
+        coarsen();
+        index /= 2;
+    }
+    if (index >= bytes_.size()) {
+        bytes_.resize(index + 1, 0);
+    }
+    bytes_[index] += bytes;
+}
+
+void Timeline::merge(const Timeline& other) {
+    Timeline source = other;
+    while (source.interval_ < interval_) {
+        source.coarsen();
+    }
+    while (interval_ < source.interval_) {
+        coarsen();
+    }
+    if (source.bytes_.size() > bytes_.size()) {
+        bytes_.resize(source.bytes_.size(), 0);
+    }
+    for (std::size_t i = 0; i < source.bytes_.size(); ++i) {
+        bytes_[i] += source.bytes_[i];
+    }
+}
+
+double Timeline::peak_rate() const {
+    const std::uint64_t peak = bytes_.empty() ? 0 : *std::max_element(bytes_.begin(), bytes_.end());
+    return static_cast<double>(peak) / interval_;
+}
+
+double Timeline::mean_rate() const {
+    if (bytes_.empty()) {
+        return 0.0;
+    }
+    std::uint64_t total = 0;
+    for (const std::uint64_t bytes : bytes_) {
+        total += bytes;
+    }
+    return static_cast<double>(total) / (interval_ * static_cast<double>(bytes_.size()));
+}
+
+void Timeline::coarsen() {
+    for (std::size_t i = 0; i < bytes_.size(); ++i) {
+        if (i % 2 == 0) {
+            bytes_[i / 2] = bytes_[i];
+        } else {
+            bytes_[i / 2] += bytes_[i];
+        }
+    }
+    bytes_.resize((bytes_.size() + 1) / 2);
+    interval_ *= 2.0;
+}
+
+void ScanDistribution::record(const std::string& path, std::uint64_t size, double seconds, double finished_at) {
+    hash_micros.record(static_cast<std::uint64_t>(seconds * 1e6));
+    file_bytes.record(size);
+    throughput.add(finished_at, size);
+    if (slowest.size() == kSlowestFiles && seconds <= slowest.back().seconds) {
+        return;
+    }
+    const auto slower = [](const SlowFile& a, const SlowFile& b) { return a.seconds > b.seconds; };
+    SlowFile file{path, size, seconds};
+    slowest.insert(std::upper_bound(slowest.begin(), slowest.end(), file, slower), std::move(file));
+    if (slowest.size() > kSlowestFiles) {
+        slowest.pop_back();
+    }
+}
+
+void ScanDistribution::merge(const ScanDistribution& other) {
+    hash_micros.merge(other.hash_micros);
+    file_bytes.merge(other.file_bytes);
+    throughput.merge(other.throughput);
+    const auto slower = [](const SlowFile& a, const SlowFile& b) { return a.seconds > b.seconds; };
+    std::vector<SlowFile> combined;
+    combined.reserve(slowest.size() + other.slowest.size());
+    std::merge(slowest.begin(), slowest.end(), other.slowest.begin(), other.slowest.end(),
+               std::back_inserter(combined), slower);
+    if (combined.size() > kSlowestFiles) {
+        combined.resize(kSlowestFiles);
+    }
+    slowest = std::move(combined);
+}
+
+} // namespace core
@@ -0,0 +1,89 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace core {
+
+// Log-linear (HDR-style) histogram of unsigned values. Values below 32 are
+// exact; above that each power of two is split into 16 buckets, so any value
+// is known to within 1/16 of itself over the whole 64-bit range. Buckets are
+// allocated on the first record, so an empty histogram costs nothing.
+class Histogram {
+public:
+    struct Bucket {
+        std::uint64_t low;
+        std::uint64_t high;
+        std::uint64_t count;
+    };
+
+    void record(std::uint64_t value);
+    void merge(const Histogram& other);
+
+    std::uint64_t count() const { return count_; }
+    std::uint64_t min() const { return min_; }
+    std::uint64_t max() const { return max_; }
+    double sum() const { return sum_; }
+    double mean() const { return count_ == 0 ? 0.0 : sum_ / static_cast<double>(count_); }
+    // Upper bound of the bucket holding the value at `fraction` (0.5 = median),
+    // capped to max(); 0 when empty.
+    std::uint64_t percentile(double fraction) const;
+    // Non-empty buckets in ascending order.
+    std::vector<Bucket> buckets() const;
+
+private:
+    std::vector<std::uint64_t> counts_;
+    std::uint64_t count_ = 0;
+    std::uint64_t min_ = 0;
+    std::uint64_t max_ = 0;
+    double sum_ = 0.0;
+};
+
+// Bytes completed per fixed interval since a common origin. The interval
+// starts at 100 ms and doubles (merging neighbours) whenever the series would
+// exceed kMaxIntervals, so a long scan keeps a bounded, evenly spaced series.
+class Timeline {
+public:
+    static constexpr std::size_t kMaxIntervals = 120;
+
+    void add(double offset_seconds, std::uint64_t bytes);
+    void merge(const Timeline& other);
+
+    double interval() const { return interval_; }
+    const std::vector<std::uint64_t>& bytes() const { return bytes_; }
+    // Highest and average bytes/sec over the recorded intervals.
+    double peak_rate() const;
+    double mean_rate() const;
+
+private:
+    void coarsen();
+
+    double interval_ = 0.1;
+    std::vector<std::uint64_t> bytes_;
+};
+
+struct SlowFile {
+    std::string path;
+    std::uint64_t size = 0;
+    double seconds = 0.0;
+};
+
+// Per-file view of the hash phase: latency and size histograms, throughput
+// over time and the slowest files. Hashing threads each fill their own and
+// merge once at the end, so recording takes no lock.
+struct ScanDistribution {
+    static constexpr std::size_t kSlowestFiles = 10;
+
+    Histogram hash_micros;
+    Histogram file_bytes;
+    Timeline throughput;
+    std::vector<SlowFile> slowest;  // Slowest first, at most kSlowestFiles.
+
+    bool empty() const { return hash_micros.count() == 0; }
+    // `finished_at` is seconds since the start of hashing.
+    void record(const std::string& path, std::uint64_t size, double seconds, double finished_at);
+    void merge(const ScanDistribution& other);
+};
+
+} // namespace core
@@ -7,6 +7,9 @@
 #include <iomanip>
 #include <sstream>
 #include <system_error>
+#ifndef _WIN32
+#include <sys/stat.h>
+#endif
 
 namespace fs = std::filesystem;
 
@@ -20,6 +23,7 @@ void ensure_dirs() {
     fs::create_directories(config::REPORT_HTML_DIR, ec);
     fs::create_directories(config::REPORT_JSON_DIR, ec);
     fs::create_directories(config::REPORT_CSV_DIR, ec);
+    fs::create_directories(config::REPORT_COLUMNAR_DIR, ec);
 }
 
 std::string timestamp() {
@@ -75,4 +79,77 @@ std::string sanitize_token(const std::string& value, const std::string& fallback
     return out;
 }
 
+bool parse_time(const std::string& text, std::time_t& out) {
+    if (text.empty()) {
+        return false;
+    }
+
+    if (std::all_of(text.begin(), text.end(), [](unsigned char c) { return std::isdigit(c) != 0; })) {
+        try {
+            out = static_cast<std::time_t>(std::stoll(text));
+        } catch (...) {
+            return false;
+        }
+        return true;
+    }
+
+    std::string normalized = text;
+    std::replace(normalized.begin(), normalized.end(), 'T', ' ');
+
+    static const char* const formats[] = {
+        "%Y-%m-%d %H:%M:%S",
+        "%Y-%m-%d %H:%M",
+        "%Y-%m-%d"
+    };
+    for (const char* format : formats) {
+        std::tm tm{};
+        std::istringstream in(normalized);
+        in >> std::get_time(&tm, format);
+        if (in.fail()) {
+            continue;
+        }
+        in >> std::ws;
+        if (!in.eof()) {
+            continue;
+        }
+        tm.tm_isdst = -1;
+        const std::time_t value = std::mktime(&tm);
+        if (value == static_cast<std::time_t>(-1)) {
+            return false;
+        }
+        out = value;
+        return true;
+    }
+    return false;
+}
+
+std::string format_time(std::time_t value) {
+    if (value <= 0) {
+        return "-";
+    }
+    std::tm tm{};
+#ifdef _WIN32
+    localtime_s(&tm, &value);
+#else
+    localtime_r(&value, &tm);
+#endif
+    std::ostringstream out;
+    out << std::put_time(&tm, "%Y-%m-%d %H:%M:%S");
+    return out.str();
+}
+
+void set_error(std::string* error, const std::string& message) {
+    if (error != nullptr) {
+        *error = message;
+    }
+}
+
+void tighten_file_permissions(const std::string& path) {
+#ifndef _WIN32
+    ::chmod(path.c_str(), S_IRUSR | S_IWUSR);
+#else
+    (void)path;
+#endif
+}
+
 } // namespace fsutil
\ No newline at end of file
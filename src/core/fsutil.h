@@ -1,4 +1,5 @@
 #pragma once
+#include <ctime>
 #include <string>
 
 namespace fsutil {
@@ -6,4 +7,11 @@ namespace fsutil {
     std::string timestamp();
     std::string sanitize_token(const std::string& value,
                                const std::string& fallback = "scan");
+    // Accepts epoch seconds or local "YYYY-MM-DD[ HH:MM[:SS]]" (a 'T' separator is fine too).
+    bool parse_time(const std::string& text, std::time_t& out);
+    std::string format_time(std::time_t value);
+    // Stores `message` in `*error` when the caller asked for one.
+    void set_error(std::string* error, const std::string& message);
+    // Owner read/write only; a no-op on Windows.
+    void tighten_file_permissions(const std::string& path);
 }
\ No newline at end of file
@@ -0,0 +1,319 @@
+#include "log_segments.h"
+#include "codec.h"
+#include "config.h"
+#include "fsutil.h"
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string_view>
+#include <system_error>
+
+namespace fs = std::filesystem;
+
+namespace core {
+
+namespace {
+
+const char kIndexHeader[] = "# sentinel-c log segments v1\n";
+// Compressed segment: magic, then blocks of {u32 raw size, u32 stored size,
+// u32 crc32 of the raw bytes, payload}. A block whose stored size equals its
+// raw size is kept uncompressed.
+const char kSegmentMagic[] = "SNTLLOG1";
+constexpr std::size_t kMagicSize = 8;
+constexpr std::size_t kBlockSize = std::size_t{1} << 20;
+constexpr std::size_t kBlockHeader = 12;
+
+bool parse_number(std::string_view text, std::uint64_t& value) {
+    if (text.empty()) {
+        return false;
+    }
+    value = 0;
+    for (const char ch : text) {
+        if (ch < '0' || ch > '9') {
+            return false;
+        }
+        value = value * 10 + static_cast<std::uint64_t>(ch - '0');
+    }
+    return true;
+}
+
+std::string index_line(const LogSegment& segment) {
+    std::string line = std::to_string(static_cast<long long>(segment.first));
+    line += '\t';
+    line += std::to_string(static_cast<long long>(segment.last));
+    line += '\t';
+    line += std::to_string(segment.raw_bytes);
+    line += '\t';
+    line += segment.source;
+    line += '\t';
+    line += fs::path(segment.path).filename().generic_string();
+    line += '\n';
+    return line;
+}
+
+bool write_file(const std::string& path, const std::string& text, const char* mode, std::string* error) {
+    std::FILE* file = std::fopen(path.c_str(), mode);
+    if (file == nullptr) {
+        fsutil::set_error(error, "failed to open " + path);
+        return false;
+    }
+    const bool ok = std::fwrite(text.data(), 1, text.size(), file) == text.size();
+    const bool closed = std::fclose(file) == 0;
+    if (!ok || !closed) {
+        fsutil::set_error(error, "failed to write " + path);
+        return false;
+    }
+    return true;
+}
+
+bool append_index(const LogSegment& segment, std::string* error) {
+    std::error_code ec;
+    const bool fresh = !fs::exists(config::LOG_SEGMENT_INDEX, ec);
+    const std::string line = index_line(segment);
+    return write_file(config::LOG_SEGMENT_INDEX, fresh ? kIndexHeader + line : line, "ab", error);
+}
+
+bool install(const std::string& temp, const std::string& path, std::string* error) {
+    std::error_code ec;
+    fs::rename(temp, path, ec);
+    if (ec) {
+        ec.clear();
+        fs::remove(path, ec);
+        ec.clear();
+        fs::rename(temp, path, ec);
+        if (ec) {
+            fs::remove(temp, ec);
+            fsutil::set_error(error, "failed to install " + path);
+            return false;
+        }
+    }
+    return true;
+}
+
+// Streams `source` into `target` one block at a time, so memory stays at a
+// block however large the segment grew.
+bool compress_file(const std::string& source, const std::string& target, std::string* error) {
+    std::ifstream in(source, std::ios::binary);
+    if (!in.is_open()) {
+        fsutil::set_error(error, "failed to open " + source);
+        return false;
+    }
+    const std::string temp = target + ".tmp";
+    std::FILE* out = std::fopen(temp.c_str(), "wb");
+    if (out == nullptr) {
+        fsutil::set_error(error, "failed to open " + temp);
+        return false;
+    }
+
+    bool ok = std::fwrite(kSegmentMagic, 1, kMagicSize, out) == kMagicSize;
+    std::string raw(kBlockSize, '\0');
+    std::string header;
+    while (ok && in) {
+        in.read(raw.data(), static_cast<std::streamsize>(raw.size()));
+        const std::size_t size = static_cast<std::size_t>(in.gcount());
+        if (size == 0) {
+            break;
+        }
+        std::string stored = codec::compress(raw.data(), size);
+        const bool packed = stored.size() < size;
+        const char* payload = packed ? stored.data() : raw.data();
+        const std::size_t payload_size = packed ? stored.size() : size;
+        header.clear();
+        codec::put_u32(header, static_cast<std::uint32_t>(size));
+        codec::put_u32(header, static_cast<std::uint32_t>(payload_size));
+        codec::put_u32(header, codec::crc32(raw.data(), size));
+        ok = std::fwrite(header.data(), 1, header.size(), out) == header.size() &&
+             std::fwrite(payload, 1, payload_size, out) == payload_size;
+    }
+    ok = ok && !in.bad();
+    ok = std::fclose(out) == 0 && ok;
+    if (!ok) {
+        std::error_code ec;
+        fs::remove(temp, ec);
+        fsutil::set_error(error, "failed to compress log segment " + target);
+        return false;
+    }
+    return install(temp, target, error);
+}
+
+bool decompress_text(const std::string& data, std::string& text, std::string* error) {
+    if (data.size() < kMagicSize || data.compare(0, kMagicSize, kSegmentMagic) != 0) {
+        fsutil::set_error(error, "not a compressed log segment");
+        return false;
+    }
+    text.clear();
+    std::string block;
+    std::size_t offset = kMagicSize;
+    while (offset < data.size()) {
+        if (data.size() - offset < kBlockHeader) {
+            fsutil::set_error(error, "truncated log segment block header");
+            return false;
+        }
+        const std::uint32_t raw_size = codec::get_u32(data.data() + offset);
+        const std::uint32_t stored_size = codec::get_u32(data.data() + offset + 4);
+        const std::uint32_t crc = codec::get_u32(data.data() + offset + 8);
+        offset += kBlockHeader;
+        if (data.size() - offset < stored_size || raw_size > kBlockSize) {
+            fsutil::set_error(error, "truncated log segment block");
+            return false;
+        }
+        const std::size_t start = text.size();
+        if (stored_size == raw_size) {
+            text.append(data, offset, stored_size);
+        } else {
+            if (!codec::decompress(data.data() + offset, stored_size, raw_size, block)) {
+                fsutil::set_error(error, "corrupt log segment block");
+                return false;
+            }
+            text += block;
+        }
+        if (codec::crc32(text.data() + start, raw_size) != crc) {
+            fsutil::set_error(error, "log segment checksum mismatch");
+            return false;
+        }
+        offset += stored_size;
+    }
+    return true;
+}
+
+bool rewrite_index(const std::vector<LogSegment>& segments, std::string* error) {
+    std::string text = kIndexHeader;
+    for (const LogSegment& segment : segments) {
+        text += index_line(segment);
+    }
+    const std::string temp = config::LOG_SEGMENT_INDEX + ".tmp";
+    return write_file(temp, text, "wb", error) && install(temp, config::LOG_SEGMENT_INDEX, error);
+}
+
+bool prune(std::size_t keep, std::string* error) {
+    std::vector<LogSegment> segments;
+    if (!load_log_segments(segments, error) || segments.size() <= keep) {
+        return true;
+    }
+    const std::size_t excess = segments.size() - keep;
+    for (std::size_t i = 0; i < excess; ++i) {
+        std::error_code ec;
+        fs::remove(segments[i].path, ec);
+    }
+    segments.erase(segments.begin(), segments.begin() + static_cast<std::ptrdiff_t>(excess));
+    return rewrite_index(segments, error);
+}
+
+} // namespace
+
+bool seal_log_segment(const std::string& active_path,
+                      unsigned sequence,
+                      bool compress,
+                      std::size_t keep,
+                      LogSegment& segment,
+                      std::string* error) {
+    std::error_code ec;
+    fs::create_directories(config::LOG_ARCHIVE_DIR, ec);
+    if (ec) {
+        fsutil::set_error(error, "failed to create log archive: " + ec.message());
+        return false;
+    }
+
+    const fs::path active(active_path);
+    char number[16];
+    std::snprintf(number, sizeof(number), ".%04u", sequence);
+    std::string name = active.stem().generic_string() + number + active.extension().generic_string();
+    if (compress) {
+        name += ".lz";
+    }
+    segment.source = active.filename().generic_string();
+    segment.path = config::normalize_path_string(fs::path(config::LOG_ARCHIVE_DIR) / name);
+
+    if (compress) {
+        if (!compress_file(active_path, segment.path, error)) {
+            return false;
+        }
+        fs::remove(active_path, ec);
+    } else {
+        fs::rename(active_path, segment.path, ec);
+        if (ec) {
+            fsutil::set_error(error, "failed to move log segment: " + ec.message());
+            return false;
+        }
+    }
+
+    if (!append_index(segment, error)) {
+        return false;
+    }
+    return keep == 0 || prune(keep, error);
+}
+
+bool load_log_segments(std::vector<LogSegment>& segments, std::string* error) {
+    segments.clear();
+    std::ifstream in(config::LOG_SEGMENT_INDEX, std::ios::binary);
+    if (!in.is_open()) {
+        std::error_code ec;
+        if (fs::exists(config::LOG_SEGMENT_INDEX, ec)) {
+            fsutil::set_error(error, "failed to open log segment index: " + config::LOG_SEGMENT_INDEX);
+            return false;
+        }
+        return true;
+    }
+
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        // Exactly five fields; anything else is a torn append and is skipped.
+        std::string_view rest(line);
+        std::string_view fields[5];
+        std::size_t count = 0;
+        while (count < 5) {
+            const std::size_t tab = rest.find('\t');
+            fields[count++] = rest.substr(0, tab);
+            if (tab == std::string_view::npos) {
+                rest = std::string_view();
+                break;
+            }
+            rest.remove_prefix(tab + 1);
+        }
+        std::uint64_t first = 0;
+        std::uint64_t last = 0;
+        LogSegment segment;
+        if (count != 5 || !rest.empty() || fields[3].empty() || fields[4].empty() ||
+            !parse_number(fields[0], first) || !parse_number(fields[1], last) ||
+            !parse_number(fields[2], segment.raw_bytes)) {
+            continue;
+        }
+        segment.first = static_cast<std::time_t>(first);
+        segment.last = static_cast<std::time_t>(last);
+        segment.source = std::string(fields[3]);
+        segment.path = config::normalize_path_string(fs::path(config::LOG_ARCHIVE_DIR) / std::string(fields[4]));
+        segments.push_back(std::move(segment));
+    }
+    return true;
+}
+
+bool read_log_segment(const LogSegment& segment, std::string& text, std::string* error) {
+    std::ifstream in(segment.path, std::ios::binary);
+    if (!in.is_open()) {
+        fsutil::set_error(error, "log segment not found: " + segment.path);
+        return false;
+    }
+    std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    if (in.bad()) {
+        fsutil::set_error(error, "failed to read log segment: " + segment.path);
+        return false;
+    }
+    if (segment.path.size() < 3 || segment.path.compare(segment.path.size() - 3, 3, ".lz") != 0) {
+        text = std::move(data);
+        return true;
+    }
+    if (!decompress_text(data, text, error)) {
+        if (error != nullptr) {
+            *error += ": " + segment.path;
+        }
+        return false;
+    }
+    return true;
+}
+
+} // namespace core
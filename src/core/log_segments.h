@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <vector>
+
+namespace core {
+
+// Sealed pieces of rotated activity logs live in logs/archive/, listed in
+// logs/archive/segments.idx with the time range they cover so readers can pick
+// a segment without opening any. One tab-separated line per segment, appended
+// when it is sealed: first, last, raw bytes, source log name, segment name.
+struct LogSegment {
+    std::string path;    // Archived file (".log", or ".log.lz" when compressed).
+    std::string source;  // File name of the activity log it was cut from.
+    std::time_t first = 0;
+    std::time_t last = 0;
+    std::uint64_t raw_bytes = 0;
+};
+
+// Moves `active_path` into the archive as segment `sequence` of its log,
+// compressing it when asked, and records it in the index. `segment` carries
+// the time range and size in; its path and source are filled in. With
+// `keep` > 0 the oldest segments beyond that count are deleted.
+bool seal_log_segment(const std::string& active_path,
+                      unsigned sequence,
+                      bool compress,
+                      std::size_t keep,
+                      LogSegment& segment,
+                      std::string* error = nullptr);
+
+// Segments in seal order; a missing index is an empty archive.
+bool load_log_segments(std::vector<LogSegment>& segments, std::string* error = nullptr);
+
+// Whole text of a segment, decompressed and checksum-verified when needed.
+bool read_log_segment(const LogSegment& segment, std::string& text, std::string* error = nullptr);
+
+} // namespace core
@@ -1,17 +1,66 @@
 #include "logger.h"
 #include "colors.h"
 #include "config.h"
+#include "log_segments.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
 #include <ctime>
 #include <fstream>
-#include <iomanip>
 #include <iostream>
 #include <mutex>
-#include <sstream>
+#include <streambuf>
+#include <thread>
+#include <utility>
 
 namespace {
 
+// Records are formatted on the writer thread: callers only capture the
+// level, the wall-clock second and the message, then push into a bounded
+// multi-producer ring (per-slot sequence numbers, no lock on the fast path).
+struct Record {
+    logger::Level level = logger::Level::INFO;
+    std::time_t time = 0;
+    std::string message;
+};
+
+constexpr std::size_t kRingSize = 8192;  // Power of two.
+constexpr std::size_t kBatchLimit = 1024;
+
+struct Slot {
+    std::atomic<std::size_t> sequence{0};
+    Record record;
+};
+
+Slot ring[kRingSize];
+std::atomic<std::size_t> enqueue_pos{0};
+std::atomic<std::size_t> written_pos{0};  // Records fully written so far.
+std::size_t dequeue_pos = 0;              // Writer thread only.
+
+std::atomic<bool> running{false};
+std::atomic<bool> stopping{false};
+std::atomic<bool> writer_idle{false};
+std::thread writer;
+std::mutex wake_mutex;
+std::condition_variable wake_cv;
+std::mutex done_mutex;
+std::condition_variable done_cv;
+
+// Guards log_stream and the segment state below against reopen(), rotation
+// and the synchronous fallback.
+std::mutex file_mutex;
 std::ofstream log_stream;
-std::mutex log_mutex;
+std::string log_path;
+core::LogRotation rotation;
+bool rotation_failed = false;
+unsigned segment_sequence = 0;
+std::uint64_t segment_bytes = 0;
+std::time_t segment_first = 0;
+std::time_t segment_last = 0;
+
+std::streambuf* terminal = nullptr;
 
 std::tm local_time(std::time_t t) {
     std::tm tm{};
@@ -23,14 +72,6 @@ std::tm local_time(std::time_t t) {
     return tm;
 }
 
-std::string timestamp() {
-    const std::time_t t = std::time(nullptr);
-    const std::tm tm = local_time(t);
-    std::ostringstream out;
-    out << std::put_time(&tm, "%Y-%m-%d %H:%M:%S");
-    return out.str();
-}
-
 const char* level_label(logger::Level level) {
     switch (level) {
         case logger::Level::SUCCESS: return "SUCCESS";
@@ -49,41 +90,320 @@ colors::Tone level_tone(logger::Level level) {
     }
 }
 
+// "[YYYY-MM-DD HH:MM:SS] ", rebuilt only when the second changes.
+class TimestampCache {
+public:
+    const std::string& get(std::time_t t) {
+        if (t != second_ || text_.empty()) {
+            const std::tm tm = local_time(t);
+            char buffer[32];
+            const std::size_t size = std::strftime(buffer, sizeof(buffer), "[%Y-%m-%d %H:%M:%S] ", &tm);
+            text_.assign(buffer, size);
+            second_ = t;
+        }
+        return text_;
+    }
+
+private:
+    std::time_t second_ = 0;
+    std::string text_;
+};
+
+void format_record(const Record& record, TimestampCache& stamps, std::string& screen, std::string& file) {
+    const std::string& stamp = stamps.get(record.time);
+    const char* label = level_label(record.level);
+    const std::size_t start = file.size();
+    file += stamp;
+    file += '[';
+    file += label;
+    file += "] ";
+    file += record.message;
+    file += '\n';
+
+    const bool painted = colors::enabled();
+    if (painted) {
+        screen += colors::code(level_tone(record.level));
+    }
+    screen.append(file, start, file.size() - start - 1);
+    if (painted) {
+        screen += colors::code(colors::Tone::Reset);
+    }
+    screen += '\n';
+}
+
+// Caller holds file_mutex.
+void open_log(std::ios::openmode mode) {
+    if (log_stream.is_open()) {
+        log_stream.close();
+    }
+    log_path = config::LOG_FILE;
+    log_stream.open(log_path, mode);
+    const std::streamoff size = log_stream.is_open() ? static_cast<std::streamoff>(log_stream.tellp()) : 0;
+    segment_bytes = size > 0 ? static_cast<std::uint64_t>(size) : 0;
+    // Records already in a reopened file count as written now.
+    segment_first = segment_last = segment_bytes > 0 ? std::time(nullptr) : 0;
+}
+
+// Caller holds file_mutex.
+bool rotation_due(std::size_t incoming, std::time_t first) {
+    if (rotation_failed || segment_bytes == 0) {
+        return false;
+    }
+    return (rotation.max_bytes > 0 && segment_bytes + incoming > rotation.max_bytes) ||
+           (rotation.max_age_seconds > 0 &&
+            first - segment_first >= static_cast<std::time_t>(rotation.max_age_seconds));
+}
+
+// Caller holds file_mutex. On failure the current file stays open for append
+// and rotation is switched off for the rest of the run.
+void rotate() {
+    log_stream.close();
+    core::LogSegment segment;
+    segment.first = segment_first;
+    segment.last = segment_last;
+    segment.raw_bytes = segment_bytes;
+    std::string error;
+    if (!core::seal_log_segment(log_path, ++segment_sequence, rotation.compress, rotation.keep_segments,
+                                segment, &error)) {
+        rotation_failed = true;
+        std::cerr << "[WARN] Log rotation disabled: " << error << "\n";
+        open_log(std::ios::app);
+        return;
+    }
+    open_log(std::ios::trunc);
+}
+
+void emit(const std::string& screen, const std::string& file, std::time_t first, std::time_t last) {
+    if (!screen.empty()) {
+        std::streambuf* target = terminal != nullptr ? terminal : std::cout.rdbuf();
+        target->sputn(screen.data(), static_cast<std::streamsize>(screen.size()));
+    }
+    std::lock_guard<std::mutex> guard(file_mutex);
+    if (!file.empty() && log_stream.is_open()) {
+        if (rotation_due(file.size(), first)) {
+            rotate();
+        }
+        log_stream.write(file.data(), static_cast<std::streamsize>(file.size()));
+        log_stream.flush();
+        if (segment_bytes == 0) {
+            segment_first = first;
+        }
+        segment_last = last;
+        segment_bytes += file.size();
+    }
+}
+
+bool try_push(Record& record) {
+    std::size_t pos = enqueue_pos.load(std::memory_order_relaxed);
+    while (true) {
+        Slot& slot = ring[pos & (kRingSize - 1)];
+        const std::size_t sequence = slot.sequence.load(std::memory_order_acquire);
+        const std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos);
+        if (diff == 0) {
+            if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                slot.record = std::move(record);
+                // seq_cst pairs with the writer's idle check in writer_loop().
+                slot.sequence.store(pos + 1);
+                return true;
+            }
+        } else if (diff < 0) {
+            return false;
+        } else {
+            pos = enqueue_pos.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+bool try_pop(Record& record) {
+    Slot& slot = ring[dequeue_pos & (kRingSize - 1)];
+    if (slot.sequence.load(std::memory_order_acquire) != dequeue_pos + 1) {
+        return false;
+    }
+    record = std::move(slot.record);
+    slot.sequence.store(dequeue_pos + kRingSize, std::memory_order_release);
+    ++dequeue_pos;
+    return true;
+}
+
+void wake_writer() {
+    if (writer_idle.load()) {
+        std::lock_guard<std::mutex> guard(wake_mutex);
+        wake_cv.notify_one();
+    }
+}
+
+void writer_loop() {
+    TimestampCache stamps;
+    std::string screen;
+    std::string file;
+    Record record;
+    while (true) {
+        screen.clear();
+        file.clear();
+        std::size_t batch = 0;
+        std::time_t first = 0;
+        while (batch < kBatchLimit && try_pop(record)) {
+            format_record(record, stamps, screen, file);
+            if (batch++ == 0) {
+                first = record.time;
+            }
+        }
+
+        if (batch > 0) {
+            emit(screen, file, first, record.time);
+            written_pos.store(dequeue_pos, std::memory_order_release);
+            std::lock_guard<std::mutex> guard(done_mutex);
+            done_cv.notify_all();
+            continue;
+        }
+
+        if (stopping.load() && dequeue_pos == enqueue_pos.load()) {
+            return;
+        }
+        std::unique_lock<std::mutex> guard(wake_mutex);
+        writer_idle.store(true);
+        // Re-check after announcing idleness so a concurrent push cannot be missed;
+        // the timeout only covers a producer that is mid-publish.
+        const Slot& next = ring[dequeue_pos & (kRingSize - 1)];
+        if (next.sequence.load() != dequeue_pos + 1 && !stopping.load()) {
+            wake_cv.wait_for(guard, std::chrono::milliseconds(50));
+        }
+        writer_idle.store(false);
+    }
+}
+
+bool pending() {
+    return running.load(std::memory_order_acquire) &&
+           written_pos.load(std::memory_order_acquire) != enqueue_pos.load(std::memory_order_acquire);
+}
+
+// Sits in front of std::cout's buffer and drains queued log records before any
+// direct console output, so log lines and reports/summaries keep their order.
+class OrderedConsoleBuf : public std::streambuf {
+public:
+    explicit OrderedConsoleBuf(std::streambuf* target) : target_(target) {}
+
+protected:
+    int_type overflow(int_type ch) override {
+        logger::flush();
+        if (traits_type::eq_int_type(ch, traits_type::eof())) {
+            return traits_type::not_eof(ch);
+        }
+        return target_->sputc(traits_type::to_char_type(ch));
+    }
+    std::streamsize xsputn(const char* data, std::streamsize size) override {
+        logger::flush();
+        return target_->sputn(data, size);
+    }
+    int sync() override {
+        logger::flush();
+        return target_->pubsync();
+    }
+
+private:
+    std::streambuf* target_;
+};
+
+void write_now(logger::Level level, const std::string& message) {
+    static std::mutex direct_mutex;
+    std::lock_guard<std::mutex> guard(direct_mutex);
+    TimestampCache stamps;
+    std::string screen;
+    std::string file;
+    const std::time_t now = std::time(nullptr);
+    format_record(Record{level, now, message}, stamps, screen, file);
+    emit(screen, file, now, now);
+}
+
+struct Shutdown {
+    ~Shutdown() { logger::shutdown(); }
+} shutdown_at_exit;
+
 } // namespace
 
 namespace logger {
 
 void init() {
-    std::lock_guard<std::mutex> guard(log_mutex);
     colors::initialize();
-    if (!log_stream.is_open()) {
-        log_stream.open(config::LOG_FILE, std::ios::app);
+    {
+        std::lock_guard<std::mutex> guard(file_mutex);
+        if (!log_stream.is_open()) {
+            open_log(std::ios::app);
+        }
+    }
+    if (running.load()) {
+        return;
     }
+    for (std::size_t i = 0; i < kRingSize; ++i) {
+        ring[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    enqueue_pos.store(0);
+    written_pos.store(0);
+    dequeue_pos = 0;
+    stopping.store(false);
+
+    static OrderedConsoleBuf* console = nullptr;
+    if (console == nullptr) {
+        terminal = std::cout.rdbuf();
+        console = new OrderedConsoleBuf(terminal);
+        std::cout.rdbuf(console);
+    }
+    writer = std::thread(writer_loop);
+    running.store(true, std::memory_order_release);
 }
 
 void reopen() {
-    std::lock_guard<std::mutex> guard(log_mutex);
+    flush();
     colors::initialize();
-    if (log_stream.is_open()) {
-        log_stream.close();
-    }
-    log_stream.open(config::LOG_FILE, std::ios::app);
+    std::lock_guard<std::mutex> guard(file_mutex);
+    open_log(std::ios::app);
+}
+
+void set_rotation(const core::LogRotation& settings) {
+    std::lock_guard<std::mutex> guard(file_mutex);
+    rotation = settings;
+    rotation_failed = false;
 }
 
 void write(Level level, const std::string& message) {
-    std::lock_guard<std::mutex> guard(log_mutex);
-    const std::string prefix =
-        "[" + timestamp() + "] [" + level_label(level) + "] ";
+    if (!running.load(std::memory_order_acquire)) {
+        write_now(level, message);
+        return;
+    }
+    Record record{level, std::time(nullptr), message};
+    while (!try_push(record)) {
+        // Ring full: the writer is behind, so wait for it rather than drop.
+        wake_writer();
+        std::this_thread::yield();
+    }
+    wake_writer();
+}
 
-    if (colors::enabled()) {
-        std::cout << colors::paint(prefix + message, level_tone(level)) << "\n";
-    } else {
-        std::cout << prefix << message << "\n";
+void flush() {
+    if (!pending()) {
+        return;
     }
+    const std::size_t target = enqueue_pos.load(std::memory_order_acquire);
+    wake_writer();
+    std::unique_lock<std::mutex> guard(done_mutex);
+    done_cv.wait(guard, [target]() { return written_pos.load(std::memory_order_acquire) >= target; });
+}
 
-    if (log_stream.is_open()) {
-        log_stream << prefix << message << "\n";
+void shutdown() {
+    if (!running.load()) {
+        return;
+    }
+    flush();
+    stopping.store(true);
+    {
+        std::lock_guard<std::mutex> guard(wake_mutex);
+        wake_cv.notify_one();
+    }
+    if (writer.joinable()) {
+        writer.join();
     }
+    running.store(false, std::memory_order_release);
+    std::cout.flush();
 }
 
 void info(const std::string& m)    { write(Level::INFO, m); }
@@ -91,4 +411,4 @@ void success(const std::string& m) { write(Level::SUCCESS, m); }
 void warning(const std::string& m) { write(Level::WARNING, m); }
 void error(const std::string& m)   { write(Level::ERROR, m); }
 
-} // namespace logger
\ No newline at end of file
+} // namespace logger
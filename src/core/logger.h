@@ -1,5 +1,6 @@
 #pragma once
 #include <string>
+#include "runtime_settings.h"
 
 namespace logger {
 
@@ -10,9 +11,19 @@ enum class Level {
     ERROR
 };
 
+// Records are queued and written by a background thread (terminal + log
+// file). Any std::cout output first waits for queued records, so console
+// ordering is unchanged; flush() makes the log file current.
 void init();
 void reopen();
+// Applies to the open log from the next write on; limits are checked on the
+// writer thread before each batch, so a segment can overshoot by one batch.
+void set_rotation(const core::LogRotation& rotation);
 void write(Level level, const std::string& message);
+// Blocks until every record queued so far has been written.
+void flush();
+// Flushes and stops the writer thread; later records are written inline.
+void shutdown();
 void info(const std::string& message);
 void success(const std::string& message);
 void warning(const std::string& message);
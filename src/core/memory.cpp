@@ -0,0 +1,178 @@
+#include "memory.h"
+#include <cstdlib>
+#include <new>
+#ifdef _WIN32
+#include <malloc.h>
+#include <windows.h>
+#include <psapi.h>
+#elif defined(__APPLE__)
+#include <malloc/malloc.h>
+#include <sys/resource.h>
+#else
+#include <malloc.h>
+#include <sys/resource.h>
+#endif
+
+namespace memory {
+
+namespace {
+
+struct Counters {
+    std::atomic<std::uint64_t> allocations{0};
+    std::atomic<std::uint64_t> allocated{0};
+    std::atomic<std::uint64_t> freed{0};
+    std::atomic<std::int64_t> net{0};
+    std::atomic<std::int64_t> peak{0};
+};
+
+Counters counters[kAreaCount];
+std::atomic<std::int64_t> live{0};
+std::atomic<std::int64_t> peak_live{0};
+thread_local Area current = Area::Other;
+
+std::size_t usable_size(void* block) {
+#ifdef _WIN32
+    return _msize(block);
+#elif defined(__APPLE__)
+    return malloc_size(block);
+#else
+    return malloc_usable_size(block);
+#endif
+}
+
+void raise(std::atomic<std::int64_t>& peak, std::int64_t value) {
+    std::int64_t seen = peak.load(std::memory_order_relaxed);
+    while (value > seen && !peak.compare_exchange_weak(seen, value, std::memory_order_relaxed)) {
+    }
+}
+
+void note_allocation(void* block) {
+    const auto bytes = static_cast<std::int64_t>(usable_size(block));
+    Counters& area = counters[static_cast<std::size_t>(current)];
+    area.allocations.fetch_add(1, std::memory_order_relaxed);
+    area.allocated.fetch_add(static_cast<std::uint64_t>(bytes), std::memory_order_relaxed);
+    raise(area.peak, area.net.fetch_add(bytes, std::memory_order_relaxed) + bytes);
+    raise(peak_live, live.fetch_add(bytes, std::memory_order_relaxed) + bytes);
+}
+
+void note_free(void* block) {
+    const auto bytes = static_cast<std::int64_t>(usable_size(block));
+    Counters& area = counters[static_cast<std::size_t>(current)];
+    area.freed.fetch_add(static_cast<std::uint64_t>(bytes), std::memory_order_relaxed);
+    area.net.fetch_sub(bytes, std::memory_order_relaxed);
+    live.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+void* allocate(std::size_t size, bool nothrow) {
+    while (true) {
+        void* block = std::malloc(size == 0 ? 1 : size);
+        if (block != nullptr) {
+            if (enabled()) {
+                note_allocation(block);
+            }
+            return block;
+        }
+        const std::new_handler handler = std::get_new_handler();
+        if (handler == nullptr) {
+            if (nothrow) {
+                return nullptr;
+            }
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+
+void release(void* block) {
+    if (block == nullptr) {
+        return;
+    }
+    if (enabled()) {
+        note_free(block);
+    }
+    std::free(block);
+}
+
+} // namespace
+
+void enable(bool on) {
+    detail::active.store(on, std::memory_order_relaxed);
+}
+
+const char* area_name(Area area) {
+    switch (area) {
+        case Area::Other: return "other";
+        case Area::Walker: return "walker";
+        case Area::Snapshot: return "snapshot";
+        case Area::Baseline: return "baseline";
+        case Area::Compare: return "compare";
+        case Area::Reports: return "reports";
+    }
+    return "unknown";
+}
+
+Usage capture() {
+    Usage usage;
+    for (std::size_t i = 0; i < kAreaCount; ++i) {
+        const Counters& area = counters[i];
+        AreaUsage& out = usage.areas[i];
+        out.allocations = area.allocations.load(std::memory_order_relaxed);
+        out.allocated = area.allocated.load(std::memory_order_relaxed);
+        out.freed = area.freed.load(std::memory_order_relaxed);
+        out.net = area.net.load(std::memory_order_relaxed);
+        out.peak = area.peak.load(std::memory_order_relaxed);
+    }
+    usage.live = live.load(std::memory_order_relaxed);
+    usage.peak_live = peak_live.load(std::memory_order_relaxed);
+    usage.peak_rss = peak_rss_bytes();
+    return usage;
+}
+
+std::uint64_t peak_rss_bytes() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS process{};
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &process, sizeof(process))) {
+        return static_cast<std::uint64_t>(process.PeakWorkingSetSize);
+    }
+    return 0;
+#else
+    struct rusage usage {};
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+#ifdef __APPLE__
+    return static_cast<std::uint64_t>(usage.ru_maxrss);
+#else
+    return static_cast<std::uint64_t>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+}
+
+Scope::Scope(Area area) : outer_(current) {
+    current = area;
+}
+
+Scope::~Scope() {
+    current = outer_;
+}
+
+} // namespace memory
+
+// Replaceable global allocation functions. Aligned (std::align_val_t) forms
+// keep the library defaults and are not counted.
+void* operator new(std::size_t size) { return memory::allocate(size, false); }
+void* operator new[](std::size_t size) { return memory::allocate(size, false); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return memory::allocate(size, true);
+    } catch (...) {
+        return nullptr;
+    }
+}
+void* operator new[](std::size_t size, const std::nothrow_t& tag) noexcept { return operator new(size, tag); }
+void operator delete(void* block) noexcept { memory::release(block); }
+void operator delete[](void* block) noexcept { memory::release(block); }
+void operator delete(void* block, std::size_t) noexcept { memory::release(block); }
+void operator delete[](void* block, std::size_t) noexcept { memory::release(block); }
+void operator delete(void* block, const std::nothrow_t&) noexcept { memory::release(block); }
+void operator delete[](void* block, const std::nothrow_t&) noexcept { memory::release(block); }
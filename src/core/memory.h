@@ -0,0 +1,66 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace memory {
+
+// Subsystems that heap allocations are charged to. Untagged work is Other.
+enum class Area : std::size_t {
+    Other,
+    Walker,    // collect_pending: the pending file list and its paths
+    Snapshot,  // hashing and the snapshot FileMap
+    Baseline,  // baseline load/save and its FileMap
+    Compare,   // change classification and the ScanResult maps
+    Reports    // report model, sorts and writers
+};
+constexpr std::size_t kAreaCount = 6;
+
+namespace detail {
+inline std::atomic<bool> active{false};
+}
+
+// Counting replacements of the global operator new/delete (memory.cpp) feed
+// these totals while enabled. Sizes are the allocator's usable size, so no
+// header is added to any block; when disabled, each allocation costs one
+// relaxed load. A free is charged to the area current on the freeing thread,
+// so per-area figures are net bytes allocated while that area was current:
+// a structure built in one area and freed after the run still shows up there.
+void enable(bool on);
+inline bool enabled() { return detail::active.load(std::memory_order_relaxed); }
+const char* area_name(Area area);
+
+struct AreaUsage {
+    std::uint64_t allocations = 0;
+    std::uint64_t allocated = 0;  // Bytes
+    std::uint64_t freed = 0;
+    std::int64_t net = 0;         // allocated - freed, now
+    std::int64_t peak = 0;        // Highest net seen
+};
+
+struct Usage {
+    std::array<AreaUsage, kAreaCount> areas{};
+    std::int64_t live = 0;        // Counted heap bytes in use now
+    std::int64_t peak_live = 0;   // ...and at the worst moment
+    std::uint64_t peak_rss = 0;   // Process peak resident set, 0 if unknown
+};
+
+Usage capture();
+
+// Peak resident set size of this process; 0 when the platform does not say.
+std::uint64_t peak_rss_bytes();
+
+// Charges the calling thread's allocations to `area` until destroyed.
+class Scope {
+public:
+    explicit Scope(Area area);
+    ~Scope();
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+private:
+    Area outer_;
+};
+
+} // namespace memory
@@ -0,0 +1,299 @@
+#include "metrics.h"
+#include "config.h"
+#include "fsutil.h"
+#include "memory.h"
+#include "profiler.h"
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <system_error>
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace metrics {
+
+namespace {
+
+std::string label_value(const std::string& text) {
+    std::string out;
+    out.reserve(text.size());
+    for (const char ch : text) {
+        switch (ch) {
+            case '\\': out += "\\\\"; break;
+            case '"': out += "\\\""; break;
+            case '\n': out += "\\n"; break;
+            default: out += ch; break;
+        }
+    }
+    return out;
+}
+
+// One metric family: HELP and TYPE lines, then its samples.
+class Writer {
+public:
+    Writer() { out_.precision(9); }
+
+    void family(const char* name, const char* type, const char* help) {
+        out_ << "# HELP " << name << ' ' << help << "\n# TYPE " << name << ' ' << type << '\n';
+    }
+    template <typename T>
+    void sample(const char* name, const std::string& labels, T value) {
+        out_ << name;
+        if (!labels.empty()) {
+            out_ << '{' << labels << '}';
+        }
+        out_ << ' ' << value << '\n';
+    }
+    template <typename T>
+    void single(const char* name, const char* type, const char* help, T value) {
+        family(name, type, help);
+        sample(name, "", value);
+    }
+    std::string str() const { return out_.str(); }
+
+private:
+    std::ostringstream out_;
+};
+
+#ifndef _WIN32
+#ifdef MSG_NOSIGNAL
+constexpr int kSendFlags = MSG_NOSIGNAL;
+#else
+constexpr int kSendFlags = 0;
+#endif
+
+void send_all(int socket, const std::string& data) {
+    std::size_t sent = 0;
+    while (sent < data.size()) {
+        const ssize_t n = ::send(socket, data.data() + sent, data.size() - sent, kSendFlags);
+        if (n <= 0) {
+            return;
+        }
+        sent += static_cast<std::size_t>(n);
+    }
+}
+
+std::string response(const char* status, const std::string& body) {
+    return std::string("HTTP/1.1 ") + status +
+           "\r\nContent-Type: text/plain; version=0.0.4; charset=utf-8\r\nContent-Length: " +
+           std::to_string(body.size()) + "\r\nConnection: close\r\n\r\n" + body;
+}
+#endif
+
+} // namespace
+
+std::string render(const Sample& sample) {
+    const core::ScanStats& stats = sample.stats;
+    const core::ScanDistribution& files = stats.distribution;
+    Writer out;
+
+    out.family("sentinel_info", "gauge", "Version, command and target of the exporting run.");
+    out.sample("sentinel_info",
+               "version=\"" + label_value(config::VERSION) + "\",command=\"" + label_value(sample.command) +
+                   "\",target=\"" + label_value(sample.target) + "\"",
+               1);
+    out.single("sentinel_files_scanned", "gauge", "Files hashed by the latest scan.", stats.scanned);
+    out.single("sentinel_bytes_hashed", "gauge", "Bytes of the files hashed by the latest scan.",
+               static_cast<std::uint64_t>(files.file_bytes.sum()));
+    out.family("sentinel_changes", "gauge", "Changes against the baseline found by the latest scan.");
+    out.sample("sentinel_changes", "type=\"added\"", stats.added);
+    out.sample("sentinel_changes", "type=\"modified\"", stats.modified);
+    out.sample("sentinel_changes", "type=\"deleted\"", stats.deleted);
+    out.single("sentinel_scan_duration_seconds", "gauge", "Wall time of the latest snapshot.", stats.duration);
+
+    if (stats.profile.enabled) {
+        out.family("sentinel_phase_seconds", "gauge",
+                   "Time per phase of the latest scan, excluding nested phases; hash and report sum all workers.");
+        for (std::size_t i = 0; i < core::kPhaseCount; ++i) {
+            const core::PhaseStats& phase = stats.profile.phases[i];
+            if (phase.calls != 0) {
+                out.sample("sentinel_phase_seconds",
+                           std::string("phase=\"") + profiler::phase_name(static_cast<core::Phase>(i)) + "\"",
+                           phase.seconds);
+            }
+        }
+    }
+    out.single("sentinel_baseline_load_seconds", "gauge", "Time spent loading the baseline.",
+               sample.baseline_load_seconds);
+    out.single("sentinel_seal_check_seconds", "gauge", "Time spent verifying the baseline seal.",
+               sample.seal_check_seconds);
+
+    out.family("sentinel_file_hash_seconds", "summary", "Per-file hash latency of the latest scan.");
+    const std::pair<const char*, double> quantiles[] = {{"0.5", 0.5}, {"0.9", 0.9}, {"0.99", 0.99}, {"0.999", 0.999}};
+    for (const auto& [label, fraction] : quantiles) {
+        out.sample("sentinel_file_hash_seconds", std::string("quantile=\"") + label + "\"",
+                   static_cast<double>(files.hash_micros.percentile(fraction)) / 1e6);
+    }
+    out.sample("sentinel_file_hash_seconds_sum", "", files.hash_micros.sum() / 1e6);
+    out.sample("sentinel_file_hash_seconds_count", "", files.hash_micros.count());
+
+    // Busy time is the sum of per-file hash latencies, so waiting for work or
+    // for the result lock counts as idle.
+    double utilization = 0.0;
+    if (stats.hash_workers != 0 && stats.hash_seconds > 0.0) {
+        utilization = files.hash_micros.sum() / 1e6 / (static_cast<double>(stats.hash_workers) * stats.hash_seconds);
+    }
+    out.single("sentinel_hash_workers", "gauge", "Threads that hashed files in the latest scan.", stats.hash_workers);
+    out.single("sentinel_worker_utilization_ratio", "gauge",
+               "Share of the hash phase the hashing threads spent hashing.", utilization);
+    if (const std::uint64_t rss = memory::peak_rss_bytes(); rss != 0) {
+        out.single("sentinel_peak_rss_bytes", "gauge", "Peak resident set size of the process.", rss);
+    }
+    out.single("sentinel_last_scan_timestamp_seconds", "gauge", "Unix time the latest scan finished.",
+               static_cast<std::int64_t>(sample.finished));
+    if (sample.command == "watch") {
+        out.single("sentinel_watch_cycles_total", "counter", "Watch cycles finished.", sample.cycles);
+        out.single("sentinel_watch_changed_cycles_total", "counter", "Watch cycles that found changes.",
+                   sample.changed_cycles);
+    }
+    return out.str();
+}
+
+bool write_textfile(const std::string& path, const std::string& text, std::string* error) {
+    const std::string temp_path = path + ".tmp";
+    {
+        std::ofstream out(temp_path, std::ios::binary | std::ios::trunc);
+        out << text;
+        out.flush();
+        if (!out) {
+            std::error_code ec;
+            fs::remove(temp_path, ec);
+            fsutil::set_error(error, "Failed to write metrics file: " + temp_path);
+            return false;
+        }
+    }
+    std::error_code ec;
+    fs::rename(temp_path, path, ec);
+    if (ec) {
+        ec.clear();
+        fs::remove(path, ec);
+        ec.clear();
+        fs::rename(temp_path, path, ec);
+        if (ec) {
+            fs::remove(temp_path, ec);
+            fsutil::set_error(error, "Failed to install metrics file: " + path);
+            return false;
+        }
+    }
+    return true;
+}
+
+Endpoint::~Endpoint() {
+    stopping_.store(true);
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+#ifndef _WIN32
+    if (listener_ >= 0) {
+        ::close(listener_);
+    }
+#endif
+}
+
+void Endpoint::publish(std::string text) {
+    std::lock_guard<std::mutex> guard(lock_);
+    text_ = std::move(text);
+}
+
+#ifdef _WIN32
+
+bool Endpoint::start(int, std::string* error) {
+    fsutil::set_error(error, "--metrics-port is not supported on Windows; use --metrics-file.");
+    return false;
+}
+
+void Endpoint::serve() {}
+void Endpoint::answer(int) {}
+
+#else
+
+bool Endpoint::start(int port, std::string* error) {
+    if (port <= 0 || port > 65535) {
+        fsutil::set_error(error, "Invalid metrics port: " + std::to_string(port));
+        return false;
+    }
+    listener_ = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (listener_ < 0) {
+        fsutil::set_error(error, "Failed to create metrics socket.");
+        return false;
+    }
+    const int reuse = 1;
+    ::setsockopt(listener_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(static_cast<std::uint16_t>(port));
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (::bind(listener_, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 ||
+        ::listen(listener_, 8) != 0) {
+        ::close(listener_);
+        listener_ = -1;
+        fsutil::set_error(error, "Failed to listen on 127.0.0.1:" + std::to_string(port) + " for metrics.");
+        return false;
+    }
+    thread_ = std::thread([this]() { serve(); });
+    return true;
+}
+
+// Polls so the destructor can stop the loop within one timeout.
+void Endpoint::serve() {
+    while (!stopping_.load()) {
+        pollfd waiting{listener_, POLLIN, 0};
+        if (::poll(&waiting, 1, 200) <= 0 || (waiting.revents & POLLIN) == 0) {
+            continue;
+        }
+        const int client = ::accept(listener_, nullptr, nullptr);
+        if (client >= 0) {
+            answer(client);
+            ::close(client);
+        }
+    }
+}
+
+void Endpoint::answer(int client) {
+    // Only the request line matters; give a slow client two seconds to send it.
+    std::string request;
+    char chunk[1024];
+    while (request.find("\r\n") == std::string::npos && request.size() < 8192) {
+        pollfd readable{client, POLLIN, 0};
+        if (::poll(&readable, 1, 2000) <= 0) {
+            return;
+        }
+        const ssize_t n = ::recv(client, chunk, sizeof(chunk), 0);
+        if (n <= 0) {
+            return;
+        }
+        request.append(chunk, static_cast<std::size_t>(n));
+    }
+
+    std::istringstream line(request.substr(0, request.find("\r\n")));
+    std::string method;
+    std::string target;
+    line >> method >> target;
+    if (method != "GET") {
+        send_all(client, response("405 Method Not Allowed", "Only GET is supported.\n"));
+        return;
+    }
+    if (target != "/metrics" && target != "/") {
+        send_all(client, response("404 Not Found", "Metrics are served at /metrics.\n"));
+        return;
+    }
+    std::string body;
+    {
+        std::lock_guard<std::mutex> guard(lock_);
+        body = text_;
+    }
+    send_all(client, response("200 OK", body));
+}
+
+#endif
+
+} // namespace metrics
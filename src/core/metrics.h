@@ -0,0 +1,57 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <ctime>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "types.h"
+
+namespace metrics {
+
+// Everything one exported scan (or watch cycle) reports.
+struct Sample {
+    std::string command;
+    std::string target;
+    core::ScanStats stats;  // Phase times need the profiler enabled.
+    double baseline_load_seconds = 0.0;
+    double seal_check_seconds = 0.0;
+    // Watch only: cycles finished so far and how many of them saw changes.
+    std::uint64_t cycles = 0;
+    std::uint64_t changed_cycles = 0;
+    std::time_t finished = 0;
+};
+
+// Prometheus text exposition format (version 0.0.4), readable by the
+// node_exporter textfile collector and by any OpenMetrics scraper.
+std::string render(const Sample& sample);
+
+// Replaces `path` through a temp file and a rename, so a collector never sees
+// a partial file.
+bool write_textfile(const std::string& path, const std::string& text, std::string* error = nullptr);
+
+// Serves the latest published text at http://127.0.0.1:<port>/metrics from a
+// background thread. Loopback only, one request per connection, POSIX only
+// (start() fails on Windows). The destructor stops the thread.
+class Endpoint {
+public:
+    Endpoint() = default;
+    ~Endpoint();
+    Endpoint(const Endpoint&) = delete;
+    Endpoint& operator=(const Endpoint&) = delete;
+
+    bool start(int port, std::string* error = nullptr);
+    void publish(std::string text);
+
+private:
+    void serve();
+    void answer(int client);
+
+    int listener_ = -1;
+    std::thread thread_;
+    std::atomic<bool> stopping_{false};
+    std::mutex lock_;
+    std::string text_;
+};
+
+} // namespace metrics
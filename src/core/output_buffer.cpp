@@ -0,0 +1,255 @@
+#include "output_buffer.h"
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstring>
+
+namespace {
+
+// 0 = copy as-is; otherwise the character following the backslash
+// ('u' means a \u00XX escape).
+constexpr std::array<char, 256> make_json_table() {
+    std::array<char, 256> table{};
+    for (int c = 0; c < 0x20; ++c) {
+        table[c] = 'u';
+    }
+    table['\b'] = 'b';
+    table['\f'] = 'f';
+    table['\n'] = 'n';
+    table['\r'] = 'r';
+    table['\t'] = 't';
+    table['"'] = '"';
+    table['\\'] = '\\';
+    return table;
+}
+
+constexpr std::array<char, 256> make_script_json_table() {
+    std::array<char, 256> table = make_json_table();
+    table['<'] = 'u';
+    table['>'] = 'u';
+    table['&'] = 'u';
+    return table;
+}
+
+// 0 = copy as-is; otherwise an index into kHtmlEntities.
+constexpr std::array<unsigned char, 256> make_html_table() {
+    std::array<unsigned char, 256> table{};
+    table['&'] = 1;
+    table['<'] = 2;
+    table['>'] = 3;
+    table['"'] = 4;
+    table['\''] = 5;
+    return table;
+}
+
+constexpr std::array<bool, 256> make_csv_table() {
+    std::array<bool, 256> table{};
+    table['"'] = true;
+    table[','] = true;
+    table['\n'] = true;
+    table['\r'] = true;
+    return table;
+}
+
+constexpr std::array<char, 256> kJsonEscape = make_json_table();
+constexpr std::array<char, 256> kScriptJsonEscape = make_script_json_table();
+constexpr std::array<unsigned char, 256> kHtmlEscape = make_html_table();
+constexpr std::array<bool, 256> kCsvSpecial = make_csv_table();
+constexpr std::string_view kHtmlEntities[] = {"", "&amp;", "&lt;", "&gt;", "&quot;", "&#39;"};
+constexpr char kHexDigits[] = "0123456789abcdef";
+
+inline unsigned char byte_at(std::string_view text, std::size_t index) {
+    return static_cast<unsigned char>(text[index]);
+}
+
+} // namespace
+
+namespace core {
+
+std::size_t decimal_digits(std::uint64_t value) {
+    std::size_t digits = 1;
+    while (value >= 10) {
+        value /= 10;
+        ++digits;
+    }
+    return digits;
+}
+
+OutputBuffer::OutputBuffer(std::size_t capacity)
+    : data_(new char[capacity < 4096 ? 4096 : capacity]),
+      capacity_(capacity < 4096 ? 4096 : capacity) {}
+
+OutputBuffer::~OutputBuffer() {
+    close();
+}
+
+bool OutputBuffer::open(const std::string& path) {
+    close();
+    size_ = 0;
+    written_ = 0;
+    failed_ = false;
+    file_ = std::fopen(path.c_str(), "wb");
+    if (file_ == nullptr) {
+        return false;
+    }
+    // Everything is staged in data_; stdio's own buffer would only add a copy.
+    std::setvbuf(file_, nullptr, _IONBF, 0);
+    return true;
+}
+
+bool OutputBuffer::flush() {
+    if (size_ == 0) {
+        return !failed_;
+    }
+    if (file_ == nullptr || std::fwrite(data_.get(), 1, size_, file_) != size_) {
+        failed_ = true;
+    }
+    written_ += size_;
+    size_ = 0;
+    return !failed_;
+}
+
+bool OutputBuffer::close() {
+    if (file_ == nullptr) {
+        return !failed_;
+    }
+    flush();
+    if (std::fclose(file_) != 0) {
+        failed_ = true;
+    }
+    file_ = nullptr;
+    return !failed_;
+}
+
+void OutputBuffer::write(const char* data, std::size_t size) {
+    if (size <= capacity_ - size_) {
+        std::memcpy(data_.get() + size_, data, size);
+        size_ += size;
+        return;
+    }
+    flush();
+    if (size >= capacity_) {
+        if (file_ == nullptr || std::fwrite(data, 1, size, file_) != size) {
+            failed_ = true;
+        }
+        written_ += size;
+        return;
+    }
+    std::memcpy(data_.get(), data, size);
+    size_ = size;
+}
+
+void OutputBuffer::fill(char c, std::size_t count) {
+    while (count > 0) {
+        if (size_ == capacity_) {
+            flush();
+        }
+        const std::size_t chunk = std::min(count, capacity_ - size_);
+        std::memset(data_.get() + size_, c, chunk);
+        size_ += chunk;
+        count -= chunk;
+    }
+}
+
+void OutputBuffer::put_uint(std::uint64_t value) {
+    char digits[24];
+    const auto result = std::to_chars(digits, digits + sizeof(digits), value);
+    write(digits, static_cast<std::size_t>(result.ptr - digits));
+}
+
+void OutputBuffer::put_int(std::int64_t value) {
+    char digits[24];
+    const auto result = std::to_chars(digits, digits + sizeof(digits), value);
+    write(digits, static_cast<std::size_t>(result.ptr - digits));
+}
+
+void OutputBuffer::put_double(double value) {
+    char digits[32];
+    const auto result = std::to_chars(digits, digits + sizeof(digits), value);
+    write(digits, static_cast<std::size_t>(result.ptr - digits));
+}
+
+void OutputBuffer::put_fixed(double value, int precision) {
+    // Large enough for DBL_MAX in fixed notation with a generous precision.
+    char digits[384];
+    const auto result =
+        std::to_chars(digits, digits + sizeof(digits), value, std::chars_format::fixed, precision);
+    if (result.ec == std::errc()) {
+        write(digits, static_cast<std::size_t>(result.ptr - digits));
+    } else {
+        put_double(value);
+    }
+}
+
+void OutputBuffer::put_json_escaped(std::string_view text, bool script_safe) {
+    const std::array<char, 256>& table = script_safe ? kScriptJsonEscape : kJsonEscape;
+    std::size_t run = 0;
+    for (std::size_t i = 0; i < text.size(); ++i) {
+        const char escape = table[byte_at(text, i)];
+        if (escape == 0) {
+            continue;
+        }
+        write(text.data() + run, i - run);
+        run = i + 1;
+        if (escape == 'u') {
+            const unsigned char c = byte_at(text, i);
+            const char sequence[6] = {'\\', 'u', '0', '0', kHexDigits[c >> 4], kHexDigits[c & 0x0f]};
+            write(sequence, sizeof(sequence));
+        } else {
+            const char sequence[2] = {'\\', escape};
+            write(sequence, sizeof(sequence));
+        }
+    }
+    write(text.data() + run, text.size() - run);
+}
+
+void OutputBuffer::put_html_escaped(std::string_view text) {
+    std::size_t run = 0;
+    for (std::size_t i = 0; i < text.size(); ++i) {
+        const unsigned char entity = kHtmlEscape[byte_at(text, i)];
+        if (entity == 0) {
+            continue;
+        }
+        write(text.data() + run, i - run);
+        run = i + 1;
+        *this << kHtmlEntities[entity];
+    }
+    write(text.data() + run, text.size() - run);
+}
+
+void OutputBuffer::put_csv_field(std::string_view text) {
+    bool needs_quotes = false;
+    for (std::size_t i = 0; i < text.size() && !needs_quotes; ++i) {
+        needs_quotes = kCsvSpecial[byte_at(text, i)];
+    }
+    if (!needs_quotes) {
+        write(text.data(), text.size());
+        return;
+    }
+
+    put('"');
+    std::size_t run = 0;
+    for (std::size_t i = 0; i < text.size(); ++i) {
+        if (text[i] == '"') {
+            // Emit the run including this quote, then restart at it so it doubles.
+            write(text.data() + run, i + 1 - run);
+            run = i;
+        }
+    }
+    write(text.data() + run, text.size() - run);
+    put('"');
+}
+
+OutputBuffer& OutputBuffer::operator<<(const Padded& value) {
+    const std::size_t padding = value.width > value.text.size() ? value.width - value.text.size() : 0;
+    if (value.right) {
+        fill(' ', padding);
+        write(value.text.data(), value.text.size());
+    } else {
+        write(value.text.data(), value.text.size());
+        fill(' ', padding);
+    }
+    return *this;
+}
+
+} // namespace core
@@ -0,0 +1,104 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace core {
+
+// Escaping/formatting manipulators for OutputBuffer::operator<<. They hold a
+// view, so the referenced text must outlive the insert expression only.
+struct JsonText { std::string_view text; bool script_safe; };
+struct HtmlText { std::string_view text; };
+struct CsvField { std::string_view text; };
+struct Padded { std::string_view text; std::size_t width; bool right; };
+struct Fixed { double value; int precision; };
+
+inline JsonText json_text(std::string_view text) { return JsonText{text, false}; }
+// JSON string body that is also safe inside an HTML <script> element:
+// '<', '>' and '&' become \u escapes so the data can never close the tag.
+inline JsonText script_json_text(std::string_view text) { return JsonText{text, true}; }
+inline HtmlText html_text(std::string_view text) { return HtmlText{text}; }
+// Quotes the field only when it contains a quote, comma or line break.
+inline CsvField csv_field(std::string_view text) { return CsvField{text}; }
+inline Padded pad_left(std::string_view text, std::size_t width) { return Padded{text, width, false}; }
+inline Padded pad_right(std::string_view text, std::size_t width) { return Padded{text, width, true}; }
+inline Fixed fixed(double value, int precision) { return Fixed{value, precision}; }
+
+std::size_t decimal_digits(std::uint64_t value);
+
+// Write-only file sink for large generated outputs (reports). Bytes collect in
+// one preallocated chunk and reach the file in chunk-sized fwrite calls; numbers
+// go through std::to_chars and escaping is table-driven and done in place, so
+// no per-field temporaries or ostream formatting state are involved.
+class OutputBuffer {
+public:
+    static constexpr std::size_t kDefaultCapacity = std::size_t{4} << 20;
+
+    explicit OutputBuffer(std::size_t capacity = kDefaultCapacity);
+    ~OutputBuffer();
+    OutputBuffer(const OutputBuffer&) = delete;
+    OutputBuffer& operator=(const OutputBuffer&) = delete;
+
+    bool open(const std::string& path);
+    bool is_open() const { return file_ != nullptr; }
+    // Flushes and closes; false if any write failed since open().
+    bool close();
+    bool flush();
+    bool good() const { return !failed_; }
+    std::uint64_t bytes_written() const { return written_ + size_; }
+
+    void write(const char* data, std::size_t size);
+    void put(char c) {
+        if (size_ == capacity_) {
+            flush();
+        }
+        data_[size_++] = c;
+    }
+    void fill(char c, std::size_t count);
+    void put_uint(std::uint64_t value);
+    void put_int(std::int64_t value);
+    // Shortest representation that round-trips (valid JSON for finite values).
+    void put_double(double value);
+    void put_fixed(double value, int precision);
+    void put_json_escaped(std::string_view text, bool script_safe = false);
+    void put_html_escaped(std::string_view text);
+    void put_csv_field(std::string_view text);
+
+    OutputBuffer& operator<<(std::string_view text) { write(text.data(), text.size()); return *this; }
+    OutputBuffer& operator<<(const std::string& text) { write(text.data(), text.size()); return *this; }
+    OutputBuffer& operator<<(const char* text) { return *this << std::string_view(text); }
+    OutputBuffer& operator<<(char c) { put(c); return *this; }
+    OutputBuffer& operator<<(double value) { put_double(value); return *this; }
+    OutputBuffer& operator<<(const JsonText& value) { put_json_escaped(value.text, value.script_safe); return *this; }
+    OutputBuffer& operator<<(const HtmlText& value) { put_html_escaped(value.text); return *this; }
+    OutputBuffer& operator<<(const CsvField& value) { put_csv_field(value.text); return *this; }
+    OutputBuffer& operator<<(const Fixed& value) { put_fixed(value.value, value.precision); return *this; }
+    OutputBuffer& operator<<(const Padded& value);
+
+    template <typename T,
+              typename = std::enable_if_t<std::is_integral_v<T> &&
+                                          !std::is_same_v<T, char> &&
+                                          !std::is_same_v<T, bool>>>
+    OutputBuffer& operator<<(T value) {
+        if constexpr (std::is_signed_v<T>) {
+            put_int(static_cast<std::int64_t>(value));
+        } else {
+            put_uint(static_cast<std::uint64_t>(value));
+        }
+        return *this;
+    }
+
+private:
+    std::unique_ptr<char[]> data_;
+    std::size_t capacity_ = 0;
+    std::size_t size_ = 0;
+    std::uint64_t written_ = 0;
+    std::FILE* file_ = nullptr;
+    bool failed_ = false;
+};
+
+} // namespace core
@@ -0,0 +1,108 @@
+#include "profiler.h"
+
+namespace profiler {
+
+namespace {
+
+struct Totals {
+    std::atomic<std::uint64_t> nanos{0};
+    std::atomic<std::uint64_t> calls{0};
+    std::atomic<std::uint64_t> files{0};
+    std::atomic<std::uint64_t> bytes{0};
+    std::atomic<std::uint64_t> syscalls{0};
+    std::atomic<std::uint64_t> errors{0};
+};
+
+Totals totals[core::kPhaseCount];
+thread_local Scope* current = nullptr;
+
+void add(std::atomic<std::uint64_t>& counter, std::uint64_t value) {
+    if (value != 0) {
+        counter.fetch_add(value, std::memory_order_relaxed);
+    }
+}
+
+} // namespace
+
+namespace detail {
+
+void note_syscalls(std::uint64_t count) {
+    if (current != nullptr) {
+        current->add_syscalls(count);
+    }
+}
+
+} // namespace detail
+
+void enable(bool on) {
+    detail::active.store(on, std::memory_order_relaxed);
+}
+
+void reset() {
+    for (Totals& phase : totals) {
+        phase.nanos.store(0, std::memory_order_relaxed);
+        phase.calls.store(0, std::memory_order_relaxed);
+        phase.files.store(0, std::memory_order_relaxed);
+        phase.bytes.store(0, std::memory_order_relaxed);
+        phase.syscalls.store(0, std::memory_order_relaxed);
+        phase.errors.store(0, std::memory_order_relaxed);
+    }
+}
+
+core::ScanProfile capture() {
+    core::ScanProfile profile;
+    profile.enabled = enabled();
+    for (std::size_t i = 0; i < core::kPhaseCount; ++i) {
+        const Totals& phase = totals[i];
+        core::PhaseStats& out = profile.phases[i];
+        out.seconds = static_cast<double>(phase.nanos.load(std::memory_order_relaxed)) / 1e9;
+        out.calls = phase.calls.load(std::memory_order_relaxed);
+        out.files = phase.files.load(std::memory_order_relaxed);
+        out.bytes = phase.bytes.load(std::memory_order_relaxed);
+        out.syscalls = phase.syscalls.load(std::memory_order_relaxed);
+        out.errors = phase.errors.load(std::memory_order_relaxed);
+    }
+    return profile;
+}
+
+const char* phase_name(core::Phase phase) {
+    switch (phase) {
+        case core::Phase::Walk: return "walk";
+        case core::Phase::Canonicalize: return "canonicalize";
+        case core::Phase::Ignore: return "ignore";
+        case core::Phase::Stat: return "stat";
+        case core::Phase::Hash: return "hash";
+        case core::Phase::Compare: return "compare";
+        case core::Phase::BaselineLoad: return "baseline_load";
+        case core::Phase::SealCheck: return "seal_check";
+        case core::Phase::BaselineSave: return "baseline_save";
+        case core::Phase::Report: return "report";
+    }
+    return "unknown";
+}
+
+void Scope::begin() {
+    outer_ = current;
+    current = this;
+    start_ = std::chrono::steady_clock::now();
+}
+
+void Scope::end() {
+    const std::uint64_t elapsed = static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_)
+            .count());
+    current = outer_;
+    if (outer_ != nullptr) {
+        outer_->nested_nanos_ += elapsed;
+    }
+
+    Totals& phase = totals[static_cast<std::size_t>(phase_)];
+    add(phase.nanos, elapsed > nested_nanos_ ? elapsed - nested_nanos_ : 0);
+    phase.calls.fetch_add(1, std::memory_order_relaxed);
+    add(phase.files, files_);
+    add(phase.bytes, bytes_);
+    add(phase.syscalls, syscalls_);
+    add(phase.errors, errors_);
+}
+
+} // namespace profiler
@@ -0,0 +1,67 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include "types.h"
+
+namespace profiler {
+
+namespace detail {
+inline std::atomic<bool> active{false};
+void note_syscalls(std::uint64_t count);
+}
+
+// Process-wide phase totals, collected only while enabled. When disabled a
+// Scope costs one relaxed load and never reads the clock.
+void enable(bool on);
+inline bool enabled() { return detail::active.load(std::memory_order_relaxed); }
+void reset();
+core::ScanProfile capture();
+const char* phase_name(core::Phase phase);
+
+// Adds filesystem calls (open, read, stat, ...) to the innermost Scope open on
+// the calling thread; nothing happens outside a scope.
+inline void note_syscalls(std::uint64_t count) {
+    if (enabled()) {
+        detail::note_syscalls(count);
+    }
+}
+
+// Times one occurrence of a phase on the current thread. Scopes nest: time
+// spent in an inner scope is charged to the inner phase only.
+class Scope {
+public:
+    explicit Scope(core::Phase phase) : phase_(phase), active_(enabled()) {
+        if (active_) {
+            begin();
+        }
+    }
+    ~Scope() {
+        if (active_) {
+            end();
+        }
+    }
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+    void add_files(std::uint64_t count = 1) { files_ += count; }
+    void add_bytes(std::uint64_t count) { bytes_ += count; }
+    void add_syscalls(std::uint64_t count) { syscalls_ += count; }
+    void add_error() { ++errors_; }
+
+private:
+    void begin();
+    void end();
+
+    core::Phase phase_;
+    bool active_;
+    Scope* outer_ = nullptr;
+    std::chrono::steady_clock::time_point start_{};
+    std::uint64_t nested_nanos_ = 0;
+    std::uint64_t files_ = 0;
+    std::uint64_t bytes_ = 0;
+    std::uint64_t syscalls_ = 0;
+    std::uint64_t errors_ = 0;
+};
+
+} // namespace profiler
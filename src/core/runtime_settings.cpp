@@ -1,10 +1,15 @@
 #include "runtime_settings.h"
 #include "config.h"
+#include <cctype>
+#include <cerrno>
+#include <cstdint>
 #include <cstdlib>
 #include <filesystem>
 #include <fstream>
 #include <string>
 #include <system_error>
+#include <utility>
+#include <vector>
 
 namespace fs = std::filesystem;
 
@@ -59,15 +64,10 @@ fs::path settings_path() {
     return detect_config_home() / "sentinel-c" / "settings.ini";
 }
 
-} // namespace
-
-namespace core {
-
-std::string settings_file_path() {
-    return config::normalize_path_string(settings_path());
-}
+using Setting = std::pair<std::string, std::string>;
 
-std::optional<std::string> load_saved_output_root(std::string* error) {
+// Reads key=value pairs in file order; a missing file is not an error.
+bool read_settings(std::vector<Setting>& settings, std::string* error) {
     if (error != nullptr) {
         error->clear();
     }
@@ -75,13 +75,7 @@ std::optional<std::string> load_saved_output_root(std::string* error) {
     const fs::path file_path = settings_path();
     std::error_code ec;
     if (!fs::exists(file_path, ec)) {
-        return std::nullopt;
-    }
-    if (ec) {
-        if (error != nullptr) {
-            *error = "failed to read settings file: " + ec.message();
-        }
-        return std::nullopt;
+        return true;
     }
 
     std::ifstream in(file_path);
@@ -90,7 +84,7 @@ std::optional<std::string> load_saved_output_root(std::string* error) {
             *error = "failed to open settings file: " +
                      config::normalize_path_string(file_path);
         }
-        return std::nullopt;
+        return false;
     }
 
     std::string line;
@@ -104,17 +98,125 @@ std::optional<std::string> load_saved_output_root(std::string* error) {
         if (eq == std::string::npos) {
             continue;
         }
+        settings.emplace_back(trim_copy(line.substr(0, eq)), trim_copy(line.substr(eq + 1)));
+    }
+    return true;
+}
+
+// Unit suffix letters and their multipliers, e.g. "32M" or "6h".
+struct Unit {
+    char suffix;
+    std::uint64_t scale;
+};
+constexpr Unit kSizeUnits[] = {{'K', 1ULL << 10}, {'M', 1ULL << 20}, {'G', 1ULL << 30}, {0, 0}};
+constexpr Unit kAgeUnits[] = {{'S', 1}, {'M', 60}, {'H', 3600}, {'D', 86400}, {0, 0}};
 
-        const std::string key = trim_copy(line.substr(0, eq));
-        const std::string value = trim_copy(line.substr(eq + 1));
-        if (key == "output_root" && !value.empty()) {
-            return value;
+bool parse_scaled(const std::string& text, const Unit* units, std::uint64_t& out) {
+    std::string value = text;
+    std::uint64_t scale = 1;
+    if (value == "off" || value == "none") {
+        out = 0;
+        return true;
+    }
+    if (!value.empty() && units != nullptr &&
+        std::isalpha(static_cast<unsigned char>(value.back()))) {
+        const char suffix = static_cast<char>(std::toupper(static_cast<unsigned char>(value.back())));
+        const Unit* unit = units;
+        while (unit->suffix != 0 && unit->suffix != suffix) {
+            ++unit;
+        }
+        if (unit->suffix == 0) {
+            return false;
         }
+        scale = unit->scale;
+        value.pop_back();
+    }
+    if (value.empty() || value.find_first_not_of("0123456789") != std::string::npos) {
+        return false;
+    }
+    errno = 0;
+    const unsigned long long number = std::strtoull(value.c_str(), nullptr, 10);
+    if (errno == ERANGE || number > UINT64_MAX / scale) {
+        return false;
+    }
+    out = static_cast<std::uint64_t>(number) * scale;
+    return true;
+}
+
+bool parse_flag(const std::string& text, bool& out) {
+    std::string value;
+    for (const char c : text) {
+        value += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+    if (value == "1" || value == "true" || value == "yes" || value == "on") {
+        out = true;
+        return true;
     }
+    if (value == "0" || value == "false" || value == "no" || value == "off") {
+        out = false;
+        return true;
+    }
+    return false;
+}
+
+} // namespace
+
+namespace core {
+
+std::string settings_file_path() {
+    return config::normalize_path_string(settings_path());
+}
 
+std::optional<std::string> load_saved_output_root(std::string* error) {
+    std::vector<Setting> settings;
+    if (!read_settings(settings, error)) {
+        return std::nullopt;
+    }
+    for (const Setting& setting : settings) {
+        if (setting.first == "output_root" && !setting.second.empty()) {
+            return setting.second;
+        }
+    }
     return std::nullopt;
 }
 
+LogRotation load_log_rotation(std::vector<std::string>* warnings) {
+    LogRotation rotation;
+    std::vector<Setting> settings;
+    std::string error;
+    if (!read_settings(settings, &error)) {
+        if (warnings != nullptr && !error.empty()) {
+            warnings->push_back(error);
+        }
+        return rotation;
+    }
+
+    for (const Setting& setting : settings) {
+        const std::string& key = setting.first;
+        const std::string& value = setting.second;
+        bool valid = true;
+        if (key == "log_rotate_size") {
+            valid = parse_scaled(value, kSizeUnits, rotation.max_bytes);
+        } else if (key == "log_rotate_age") {
+            valid = parse_scaled(value, kAgeUnits, rotation.max_age_seconds);
+        } else if (key == "log_compress") {
+            valid = parse_flag(value, rotation.compress);
+        } else if (key == "log_keep_segments") {
+            std::uint64_t keep = 0;
+            valid = parse_scaled(value, nullptr, keep);
+            if (valid) {
+                rotation.keep_segments = static_cast<std::size_t>(keep);
+            }
+        } else {
+            continue;
+        }
+        if (!valid && warnings != nullptr) {
+            warnings->push_back("ignoring invalid " + key + " value: " + value);
+        }
+    }
+    return rotation;
+}
+
 bool save_output_root(const std::string& output_root, std::string* error) {
     if (error != nullptr) {
         error->clear();
@@ -138,6 +240,22 @@ bool save_output_root(const std::string& output_root, std::string* error) {
         return false;
     }
 
+    // Keep every other line (log rotation keys, comments) as the user wrote it.
+    std::vector<std::string> kept;
+    {
+        std::ifstream in(file_path);
+        std::string line;
+        while (in && std::getline(in, line)) {
+            const std::string trimmed = trim_copy(line);
+            const std::size_t eq = trimmed.find('=');
+            if (trimmed == "# Sentinel-C runtime settings" ||
+                (eq != std::string::npos && trim_copy(trimmed.substr(0, eq)) == "output_root")) {
+                continue;
+            }
+            kept.push_back(line);
+        }
+    }
+
     const fs::path temp_file = file_path.string() + ".tmp";
     std::ofstream out(temp_file, std::ios::trunc);
     if (!out.is_open()) {
@@ -150,6 +268,9 @@ bool save_output_root(const std::string& output_root, std::string* error) {
 
     out << "# Sentinel-C runtime settings\n";
     out << "output_root=" << output_root << "\n";
+    for (const std::string& line : kept) {
+        out << line << "\n";
+    }
     out.close();
     if (!out) {
         if (error != nullptr) {
@@ -176,5 +297,9 @@ bool save_output_root(const std::string& output_root, std::string* error) {
     return true;
 }
 
+bool parse_byte_size(const std::string& text, std::uint64_t& out) {
+    return parse_scaled(text, kSizeUnits, out);
+}
+
 } // namespace core
 
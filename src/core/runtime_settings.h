@@ -1,7 +1,10 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <optional>
 #include <string>
+#include <vector>
 
 namespace core {
 
@@ -9,5 +12,24 @@ std::optional<std::string> load_saved_output_root(std::string* error = nullptr);
 bool save_output_root(const std::string& output_root, std::string* error = nullptr);
 std::string settings_file_path();
 
+// Activity log rotation, read from the same settings.ini. A segment is sealed
+// when the next write would take it past `max_bytes` or its first record is
+// `max_age_seconds` old; either limit is off at 0.
+struct LogRotation {
+    std::uint64_t max_bytes = std::uint64_t{32} << 20;
+    std::uint64_t max_age_seconds = 0;
+    bool compress = true;
+    // Oldest archived segments beyond this count are deleted; 0 keeps all.
+    std::size_t keep_segments = 0;
+};
+
+// Missing keys keep their defaults; malformed values are reported in
+// `warnings` and ignored.
+LogRotation load_log_rotation(std::vector<std::string>* warnings = nullptr);
+
+// Byte count with an optional K, M or G suffix (binary multiples), as used by
+// log_rotate_size; "off" and "none" read as 0.
+bool parse_byte_size(const std::string& text, std::uint64_t& out);
+
 } // namespace core
 
@@ -1,7 +1,10 @@
 #include "summary.h"
 #include "config.h"
+#include "profiler.h"
 #include <iostream>
+#include <cmath>
 #include <iomanip>
+#include <sstream>
 #include <ctime>
 
 static std::string now() {
@@ -19,6 +22,98 @@ static std::string now() {
 
 namespace core {
 
+static std::string format_bytes(double bytes) {
+    static const char* const units[] = {"B", "KiB", "MiB", "GiB", "TiB"};
+    std::size_t unit = 0;
+    while (std::fabs(bytes) >= 1024.0 && unit + 1 < sizeof(units) / sizeof(units[0])) {
+        bytes /= 1024.0;
+        ++unit;
+    }
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(unit == 0 ? 0 : 1) << bytes << " " << units[unit];
+    return out.str();
+}
+
+static std::string format_millis(std::uint64_t micros) {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(2) << static_cast<double>(micros) / 1000.0 << " ms";
+    return out.str();
+}
+
+static void print_distribution(const ScanDistribution& d) {
+    const Histogram& latency = d.hash_micros;
+    const Histogram& sizes = d.file_bytes;
+    std::cout << "File Distribution (" << latency.count() << " hashed files, values within 1/16)\n"
+              << "  Hash latency : p50 " << format_millis(latency.percentile(0.50))
+              << "  p90 " << format_millis(latency.percentile(0.90))
+              << "  p99 " << format_millis(latency.percentile(0.99))
+              << "  p99.9 " << format_millis(latency.percentile(0.999))
+              << "  max " << format_millis(latency.max()) << "\n"
+              << "  File size    : p50 " << format_bytes(static_cast<double>(sizes.percentile(0.50)))
+              << "  p90 " << format_bytes(static_cast<double>(sizes.percentile(0.90)))
+              << "  p99 " << format_bytes(static_cast<double>(sizes.percentile(0.99)))
+              << "  max " << format_bytes(static_cast<double>(sizes.max())) << "\n"
+              << "  Throughput   : peak " << format_bytes(d.throughput.peak_rate()) << "/s, mean "
+              << format_bytes(d.throughput.mean_rate()) << "/s over " << d.throughput.bytes().size()
+              << " x " << std::fixed << std::setprecision(2) << d.throughput.interval() << " s\n";
+    if (!d.slowest.empty()) {
+        std::cout << "Slowest Files\n";
+        for (const SlowFile& file : d.slowest) {
+            std::cout << "  " << std::right << std::setw(11) << format_millis(static_cast<std::uint64_t>(file.seconds * 1e6))
+                      << std::setw(12) << format_bytes(static_cast<double>(file.size)) << "  " << file.path << "\n";
+        }
+    }
+}
+
+static void print_profile(const ScanStats& stats) {
+    const ScanProfile& profile = stats.profile;
+    std::cout << "Phase Profile (time excludes nested phases; hash and report sum all workers)\n"
+              << "  " << std::left << std::setw(14) << "Phase" << std::right
+              << std::setw(11) << "Time (ms)" << std::setw(9) << "Calls"
+              << std::setw(10) << "Files" << std::setw(15) << "Bytes"
+              << std::setw(11) << "Syscalls" << std::setw(8) << "Errors" << "\n";
+    for (std::size_t i = 0; i < kPhaseCount; ++i) {
+        const PhaseStats& phase = profile.phases[i];
+        if (phase.calls == 0) {
+            continue;
+        }
+        std::cout << "  " << std::left << std::setw(14) << profiler::phase_name(static_cast<Phase>(i))
+                  << std::right << std::setw(11) << std::fixed << std::setprecision(2)
+                  << phase.seconds * 1000.0 << std::setw(9) << phase.calls
+                  << std::setw(10) << phase.files << std::setw(15) << phase.bytes
+                  << std::setw(11) << phase.syscalls << std::setw(8) << phase.errors << "\n";
+    }
+    if (!stats.distribution.empty()) {
+        std::cout << "\n";
+        print_distribution(stats.distribution);
+    }
+    std::cout << "------------------------------------------------------------\n\n";
+}
+
+void print_memory_report(std::ostream& out, const memory::Usage& usage) {
+    out << "Memory Report (heap bytes charged to the subsystem running when allocated or freed)\n"
+        << "  " << std::left << std::setw(10) << "Area" << std::right << std::setw(12) << "Allocs"
+        << std::setw(13) << "Allocated" << std::setw(13) << "Freed" << std::setw(13) << "Held"
+        << std::setw(13) << "Peak held" << "\n";
+    for (std::size_t i = 0; i < memory::kAreaCount; ++i) {
+        const memory::AreaUsage& area = usage.areas[i];
+        if (area.allocations == 0 && area.freed == 0) {
+            continue;
+        }
+        out << "  " << std::left << std::setw(10) << memory::area_name(static_cast<memory::Area>(i))
+            << std::right << std::setw(12) << area.allocations
+            << std::setw(13) << format_bytes(static_cast<double>(area.allocated))
+            << std::setw(13) << format_bytes(static_cast<double>(area.freed))
+            << std::setw(13) << format_bytes(static_cast<double>(area.net))
+            << std::setw(13) << format_bytes(static_cast<double>(area.peak)) << "\n";
+    }
+    out << "  Heap in use : " << format_bytes(static_cast<double>(usage.live)) << " now, "
+        << format_bytes(static_cast<double>(usage.peak_live)) << " at peak\n"
+        << "  Peak RSS    : "
+        << (usage.peak_rss == 0 ? std::string("unknown") : format_bytes(static_cast<double>(usage.peak_rss)))
+        << "\n";
+}
+
 void print_summary(
     const std::string& target,
     const ScanStats& s,
@@ -37,12 +132,20 @@ void print_summary(
     << "Deleted Files    : " << s.deleted << "\n\n"
     << "Scan Duration    : " << std::fixed << std::setprecision(2)
     << s.duration << " seconds\n"
-    "------------------------------------------------------------\n\n"
+    "------------------------------------------------------------\n\n";
+    if (s.profile.enabled) {
+        print_profile(s);
+    }
+    std::cout
     << "Output Locations:\n"
     << "  CLI Report  : " << p.cli_report << "\n"
     << "  HTML Report : " << p.html_report << "\n"
     << "  JSON Report : " << p.json_report << "\n"
-    << "  CSV Report  : " << p.csv_report << "\n"
+    << "  CSV Report  : " << p.csv_report << "\n";
+    if (p.columnar_report != "N/A") {
+        std::cout << "  Columnar    : " << p.columnar_report << "\n";
+    }
+    std::cout
     << "  Log File    : " << p.log_file << "\n"
     << "  Baseline    : " << p.baseline << "\n"
     << "  Seal File   : " << p.baseline_seal << "\n\n";
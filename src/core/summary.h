@@ -1,5 +1,7 @@
 #pragma once
+#include "memory.h"
 #include "types.h"
+#include <ostream>
 #include <string>
 
 namespace core {
@@ -9,4 +11,6 @@ namespace core {
         const OutputPaths& paths,
         bool baseline_ok
     );
+    // --memory-report table: heap use per subsystem, then totals and peak RSS.
+    void print_memory_report(std::ostream& out, const memory::Usage& usage);
 }
@@ -0,0 +1,150 @@
+#include "trace.h"
+#include "fsutil.h"
+#include "output_buffer.h"
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace trace {
+
+namespace {
+
+struct Event {
+    std::string name;
+    const char* category;
+    double start;
+    double duration;
+    std::uint32_t tid;
+    std::string args;
+};
+
+struct Buffer {
+    std::uint32_t tid = 0;
+    std::string name;
+    std::vector<Event> events;
+};
+
+// Buffers outlive their threads (pool workers exit before finish()); the
+// registry owns them and each thread caches a pointer to its own.
+std::mutex registry_lock;
+std::vector<std::unique_ptr<Buffer>> buffers;
+std::unique_ptr<core::OutputBuffer> sink;
+std::string sink_path;
+std::chrono::steady_clock::time_point origin;
+thread_local Buffer* local = nullptr;
+
+Buffer& local_buffer() {
+    if (local == nullptr) {
+        std::lock_guard<std::mutex> guard(registry_lock);
+        buffers.push_back(std::make_unique<Buffer>());
+        local = buffers.back().get();
+        local->tid = static_cast<std::uint32_t>(buffers.size());
+        local->events.reserve(256);
+    }
+    return *local;
+}
+
+void write_metadata(core::OutputBuffer& out, const char* kind, std::uint32_t tid, const std::string& name) {
+    out << "{\"name\":\"" << kind << "\",\"ph\":\"M\",\"pid\":1,\"tid\":";
+    out.put_uint(tid);
+    out << ",\"args\":{\"name\":\"" << core::json_text(name) << "\"}}";
+}
+
+void write_event(core::OutputBuffer& out, const Event& event) {
+    out << "{\"name\":\"" << core::json_text(event.name) << "\",\"cat\":\"" << event.category
+        << "\",\"ph\":\"X\",\"ts\":" << core::fixed(event.start, 3)
+        << ",\"dur\":" << core::fixed(event.duration, 3) << ",\"pid\":1,\"tid\":";
+    out.put_uint(event.tid);
+    if (!event.args.empty()) {
+        out << ",\"args\":{" << event.args << '}';
+    }
+    out << '}';
+}
+
+} // namespace
+
+bool start(const std::string& path, std::string* error) {
+    auto out = std::make_unique<core::OutputBuffer>(std::size_t{1} << 20);
+    if (!out->open(path)) {
+        fsutil::set_error(error, "Failed to open trace file: " + path);
+        return false;
+    }
+    {
+        std::lock_guard<std::mutex> guard(registry_lock);
+        sink = std::move(out);
+        sink_path = path;
+        origin = std::chrono::steady_clock::now();
+    }
+    name_thread("main");
+    detail::active.store(true, std::memory_order_relaxed);
+    return true;
+}
+
+// Called once the threads that recorded spans are done with them.
+bool finish(std::string* error) {
+    detail::active.store(false, std::memory_order_relaxed);
+    std::lock_guard<std::mutex> guard(registry_lock);
+    if (!sink) {
+        return true;
+    }
+
+    core::OutputBuffer& out = *sink;
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    write_metadata(out, "process_name", 0, "sentinel-c");
+    for (const std::unique_ptr<Buffer>& buffer : buffers) {
+        out << ",\n";
+        write_metadata(out, "thread_name", buffer->tid,
+                       buffer->name.empty() ? "thread " + std::to_string(buffer->tid) : buffer->name);
+    }
+    for (std::unique_ptr<Buffer>& buffer : buffers) {
+        for (const Event& event : buffer->events) {
+            out << ",\n";
+            write_event(out, event);
+        }
+        buffer->events.clear();
+        buffer->events.shrink_to_fit();
+    }
+    out << "\n]}\n";
+
+    const bool ok = out.close();
+    sink.reset();
+    if (!ok) {
+        fsutil::set_error(error, "Failed to write trace file: " + sink_path);
+    }
+    return ok;
+}
+
+double now() {
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - origin).count();
+}
+
+void name_thread(const std::string& name) {
+    Buffer& buffer = local_buffer();
+    std::lock_guard<std::mutex> guard(registry_lock);
+    buffer.name = name;
+}
+
+std::uint32_t thread_id() {
+    return local_buffer().tid;
+}
+
+void complete(std::string name, const char* category, double start_us, double end_us, std::string args) {
+    Buffer& buffer = local_buffer();
+    complete_on(buffer.tid, std::move(name), category, start_us, end_us, std::move(args));
+}
+
+void complete_on(std::uint32_t tid,
+                 std::string name,
+                 const char* category,
+                 double start_us,
+                 double end_us,
+                 std::string args) {
+    if (!active()) {
+        return;
+    }
+    local_buffer().events.push_back(
+        Event{std::move(name), category, start_us, end_us > start_us ? end_us - start_us : 0.0, tid, std::move(args)});
+}
+
+} // namespace trace
@@ -0,0 +1,64 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace trace {
+
+namespace detail {
+inline std::atomic<bool> active{false};
+}
+
+// Files at least this large get a span of their own in the hashing workers;
+// smaller ones are folded into one span per run of consecutive files.
+constexpr std::uint64_t kFileSpanBytes = std::uint64_t{1} << 20;
+
+// Chrome Trace Event recording (chrome://tracing, Perfetto). Each thread keeps
+// its spans in its own buffer, so recording takes no lock after a thread's
+// first span; nothing is written until finish(). When inactive a Span costs
+// one relaxed load and never reads the clock.
+//
+// start() opens `path` right away so a bad destination fails before the scan.
+bool start(const std::string& path, std::string* error = nullptr);
+inline bool active() { return detail::active.load(std::memory_order_relaxed); }
+// Stops recording and writes every thread's spans; false if the write failed.
+bool finish(std::string* error = nullptr);
+
+// Microseconds since start(), on the steady clock.
+double now();
+// Names the calling thread in the viewer; unnamed threads show as "thread N".
+void name_thread(const std::string& name);
+// Viewer id of the calling thread, for spans recorded on its behalf.
+std::uint32_t thread_id();
+
+// Records a finished span on the calling thread (or on `tid`). `args` is the
+// inside of a JSON object ("\"files\":3,...") or empty.
+void complete(std::string name, const char* category, double start_us, double end_us,
+              std::string args = {});
+void complete_on(std::uint32_t tid, std::string name, const char* category, double start_us,
+                 double end_us, std::string args = {});
+
+// Records the lifetime of the enclosing block as one span.
+class Span {
+public:
+    Span(const char* name, const char* category) : name_(name), category_(category), active_(active()) {
+        if (active_) {
+            start_ = now();
+        }
+    }
+    ~Span() {
+        if (active_) {
+            complete(name_, category_, start_, now());
+        }
+    }
+    Span(const Span&) = delete;
+    Span& operator=(const Span&) = delete;
+
+private:
+    const char* name_;
+    const char* category_;
+    bool active_;
+    double start_ = 0.0;
+};
+
+} // namespace trace
@@ -1,8 +1,11 @@
 #pragma once
+#include <array>
+#include <cstddef>
 #include <string>
 #include <vector>
 #include <cstdint>
 #include <ctime>
+#include "distribution.h"
 
 namespace core {
 
@@ -13,12 +16,54 @@ struct FileEntry {
     std::time_t mtime;
 };
 
+enum class Phase : std::size_t {
+    Walk,
+    Canonicalize,
+    Ignore,
+    Stat,
+    Hash,
+    Compare,
+    BaselineLoad,
+    SealCheck,
+    BaselineSave,
+    Report
+};
+constexpr std::size_t kPhaseCount = 10;
+
+// Time is exclusive of nested phases; for phases that run on worker threads
+// (hash, report) it is summed across the workers.
+struct PhaseStats {
+    double   seconds  = 0.0;
+    uint64_t calls    = 0;
+    uint64_t files    = 0;
+    uint64_t bytes    = 0;
+    uint64_t syscalls = 0;
+    uint64_t errors   = 0;
+};
+
+// Filled only when profiling is on (--profile), see core/profiler.h.
+struct ScanProfile {
+    bool enabled = false;
+    std::array<PhaseStats, kPhaseCount> phases{};
+};
+
 struct ScanStats {
     size_t scanned  = 0;
     size_t added    = 0;
     size_t modified = 0;
     size_t deleted  = 0;
     double duration = 0.0;
+    ScanProfile profile;
+    // Per-file hash latency, sizes, throughput and slowest files of the
+    // snapshot that produced these stats.
+    ScanDistribution distribution;
+    // Wall time of the hash phase and the threads that shared it.
+    double hash_seconds = 0.0;
+    size_t hash_workers = 0;
+    // Sorted runs written to disk under --memory-limit.
+    size_t spill_runs = 0;
+    // Files whose digest came from a scan journal (--resume), not hashed again.
+    size_t resumed = 0;
 };
 
 struct OutputPaths {
@@ -26,6 +71,7 @@ struct OutputPaths {
     std::string html_report;
     std::string json_report;
     std::string csv_report;
+    std::string columnar_report;
     std::string log_file;
     std::string baseline;
     std::string baseline_seal;
@@ -1,7 +1,7 @@
 #pragma once
 #include <string>
-#include "../scanner/scanner.h"
+#include "report_model.h"
 
 namespace reports {
-std::string write_cli(const scanner::ScanResult& result, const std::string& scan_id);
+std::string write_cli(const ReportModel& model);
 }
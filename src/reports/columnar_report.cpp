@@ -0,0 +1,223 @@
+#include "columnar_report.h"
+#include "../core/codec.h"
+#include "../core/config.h"
+#include "../core/output_buffer.h"
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace reports {
+
+namespace {
+
+constexpr char kMagic[8] = {'S', 'N', 'T', 'L', 'C', 'O', 'L', '1'};
+constexpr std::uint32_t kVersion = 1;
+constexpr std::size_t kHeaderSize = 80;
+constexpr std::size_t kColumnEntrySize = 40;
+constexpr std::size_t kAlignment = 64;
+constexpr std::size_t kDigestWidth = 32;
+
+// Physical type codes stored in the column directory.
+enum ColumnType : std::uint32_t {
+    UInt8 = 1,
+    UInt32 = 2,
+    UInt64 = 3,
+    Int64 = 4,
+    FixedBinary = 5,
+    Offsets64 = 6,
+    Bytes = 7
+};
+
+struct Column {
+    const char* name;
+    ColumnType type;
+    std::uint32_t width;
+    std::uint64_t length;
+    std::uint64_t offset;
+};
+
+std::uint64_t align_up(std::uint64_t value) {
+    return (value + kAlignment - 1) / kAlignment * kAlignment;
+}
+
+// Raw SHA-256 bytes; all zero when the stored digest is not 64 hex digits.
+void put_digest(std::string& staged, const std::string& hex) {
+    char raw[kDigestWidth] = {};
+    if (hex.size() == kDigestWidth * 2) {
+        for (std::size_t i = 0; i < kDigestWidth; ++i) {
+            const int high = codec::hex_value(hex[2 * i]);
+            const int low = codec::hex_value(hex[2 * i + 1]);
+            if (high < 0 || low < 0) {
+                std::memset(raw, 0, sizeof(raw));
+                break;
+            }
+            raw[i] = static_cast<char>((high << 4) | low);
+        }
+    }
+    staged.append(raw, sizeof(raw));
+}
+
+std::uint8_t kind_code(ChangeKind kind) {
+    switch (kind) {
+        case ChangeKind::Added: return 0;
+        case ChangeKind::Modified: return 1;
+        default: return 2;
+    }
+}
+
+// Fixed-width fields are encoded into `staged` with the codec helpers and
+// handed to the buffer in slices of this size.
+constexpr std::size_t kStageBytes = 64 * 1024;
+
+void drain(core::OutputBuffer& out, std::string& staged) {
+    if (staged.size() >= kStageBytes) {
+        out << staged;
+        staged.clear();
+    }
+}
+
+// Writes what is staged, then zero-fills up to the next column.
+void pad_to(core::OutputBuffer& out, std::string& staged, std::uint64_t position) {
+    out << staged;
+    staged.clear();
+    out.fill('\0', static_cast<std::size_t>(position - out.bytes_written()));
+}
+
+} // namespace
+
+std::string write_columnar(const ReportModel& model) {
+    const std::string file = config::REPORT_COLUMNAR_DIR +
+                             "/sentinel-c_integrity_columnar_report_" + model.scan_id + ".scol";
+
+    // Split each path into a dictionary-encoded directory and a file name.
+    const std::size_t rows = model.changes.size();
+    std::vector<std::string_view> dirs;
+    std::unordered_map<std::string_view, std::uint32_t> dir_ids;
+    std::vector<std::uint32_t> row_dirs;
+    std::vector<std::string_view> names;
+    row_dirs.reserve(rows);
+    names.reserve(rows);
+    std::uint64_t name_bytes = 0;
+    std::uint64_t dir_bytes = 0;
+    for (const ChangeRecord& record : model.changes) {
+        const std::string_view path(record.entry->path);
+        const std::size_t slash = path.rfind('/');
+        const std::string_view dir = slash == std::string_view::npos ? std::string_view() : path.substr(0, slash);
+        const std::string_view name = slash == std::string_view::npos ? path : path.substr(slash + 1);
+        const auto inserted = dir_ids.emplace(dir, static_cast<std::uint32_t>(dirs.size()));
+        if (inserted.second) {
+            dirs.push_back(dir);
+            dir_bytes += dir.size();
+        }
+        row_dirs.push_back(inserted.first->second);
+        names.push_back(name);
+        name_bytes += name.size();
+    }
+
+    Column columns[] = {
+        {"kind", UInt8, 1, rows, 0},
+        {"dir", UInt32, 4, rows * 4, 0},
+        {"name_offsets", Offsets64, 8, (rows + 1) * 8, 0},
+        {"name_data", Bytes, 1, name_bytes, 0},
+        {"size", UInt64, 8, rows * 8, 0},
+        {"mtime", Int64, 8, rows * 8, 0},
+        {"sha256", FixedBinary, kDigestWidth, rows * kDigestWidth, 0},
+        {"dir_offsets", Offsets64, 8, (dirs.size() + 1) * 8, 0},
+        {"dir_data", Bytes, 1, dir_bytes, 0},
+    };
+    const std::size_t column_count = sizeof(columns) / sizeof(columns[0]);
+    std::uint64_t position = align_up(kHeaderSize + column_count * kColumnEntrySize);
+    for (Column& column : columns) {
+        column.offset = position;
+        position = align_up(position + column.length);
+    }
+
+    core::OutputBuffer out;
+    if (!out.open(file)) {
+        return "";
+    }
+
+    std::string staged;
+    staged.reserve(kStageBytes + kDigestWidth);
+    staged.append(kMagic, sizeof(kMagic));
+    codec::put_u32(staged, kVersion);
+    codec::put_u32(staged, static_cast<std::uint32_t>(column_count));
+    codec::put_u64(staged, rows);
+    codec::put_u64(staged, dirs.size());
+    codec::put_u64(staged, model.stats.scanned);
+    codec::put_u64(staged, model.stats.added);
+    codec::put_u64(staged, model.stats.modified);
+    codec::put_u64(staged, model.stats.deleted);
+    std::uint64_t duration_bits = 0;
+    static_assert(sizeof(duration_bits) == sizeof(model.stats.duration), "IEEE-754 double expected");
+    std::memcpy(&duration_bits, &model.stats.duration, sizeof(duration_bits));
+    codec::put_u64(staged, duration_bits);
+    codec::put_u64(staged, 0);
+
+    for (const Column& column : columns) {
+        char name[16] = {};
+        std::memcpy(name, column.name, std::strlen(column.name));
+        staged.append(name, sizeof(name));
+        codec::put_u32(staged, column.type);
+        codec::put_u32(staged, column.width);
+        codec::put_u64(staged, column.offset);
+        codec::put_u64(staged, column.length);
+    }
+
+    pad_to(out, staged, columns[0].offset);
+    for (const ChangeRecord& record : model.changes) {
+        out.put(static_cast<char>(kind_code(record.kind)));
+    }
+    pad_to(out, staged, columns[1].offset);
+    for (const std::uint32_t id : row_dirs) {
+        codec::put_u32(staged, id);
+        drain(out, staged);
+    }
+    pad_to(out, staged, columns[2].offset);
+    std::uint64_t cursor = 0;
+    codec::put_u64(staged, cursor);
+    for (const std::string_view name : names) {
+        cursor += name.size();
+        codec::put_u64(staged, cursor);
+        drain(out, staged);
+    }
+    pad_to(out, staged, columns[3].offset);
+    for (const std::string_view name : names) {
+        out << name;
+    }
+    pad_to(out, staged, columns[4].offset);
+    for (const ChangeRecord& record : model.changes) {
+        codec::put_u64(staged, static_cast<std::uint64_t>(record.entry->size));
+        drain(out, staged);
+    }
+    pad_to(out, staged, columns[5].offset);
+    for (const ChangeRecord& record : model.changes) {
+        codec::put_u64(staged, static_cast<std::uint64_t>(static_cast<std::int64_t>(record.entry->mtime)));
+        drain(out, staged);
+    }
+    pad_to(out, staged, columns[6].offset);
+    for (const ChangeRecord& record : model.changes) {
+        put_digest(staged, record.entry->hash);
+        drain(out, staged);
+    }
+    pad_to(out, staged, columns[7].offset);
+    cursor = 0;
+    codec::put_u64(staged, cursor);
+    for (const std::string_view dir : dirs) {
+        cursor += dir.size();
+        codec::put_u64(staged, cursor);
+        drain(out, staged);
+    }
+    pad_to(out, staged, columns[8].offset);
+    for (const std::string_view dir : dirs) {
+        out << dir;
+    }
+    pad_to(out, staged, position);
+
+    return out.close() ? file : "";
+}
+
+} // namespace reports
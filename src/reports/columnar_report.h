@@ -0,0 +1,14 @@
+#pragma once
+
+#include "report_model.h"
+#include <string>
+
+namespace reports {
+
+// Binary column-per-array dump of the change list for dataframe tools
+// (layout in docs/Usage.txt, "Columnar report layout"). Every column starts on
+// a 64-byte boundary and uses Arrow's physical layouts, so a reader can map
+// the file and wrap the columns without parsing or copying.
+std::string write_columnar(const ReportModel& model);
+
+} // namespace reports
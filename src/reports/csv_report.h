@@ -1,11 +1,10 @@
 #pragma once
 
-#include "../scanner/scanner.h"
+#include "report_model.h"
 #include <string>
 
 namespace reports {
 
-std::string write_csv(const scanner::ScanResult& result, const std::string& scan_id = "");
+std::string write_csv(const ReportModel& model);
 
 } // namespace reports
-
@@ -1,77 +1,15 @@
 #include "html_report.h"
-#include "advice.h"
 #include "../core/config.h"
-#include "../core/fsutil.h"
+#include "../core/output_buffer.h"
 #include <algorithm>
 #include <cctype>
-#include <ctime>
-#include <fstream>
-#include <iomanip>
-#include <sstream>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 
 namespace {
 
-std::string escape_html(const std::string& text) {
-    std::string out;
-    out.reserve(text.size());
-    for (char c : text) {
-        switch (c) {
-            case '&': out += "&amp;"; break;
-            case '<': out += "&lt;"; break;
-            case '>': out += "&gt;"; break;
-            case '"': out += "&quot;"; break;
-            case '\'': out += "&#39;"; break;
-            default: out += c; break;
-        }
-    }
-    return out;
-}
-
-std::vector<const core::FileEntry*> sorted_entries(const scanner::FileMap& files) {
-    std::vector<const core::FileEntry*> entries;
-    entries.reserve(files.size());
-    for (const auto& item : files) {
-        entries.push_back(&item.second);
-    }
-    std::sort(entries.begin(), entries.end(),
-              [](const core::FileEntry* left, const core::FileEntry* right) {
-                  return left->path < right->path;
-              });
-    return entries;
-}
-
-std::tm local_time(std::time_t t) {
-    std::tm tm{};
-#ifdef _WIN32
-    localtime_s(&tm, &t);
-#else
-    localtime_r(&t, &tm);
-#endif
-    return tm;
-}
-
-std::string format_time(std::time_t t) {
-    if (t <= 0) {
-        return "-";
-    }
-    const std::tm tm = local_time(t);
-    std::ostringstream out;
-    out << std::put_time(&tm, "%Y-%m-%d %H:%M:%S");
-    return out.str();
-}
-
-std::string now_string() {
-    return format_time(std::time(nullptr));
-}
-
-std::string format_duration(double seconds) {
-    std::ostringstream out;
-    out << std::fixed << std::setprecision(3) << seconds << "s";
-    return out.str();
-}
-
 std::string lower_copy(std::string value) {
     std::transform(value.begin(), value.end(), value.begin(), [](unsigned char c) {
         return static_cast<char>(std::tolower(c));
@@ -90,69 +28,254 @@ std::string risk_css(const std::string& risk_level) {
     return "risk-low";
 }
 
-std::string report_scan_id(const std::string& scan_id) {
-    const std::string raw_id = scan_id.empty() ? fsutil::timestamp() : scan_id;
-    return fsutil::sanitize_token(raw_id, "scan");
+// Columnar change data for the client-side viewer. Directories and mtime
+// strings are dictionary-encoded; everything else is one array per column in
+// model (path) order. Embedded in a <script> element, so strings are written
+// script-safe.
+void write_change_data(core::OutputBuffer& out, const std::vector<reports::ChangeRecord>& changes) {
+    std::unordered_map<std::string_view, std::size_t> dir_ids;
+    std::unordered_map<std::string_view, std::size_t> mtime_ids;
+    std::vector<std::string_view> dirs;
+    std::vector<std::string_view> mtimes;
+    std::vector<std::size_t> dir_of;
+    std::vector<std::size_t> mtime_of;
+    dir_of.reserve(changes.size());
+    mtime_of.reserve(changes.size());
+
+    for (const reports::ChangeRecord& record : changes) {
+        const std::string_view path = record.entry->path;
+        const std::size_t slash = path.rfind('/');
+        const std::string_view dir = slash == std::string_view::npos ? std::string_view() : path.substr(0, slash + 1);
+        const auto dir_it = dir_ids.emplace(dir, dirs.size());
+        if (dir_it.second) {
+            dirs.push_back(dir);
+        }
+        dir_of.push_back(dir_it.first->second);
+
+        const auto mtime_it = mtime_ids.emplace(record.mtime_text, mtimes.size());
+        if (mtime_it.second) {
+            mtimes.push_back(record.mtime_text);
+        }
+        mtime_of.push_back(mtime_it.first->second);
+    }
+
+    const auto write_strings = [&](const char* key, const std::vector<std::string_view>& values) {
+        out << '"' << key << "\":[";
+        for (std::size_t i = 0; i < values.size(); ++i) {
+            out << (i == 0 ? "\"" : ",\"") << core::script_json_text(values[i]) << '"';
+        }
+        out << ']';
+    };
+    const auto write_ids = [&](const char* key, const std::vector<std::size_t>& values) {
+        out << '"' << key << "\":[";
+        for (std::size_t i = 0; i < values.size(); ++i) {
+            if (i > 0) {
+                out << ',';
+            }
+            out << values[i];
+        }
+        out << ']';
+    };
+
+    out << '{';
+    out << "\"kind\":[";
+    for (std::size_t i = 0; i < changes.size(); ++i) {
+        if (i > 0) {
+            out << ',';
+        }
+        out << static_cast<int>(changes[i].kind);
+    }
+    out << "],";
+    write_strings("dirs", dirs);
+    out << ',';
+    write_ids("dir", dir_of);
+    out << ",\"name\":[";
+    for (std::size_t i = 0; i < changes.size(); ++i) {
+        const std::string_view path = changes[i].entry->path;
+        const std::string_view name = path.substr(dirs[dir_of[i]].size());
+        out << (i == 0 ? "\"" : ",\"") << core::script_json_text(name) << '"';
+    }
+    out << "],\"size\":[";
+    for (std::size_t i = 0; i < changes.size(); ++i) {
+        if (i > 0) {
+            out << ',';
+        }
+        out << changes[i].entry->size;
+    }
+    out << "],";
+    write_strings("mtimes", mtimes);
+    out << ',';
+    write_ids("mtime", mtime_of);
+    out << ",\"hash\":[";
+    for (std::size_t i = 0; i < changes.size(); ++i) {
+        out << (i == 0 ? "\"" : ",\"") << core::script_json_text(changes[i].entry->hash) << '"';
+    }
+    out << "]}";
 }
 
-void write_change_table(std::ofstream& out,
-                        const std::string& title,
-                        const std::string& status_label,
-                        const std::string& pill_class,
-                        const std::vector<const core::FileEntry*>& entries) {
+void write_change_viewer(core::OutputBuffer& out, const reports::ReportModel& model) {
     out << "      <section class='panel'>\n";
     out << "        <div class='panel-head'>\n";
-    out << "          <h2>" << escape_html(title) << "</h2>\n";
-    out << "          <span class='count'>" << entries.size() << "</span>\n";
+    out << "          <h2>Changed Files</h2>\n";
+    out << "          <span class='count' id='change-count'>" << model.changes.size() << "</span>\n";
     out << "        </div>\n";
-    if (entries.empty()) {
-        out << "        <p class='empty'>No entries in this category for this scan.</p>\n";
+    if (model.changes.empty()) {
+        out << "        <p class='empty'>No changed files detected for this scan.</p>\n";
         out << "      </section>\n";
         return;
     }
 
-    out << "        <div class='table-wrap'>\n";
-    out << "          <table>\n";
-    out << "            <thead>\n";
-    out << "              <tr>\n";
-    out << "                <th>Status</th>\n";
-    out << "                <th>Path</th>\n";
-    out << "                <th>Size (bytes)</th>\n";
-    out << "                <th>Modified Time</th>\n";
-    out << "                <th>SHA-256</th>\n";
-    out << "              </tr>\n";
-    out << "            </thead>\n";
-    out << "            <tbody>\n";
-    for (const core::FileEntry* entry : entries) {
-        out << "              <tr>\n";
-        out << "                <td><span class='pill " << pill_class << "'>"
-            << escape_html(status_label) << "</span></td>\n";
-        out << "                <td class='path'><code>" << escape_html(entry->path) << "</code></td>\n";
-        out << "                <td class='num'>" << entry->size << "</td>\n";
-        out << "                <td>" << escape_html(format_time(entry->mtime)) << "</td>\n";
-        out << "                <td class='hash'><code>" << escape_html(entry->hash) << "</code></td>\n";
-        out << "              </tr>\n";
-    }
-    out << "            </tbody>\n";
-    out << "          </table>\n";
+    out << "        <div class='toolbar'>\n";
+    out << "          <input id='change-search' type='search' placeholder='Search path, digest or time' aria-label='Search changes'>\n";
+    out << "          <span class='muted' id='change-visible'></span>\n";
     out << "        </div>\n";
+    out << "        <noscript><p class='empty'>Enable JavaScript to browse the change table.</p></noscript>\n";
+    out << "        <div class='grid-wrap'>\n";
+    out << "          <div class='grid'>\n";
+    out << "            <div class='grow ghead'><span>Status</span><span>Path</span><span class='num'>Size (bytes)</span>"
+        << "<span>Modified Time</span><span>SHA-256</span></div>\n";
+    out << "            <div class='grow gfilter'>\n";
+    out << "              <select id='filter-kind' aria-label='Filter by status'><option value=''>All</option>"
+        << "<option value='0'>NEW</option><option value='1'>MODIFIED</option><option value='2'>DELETED</option></select>\n";
+    out << "              <input id='filter-path' type='text' placeholder='path contains' aria-label='Filter by path'>\n";
+    out << "              <input id='filter-size' type='text' placeholder='&gt;=N or &lt;=N' aria-label='Filter by size'>\n";
+    out << "              <input id='filter-mtime' type='text' placeholder='time starts with' aria-label='Filter by modified time'>\n";
+    out << "              <input id='filter-hash' type='text' placeholder='digest prefix' aria-label='Filter by digest'>\n";
+    out << "            </div>\n";
+    out << "            <div class='viewport' id='change-viewport'>\n";
+    out << "              <div id='change-spacer'></div>\n";
+    out << "              <div id='change-rows'></div>\n";
+    out << "            </div>\n";
+    out << "          </div>\n";
+    out << "        </div>\n";
+    out << "        <script type='application/json' id='change-data'>";
+    write_change_data(out, model.changes);
+    out << "</script>\n";
     out << "      </section>\n";
 }
 
-void write_advisor_list(std::ofstream& out,
+// Renders only the rows inside the viewport (plus a small overscan), so the
+// DOM size stays constant regardless of how many changes the report carries.
+void write_viewer_script(core::OutputBuffer& out) {
+    out << "  <script>\n";
+    out << "    (function () {\n";
+    out << "      var node = document.getElementById('change-data');\n";
+    out << "      if (!node) { return; }\n";
+    out << "      var data = JSON.parse(node.textContent);\n";
+    out << "      var total = data.kind.length;\n";
+    out << "      var labels = ['NEW', 'MODIFIED', 'DELETED'];\n";
+    out << "      var pills = ['pill-new', 'pill-mod', 'pill-del'];\n";
+    out << "      var rowHeight = 34;\n";
+    out << "      var overscan = 12;\n";
+    out << "      var viewport = document.getElementById('change-viewport');\n";
+    out << "      var spacer = document.getElementById('change-spacer');\n";
+    out << "      var rows = document.getElementById('change-rows');\n";
+    out << "      var visible = document.getElementById('change-visible');\n";
+    out << "      var search = document.getElementById('change-search');\n";
+    out << "      var fKind = document.getElementById('filter-kind');\n";
+    out << "      var fPath = document.getElementById('filter-path');\n";
+    out << "      var fSize = document.getElementById('filter-size');\n";
+    out << "      var fTime = document.getElementById('filter-mtime');\n";
+    out << "      var fHash = document.getElementById('filter-hash');\n";
+    out << "      var lowerPaths = null;\n";
+    out << "      var view = [];\n";
+    out << "      function pathAt(i) { return data.dirs[data.dir[i]] + data.name[i]; }\n";
+    out << "      function lowerPath(i) {\n";
+    out << "        if (!lowerPaths) {\n";
+    out << "          lowerPaths = new Array(total);\n";
+    out << "          for (var k = 0; k < total; k++) { lowerPaths[k] = pathAt(k).toLowerCase(); }\n";
+    out << "        }\n";
+    out << "        return lowerPaths[i];\n";
+    out << "      }\n";
+    out << "      function esc(text) {\n";
+    out << "        return String(text).replace(/[&<>\"']/g, function (c) {\n";
+    out << "          return { '&': '&amp;', '<': '&lt;', '>': '&gt;', '\"': '&quot;', \"'\": '&#39;' }[c];\n";
+    out << "        });\n";
+    out << "      }\n";
+    out << "      function sizeTest(text) {\n";
+    out << "        var m = /^\\s*(>=|<=|>|<|=)?\\s*(\\d+)\\s*$/.exec(text);\n";
+    out << "        if (!m) { return null; }\n";
+    out << "        var n = Number(m[2]);\n";
+    out << "        switch (m[1]) {\n";
+    out << "          case '>=': return function (v) { return v >= n; };\n";
+    out << "          case '<=': return function (v) { return v <= n; };\n";
+    out << "          case '>': return function (v) { return v > n; };\n";
+    out << "          case '<': return function (v) { return v < n; };\n";
+    out << "          default: return function (v) { return v === n; };\n";
+    out << "        }\n";
+    out << "      }\n";
+    out << "      function applyFilters() {\n";
+    out << "        var q = search.value.trim().toLowerCase();\n";
+    out << "        var kind = fKind.value === '' ? -1 : Number(fKind.value);\n";
+    out << "        var path = fPath.value.trim().toLowerCase();\n";
+    out << "        var size = sizeTest(fSize.value);\n";
+    out << "        var time = fTime.value.trim();\n";
+    out << "        var hash = fHash.value.trim().toLowerCase();\n";
+    out << "        view = [];\n";
+    out << "        for (var i = 0; i < total; i++) {\n";
+    out << "          if (kind >= 0 && data.kind[i] !== kind) { continue; }\n";
+    out << "          if (path && lowerPath(i).indexOf(path) < 0) { continue; }\n";
+    out << "          if (size && !size(data.size[i])) { continue; }\n";
+    out << "          if (time && data.mtimes[data.mtime[i]].lastIndexOf(time, 0) !== 0) { continue; }\n";
+    out << "          if (hash && data.hash[i].lastIndexOf(hash, 0) !== 0) { continue; }\n";
+    out << "          if (q && lowerPath(i).indexOf(q) < 0 && data.hash[i].indexOf(q) < 0 &&\n";
+    out << "              data.mtimes[data.mtime[i]].indexOf(q) < 0) { continue; }\n";
+    out << "          view.push(i);\n";
+    out << "        }\n";
+    out << "        spacer.style.height = (view.length * rowHeight) + 'px';\n";
+    out << "        visible.textContent = view.length === total ? total + ' rows' : view.length + ' of ' + total + ' rows';\n";
+    out << "        viewport.scrollTop = 0;\n";
+    out << "        render();\n";
+    out << "      }\n";
+    out << "      function render() {\n";
+    out << "        var first = Math.max(0, Math.floor(viewport.scrollTop / rowHeight) - overscan);\n";
+    out << "        var last = Math.min(view.length, Math.ceil((viewport.scrollTop + viewport.clientHeight) / rowHeight) + overscan);\n";
+    out << "        var html = [];\n";
+    out << "        for (var r = first; r < last; r++) {\n";
+    out << "          var i = view[r];\n";
+    out << "          var p = esc(pathAt(i));\n";
+    out << "          html.push(\"<div class='grow vrow' style='top:\" + (r * rowHeight) + \"px'>\" +\n";
+    out << "            \"<span><span class='pill \" + pills[data.kind[i]] + \"'>\" + labels[data.kind[i]] + '</span></span>' +\n";
+    out << "            \"<span class='path' title='\" + p + \"'><code>\" + p + '</code></span>' +\n";
+    out << "            \"<span class='num'>\" + data.size[i] + '</span>' +\n";
+    out << "            '<span>' + esc(data.mtimes[data.mtime[i]]) + '</span>' +\n";
+    out << "            \"<span class='hash'><code>\" + esc(data.hash[i]) + '</code></span></div>');\n";
+    out << "        }\n";
+    out << "        rows.innerHTML = html.join('');\n";
+    out << "      }\n";
+    out << "      var timer = null;\n";
+    out << "      function schedule() {\n";
+    out << "        if (timer) { clearTimeout(timer); }\n";
+    out << "        timer = setTimeout(function () { timer = null; applyFilters(); }, 150);\n";
+    out << "      }\n";
+    out << "      [search, fPath, fSize, fTime, fHash].forEach(function (input) { input.addEventListener('input', schedule); });\n";
+    out << "      fKind.addEventListener('change', applyFilters);\n";
+    out << "      var framePending = false;\n";
+    out << "      viewport.addEventListener('scroll', function () {\n";
+    out << "        if (framePending) { return; }\n";
+    out << "        framePending = true;\n";
+    out << "        window.requestAnimationFrame(function () { framePending = false; render(); });\n";
+    out << "      });\n";
+    out << "      window.addEventListener('resize', render);\n";
+    out << "      applyFilters();\n";
+    out << "    })();\n";
+    out << "  </script>\n";
+}
+
+void write_advisor_list(core::OutputBuffer& out,
                         const std::string& title,
                         const std::vector<std::string>& lines,
                         const std::string& empty_text) {
     out << "          <article class='advisor-card'>\n";
-    out << "            <h3>" << escape_html(title) << "</h3>\n";
+    out << "            <h3>" << core::html_text(title) << "</h3>\n";
     if (lines.empty()) {
-        out << "            <p class='muted'>" << escape_html(empty_text) << "</p>\n";
+        out << "            <p class='muted'>" << core::html_text(empty_text) << "</p>\n";
         out << "          </article>\n";
         return;
     }
     out << "            <ul>\n";
     for (const std::string& line : lines) {
-        out << "              <li>" << escape_html(line) << "</li>\n";
+        out << "              <li>" << core::html_text(line) << "</li>\n";
     }
     out << "            </ul>\n";
     out << "          </article>\n";
@@ -162,21 +285,17 @@ void write_advisor_list(std::ofstream& out,
 
 namespace reports {
 
-std::string write_html(const scanner::ScanResult& result, const std::string& scan_id) {
-    const std::string id = report_scan_id(scan_id);
+std::string write_html(const ReportModel& model) {
     const std::string file =
-        config::REPORT_HTML_DIR + "/sentinel-c_integrity_html_report_" + id + ".html";
+        config::REPORT_HTML_DIR + "/sentinel-c_integrity_html_report_" + model.scan_id + ".html";
 
-    std::ofstream out(file, std::ios::trunc);
-    if (!out.is_open()) {
+    core::OutputBuffer out;
+    if (!out.open(file)) {
         return "";
     }
 
-    const AdvisorNarrative narrative = advisor_narrative(result);
-    const auto added = sorted_entries(result.added);
-    const auto modified = sorted_entries(result.modified);
-    const auto deleted = sorted_entries(result.deleted);
-    const bool clean = advisor_status(result) == "clean";
+    const AdvisorNarrative& narrative = model.narrative;
+    const bool clean = model.clean();
     const std::string status = clean ? "CLEAN" : "CHANGES_DETECTED";
     const std::string risk_level = narrative.risk_level.empty() ? (clean ? "low" : "medium")
                                                                  : narrative.risk_level;
@@ -186,7 +305,7 @@ std::string write_html(const scanner::ScanResult& result, const std::string& sca
     out << "<head>\n";
     out << "  <meta charset='UTF-8'>\n";
     out << "  <meta name='viewport' content='width=device-width, initial-scale=1.0'>\n";
-    out << "  <title>" << escape_html(config::TOOL_NAME) << " Report</title>\n";
+    out << "  <title>" << core::html_text(config::TOOL_NAME) << " Report</title>\n";
     out << "  <style>\n";
     out << "    :root {\n";
     out << "      --bg:#eef3f8;\n";
@@ -287,15 +406,22 @@ std::string write_html(const scanner::ScanResult& result, const std::string& sca
     out << "    h2 { margin:0; font-size:18px; }\n";
     out << "    .count { background:var(--panel-alt); border:1px solid var(--line); border-radius:999px; padding:4px 10px; font-size:12px; color:var(--muted); }\n";
     out << "    .empty { margin:12px 0 2px; color:var(--muted); }\n";
-    out << "    .table-wrap { overflow:auto; margin-top:12px; }\n";
-    out << "    table { width:100%; border-collapse:collapse; min-width:760px; }\n";
-    out << "    th, td { border-bottom:1px solid var(--line); padding:10px 8px; vertical-align:top; text-align:left; }\n";
-    out << "    th { font-size:12px; color:var(--muted); text-transform:uppercase; letter-spacing:0.5px; }\n";
-    out << "    td { font-size:13px; }\n";
-    out << "    td.num { text-align:right; white-space:nowrap; }\n";
-    out << "    td.path code, td.hash code { font-family:\"IBM Plex Mono\",\"Consolas\",\"Menlo\",monospace; font-size:12px; }\n";
-    out << "    td.path code { word-break:break-word; }\n";
-    out << "    td.hash code { color:#3c5162; }\n";
+    out << "    .toolbar { display:flex; align-items:center; gap:12px; margin-top:12px; flex-wrap:wrap; }\n";
+    out << "    .toolbar input { flex:1 1 320px; }\n";
+    out << "    input, select { font:inherit; font-size:13px; color:var(--ink); background:var(--panel-alt); border:1px solid var(--line); border-radius:8px; padding:6px 8px; min-width:0; }\n";
+    out << "    .grid-wrap { overflow-x:auto; margin-top:12px; }\n";
+    out << "    .grid { min-width:960px; }\n";
+    out << "    .grow { display:grid; grid-template-columns:110px minmax(280px,2fr) 110px 170px minmax(220px,1.4fr); gap:8px; align-items:center; padding:0 8px; }\n";
+    out << "    .grow > span { overflow:hidden; text-overflow:ellipsis; white-space:nowrap; font-size:13px; }\n";
+    out << "    .ghead { border-bottom:1px solid var(--line); padding-top:6px; padding-bottom:6px; }\n";
+    out << "    .ghead > span { font-size:12px; color:var(--muted); text-transform:uppercase; letter-spacing:0.5px; }\n";
+    out << "    .gfilter { border-bottom:1px solid var(--line); padding-top:6px; padding-bottom:6px; }\n";
+    out << "    .viewport { position:relative; height:560px; overflow-y:auto; }\n";
+    out << "    #change-rows { position:absolute; top:0; left:0; right:0; }\n";
+    out << "    .vrow { position:absolute; left:0; right:0; height:34px; border-bottom:1px solid var(--line); }\n";
+    out << "    .grow .num { text-align:right; }\n";
+    out << "    .grow .path code, .grow .hash code { font-family:\"IBM Plex Mono\",\"Consolas\",\"Menlo\",monospace; font-size:12px; }\n";
+    out << "    .grow .hash code { color:#3c5162; }\n";
     out << "    .pill { border-radius:999px; padding:4px 9px; font-size:11px; font-weight:700; letter-spacing:0.45px; display:inline-block; }\n";
     out << "    .pill-new { background:#e8f7ef; color:#15653f; }\n";
     out << "    .pill-mod { background:#fff3de; color:#875100; }\n";
@@ -314,7 +440,7 @@ std::string write_html(const scanner::ScanResult& result, const std::string& sca
     out << "    body.theme-dark .meta-item span { color:#bfd3e7; }\n";
     out << "    body.theme-dark .theme-toggle { background:rgba(0,0,0,0.22); border-color:rgba(255,255,255,0.22); }\n";
     out << "    body.theme-dark .theme-toggle:hover { background:rgba(0,0,0,0.36); }\n";
-    out << "    body.theme-dark td.hash code { color:#9eb6cb; }\n";
+    out << "    body.theme-dark .grow .hash code { color:#9eb6cb; }\n";
     out << "    body.theme-dark .advisor-summary { color:#cbdcf0; }\n";
     out << "    @media (max-width: 760px) {\n";
     out << "      .page { margin-top:16px; padding:0 12px; }\n";
@@ -330,7 +456,7 @@ std::string write_html(const scanner::ScanResult& result, const std::string& sca
     out << "    <header class='hero'>\n";
     out << "      <div class='hero-top'>\n";
     out << "        <div>\n";
-    out << "          <h1>" << escape_html(config::TOOL_NAME + " " + config::VERSION) << " Integrity Report</h1>\n";
+    out << "          <h1>" << core::html_text(config::TOOL_NAME + " " + config::VERSION) << " Integrity Report</h1>\n";
     out << "          <p class='subtitle'>Structured host integrity evidence for operations and audits.</p>\n";
     out << "        </div>\n";
     out << "        <div class='actions'>\n";
@@ -338,37 +464,35 @@ std::string write_html(const scanner::ScanResult& result, const std::string& sca
     out << "          <div class='badges'>\n";
     out << "            <span class='badge " << (clean ? "status-clean" : "status-change") << "'>STATUS: " << status << "</span>\n";
     out << "            <span class='badge " << risk_css(risk_level) << "'>RISK: "
-        << escape_html(lower_copy(risk_level)) << "</span>\n";
+        << core::html_text(lower_copy(risk_level)) << "</span>\n";
     out << "          </div>\n";
     out << "        </div>\n";
     out << "      </div>\n";
     out << "      <div class='meta'>\n";
-    out << "        <div class='meta-item'><span>Scan ID</span><strong>" << escape_html(id) << "</strong></div>\n";
-    out << "        <div class='meta-item'><span>Generated</span><strong>" << escape_html(now_string()) << "</strong></div>\n";
+    out << "        <div class='meta-item'><span>Scan ID</span><strong>" << core::html_text(model.scan_id) << "</strong></div>\n";
+    out << "        <div class='meta-item'><span>Generated</span><strong>" << core::html_text(model.generated_at) << "</strong></div>\n";
     out << "        <div class='meta-item'><span>Tool</span><strong>"
-        << escape_html(config::TOOL_NAME + " " + config::VERSION) << "</strong></div>\n";
+        << core::html_text(config::TOOL_NAME + " " + config::VERSION) << "</strong></div>\n";
     out << "      </div>\n";
     out << "    </header>\n";
     out << "    <section class='kpis'>\n";
-    out << "      <article class='kpi'><span>Files Scanned</span><strong>" << result.stats.scanned << "</strong></article>\n";
-    out << "      <article class='kpi ok'><span>New Files</span><strong>" << result.stats.added << "</strong></article>\n";
-    out << "      <article class='kpi warn'><span>Modified Files</span><strong>" << result.stats.modified << "</strong></article>\n";
-    out << "      <article class='kpi danger'><span>Deleted Files</span><strong>" << result.stats.deleted << "</strong></article>\n";
-    out << "      <article class='kpi'><span>Duration</span><strong>" << escape_html(format_duration(result.stats.duration))
+    out << "      <article class='kpi'><span>Files Scanned</span><strong>" << model.stats.scanned << "</strong></article>\n";
+    out << "      <article class='kpi ok'><span>New Files</span><strong>" << model.stats.added << "</strong></article>\n";
+    out << "      <article class='kpi warn'><span>Modified Files</span><strong>" << model.stats.modified << "</strong></article>\n";
+    out << "      <article class='kpi danger'><span>Deleted Files</span><strong>" << model.stats.deleted << "</strong></article>\n";
+    out << "      <article class='kpi'><span>Duration</span><strong>" << core::fixed(model.stats.duration, 3) << "s"
         << "</strong></article>\n";
     out << "    </section>\n";
 
-    write_change_table(out, "New Files", "NEW", "pill-new", added);
-    write_change_table(out, "Modified Files", "MODIFIED", "pill-mod", modified);
-    write_change_table(out, "Deleted Files", "DELETED", "pill-del", deleted);
+    write_change_viewer(out, model);
 
     out << "    <section class='panel'>\n";
     out << "      <div class='panel-head'>\n";
     out << "        <h2>Guidance</h2>\n";
     out << "        <span class='count " << risk_css(risk_level) << "'>risk: "
-        << escape_html(lower_copy(risk_level)) << "</span>\n";
+        << core::html_text(lower_copy(risk_level)) << "</span>\n";
     out << "      </div>\n";
-    out << "      <p class='advisor-summary'>" << escape_html(narrative.summary) << "</p>\n";
+    out << "      <p class='advisor-summary'>" << core::html_text(narrative.summary) << "</p>\n";
     std::vector<std::string> guidance_lines;
     guidance_lines.reserve(narrative.whys.size() +
                            narrative.what_matters.size() +
@@ -384,9 +508,10 @@ std::string write_html(const scanner::ScanResult& result, const std::string& sca
                        "No extra guidance was needed for this scan.");
     out << "      </div>\n";
     out << "    </section>\n";
-    out << "    <p class='foot'>Generated by " << escape_html(config::TOOL_NAME + " " + config::VERSION)
+    out << "    <p class='foot'>Generated by " << core::html_text(config::TOOL_NAME + " " + config::VERSION)
         << " &middot; local-first reporting</p>\n";
     out << "  </main>\n";
+    write_viewer_script(out);
     out << "  <script>\n";
     out << "    (function () {\n";
     out << "      var key = 'sentinel-c-report-theme';\n";
@@ -413,7 +538,7 @@ std::string write_html(const scanner::ScanResult& result, const std::string& sca
     out << "</body>\n";
     out << "</html>\n";
 
-    return file;
+    return out.close() ? file : "";
 }
 
 } // namespace reports
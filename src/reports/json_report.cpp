@@ -1,79 +1,25 @@
 #include "json_report.h"
-#include "advice.h"
 #include "../core/config.h"
-#include "../core/fsutil.h"
-#include <algorithm>
-#include <ctime>
-#include <fstream>
-#include <iomanip>
-#include <sstream>
+#include "../core/output_buffer.h"
 #include <string>
 #include <vector>
 
 namespace {
 
-std::string escape_json(const std::string& text) {
-    std::string out;
-    out.reserve(text.size());
-    for (char c : text) {
-        switch (c) {
-            case '\\': out += "\\\\"; break;
-            case '"': out += "\\\""; break;
-            case '\b': out += "\\b"; break;
-            case '\f': out += "\\f"; break;
-            case '\n': out += "\\n"; break;
-            case '\r': out += "\\r"; break;
-            case '\t': out += "\\t"; break;
-            default: out += c; break;
-        }
-    }
-    return out;
-}
-
-std::string format_mtime(std::time_t timestamp) {
-    if (timestamp <= 0) {
-        return "-";
-    }
-
-    std::tm tm{};
-#ifdef _WIN32
-    localtime_s(&tm, &timestamp);
-#else
-    localtime_r(&timestamp, &tm);
-#endif
-
-    std::ostringstream out;
-    out << std::put_time(&tm, "%Y-%m-%d %H:%M:%S");
-    return out.str();
-}
-
-std::vector<const core::FileEntry*> sorted_entries(const scanner::FileMap& data) {
-    std::vector<const core::FileEntry*> entries;
-    entries.reserve(data.size());
-    for (const auto& item : data) {
-        entries.push_back(&item.second);
-    }
-    std::sort(entries.begin(), entries.end(), [](const core::FileEntry* left, const core::FileEntry* right) {
-        return left->path < right->path;
-    });
-    return entries;
-}
-
-void write_entries(std::ofstream& out,
+void write_entries(core::OutputBuffer& out,
                    const char* name,
-                   const scanner::FileMap& data,
+                   const std::vector<const reports::ChangeRecord*>& entries,
                    bool trailing_comma) {
-    const auto entries = sorted_entries(data);
-
     out << "  \"" << name << "\": [\n";
     for (std::size_t index = 0; index < entries.size(); ++index) {
-        const core::FileEntry& entry = *entries[index];
+        const reports::ChangeRecord& record = *entries[index];
+        const core::FileEntry& entry = *record.entry;
         out << "    {"
-            << "\"path\":\"" << escape_json(entry.path) << "\"," 
+            << "\"path\":\"" << core::json_text(entry.path) << "\"," 
             << "\"size\":" << entry.size << ","
             << "\"mtime\":" << entry.mtime << ","
-            << "\"mtime_text\":\"" << escape_json(format_mtime(entry.mtime)) << "\"," 
-            << "\"sha256\":\"" << escape_json(entry.hash) << "\""
+            << "\"mtime_text\":\"" << core::json_text(record.mtime_text) << "\"," 
+            << "\"sha256\":\"" << core::json_text(entry.hash) << "\""
             << "}";
         if (index + 1 < entries.size()) {
             out << ",";
@@ -87,13 +33,13 @@ void write_entries(std::ofstream& out,
     out << "\n";
 }
 
-void write_string_array(std::ofstream& out,
+void write_string_array(core::OutputBuffer& out,
                         const char* key,
                         const std::vector<std::string>& values,
                         bool trailing_comma) {
     out << "    \"" << key << "\": [\n";
     for (std::size_t i = 0; i < values.size(); ++i) {
-        out << "      \"" << escape_json(values[i]) << "\"";
+        out << "      \"" << core::json_text(values[i]) << "\"";
         if (i + 1 < values.size()) {
             out << ",";
         }
@@ -106,42 +52,77 @@ void write_string_array(std::ofstream& out,
     out << "\n";
 }
 
+void write_histogram(core::OutputBuffer& out, const char* key, const core::Histogram& histogram, bool trailing_comma) {
+    out << "    \"" << key << "\": {\"count\": " << histogram.count() << ", \"min\": " << histogram.min()
+        << ", \"mean\": " << histogram.mean() << ", \"p50\": " << histogram.percentile(0.50)
+        << ", \"p90\": " << histogram.percentile(0.90) << ", \"p99\": " << histogram.percentile(0.99)
+        << ", \"p999\": " << histogram.percentile(0.999) << ", \"max\": " << histogram.max() << ", \"buckets\": [";
+    const std::vector<core::Histogram::Bucket> buckets = histogram.buckets();
+    for (std::size_t i = 0; i < buckets.size(); ++i) {
+        out << (i == 0 ? "[" : ", [") << buckets[i].low << ", " << buckets[i].high << ", " << buckets[i].count << ']';
+    }
+    out << "]}" << (trailing_comma ? ",\n" : "\n");
+}
+
+// Per-file hash latency, sizes, throughput and slowest files of the scan.
+void write_distribution(core::OutputBuffer& out, const core::ScanDistribution& distribution) {
+    out << "  \"distribution\": {\n";
+    write_histogram(out, "hash_latency_us", distribution.hash_micros, true);
+    write_histogram(out, "file_size_bytes", distribution.file_bytes, true);
+    out << "    \"throughput\": {\"interval_seconds\": " << distribution.throughput.interval()
+        << ", \"peak_bytes_per_second\": " << distribution.throughput.peak_rate()
+        << ", \"mean_bytes_per_second\": " << distribution.throughput.mean_rate() << ", \"bytes\": [";
+    const std::vector<std::uint64_t>& series = distribution.throughput.bytes();
+    for (std::size_t i = 0; i < series.size(); ++i) {
+        out << (i == 0 ? "" : ", ") << series[i];
+    }
+    out << "]},\n";
+    out << "    \"slowest\": [\n";
+    for (std::size_t i = 0; i < distribution.slowest.size(); ++i) {
+        const core::SlowFile& file = distribution.slowest[i];
+        out << "      {\"path\":\"" << core::json_text(file.path) << "\",\"size\":" << file.size
+            << ",\"seconds\":" << file.seconds << '}' << (i + 1 < distribution.slowest.size() ? ",\n" : "\n");
+    }
+    out << "    ]\n";
+    out << "  },\n";
+}
+
 } // namespace
 
 namespace reports {
 
-std::string write_json(const scanner::ScanResult& result, const std::string& scan_id) {
-    const std::string raw_id = scan_id.empty() ? fsutil::timestamp() : scan_id;
-    const std::string id = fsutil::sanitize_token(raw_id, "scan");
+std::string write_json(const ReportModel& model) {
     const std::string file =
-        config::REPORT_JSON_DIR + "/sentinel-c_integrity_json_report_" + id + ".json";
+        config::REPORT_JSON_DIR + "/sentinel-c_integrity_json_report_" + model.scan_id + ".json";
 
-    std::ofstream out(file, std::ios::trunc);
-    if (!out.is_open()) {
+    core::OutputBuffer out;
+    if (!out.open(file)) {
         return "";
     }
 
-    const AdvisorNarrative narrative = advisor_narrative(result);
-    const std::string status = advisor_status(result);
+    const AdvisorNarrative& narrative = model.narrative;
 
     out << "{\n";
-    out << "  \"version\": \"" << escape_json(config::VERSION) << "\",\n";
-    out << "  \"scan_id\": \"" << escape_json(id) << "\",\n";
-    out << "  \"generated_at\": \"" << escape_json(format_mtime(std::time(nullptr))) << "\",\n";
-    out << "  \"status\": \"" << status << "\",\n";
+    out << "  \"version\": \"" << core::json_text(config::VERSION) << "\",\n";
+    out << "  \"scan_id\": \"" << core::json_text(model.scan_id) << "\",\n";
+    out << "  \"generated_at\": \"" << core::json_text(model.generated_at) << "\",\n";
+    out << "  \"status\": \"" << model.status << "\",\n";
     out << "  \"stats\": {\n";
-    out << "    \"scanned\": " << result.stats.scanned << ",\n";
-    out << "    \"added\": " << result.stats.added << ",\n";
-    out << "    \"modified\": " << result.stats.modified << ",\n";
-    out << "    \"deleted\": " << result.stats.deleted << ",\n";
-    out << "    \"duration\": " << result.stats.duration << "\n";
+    out << "    \"scanned\": " << model.stats.scanned << ",\n";
+    out << "    \"added\": " << model.stats.added << ",\n";
+    out << "    \"modified\": " << model.stats.modified << ",\n";
+    out << "    \"deleted\": " << model.stats.deleted << ",\n";
+    out << "    \"duration\": " << model.stats.duration << "\n";
     out << "  },\n";
-    write_entries(out, "new", result.added, true);
-    write_entries(out, "modified", result.modified, true);
-    write_entries(out, "deleted", result.deleted, true);
+    if (!model.stats.distribution.empty()) {
+        write_distribution(out, model.stats.distribution);
+    }
+    write_entries(out, "new", model.added, true);
+    write_entries(out, "modified", model.modified, true);
+    write_entries(out, "deleted", model.deleted, true);
     out << "  \"advisor\": {\n";
-    out << "    \"summary\": \"" << escape_json(narrative.summary) << "\",\n";
-    out << "    \"risk_level\": \"" << escape_json(narrative.risk_level) << "\",\n";
+    out << "    \"summary\": \"" << core::json_text(narrative.summary) << "\",\n";
+    out << "    \"risk_level\": \"" << core::json_text(narrative.risk_level) << "\",\n";
     write_string_array(out, "whys", narrative.whys, true);
     write_string_array(out, "what_matters", narrative.what_matters, true);
     write_string_array(out, "teaching", narrative.teaching, true);
@@ -149,7 +130,7 @@ std::string write_json(const scanner::ScanResult& result, const std::string& sca
     out << "  }\n";
     out << "}\n";
 
-    return file;
+    return out.close() ? file : "";
 }
 
 } // namespace reports
\ No newline at end of file
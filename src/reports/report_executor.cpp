@@ -0,0 +1,250 @@
+#include "report_executor.h"
+#include "cli_report.h"
+#include "columnar_report.h"
+#include "csv_report.h"
+#include "html_report.h"
+#include "json_report.h"
+#include "report_manifest.h"
+#include "../core/memory.h"
+#include "../core/profiler.h"
+#include "../core/trace.h"
+#include <algorithm>
+#include <ctime>
+#include <exception>
+#include <filesystem>
+#include <utility>
+
+namespace reports {
+
+namespace {
+
+// Adds every report the batch wrote to the manifest in one append.
+void record_outputs(const std::string& scan_id, ReportBatchResult& outcome) {
+    const std::pair<const char*, const std::string*> written[] = {
+        {"cli", &outcome.cli}, {"html", &outcome.html}, {"json", &outcome.json},
+        {"csv", &outcome.csv}, {"columnar", &outcome.columnar}};
+    const std::time_t now = std::time(nullptr);
+    std::vector<ManifestEntry> entries;
+    for (const auto& item : written) {
+        const std::string& path = *item.second;
+        if (path.empty() || path == "N/A") {
+            continue;
+        }
+        ManifestEntry entry;
+        entry.type = item.first;
+        entry.path = path;
+        std::error_code ec;
+        entry.size = std::filesystem::file_size(path, ec);
+        if (ec) {
+            entry.size = 0;
+        }
+        entry.scan_id = scan_id;
+        entry.written = now;
+        entries.push_back(std::move(entry));
+    }
+    std::string error;
+    if (!manifest_record(entries, &error)) {
+        outcome.warnings.push_back("Report manifest not updated: " + error);
+    }
+}
+
+} // namespace
+
+ReportExecutor::ReportExecutor(std::size_t workers, std::size_t max_pending)
+    : max_pending_(std::max<std::size_t>(1, max_pending)) {
+    const std::size_t count = std::max<std::size_t>(1, workers);
+    workers_.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        workers_.emplace_back([this]() { worker_loop(); });
+    }
+}
+
+ReportExecutor::~ReportExecutor() {
+    drain();
+    {
+        std::lock_guard<std::mutex> guard(lock_);
+        stopping_ = true;
+    }
+    work_ready_.notify_all();
+    for (std::thread& worker : workers_) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+std::shared_future<ReportBatchResult> ReportExecutor::submit(
+    std::shared_ptr<const scanner::ScanResult> result,
+    const std::string& scan_id,
+    const ReportSelection& selection,
+    ReportCallback on_done) {
+    auto batch = std::make_shared<Batch>();
+    batch->result = std::move(result);
+    batch->scan_id = scan_id;
+    batch->on_done = std::move(on_done);
+    // Workers pop from the back, so CLI starts first as it did before.
+    if (selection.columnar) {
+        batch->todo.push_back(Format::Columnar);
+    }
+    if (selection.csv) {
+        batch->todo.push_back(Format::Csv);
+    }
+    if (selection.json) {
+        batch->todo.push_back(Format::Json);
+    }
+    if (selection.html) {
+        batch->todo.push_back(Format::Html);
+    }
+    if (selection.cli) {
+        batch->todo.push_back(Format::Cli);
+    }
+    std::shared_future<ReportBatchResult> future = batch->promise.get_future().share();
+    if (batch->todo.empty()) {
+        complete(*batch);
+        return future;
+    }
+
+    std::vector<std::shared_ptr<Batch>> dropped;
+    {
+        std::lock_guard<std::mutex> guard(lock_);
+        std::size_t waiting = static_cast<std::size_t>(
+            std::count_if(queue_.begin(), queue_.end(),
+                          [](const std::shared_ptr<Batch>& item) { return !item->started; }));
+        while (waiting >= max_pending_) {
+            const auto oldest = std::find_if(queue_.begin(), queue_.end(),
+                                             [](const std::shared_ptr<Batch>& item) { return !item->started; });
+            dropped.push_back(*oldest);
+            queue_.erase(oldest);
+            --waiting;
+            ++dropped_;
+        }
+        queue_.push_back(batch);
+    }
+    work_ready_.notify_all();
+
+    for (const std::shared_ptr<Batch>& item : dropped) {
+        item->outcome.dropped = true;
+        complete(*item);
+    }
+    return future;
+}
+
+void ReportExecutor::drain() {
+    std::unique_lock<std::mutex> guard(lock_);
+    idle_.wait(guard, [this]() { return queue_.empty() && active_ == 0; });
+}
+
+std::size_t ReportExecutor::dropped() const {
+    std::lock_guard<std::mutex> guard(lock_);
+    return dropped_;
+}
+
+void ReportExecutor::worker_loop() {
+    memory::Scope area(memory::Area::Reports);
+    if (trace::active()) {
+        trace::name_thread("report worker");
+    }
+    while (true) {
+        std::shared_ptr<Batch> batch;
+        Format format = Format::Cli;
+        {
+            std::unique_lock<std::mutex> guard(lock_);
+            work_ready_.wait(guard, [this]() { return stopping_ || !queue_.empty(); });
+            if (queue_.empty()) {
+                return;
+            }
+            batch = queue_.front();
+            format = batch->todo.back();
+            batch->todo.pop_back();
+            batch->started = true;
+            ++batch->running;
+            ++active_;
+            if (batch->todo.empty()) {
+                queue_.pop_front();
+            }
+        }
+
+        std::string path;
+        std::string error;
+        {
+            profiler::Scope scope(core::Phase::Report);
+            const char* span_name = "report csv";
+            switch (format) {
+                case Format::Cli: span_name = "report cli"; break;
+                case Format::Html: span_name = "report html"; break;
+                case Format::Json: span_name = "report json"; break;
+                case Format::Csv: break;
+                case Format::Columnar: span_name = "report columnar"; break;
+            }
+            trace::Span span(span_name, "report");
+            try {
+                std::call_once(batch->model_once, [&batch]() {
+                    batch->model = build_report_model(*batch->result, batch->scan_id);
+                });
+                switch (format) {
+                    case Format::Cli: path = write_cli(batch->model); break;
+                    case Format::Html: path = write_html(batch->model); break;
+                    case Format::Json: path = write_json(batch->model); break;
+                    case Format::Csv: path = write_csv(batch->model); break;
+                    case Format::Columnar: path = write_columnar(batch->model); break;
+                }
+            } catch (const std::exception& ex) {
+                error = ex.what();
+            } catch (...) {
+                error = "unknown error";
+            }
+            if (!error.empty() || path.empty()) {
+                scope.add_error();
+            } else if (profiler::enabled()) {
+                std::error_code ec;
+                const std::uintmax_t size = std::filesystem::file_size(path, ec);
+                scope.add_files();
+                scope.add_bytes(ec ? 0 : size);
+            }
+        }
+
+        bool finished = false;
+        {
+            std::lock_guard<std::mutex> guard(lock_);
+            const char* label = "CSV";
+            std::string* slot = &batch->outcome.csv;
+            switch (format) {
+                case Format::Cli: label = "CLI"; slot = &batch->outcome.cli; break;
+                case Format::Html: label = "HTML"; slot = &batch->outcome.html; break;
+                case Format::Json: label = "JSON"; slot = &batch->outcome.json; break;
+                case Format::Csv: break;
+                case Format::Columnar: label = "Columnar"; slot = &batch->outcome.columnar; break;
+            }
+            *slot = path;
+            if (!error.empty()) {
+                batch->outcome.errors.push_back(std::string("Failed to generate ") + label + " report: " + error);
+            } else if (path.empty()) {
+                batch->outcome.warnings.push_back(std::string(label) +
+                                                  " report generation returned empty output path.");
+            }
+            --batch->running;
+            finished = batch->todo.empty() && batch->running == 0;
+        }
+        if (finished) {
+            record_outputs(batch->scan_id, batch->outcome);
+            complete(*batch);
+        }
+
+        {
+            std::lock_guard<std::mutex> guard(lock_);
+            --active_;
+            if (queue_.empty() && active_ == 0) {
+                idle_.notify_all();
+            }
+        }
+    }
+}
+
+void ReportExecutor::complete(Batch& batch) {
+    batch.promise.set_value(batch.outcome);
+    if (batch.on_done) {
+        batch.on_done(batch.outcome);
+    }
+}
+
+} // namespace reports
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "report_model.h"
+
+namespace reports {
+
+struct ReportSelection {
+    bool cli = true;
+    bool html = true;
+    bool json = true;
+    bool csv = true;
+    // Opt-in: only written when requested by name or through "all".
+    bool columnar = false;
+};
+
+struct ReportBatchResult {
+    // Written file per format: "N/A" when not selected, empty when it failed.
+    std::string cli = "N/A";
+    std::string html = "N/A";
+    std::string json = "N/A";
+    std::string csv = "N/A";
+    std::string columnar = "N/A";
+    std::vector<std::string> errors;
+    std::vector<std::string> warnings;
+    // True when a newer batch replaced this one before any writer started.
+    bool dropped = false;
+};
+
+using ReportCallback = std::function<void(const ReportBatchResult&)>;
+
+// Long-lived pool that writes report batches (one batch = the selected formats
+// for one scan). Formats of a batch run in parallel; the ReportModel is built
+// lazily by the first worker that picks the batch up, so the submitting thread
+// only pays for the enqueue.
+//
+// At most `max_pending` batches wait for a worker. Submitting past that drops
+// the oldest waiting batch: watch cycles all compare against the same baseline,
+// so a newer batch already covers every change an older one would report.
+class ReportExecutor {
+public:
+    explicit ReportExecutor(std::size_t workers = 4, std::size_t max_pending = 2);
+    // Finishes every queued batch before joining the workers.
+    ~ReportExecutor();
+    ReportExecutor(const ReportExecutor&) = delete;
+    ReportExecutor& operator=(const ReportExecutor&) = delete;
+
+    // `result` must stay valid until the batch completes; pass an owning pointer
+    // when the caller does not wait. `on_done` runs on a worker thread (or on the
+    // submitting thread for a batch dropped by this call).
+    std::shared_future<ReportBatchResult> submit(std::shared_ptr<const scanner::ScanResult> result,
+                                                 const std::string& scan_id,
+                                                 const ReportSelection& selection,
+                                                 ReportCallback on_done = {});
+    // Blocks until nothing is queued or running.
+    void drain();
+    std::size_t dropped() const;
+
+private:
+    enum class Format { Cli, Html, Json, Csv, Columnar };
+
+    struct Batch {
+        std::shared_ptr<const scanner::ScanResult> result;
+        std::string scan_id;
+        std::once_flag model_once;
+        ReportModel model;
+        std::vector<Format> todo;
+        std::size_t running = 0;
+        bool started = false;
+        ReportBatchResult outcome;
+        std::promise<ReportBatchResult> promise;
+        ReportCallback on_done;
+    };
+
+    void worker_loop();
+    static void complete(Batch& batch);
+
+    mutable std::mutex lock_;
+    std::condition_variable work_ready_;
+    std::condition_variable idle_;
+    std::deque<std::shared_ptr<Batch>> queue_;
+    std::size_t active_ = 0;
+    std::size_t max_pending_;
+    std::size_t dropped_ = 0;
+    bool stopping_ = false;
+    std::vector<std::thread> workers_;
+};
+
+} // namespace reports
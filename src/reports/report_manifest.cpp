@@ -0,0 +1,333 @@
+#include "report_manifest.h"
+#include "../core/config.h"
+#include "../core/fsutil.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string_view>
+#include <system_error>
+#include <unordered_map>
+
+namespace fs = std::filesystem;
+
+namespace reports {
+
+namespace {
+
+const char kHeader[] = "# sentinel-c report manifest v1\n";
+
+void append_field(std::string& line, std::string_view value) {
+    for (const char ch : value) {
+        switch (ch) {
+            case '\\': line += "\\\\"; break;
+            case '\t': line += "\\t"; break;
+            case '\n': line += "\\n"; break;
+            case '\r': line += "\\r"; break;
+            default: line += ch; break;
+        }
+    }
+}
+
+std::string unescape_field(std::string_view value) {
+    if (value.find('\\') == std::string_view::npos) {
+        return std::string(value);
+    }
+    std::string out;
+    out.reserve(value.size());
+    for (std::size_t i = 0; i < value.size(); ++i) {
+        if (value[i] != '\\' || i + 1 == value.size()) {
+            out += value[i];
+            continue;
+        }
+        const char next = value[++i];
+        out += next == 't' ? '\t' : next == 'n' ? '\n' : next == 'r' ? '\r' : next;
+    }
+    return out;
+}
+
+std::vector<std::string_view> split_tabs(std::string_view line) {
+    std::vector<std::string_view> fields;
+    fields.reserve(6);
+    std::size_t start = 0;
+    while (true) {
+        const std::size_t tab = line.find('\t', start);
+        fields.push_back(line.substr(start, tab == std::string_view::npos ? std::string_view::npos : tab - start));
+        if (tab == std::string_view::npos) {
+            return fields;
+        }
+        start = tab + 1;
+    }
+}
+
+bool parse_number(std::string_view text, std::uintmax_t& value) {
+    if (text.empty()) {
+        return false;
+    }
+    value = 0;
+    for (const char ch : text) {
+        if (ch < '0' || ch > '9') {
+            return false;
+        }
+        value = value * 10 + static_cast<std::uintmax_t>(ch - '0');
+    }
+    return true;
+}
+
+std::string record_line(const ManifestEntry& entry) {
+    std::string line = "+\t";
+    line += std::to_string(static_cast<long long>(entry.written));
+    line += '\t';
+    line += entry.type;
+    line += '\t';
+    line += std::to_string(entry.size);
+    line += '\t';
+    append_field(line, entry.scan_id);
+    line += '\t';
+    append_field(line, entry.path);
+    line += '\n';
+    return line;
+}
+
+bool append_text(const std::string& text, std::string* error) {
+    std::error_code ec;
+    fs::create_directories(config::REPORT_DIR, ec);
+    const bool fresh = !fs::exists(config::REPORT_MANIFEST, ec);
+    std::FILE* file = std::fopen(config::REPORT_MANIFEST.c_str(), "ab");
+    if (file == nullptr) {
+        fsutil::set_error(error, "failed to open report manifest: " + config::REPORT_MANIFEST);
+        return false;
+    }
+    const std::string payload = fresh ? kHeader + text : text;
+    const bool ok = std::fwrite(payload.data(), 1, payload.size(), file) == payload.size();
+    const bool closed = std::fclose(file) == 0;
+    if (!ok || !closed) {
+        fsutil::set_error(error, "failed to append to report manifest: " + config::REPORT_MANIFEST);
+        return false;
+    }
+    return true;
+}
+
+// "sentinel-c_integrity_<type>_report_<scan id>.<ext>" -> "<scan id>".
+std::string scan_id_from_name(const std::string& name) {
+    const std::size_t marker = name.find("_report_");
+    const std::size_t dot = name.rfind('.');
+    if (marker == std::string::npos || dot == std::string::npos || dot < marker + 8) {
+        return "";
+    }
+    return name.substr(marker + 8, dot - marker - 8);
+}
+
+std::time_t file_time(const fs::directory_entry& entry) {
+    std::error_code ec;
+    const fs::file_time_type last_write = entry.last_write_time(ec);
+    if (ec) {
+        return 0;
+    }
+    const auto converted = std::chrono::time_point_cast<std::chrono::system_clock::duration>(
+        last_write - fs::file_time_type::clock::now() + std::chrono::system_clock::now());
+    return std::chrono::system_clock::to_time_t(converted);
+}
+
+} // namespace
+
+const std::vector<std::string>& report_types() {
+    static const std::vector<std::string> types = {"cli", "html", "json", "csv", "columnar"};
+    return types;
+}
+
+std::string report_dir(const std::string& type) {
+    if (type == "cli") {
+        return config::REPORT_CLI_DIR;
+    }
+    if (type == "html") {
+        return config::REPORT_HTML_DIR;
+    }
+    if (type == "json") {
+        return config::REPORT_JSON_DIR;
+    }
+    if (type == "csv") {
+        return config::REPORT_CSV_DIR;
+    }
+    if (type == "columnar") {
+        return config::REPORT_COLUMNAR_DIR;
+    }
+    return "";
+}
+
+bool manifest_record(const std::vector<ManifestEntry>& entries, std::string* error) {
+    if (entries.empty()) {
+        return true;
+    }
+    std::string text;
+    for (const ManifestEntry& entry : entries) {
+        text += record_line(entry);
+    }
+    return append_text(text, error);
+}
+
+bool manifest_forget(const std::vector<std::string>& paths, std::string* error) {
+    if (paths.empty()) {
+        return true;
+    }
+    const std::string now = std::to_string(static_cast<long long>(std::time(nullptr)));
+    std::string text;
+    for (const std::string& path : paths) {
+        text += "-\t" + now + "\t";
+        append_field(text, path);
+        text += '\n';
+    }
+    return append_text(text, error);
+}
+
+bool manifest_load(std::vector<ManifestEntry>& entries, std::string* error) {
+    entries.clear();
+    std::ifstream in(config::REPORT_MANIFEST, std::ios::binary);
+    if (!in.is_open()) {
+        fsutil::set_error(error, "report manifest not found: " + config::REPORT_MANIFEST);
+        return false;
+    }
+
+    // Removals are rare next to records, so only they are hashed; a record is
+    // live unless its path was removed on a later line. Writers record each
+    // report file once (its name carries the scan id), so records are not
+    // de-duplicated.
+    std::unordered_map<std::string, std::size_t> removed;
+    std::vector<std::size_t> line_numbers;
+    std::string line;
+    std::size_t line_number = 0;
+    while (std::getline(in, line)) {
+        ++line_number;
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        const std::vector<std::string_view> fields = split_tabs(line);
+        std::uintmax_t written = 0;
+        if (fields[0] == "-" && fields.size() == 3 && parse_number(fields[1], written)) {
+            removed[unescape_field(fields[2])] = line_number;
+            continue;
+        }
+        ManifestEntry entry;
+        if (fields[0] != "+" || fields.size() != 6 || !parse_number(fields[1], written) ||
+            !parse_number(fields[3], entry.size) || report_dir(std::string(fields[2])).empty()) {
+            continue;
+        }
+        entry.written = static_cast<std::time_t>(written);
+        entry.type = std::string(fields[2]);
+        entry.scan_id = unescape_field(fields[4]);
+        entry.path = unescape_field(fields[5]);
+        entries.push_back(std::move(entry));
+        line_numbers.push_back(line_number);
+    }
+
+    if (removed.empty()) {
+        return true;
+    }
+    std::size_t kept = 0;
+    for (std::size_t i = 0; i < entries.size(); ++i) {
+        const auto removal = removed.find(entries[i].path);
+        if (removal != removed.end() && removal->second > line_numbers[i]) {
+            continue;
+        }
+        if (kept != i) {
+            entries[kept] = std::move(entries[i]);
+        }
+        ++kept;
+    }
+    entries.resize(kept);
+    return true;
+}
+
+bool manifest_write(const std::vector<ManifestEntry>& entries, std::string* error) {
+    std::error_code ec;
+    fs::create_directories(config::REPORT_DIR, ec);
+    const std::string temp_path = config::REPORT_MANIFEST + ".tmp";
+    {
+        std::ofstream out(temp_path, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            fsutil::set_error(error, "failed to open report manifest for write: " + temp_path);
+            return false;
+        }
+        out << kHeader;
+        for (const ManifestEntry& entry : entries) {
+            out << record_line(entry);
+        }
+        out.flush();
+        if (!out) {
+            fsutil::set_error(error, "failed to flush report manifest: " + temp_path);
+            return false;
+        }
+    }
+
+    fs::rename(temp_path, config::REPORT_MANIFEST, ec);
+    if (ec) {
+        fs::remove(config::REPORT_MANIFEST, ec);
+        ec.clear();
+        fs::rename(temp_path, config::REPORT_MANIFEST, ec);
+        if (ec) {
+            fsutil::set_error(error, "failed to install report manifest: " + ec.message());
+            return false;
+        }
+    }
+    return true;
+}
+
+bool manifest_reconcile(std::vector<ManifestEntry>& entries,
+                        ReconcileStats& stats,
+                        std::string* error) {
+    stats = ReconcileStats{};
+    std::vector<ManifestEntry> recorded;
+    manifest_load(recorded, nullptr);
+    std::unordered_map<std::string, std::size_t> by_path;
+    for (std::size_t i = 0; i < recorded.size(); ++i) {
+        by_path.emplace(recorded[i].path, i);
+    }
+
+    entries.clear();
+    std::vector<bool> seen(recorded.size(), false);
+    for (const std::string& type : report_types()) {
+        const std::string dir = report_dir(type);
+        std::error_code ec;
+        if (!fs::exists(dir, ec)) {
+            continue;
+        }
+        for (const auto& item : fs::directory_iterator(dir, ec)) {
+            if (ec || !item.is_regular_file(ec)) {
+                ec.clear();
+                continue;
+            }
+            ManifestEntry entry;
+            entry.type = type;
+            entry.path = dir + "/" + item.path().filename().string();
+            entry.size = item.file_size(ec);
+            if (ec) {
+                entry.size = 0;
+                ec.clear();
+            }
+            const auto known = by_path.find(entry.path);
+            if (known != by_path.end()) {
+                seen[known->second] = true;
+                entry.scan_id = recorded[known->second].scan_id;
+                entry.written = recorded[known->second].written;
+                ++stats.kept;
+            } else {
+                entry.scan_id = scan_id_from_name(item.path().filename().string());
+                entry.written = file_time(item);
+                ++stats.added;
+            }
+            entries.push_back(std::move(entry));
+        }
+    }
+    stats.dropped = static_cast<std::size_t>(std::count(seen.begin(), seen.end(), false));
+
+    std::stable_sort(entries.begin(), entries.end(), [](const ManifestEntry& left, const ManifestEntry& right) {
+        if (left.written != right.written) {
+            return left.written < right.written;
+        }
+        return left.path < right.path;
+    });
+    return manifest_write(entries, error);
+}
+
+} // namespace reports
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <vector>
+
+namespace reports {
+
+// Append-only log of written reports (reports/.report-manifest), so listing
+// and purging never walk the report directories. One tab-separated line per
+// event: "+" records a written report, "-" records its removal. A torn last
+// line is skipped on load; --report-index --reconcile rebuilds the file.
+struct ManifestEntry {
+    std::string type;
+    std::string path;
+    std::uintmax_t size = 0;
+    std::string scan_id;
+    std::time_t written = 0;
+};
+
+struct ReconcileStats {
+    std::size_t kept = 0;
+    std::size_t added = 0;
+    std::size_t dropped = 0;
+};
+
+// Report types in listing order and the directory each is written to.
+const std::vector<std::string>& report_types();
+std::string report_dir(const std::string& type);
+
+// Each call is a single append, so concurrent writers do not interleave lines.
+bool manifest_record(const std::vector<ManifestEntry>& entries, std::string* error = nullptr);
+bool manifest_forget(const std::vector<std::string>& paths, std::string* error = nullptr);
+// Live entries in write order; false when the manifest is missing or unreadable.
+bool manifest_load(std::vector<ManifestEntry>& entries, std::string* error = nullptr);
+// Replaces the manifest with exactly `entries`.
+bool manifest_write(const std::vector<ManifestEntry>& entries, std::string* error = nullptr);
+// Rebuilds the manifest from the report directories: files still on disk keep
+// their manifest record, unlisted files are added, vanished ones dropped.
+bool manifest_reconcile(std::vector<ManifestEntry>& entries,
+                        ReconcileStats& stats,
+                        std::string* error = nullptr);
+
+} // namespace reports
@@ -0,0 +1,63 @@
+#include "report_model.h"
+#include "../core/fsutil.h"
+#include <algorithm>
+#include <ctime>
+
+namespace reports {
+
+namespace {
+
+void collect(const scanner::FileMap& files, ChangeKind kind, std::vector<ChangeRecord>& changes) {
+    for (const auto& item : files) {
+        changes.push_back(ChangeRecord{&item.second, kind, fsutil::format_time(item.second.mtime)});
+    }
+}
+
+} // namespace
+
+const char* change_label(ChangeKind kind) {
+    switch (kind) {
+        case ChangeKind::Added: return "NEW";
+        case ChangeKind::Modified: return "MODIFIED";
+        default: return "DELETED";
+    }
+}
+
+ReportModel build_report_model(const scanner::ScanResult& result, const std::string& scan_id) {
+    ReportModel model;
+    const std::string raw_id = scan_id.empty() ? fsutil::timestamp() : scan_id;
+    model.scan_id = fsutil::sanitize_token(raw_id, "scan");
+    model.generated_at = fsutil::format_time(std::time(nullptr));
+    model.status = advisor_status(result);
+    model.stats = result.stats;
+    model.narrative = advisor_narrative(result);
+
+    model.changes.reserve(result.added.size() + result.modified.size() + result.deleted.size());
+    collect(result.added, ChangeKind::Added, model.changes);
+    collect(result.modified, ChangeKind::Modified, model.changes);
+    collect(result.deleted, ChangeKind::Deleted, model.changes);
+
+    // The only sort of the change set; per-kind views inherit its order.
+    std::sort(model.changes.begin(), model.changes.end(),
+              [](const ChangeRecord& left, const ChangeRecord& right) {
+                  const int order = left.entry->path.compare(right.entry->path);
+                  if (order != 0) {
+                      return order < 0;
+                  }
+                  return std::string(change_label(left.kind)) < change_label(right.kind);
+              });
+
+    model.added.reserve(result.added.size());
+    model.modified.reserve(result.modified.size());
+    model.deleted.reserve(result.deleted.size());
+    for (const ChangeRecord& change : model.changes) {
+        switch (change.kind) {
+            case ChangeKind::Added: model.added.push_back(&change); break;
+            case ChangeKind::Modified: model.modified.push_back(&change); break;
+            case ChangeKind::Deleted: model.deleted.push_back(&change); break;
+        }
+    }
+    return model;
+}
+
+} // namespace reports
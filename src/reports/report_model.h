@@ -0,0 +1,47 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "advice.h"
+#include "../scanner/scanner.h"
+
+namespace reports {
+
+enum class ChangeKind {
+    Added,
+    Modified,
+    Deleted
+};
+
+// "NEW", "MODIFIED" or "DELETED", as printed by the CLI and CSV reports.
+const char* change_label(ChangeKind kind);
+
+struct ChangeRecord {
+    const core::FileEntry* entry = nullptr;
+    ChangeKind kind = ChangeKind::Added;
+    std::string mtime_text;
+};
+
+// Everything the report writers derive from a scan, computed once and shared
+// read-only by all of them. Entries point into the ScanResult the model was
+// built from, so the model must not outlive it.
+struct ReportModel {
+    std::string scan_id;
+    std::string generated_at;
+    std::string status;
+    core::ScanStats stats;
+    AdvisorNarrative narrative;
+
+    // All changes ordered by path, then label.
+    std::vector<ChangeRecord> changes;
+    // Per-kind views of `changes`, each in path order.
+    std::vector<const ChangeRecord*> added;
+    std::vector<const ChangeRecord*> modified;
+    std::vector<const ChangeRecord*> deleted;
+
+    bool clean() const { return status == "clean"; }
+};
+
+ReportModel build_report_model(const scanner::ScanResult& result, const std::string& scan_id);
+
+} // namespace reports
@@ -1,15 +1,20 @@
 #include "scanner.h"
+#include "baseline_index.h"
+#include "baseline_stream.h"
+#include "history.h"
 #include "../core/config.h"
 #include "../core/fsutil.h"
+#include "../core/memory.h"
+#include "../core/profiler.h"
+#include "../core/trace.h"
 #include "hash.h"
+#include <algorithm>
 #include <filesystem>
 #include <fstream>
 #include <system_error>
 #include <string>
 #include <utility>
-#ifndef _WIN32
-#include <sys/stat.h>
-#endif
+#include <vector>
 
 namespace {
 
@@ -23,52 +28,6 @@ void clear_baseline_status() {
     g_last_baseline_warning.clear();
 }
 
-void tighten_file_permissions(const std::string& path) {
-#ifndef _WIN32
-    ::chmod(path.c_str(), S_IRUSR | S_IWUSR);
-#else
-    (void)path;
-#endif
-}
-
-bool parse_entry(std::string line, core::FileEntry& entry) {
-    const std::size_t p1 = line.find('\t');
-    const std::size_t p2 = line.find('\t', p1 == std::string::npos ? p1 : p1 + 1);
-    const std::size_t p3 = line.find('\t', p2 == std::string::npos ? p2 : p2 + 1);
-    if (p1 != std::string::npos && p2 != std::string::npos && p3 != std::string::npos) {
-        entry.path = line.substr(0, p1);
-        entry.hash = line.substr(p1 + 1, p2 - p1 - 1);
-
-        try {
-            entry.size = static_cast<uintmax_t>(std::stoull(line.substr(p2 + 1, p3 - p2 - 1)));
-            entry.mtime = static_cast<std::time_t>(std::stoll(line.substr(p3 + 1)));
-        } catch (...) {
-            return false;
-        }
-
-        return true;
-    }
-
-    // Backward compatibility with legacy "path|size|hash" format.
-    const std::size_t l1 = line.find('|');
-    const std::size_t l2 = line.find('|', l1 == std::string::npos ? l1 : l1 + 1);
-    if (l1 == std::string::npos || l2 == std::string::npos) {
-        return false;
-    }
-
-    entry.path = line.substr(0, l1);
-    entry.hash = line.substr(l2 + 1);
-
-    try {
-        entry.size = static_cast<uintmax_t>(std::stoull(line.substr(l1 + 1, l2 - l1 - 1)));
-        entry.mtime = 0;
-    } catch (...) {
-        return false;
-    }
-
-    return true;
-}
-
 bool read_seal_digest(std::string& digest, std::string& error) {
     digest.clear();
     std::ifstream in(config::BASELINE_SEAL_FILE);
@@ -92,7 +51,7 @@ bool read_seal_digest(std::string& digest, std::string& error) {
     return true;
 }
 
-bool verify_baseline_seal(std::string& error, std::string& warning) {
+bool verify_baseline_seal(std::string& error, std::string& warning, std::string* digest = nullptr) {
     error.clear();
     warning.clear();
 
@@ -104,6 +63,9 @@ bool verify_baseline_seal(std::string& error, std::string& warning) {
 
     if (!fs::exists(config::BASELINE_SEAL_FILE, ec)) {
         warning = "Baseline seal is missing. Re-run --update to enable tamper guard.";
+        if (digest != nullptr) {
+            *digest = hash::sha256_file(config::BASELINE_DB);
+        }
         return true;
     }
 
@@ -125,6 +87,9 @@ bool verify_baseline_seal(std::string& error, std::string& warning) {
         return false;
     }
 
+    if (digest != nullptr) {
+        *digest = actual_digest;
+    }
     return true;
 }
 
@@ -132,91 +97,290 @@ bool verify_baseline_seal(std::string& error, std::string& warning) {
 
 namespace scanner {
 
-bool load_baseline(FileMap& baseline, std::string* baseline_root) {
-    clear_baseline_status();
-    baseline.clear();
-    if (baseline_root != nullptr) {
-        *baseline_root = "";
+bool parse_baseline_record(const std::string& raw_line, core::FileEntry& entry) {
+    const std::string line = raw_line.rfind("file\t", 0) == 0 ? raw_line.substr(5) : raw_line;
+
+    const std::size_t p1 = line.find('\t');
+    const std::size_t p2 = line.find('\t', p1 == std::string::npos ? p1 : p1 + 1);
+    const std::size_t p3 = line.find('\t', p2 == std::string::npos ? p2 : p2 + 1);
+    if (p1 != std::string::npos && p2 != std::string::npos && p3 != std::string::npos) {
+        entry.path = line.substr(0, p1);
+        entry.hash = line.substr(p1 + 1, p2 - p1 - 1);
+
+        try {
+            entry.size = static_cast<uintmax_t>(std::stoull(line.substr(p2 + 1, p3 - p2 - 1)));
+            entry.mtime = static_cast<std::time_t>(std::stoll(line.substr(p3 + 1)));
+        } catch (...) {
+            return false;
+        }
+
+        return true;
     }
 
-    std::string seal_error;
-    std::string seal_warning;
-    if (!verify_baseline_seal(seal_error, seal_warning)) {
-        g_last_baseline_error = seal_error;
+    // Backward compatibility with legacy "path|size|hash" format.
+    const std::size_t l1 = line.find('|');
+    const std::size_t l2 = line.find('|', l1 == std::string::npos ? l1 : l1 + 1);
+    if (l1 == std::string::npos || l2 == std::string::npos) {
         return false;
     }
-    g_last_baseline_warning = seal_warning;
 
-    std::ifstream in(config::BASELINE_DB);
-    if (!in.is_open()) {
-        g_last_baseline_error = "Baseline file not found: " + config::BASELINE_DB;
+    entry.path = line.substr(0, l1);
+    entry.hash = line.substr(l2 + 1);
+
+    try {
+        entry.size = static_cast<uintmax_t>(std::stoull(line.substr(l1 + 1, l2 - l1 - 1)));
+        entry.mtime = 0;
+    } catch (...) {
         return false;
     }
 
-    bool seen_content = false;
+    return true;
+}
+
+bool BaselineReader::open(const std::string& path) {
+    in_.close();
+    in_.clear();
+    root_.clear();
+    generated_.clear();
+    pending_.clear();
+    count_.reset();
+    path_sorted_ = false;
+    saw_header_ = false;
+    has_pending_ = false;
+
+    in_.open(path);
+    if (!in_.is_open()) {
+        return false;
+    }
+
+    // Header lines always precede records; stop at the first record and keep it.
     std::string line;
-    while (std::getline(in, line)) {
+    while (std::getline(in_, line)) {
         if (line.empty() || line[0] == '#') {
             continue;
         }
-
         if (line.rfind("root\t", 0) == 0) {
-            if (baseline_root != nullptr) {
-                *baseline_root = line.substr(5);
-            }
-            seen_content = true;
+            root_ = line.substr(5);
+            saw_header_ = true;
             continue;
         }
-
         if (line.rfind("generated\t", 0) == 0) {
-            seen_content = true;
+            generated_ = line.substr(10);
+            saw_header_ = true;
+            continue;
+        }
+        if (line.rfind("order\t", 0) == 0) {
+            path_sorted_ = line.substr(6) == "path";
+            continue;
+        }
+        if (line.rfind("count\t", 0) == 0) {
+            try {
+                count_ = static_cast<std::size_t>(std::stoull(line.substr(6)));
+            } catch (...) {
+                count_.reset();
+            }
             continue;
         }
+        pending_ = std::move(line);
+        has_pending_ = true;
+        break;
+    }
+    return true;
+}
 
-        if (line.rfind("file\t", 0) == 0) {
-            line = line.substr(5);
+bool BaselineReader::next(core::FileEntry& entry) {
+    std::string line;
+    while (true) {
+        if (has_pending_) {
+            line = std::move(pending_);
+            has_pending_ = false;
+        } else if (!std::getline(in_, line)) {
+            return false;
         }
 
-        core::FileEntry entry;
-        if (!parse_entry(line, entry)) {
+        if (line.empty() || line[0] == '#') {
             continue;
         }
-        baseline[entry.path] = std::move(entry);
+        if (parse_baseline_record(line, entry)) {
+            return true;
+        }
+    }
+}
+
+bool BaselineWriter::open(const std::string& path,
+                          const std::string& root,
+                          const std::string& generated,
+                          std::optional<std::size_t> expected_count) {
+    out_.close();
+    out_.clear();
+    last_path_.clear();
+    count_field_ = -1;
+    count_ = 0;
+
+    out_.open(path, std::ios::binary | std::ios::trunc);
+    if (!out_.is_open()) {
+        return false;
+    }
+
+    out_ << "# Sentinel-C baseline v2\n";
+    out_ << "root\t" << root << "\n";
+    out_ << "generated\t" << generated << "\n";
+    out_ << "order\tpath\n";
+    out_ << "count\t";
+    if (expected_count.has_value()) {
+        out_ << *expected_count << "\n";
+    } else {
+        // Zero-padded placeholder wide enough for any 64-bit count.
+        count_field_ = out_.tellp();
+        out_ << std::string(20, '0') << "\n";
+    }
+    return static_cast<bool>(out_);
+}
+
+bool BaselineWriter::add(const core::FileEntry& entry) {
+    if (count_ > 0 && entry.path <= last_path_) {
+        return false;
+    }
+    out_ << "file\t"
+         << entry.path << '\t'
+         << entry.hash << '\t'
+         << entry.size << '\t'
+         << entry.mtime << "\n";
+    last_path_ = entry.path;
+    ++count_;
+    return true;
+}
+
+bool BaselineWriter::close() {
+    if (count_field_ != std::streampos(-1)) {
+        const std::string digits = std::to_string(count_);
+        out_.seekp(count_field_);
+        out_ << std::string(20 - digits.size(), '0') << digits;
+    }
+    out_.close();
+    return static_cast<bool>(out_);
+}
+
+bool verify_baseline(std::string* digest) {
+    clear_baseline_status();
+    profiler::Scope scope(core::Phase::SealCheck);
+    trace::Span span("seal check", "baseline");
+    const bool ok = verify_baseline_seal(g_last_baseline_error, g_last_baseline_warning, digest);
+    if (!ok) {
+        scope.add_error();
+    }
+    return ok;
+}
+
+bool load_baseline(FileMap& baseline, std::string* baseline_root) {
+    memory::Scope area(memory::Area::Baseline);
+    clear_baseline_status();
+    baseline.clear();
+    if (baseline_root != nullptr) {
+        *baseline_root = "";
+    }
+
+    profiler::Scope scope(core::Phase::BaselineLoad);
+    trace::Span span("baseline load", "baseline");
+    std::string seal_error;
+    std::string seal_warning;
+    {
+        profiler::Scope seal(core::Phase::SealCheck);
+        trace::Span seal_span("seal check", "baseline");
+        if (!verify_baseline_seal(seal_error, seal_warning)) {
+            seal.add_error();
+            g_last_baseline_error = seal_error;
+            return false;
+        }
+    }
+    g_last_baseline_warning = seal_warning;
+
+    BaselineReader reader;
+    if (!reader.open(config::BASELINE_DB)) {
+        g_last_baseline_error = "Baseline file not found: " + config::BASELINE_DB;
+        return false;
+    }
+    if (baseline_root != nullptr) {
+        *baseline_root = reader.root();
+    }
+    if (reader.count().has_value()) {
+        baseline.reserve(*reader.count());
+    }
+
+    bool seen_content = reader.saw_header();
+    core::FileEntry entry;
+    while (reader.next(entry)) {
+        std::string key = entry.path;
+        baseline[std::move(key)] = std::move(entry);
         seen_content = true;
     }
 
+    scope.add_files(baseline.size());
+    if (profiler::enabled()) {
+        std::error_code ec;
+        const std::uintmax_t size = fs::file_size(config::BASELINE_DB, ec);
+        scope.add_bytes(ec ? 0 : size);
+    }
     if (!seen_content) {
+        scope.add_error();
         g_last_baseline_error = "Baseline file is empty or invalid: " + config::BASELINE_DB;
     }
     return seen_content;
 }
 
 bool save_baseline(const FileMap& data, const std::string& baseline_root) {
+    memory::Scope area(memory::Area::Baseline);
     clear_baseline_status();
-    std::ofstream out(config::BASELINE_DB, std::ios::trunc);
-    if (!out.is_open()) {
+    profiler::Scope scope(core::Phase::BaselineSave);
+    trace::Span span("baseline save", "baseline");
+    scope.add_files(data.size());
+
+    // Records are written in path order so history, paging and diff readers
+    // can stream the file instead of loading it into a FileMap.
+    std::vector<const core::FileEntry*> entries;
+    entries.reserve(data.size());
+    for (const auto& item : data) {
+        entries.push_back(&item.second);
+    }
+    std::sort(entries.begin(), entries.end(),
+              [](const core::FileEntry* left, const core::FileEntry* right) {
+                  return left->path < right->path;
+              });
+
+    const std::string staged_path = config::BASELINE_DB + ".tmp";
+    BaselineWriter writer;
+    if (!writer.open(staged_path, baseline_root, fsutil::timestamp(), entries.size())) {
         g_last_baseline_error = "Failed to open baseline file for write: " + config::BASELINE_DB;
         return false;
     }
-
-    out << "# Sentinel-C baseline v2\n";
-    out << "root\t" << baseline_root << "\n";
-    out << "generated\t" << fsutil::timestamp() << "\n";
-
-    for (const auto& item : data) {
-        const core::FileEntry& entry = item.second;
-        out << "file\t"
-            << entry.path << '\t'
-            << entry.hash << '\t'
-            << entry.size << '\t'
-            << entry.mtime << "\n";
-    }
-    out.close();
-    if (!out) {
+    for (const core::FileEntry* item : entries) {
+        writer.add(*item);
+    }
+    if (!writer.close()) {
         g_last_baseline_error = "Failed to flush baseline file: " + config::BASELINE_DB;
         return false;
     }
-    tighten_file_permissions(config::BASELINE_DB);
+    return install_baseline(staged_path);
+}
+
+bool install_baseline(const std::string& staged_path) {
+    clear_baseline_status();
+
+    std::error_code ec;
+    if (staged_path != config::BASELINE_DB) {
+        fs::rename(staged_path, config::BASELINE_DB, ec);
+        if (ec) {
+            fs::remove(config::BASELINE_DB, ec);
+            ec.clear();
+            fs::rename(staged_path, config::BASELINE_DB, ec);
+        }
+        if (ec) {
+            fs::remove(staged_path, ec);
+            g_last_baseline_error = "Failed to replace baseline file: " + config::BASELINE_DB;
+            return false;
+        }
+    }
+    fsutil::tighten_file_permissions(config::BASELINE_DB);
 
     const std::string digest = hash::sha256_file(config::BASELINE_DB);
     if (digest.empty()) {
@@ -241,7 +405,20 @@ bool save_baseline(const FileMap& data, const std::string& baseline_root) {
             "Failed to flush baseline seal file: " + config::BASELINE_SEAL_FILE;
         return false;
     }
-    tighten_file_permissions(config::BASELINE_SEAL_FILE);
+    fsutil::tighten_file_permissions(config::BASELINE_SEAL_FILE);
+
+    std::string index_error;
+    if (!baseline_index::refresh_if_present(digest, &index_error)) {
+        g_last_baseline_warning = "Baseline saved, but path index refresh failed: " + index_error;
+    }
+
+    std::string history_error;
+    if (!history::record_current_baseline(&history_error)) {
+        if (!g_last_baseline_warning.empty()) {
+            g_last_baseline_warning += " ";
+        }
+        g_last_baseline_warning += "Baseline saved, but history snapshot failed: " + history_error;
+    }
 
     return true;
 }
@@ -0,0 +1,485 @@
+#include "baseline_archive.h"
+#include "../core/codec.h"
+#include "../core/fsutil.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <system_error>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// Layout (integers little-endian, varints LEB128):
+//   magic[8] u32 header_size header{ varint root, varint generated, u8 flags }
+//   block*   : u32 raw_size u32 stored_size u32 crc32(raw) u32 records payload[stored_size]
+//   index    : per block { u64 offset, u32 records, varint first_path }
+//   footer   : u64 index_offset u64 records u32 index_size u32 crc32(index) u32 blocks magic[8]
+// Block payload records: varint shared, varint suffix_len, suffix, u8 digest_kind
+// (0: 32 raw bytes, 1: varint length + text), varint size, varint zigzag(mtime).
+constexpr char MAGIC[8] = {'S', 'C', 'B', 'C', '1', '\0', '\0', '\0'};
+constexpr char FOOTER_MAGIC[8] = {'S', 'C', 'B', 'C', 'E', 'N', 'D', '\0'};
+constexpr std::size_t FOOTER_SIZE = 8 + 8 + 4 + 4 + 4 + sizeof(FOOTER_MAGIC);
+constexpr std::size_t BLOCK_HEADER_SIZE = 16;
+constexpr std::size_t BLOCK_TARGET_BYTES = 1 << 20;
+constexpr std::uint32_t BLOCK_MAX_RECORDS = 16384;
+// A block is closed once it reaches BLOCK_TARGET_BYTES, so only its last
+// record can carry it further; readers reject anything past this before
+// allocating for it.
+constexpr std::size_t BLOCK_MAX_RAW_BYTES = 2 * BLOCK_TARGET_BYTES;
+// Smallest block index entry: u64 offset, u32 records, one-byte varint.
+constexpr std::size_t INDEX_ENTRY_MIN_SIZE = 13;
+constexpr unsigned char FLAG_PATH_SORTED = 1;
+
+// Packed digests decode back to lower-case hex, so only lower-case ones are
+// packed; anything else is kept as text.
+bool is_packable_digest(const std::string& digest) {
+    if (digest.size() != 64) {
+        return false;
+    }
+    return std::all_of(digest.begin(), digest.end(), [](char ch) {
+        return codec::hex_value(ch) >= 0 && (ch < 'A' || ch > 'F');
+    });
+}
+
+std::uint64_t zigzag(std::int64_t value) {
+    return (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+}
+
+std::int64_t unzigzag(std::uint64_t value) {
+    return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+}
+
+bool get_string(const char*& cursor, const char* end, std::string& value) {
+    std::uint64_t length = 0;
+    if (!codec::get_varint(cursor, end, length) ||
+        length > static_cast<std::uint64_t>(end - cursor)) {
+        return false;
+    }
+    value.assign(cursor, static_cast<std::size_t>(length));
+    cursor += length;
+    return true;
+}
+
+void put_string(std::string& out, const std::string& value) {
+    codec::put_varint(out, value.size());
+    out += value;
+}
+
+bool decode_records(const std::string& raw, std::uint32_t count, std::vector<core::FileEntry>& entries) {
+    static const char HEX[] = "0123456789abcdef";
+    const char* cursor = raw.data();
+    const char* const end = cursor + raw.size();
+    std::string previous;
+
+    entries.clear();
+    entries.reserve(count);
+    for (std::uint32_t i = 0; i < count; ++i) {
+        std::uint64_t shared = 0;
+        std::uint64_t suffix = 0;
+        if (!codec::get_varint(cursor, end, shared) || shared > previous.size() ||
+            !codec::get_varint(cursor, end, suffix) ||
+            suffix > static_cast<std::uint64_t>(end - cursor)) {
+            return false;
+        }
+
+        core::FileEntry entry;
+        entry.path.reserve(static_cast<std::size_t>(shared + suffix));
+        entry.path.assign(previous, 0, static_cast<std::size_t>(shared));
+        entry.path.append(cursor, static_cast<std::size_t>(suffix));
+        cursor += suffix;
+
+        if (cursor >= end) {
+            return false;
+        }
+        const char kind = *cursor++;
+        if (kind == 0) {
+            if (end - cursor < 32) {
+                return false;
+            }
+            entry.hash.resize(64);
+            for (int b = 0; b < 32; ++b) {
+                const unsigned char byte = static_cast<unsigned char>(cursor[b]);
+                entry.hash[b * 2] = HEX[byte >> 4];
+                entry.hash[b * 2 + 1] = HEX[byte & 0x0F];
+            }
+            cursor += 32;
+        } else if (kind != 1 || !get_string(cursor, end, entry.hash)) {
+            return false;
+        }
+
+        std::uint64_t size = 0;
+        std::uint64_t mtime = 0;
+        if (!codec::get_varint(cursor, end, size) || !codec::get_varint(cursor, end, mtime)) {
+            return false;
+        }
+        entry.size = static_cast<uintmax_t>(size);
+        entry.mtime = static_cast<std::time_t>(unzigzag(mtime));
+
+        previous = entry.path;
+        entries.push_back(std::move(entry));
+    }
+    return cursor == end;
+}
+
+} // namespace
+
+namespace baseline_archive {
+
+Writer::Writer() = default;
+
+Writer::~Writer() {
+    if (out_.is_open()) {
+        out_.close();
+        std::error_code ec;
+        fs::remove(path_ + ".tmp", ec);
+    }
+}
+
+bool Writer::open(const std::string& path,
+                  const std::string& root,
+                  const std::string& generated,
+                  bool path_sorted,
+                  unsigned threads,
+                  std::string* error) {
+    path_ = path;
+    threads_ = std::max(1u, threads);
+    out_.open(path_ + ".tmp", std::ios::binary | std::ios::trunc);
+    if (!out_.is_open()) {
+        fsutil::set_error(error, "failed to open archive for write: " + path_);
+        return false;
+    }
+
+    std::string header;
+    put_string(header, root);
+    put_string(header, generated);
+    header.push_back(static_cast<char>(path_sorted ? FLAG_PATH_SORTED : 0));
+
+    std::string prologue(MAGIC, sizeof(MAGIC));
+    codec::put_u32(prologue, static_cast<std::uint32_t>(header.size()));
+    prologue += header;
+    out_.write(prologue.data(), static_cast<std::streamsize>(prologue.size()));
+    stats_.stored_bytes = prologue.size();
+    return static_cast<bool>(out_);
+}
+
+bool Writer::add(const core::FileEntry& entry) {
+    if (failed_) {
+        return false;
+    }
+
+    if (current_.records == 0) {
+        current_.first_path = entry.path;
+        previous_path_.clear();
+    }
+
+    const std::size_t limit = std::min(previous_path_.size(), entry.path.size());
+    std::size_t shared = 0;
+    while (shared < limit && previous_path_[shared] == entry.path[shared]) {
+        ++shared;
+    }
+    std::string& raw = current_.raw;
+    codec::put_varint(raw, shared);
+    codec::put_varint(raw, entry.path.size() - shared);
+    raw.append(entry.path, shared, std::string::npos);
+
+    if (is_packable_digest(entry.hash)) {
+        raw.push_back(0);
+        for (std::size_t i = 0; i < 64; i += 2) {
+            raw.push_back(static_cast<char>((codec::hex_value(entry.hash[i]) << 4) |
+                                            codec::hex_value(entry.hash[i + 1])));
+        }
+    } else {
+        raw.push_back(1);
+        put_string(raw, entry.hash);
+    }
+    codec::put_varint(raw, static_cast<std::uint64_t>(entry.size));
+    codec::put_varint(raw, zigzag(static_cast<std::int64_t>(entry.mtime)));
+
+    previous_path_ = entry.path;
+    ++current_.records;
+    ++stats_.records;
+    if (raw.size() >= BLOCK_TARGET_BYTES || current_.records >= BLOCK_MAX_RECORDS) {
+        pending_.push_back(std::move(current_));
+        current_ = PendingBlock();
+        if (pending_.size() >= threads_) {
+            return flush_pending();
+        }
+    }
+    return true;
+}
+
+bool Writer::flush_pending() {
+    // Compress up to `threads_` sealed blocks side by side, then append them in order.
+    std::vector<std::string> stored(pending_.size());
+    std::vector<std::thread> pool;
+    for (std::size_t i = 1; i < pending_.size(); ++i) {
+        pool.emplace_back([this, &stored, i]() { stored[i] = codec::compress(pending_[i].raw); });
+    }
+    if (!pending_.empty()) {
+        stored[0] = codec::compress(pending_[0].raw);
+    }
+    for (std::thread& worker : pool) {
+        worker.join();
+    }
+
+    for (std::size_t i = 0; i < pending_.size(); ++i) {
+        const PendingBlock& block = pending_[i];
+        codec::put_u64(index_, stats_.stored_bytes);
+        codec::put_u32(index_, block.records);
+        put_string(index_, block.first_path);
+
+        std::string header;
+        codec::put_u32(header, static_cast<std::uint32_t>(block.raw.size()));
+        codec::put_u32(header, static_cast<std::uint32_t>(stored[i].size()));
+        codec::put_u32(header, codec::crc32(block.raw.data(), block.raw.size()));
+        codec::put_u32(header, block.records);
+        out_.write(header.data(), static_cast<std::streamsize>(header.size()));
+        out_.write(stored[i].data(), static_cast<std::streamsize>(stored[i].size()));
+
+        stats_.raw_bytes += block.raw.size();
+        stats_.stored_bytes += header.size() + stored[i].size();
+        ++stats_.blocks;
+    }
+    pending_.clear();
+    failed_ = !out_;
+    return !failed_;
+}
+
+bool Writer::close(Stats* stats, std::string* error) {
+    if (current_.records > 0) {
+        pending_.push_back(std::move(current_));
+        current_ = PendingBlock();
+    }
+    if (!flush_pending()) {
+        fsutil::set_error(error, "failed to write archive block: " + path_);
+        return false;
+    }
+
+    std::string footer;
+    codec::put_u64(footer, stats_.stored_bytes);
+    codec::put_u64(footer, stats_.records);
+    codec::put_u32(footer, static_cast<std::uint32_t>(index_.size()));
+    codec::put_u32(footer, codec::crc32(index_.data(), index_.size()));
+    codec::put_u32(footer, static_cast<std::uint32_t>(stats_.blocks));
+    footer.append(FOOTER_MAGIC, sizeof(FOOTER_MAGIC));
+    out_.write(index_.data(), static_cast<std::streamsize>(index_.size()));
+    out_.write(footer.data(), static_cast<std::streamsize>(footer.size()));
+    stats_.stored_bytes += index_.size() + footer.size();
+    out_.close();
+    if (!out_) {
+        fsutil::set_error(error, "failed to flush archive: " + path_);
+        return false;
+    }
+
+    std::error_code ec;
+    fs::rename(path_ + ".tmp", path_, ec);
+    if (ec) {
+        fs::remove(path_, ec);
+        ec.clear();
+        fs::rename(path_ + ".tmp", path_, ec);
+        if (ec) {
+            fsutil::set_error(error, "failed to install archive: " + ec.message());
+            return false;
+        }
+    }
+    if (stats != nullptr) {
+        *stats = stats_;
+    }
+    return true;
+}
+
+bool Archive::open(const std::string& path, std::string* error) {
+    path_ = path;
+    blocks_.clear();
+
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) {
+        fsutil::set_error(error, "archive not found: " + path);
+        return false;
+    }
+
+    in.seekg(0, std::ios::end);
+    const std::streamoff file_size = in.tellg();
+    in.seekg(0);
+
+    char prologue[sizeof(MAGIC) + 4];
+    if (!in.read(prologue, sizeof(prologue)) || std::memcmp(prologue, MAGIC, sizeof(MAGIC)) != 0) {
+        fsutil::set_error(error, "not a baseline archive: " + path);
+        return false;
+    }
+    // Sizes read from the file are checked against it before anything is
+    // allocated for them.
+    const std::uint32_t header_size = codec::get_u32(prologue + sizeof(MAGIC));
+    if (static_cast<std::uint64_t>(header_size) + sizeof(prologue) + FOOTER_SIZE >
+        static_cast<std::uint64_t>(file_size)) {
+        fsutil::set_error(error, "truncated archive header: " + path);
+        return false;
+    }
+    const std::uint64_t data_offset = sizeof(prologue) + static_cast<std::uint64_t>(header_size);
+    std::string header(header_size, '\0');
+    if (!in.read(&header[0], static_cast<std::streamsize>(header.size()))) {
+        fsutil::set_error(error, "truncated archive header: " + path);
+        return false;
+    }
+    const char* cursor = header.data();
+    const char* const header_end = cursor + header.size();
+    if (!get_string(cursor, header_end, root_) || !get_string(cursor, header_end, generated_) ||
+        cursor >= header_end) {
+        fsutil::set_error(error, "corrupt archive header: " + path);
+        return false;
+    }
+    path_sorted_ = (static_cast<unsigned char>(*cursor) & FLAG_PATH_SORTED) != 0;
+
+    char footer[FOOTER_SIZE];
+    if (file_size < static_cast<std::streamoff>(FOOTER_SIZE) ||
+        !in.seekg(file_size - static_cast<std::streamoff>(FOOTER_SIZE)) ||
+        !in.read(footer, sizeof(footer)) ||
+        std::memcmp(footer + FOOTER_SIZE - sizeof(FOOTER_MAGIC), FOOTER_MAGIC, sizeof(FOOTER_MAGIC)) != 0) {
+        fsutil::set_error(error, "archive footer missing (truncated file?): " + path);
+        return false;
+    }
+    const std::uint64_t index_offset = codec::get_u64(footer);
+    record_count_ = codec::get_u64(footer + 8);
+    const std::uint32_t index_size = codec::get_u32(footer + 16);
+    const std::uint32_t index_crc = codec::get_u32(footer + 20);
+    const std::uint32_t block_count = codec::get_u32(footer + 24);
+
+    if (index_offset < data_offset ||
+        index_offset + index_size + FOOTER_SIZE != static_cast<std::uint64_t>(file_size) ||
+        block_count > index_size / INDEX_ENTRY_MIN_SIZE) {
+        fsutil::set_error(error, "corrupt archive block index: " + path);
+        return false;
+    }
+    std::string index(index_size, '\0');
+    if (!in.seekg(static_cast<std::streamoff>(index_offset)) ||
+        !in.read(&index[0], static_cast<std::streamsize>(index.size())) ||
+        codec::crc32(index.data(), index.size()) != index_crc) {
+        fsutil::set_error(error, "archive block index checksum mismatch: " + path);
+        return false;
+    }
+
+    cursor = index.data();
+    const char* const index_end = cursor + index.size();
+    blocks_.reserve(block_count);
+    for (std::uint32_t i = 0; i < block_count; ++i) {
+        BlockInfo info;
+        if (index_end - cursor < 12) {
+            fsutil::set_error(error, "corrupt archive block index: " + path);
+            return false;
+        }
+        info.offset = codec::get_u64(cursor);
+        info.records = codec::get_u32(cursor + 8);
+        cursor += 12;
+        if (!get_string(cursor, index_end, info.first_path)) {
+            fsutil::set_error(error, "corrupt archive block index: " + path);
+            return false;
+        }
+        blocks_.push_back(std::move(info));
+    }
+
+    // Each block runs up to the next one; the last up to the index.
+    for (std::size_t i = 0; i < blocks_.size(); ++i) {
+        const std::uint64_t begin = blocks_[i].offset;
+        const std::uint64_t end = i + 1 < blocks_.size() ? blocks_[i + 1].offset : index_offset;
+        if (begin < data_offset || end < begin + BLOCK_HEADER_SIZE || end > index_offset) {
+            fsutil::set_error(error, "corrupt archive block index: " + path);
+            blocks_.clear();
+            return false;
+        }
+        blocks_[i].extent = end - begin;
+    }
+    return true;
+}
+
+std::size_t Archive::find_block(const std::string& path) const {
+    const auto it = std::upper_bound(blocks_.begin(), blocks_.end(), path,
+                                     [](const std::string& value, const BlockInfo& info) {
+                                         return value < info.first_path;
+                                     });
+    return it == blocks_.begin() ? 0 : static_cast<std::size_t>(it - blocks_.begin() - 1);
+}
+
+bool Archive::read_block(std::size_t block, std::vector<core::FileEntry>& entries,
+                         std::string* error) const {
+    if (block >= blocks_.size()) {
+        fsutil::set_error(error, "archive block out of range");
+        return false;
+    }
+
+    std::ifstream in(path_, std::ios::binary);
+    char header[BLOCK_HEADER_SIZE];
+    if (!in.is_open() || !in.seekg(static_cast<std::streamoff>(blocks_[block].offset)) ||
+        !in.read(header, sizeof(header))) {
+        fsutil::set_error(error, "failed to read archive block " + std::to_string(block));
+        return false;
+    }
+    const std::uint32_t raw_size = codec::get_u32(header);
+    const std::uint32_t stored_size = codec::get_u32(header + 4);
+    const std::uint32_t crc = codec::get_u32(header + 8);
+    const std::uint32_t records = codec::get_u32(header + 12);
+    if (stored_size > blocks_[block].extent - BLOCK_HEADER_SIZE || raw_size > BLOCK_MAX_RAW_BYTES ||
+        records != blocks_[block].records || records > BLOCK_MAX_RECORDS) {
+        fsutil::set_error(error, "corrupt archive block " + std::to_string(block));
+        return false;
+    }
+
+    std::string stored(stored_size, '\0');
+    std::string raw;
+    if (!in.read(&stored[0], static_cast<std::streamsize>(stored.size())) ||
+        !codec::decompress(stored.data(), stored.size(), raw_size, raw)) {
+        fsutil::set_error(error, "corrupt archive block " + std::to_string(block));
+        return false;
+    }
+    if (codec::crc32(raw.data(), raw.size()) != crc) {
+        fsutil::set_error(error, "archive block " + std::to_string(block) + " checksum mismatch");
+        return false;
+    }
+    if (!decode_records(raw, records, entries)) {
+        fsutil::set_error(error, "corrupt records in archive block " + std::to_string(block));
+        return false;
+    }
+    return true;
+}
+
+bool Archive::for_each_block(std::size_t first_block, unsigned threads, const BlockVisitor& visit,
+                             std::string* error) const {
+    const std::size_t window = std::max(1u, threads);
+    std::vector<std::vector<core::FileEntry>> decoded(window);
+    std::vector<std::string> errors(window);
+    std::vector<char> ok(window, 0);
+
+    for (std::size_t start = first_block; start < blocks_.size(); start += window) {
+        const std::size_t count = std::min(window, blocks_.size() - start);
+        std::vector<std::thread> pool;
+        for (std::size_t i = 1; i < count; ++i) {
+            pool.emplace_back([&, i]() {
+                ok[i] = read_block(start + i, decoded[i], &errors[i]) ? 1 : 0;
+            });
+        }
+        ok[0] = read_block(start, decoded[0], &errors[0]) ? 1 : 0;
+        for (std::thread& worker : pool) {
+            worker.join();
+        }
+
+        for (std::size_t i = 0; i < count; ++i) {
+            if (ok[i] == 0) {
+                fsutil::set_error(error, errors[i]);
+                return false;
+            }
+            if (!visit(start + i, decoded[i])) {
+                return true;
+            }
+        }
+    }
+    return true;
+}
+
+bool is_archive(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    char magic[sizeof(MAGIC)];
+    return in.read(magic, sizeof(magic)) && std::memcmp(magic, MAGIC, sizeof(MAGIC)) == 0;
+}
+
+} // namespace baseline_archive
@@ -0,0 +1,102 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <vector>
+#include "../core/types.h"
+
+namespace baseline_archive {
+
+// Block-compressed baseline container (.scbc). Records are grouped into
+// independent blocks: paths are front-coded against the previous record of the
+// same block, digests are stored as 32 raw bytes, sizes and mtimes as varints,
+// and each block carries its own CRC-32. A trailing block index holds every
+// block's offset and first path, so readers can seek and decode in parallel.
+struct Stats {
+    std::uint64_t records = 0;
+    std::uint64_t blocks = 0;
+    std::uint64_t raw_bytes = 0;
+    std::uint64_t stored_bytes = 0;
+};
+
+class Writer {
+public:
+    Writer();
+    ~Writer();
+    Writer(const Writer&) = delete;
+    Writer& operator=(const Writer&) = delete;
+
+    // Up to `threads` sealed blocks are compressed in parallel before being
+    // appended, so memory stays bounded at roughly threads x block size.
+    bool open(const std::string& path,
+              const std::string& root,
+              const std::string& generated,
+              bool path_sorted,
+              unsigned threads = 1,
+              std::string* error = nullptr);
+    bool add(const core::FileEntry& entry);
+    bool close(Stats* stats = nullptr, std::string* error = nullptr);
+
+private:
+    struct PendingBlock {
+        std::string raw;
+        std::string first_path;
+        std::uint32_t records = 0;
+    };
+
+    bool flush_pending();
+
+    std::ofstream out_;
+    std::string path_;
+    unsigned threads_ = 1;
+    PendingBlock current_;
+    std::vector<PendingBlock> pending_;
+    std::string previous_path_;
+    std::string index_;
+    Stats stats_;
+    bool failed_ = false;
+};
+
+// Receives decoded blocks in file order; return false to stop early.
+using BlockVisitor = std::function<bool(std::size_t block, std::vector<core::FileEntry>& entries)>;
+
+class Archive {
+public:
+    bool open(const std::string& path, std::string* error = nullptr);
+
+    const std::string& root() const { return root_; }
+    const std::string& generated() const { return generated_; }
+    bool path_sorted() const { return path_sorted_; }
+    std::uint64_t record_count() const { return record_count_; }
+    std::size_t block_count() const { return blocks_.size(); }
+
+    // Last block whose first path is <= `path` (0 when none); sorted archives only.
+    std::size_t find_block(const std::string& path) const;
+    // Safe to call from several threads: each call uses its own stream.
+    bool read_block(std::size_t block, std::vector<core::FileEntry>& entries,
+                    std::string* error = nullptr) const;
+    // Decodes up to `threads` blocks ahead in parallel and visits them in order.
+    bool for_each_block(std::size_t first_block, unsigned threads, const BlockVisitor& visit,
+                        std::string* error = nullptr) const;
+
+private:
+    struct BlockInfo {
+        std::uint64_t offset = 0;
+        std::uint64_t extent = 0;  // Bytes up to the next block or the index.
+        std::uint32_t records = 0;
+        std::string first_path;
+    };
+
+    std::string path_;
+    std::string root_;
+    std::string generated_;
+    bool path_sorted_ = false;
+    std::uint64_t record_count_ = 0;
+    std::vector<BlockInfo> blocks_;
+};
+
+bool is_archive(const std::string& path);
+
+} // namespace baseline_archive
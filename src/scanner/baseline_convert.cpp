@@ -0,0 +1,698 @@
+#include "baseline_convert.h"
+#include "baseline_archive.h"
+#include "baseline_stream.h"
+#include "external_sort.h"
+#include "../core/fsutil.h"
+#include "../core/output_buffer.h"
+#include "../core/types.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr std::size_t FLUSH_BYTES = 1 << 20;
+// Out-of-order imports are sorted through ExternalSort within this much
+// memory; larger sources spill sorted runs under DATA_DIR/spill.
+constexpr std::uint64_t IMPORT_SORT_BUDGET = std::uint64_t{64} << 20;
+
+struct SourceHeader {
+    std::string root;
+    std::string generated;
+};
+
+using HeaderVisitor = std::function<void(const SourceHeader&)>;
+// Return false to stop reading.
+using RecordVisitor = std::function<bool(core::FileEntry&)>;
+
+void append_utf8(std::string& out, unsigned long code) {
+    if (code < 0x80) {
+        out += static_cast<char>(code);
+    } else if (code < 0x800) {
+        out += static_cast<char>(0xC0 | (code >> 6));
+        out += static_cast<char>(0x80 | (code & 0x3F));
+    } else if (code < 0x10000) {
+        out += static_cast<char>(0xE0 | (code >> 12));
+        out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (code & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (code >> 18));
+        out += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (code & 0x3F));
+    }
+}
+
+bool parse_hex4(const std::string& text, std::size_t pos, unsigned long& code) {
+    if (pos + 4 > text.size()) {
+        return false;
+    }
+    try {
+        std::size_t used = 0;
+        code = std::stoul(text.substr(pos, 4), &used, 16);
+        return used == 4;
+    } catch (...) {
+        return false;
+    }
+}
+
+void skip_space(const std::string& text, std::size_t& pos) {
+    while (pos < text.size() && (text[pos] == ' ' || text[pos] == '\t' || text[pos] == '\r')) {
+        ++pos;
+    }
+}
+
+bool parse_json_string(const std::string& text, std::size_t& pos, std::string& value) {
+    if (pos >= text.size() || text[pos] != '"') {
+        return false;
+    }
+    ++pos;
+    value.clear();
+    while (pos < text.size()) {
+        const char ch = text[pos++];
+        if (ch == '"') {
+            return true;
+        }
+        if (ch != '\\') {
+            value += ch;
+            continue;
+        }
+        if (pos >= text.size()) {
+            return false;
+        }
+        const char esc = text[pos++];
+        switch (esc) {
+            case '"': value += '"'; break;
+            case '\\': value += '\\'; break;
+            case '/': value += '/'; break;
+            case 'b': value += '\b'; break;
+            case 'f': value += '\f'; break;
+            case 'n': value += '\n'; break;
+            case 'r': value += '\r'; break;
+            case 't': value += '\t'; break;
+            case 'u': {
+                unsigned long code = 0;
+                if (!parse_hex4(text, pos, code)) {
+                    return false;
+                }
+                pos += 4;
+                unsigned long low = 0;
+                if (code >= 0xD800 && code <= 0xDBFF && pos + 6 <= text.size() &&
+                    text[pos] == '\\' && text[pos + 1] == 'u' && parse_hex4(text, pos + 2, low) &&
+                    low >= 0xDC00 && low <= 0xDFFF) {
+                    code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                    pos += 6;
+                }
+                append_utf8(value, code);
+                break;
+            }
+            default:
+                return false;
+        }
+    }
+    return false;
+}
+
+// Flat objects only (string, number and literal values), which is all the
+// NDJSON exports contain.
+bool parse_flat_json(const std::string& line, std::vector<std::pair<std::string, std::string>>& fields) {
+    fields.clear();
+    std::size_t pos = 0;
+    skip_space(line, pos);
+    if (pos >= line.size() || line[pos] != '{') {
+        return false;
+    }
+    ++pos;
+    skip_space(line, pos);
+    if (pos < line.size() && line[pos] == '}') {
+        return true;
+    }
+
+    while (pos < line.size()) {
+        std::string key;
+        std::string value;
+        skip_space(line, pos);
+        if (!parse_json_string(line, pos, key)) {
+            return false;
+        }
+        skip_space(line, pos);
+        if (pos >= line.size() || line[pos] != ':') {
+            return false;
+        }
+        ++pos;
+        skip_space(line, pos);
+        if (pos < line.size() && line[pos] == '"') {
+            if (!parse_json_string(line, pos, value)) {
+                return false;
+            }
+        } else {
+            const std::size_t end = line.find_first_of(",}", pos);
+            if (end == std::string::npos) {
+                return false;
+            }
+            value = line.substr(pos, end - pos);
+            while (!value.empty() && (value.back() == ' ' || value.back() == '\t')) {
+                value.pop_back();
+            }
+            pos = end;
+        }
+        fields.emplace_back(std::move(key), std::move(value));
+
+        skip_space(line, pos);
+        if (pos >= line.size()) {
+            return false;
+        }
+        if (line[pos] == '}') {
+            return true;
+        }
+        if (line[pos] != ',') {
+            return false;
+        }
+        ++pos;
+    }
+    return false;
+}
+
+const std::string* field(const std::vector<std::pair<std::string, std::string>>& fields,
+                         const std::string& name) {
+    for (const auto& item : fields) {
+        if (item.first == name) {
+            return &item.second;
+        }
+    }
+    return nullptr;
+}
+
+bool parse_numbers(const std::string& size, const std::string& mtime, core::FileEntry& entry) {
+    try {
+        entry.size = static_cast<uintmax_t>(std::stoull(size));
+        entry.mtime = static_cast<std::time_t>(std::stoll(mtime));
+    } catch (...) {
+        return false;
+    }
+    return true;
+}
+
+// Splits one CSV record, pulling further lines while a quoted field is open.
+bool read_csv_record(std::istream& in, std::vector<std::string>& cells) {
+    cells.clear();
+    std::string line;
+    if (!std::getline(in, line)) {
+        return false;
+    }
+
+    std::string cell;
+    bool quoted = false;
+    std::size_t pos = 0;
+    while (true) {
+        if (pos >= line.size()) {
+            if (quoted) {
+                cell += '\n';
+                if (!std::getline(in, line)) {
+                    break;
+                }
+                pos = 0;
+                continue;
+            }
+            break;
+        }
+        const char ch = line[pos++];
+        if (quoted) {
+            if (ch == '"' && pos < line.size() && line[pos] == '"') {
+                cell += '"';
+                ++pos;
+            } else if (ch == '"') {
+                quoted = false;
+            } else {
+                cell += ch;
+            }
+        } else if (ch == '"') {
+            quoted = true;
+        } else if (ch == ',') {
+            cells.push_back(std::move(cell));
+            cell.clear();
+        } else if (ch != '\r') {
+            cell += ch;
+        }
+    }
+    cells.push_back(std::move(cell));
+    return true;
+}
+
+bool read_text(const std::string& path, const HeaderVisitor& on_header,
+               const RecordVisitor& on_record, std::string* error) {
+    scanner::BaselineReader reader;
+    if (!reader.open(path)) {
+        fsutil::set_error(error, "Source baseline file not found: " + path);
+        return false;
+    }
+    core::FileEntry entry;
+    const bool has_record = reader.next(entry);
+    if (!has_record && !reader.saw_header()) {
+        fsutil::set_error(error, "Baseline file is empty or invalid: " + path);
+        return false;
+    }
+    on_header({reader.root(), reader.generated()});
+    if (!has_record || !on_record(entry)) {
+        return true;
+    }
+    while (reader.next(entry)) {
+        if (!on_record(entry)) {
+            break;
+        }
+    }
+    return true;
+}
+
+bool read_binary(const std::string& path, unsigned threads, const HeaderVisitor& on_header,
+                 const RecordVisitor& on_record, std::string* error) {
+    baseline_archive::Archive archive;
+    if (!archive.open(path, error)) {
+        return false;
+    }
+    on_header({archive.root(), archive.generated()});
+    return archive.for_each_block(0, threads, [&](std::size_t, std::vector<core::FileEntry>& entries) {
+        for (core::FileEntry& entry : entries) {
+            if (!on_record(entry)) {
+                return false;
+            }
+        }
+        return true;
+    }, error);
+}
+
+bool read_ndjson(const std::string& path, const HeaderVisitor& on_header,
+                 const RecordVisitor& on_record, std::string* error) {
+    std::ifstream in(path);
+    if (!in.is_open()) {
+        fsutil::set_error(error, "Source baseline file not found: " + path);
+        return false;
+    }
+
+    std::vector<std::pair<std::string, std::string>> fields;
+    std::string line;
+    std::size_t line_number = 0;
+    bool header_sent = false;
+    bool saw_content = false;
+    core::FileEntry entry;
+    while (std::getline(in, line)) {
+        ++line_number;
+        if (line.find_first_not_of(" \t\r") == std::string::npos) {
+            continue;
+        }
+        if (!parse_flat_json(line, fields)) {
+            fsutil::set_error(error, "invalid JSON on line " + std::to_string(line_number) + " of " + path);
+            return false;
+        }
+        saw_content = true;
+
+        const std::string* type = field(fields, "type");
+        if (type != nullptr && *type == "baseline") {
+            if (!header_sent) {
+                const std::string* root = field(fields, "root");
+                const std::string* generated = field(fields, "generated");
+                on_header({root != nullptr ? *root : "", generated != nullptr ? *generated : ""});
+                header_sent = true;
+            }
+            continue;
+        }
+        if (type != nullptr && *type != "entry") {
+            continue;
+        }
+
+        const std::string* entry_path = field(fields, "path");
+        const std::string* hash = field(fields, "hash");
+        const std::string* size = field(fields, "size");
+        const std::string* mtime = field(fields, "mtime");
+        if (entry_path == nullptr || hash == nullptr || size == nullptr || mtime == nullptr ||
+            !parse_numbers(*size, *mtime, entry)) {
+            fsutil::set_error(error, "incomplete entry on line " + std::to_string(line_number) + " of " + path);
+            return false;
+        }
+        entry.path = *entry_path;
+        entry.hash = *hash;
+
+        if (!header_sent) {
+            on_header({});
+            header_sent = true;
+        }
+        if (!on_record(entry)) {
+            return true;
+        }
+    }
+
+    if (!saw_content) {
+        fsutil::set_error(error, "Baseline file is empty or invalid: " + path);
+        return false;
+    }
+    if (!header_sent) {
+        on_header({});
+    }
+    return true;
+}
+
+bool read_csv(const std::string& path, const HeaderVisitor& on_header,
+              const RecordVisitor& on_record, std::string* error) {
+    std::ifstream in(path);
+    if (!in.is_open()) {
+        fsutil::set_error(error, "Source baseline file not found: " + path);
+        return false;
+    }
+
+    std::vector<std::string> cells;
+    if (!read_csv_record(in, cells)) {
+        fsutil::set_error(error, "Baseline file is empty or invalid: " + path);
+        return false;
+    }
+    int path_col = -1;
+    int hash_col = -1;
+    int size_col = -1;
+    int mtime_col = -1;
+    for (std::size_t i = 0; i < cells.size(); ++i) {
+        const std::string& name = cells[i];
+        if (name == "path") {
+            path_col = static_cast<int>(i);
+        } else if (name == "sha256" || name == "hash") {
+            hash_col = static_cast<int>(i);
+        } else if (name == "size") {
+            size_col = static_cast<int>(i);
+        } else if (name == "mtime") {
+            mtime_col = static_cast<int>(i);
+        }
+    }
+    if (path_col < 0 || hash_col < 0 || size_col < 0 || mtime_col < 0) {
+        fsutil::set_error(error, "CSV header must name path, sha256, size and mtime columns: " + path);
+        return false;
+    }
+    const std::size_t needed =
+        static_cast<std::size_t>(std::max({path_col, hash_col, size_col, mtime_col})) + 1;
+
+    on_header({});
+    core::FileEntry entry;
+    std::size_t row = 1;
+    while (read_csv_record(in, cells)) {
+        ++row;
+        if (cells.size() == 1 && cells[0].empty()) {
+            continue;
+        }
+        if (cells.size() < needed || !parse_numbers(cells[size_col], cells[mtime_col], entry)) {
+            fsutil::set_error(error, "invalid CSV row " + std::to_string(row) + " in " + path);
+            return false;
+        }
+        entry.path = std::move(cells[path_col]);
+        entry.hash = std::move(cells[hash_col]);
+        if (!on_record(entry)) {
+            break;
+        }
+    }
+    return true;
+}
+
+bool read_source(const std::string& path, baseline_convert::Format format, unsigned threads,
+                 const HeaderVisitor& on_header, const RecordVisitor& on_record, std::string* error) {
+    switch (format) {
+        case baseline_convert::Format::Binary:
+            return read_binary(path, threads, on_header, on_record, error);
+        case baseline_convert::Format::Ndjson:
+            return read_ndjson(path, on_header, on_record, error);
+        case baseline_convert::Format::Csv:
+            return read_csv(path, on_header, on_record, error);
+        case baseline_convert::Format::Text:
+        default:
+            return read_text(path, on_header, on_record, error);
+    }
+}
+
+bool install_file(const std::string& temp_path, const std::string& destination, std::string* error) {
+    std::error_code ec;
+    fs::rename(temp_path, destination, ec);
+    if (ec) {
+        fs::remove(destination, ec);
+        ec.clear();
+        fs::rename(temp_path, destination, ec);
+    }
+    if (ec) {
+        fs::remove(temp_path, ec);
+        fsutil::set_error(error, "failed to write " + destination + ": " + ec.message());
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+namespace baseline_convert {
+
+bool parse_format(const std::string& name, Format& format) {
+    if (name == "text") {
+        format = Format::Text;
+    } else if (name == "binary") {
+        format = Format::Binary;
+    } else if (name == "ndjson") {
+        format = Format::Ndjson;
+    } else if (name == "csv") {
+        format = Format::Csv;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+const char* format_name(Format format) {
+    switch (format) {
+        case Format::Binary: return "binary";
+        case Format::Ndjson: return "ndjson";
+        case Format::Csv: return "csv";
+        case Format::Text:
+        default: return "text";
+    }
+}
+
+Format detect_format(const std::string& path) {
+    if (baseline_archive::is_archive(path)) {
+        return Format::Binary;
+    }
+    std::ifstream in(path);
+    std::string line;
+    while (std::getline(in, line)) {
+        const std::size_t start = line.find_first_not_of(" \t\r");
+        if (start == std::string::npos) {
+            continue;
+        }
+        if (line[start] == '{') {
+            return Format::Ndjson;
+        }
+        if (line.rfind("path,", start) == start) {
+            return Format::Csv;
+        }
+        break;
+    }
+    return Format::Text;
+}
+
+bool export_baseline(const std::string& baseline_path,
+                     const std::string& destination,
+                     Format format,
+                     const std::string& prefix,
+                     unsigned threads,
+                     Stats* stats,
+                     std::string* error) {
+    scanner::BaselineReader reader;
+    if (!reader.open(baseline_path)) {
+        fsutil::set_error(error, "Baseline file not found: " + baseline_path);
+        return false;
+    }
+
+    Stats result;
+    result.path_sorted = reader.path_sorted();
+    const std::string temp_path = destination + ".tmp";
+
+    baseline_archive::Writer archive;
+    scanner::BaselineWriter text;
+    core::OutputBuffer out(FLUSH_BYTES);
+
+    if (format == Format::Binary) {
+        if (!archive.open(destination, reader.root(), reader.generated(), result.path_sorted,
+                          threads, error)) {
+            return false;
+        }
+    } else if (format == Format::Text && result.path_sorted) {
+        if (!text.open(temp_path, reader.root(), reader.generated())) {
+            fsutil::set_error(error, "failed to open export file: " + destination);
+            return false;
+        }
+    } else {
+        if (!out.open(temp_path)) {
+            fsutil::set_error(error, "failed to open export file: " + destination);
+            return false;
+        }
+        if (format == Format::Text) {
+            out << "# Sentinel-C baseline v2\nroot\t" << reader.root()
+                << "\ngenerated\t" << reader.generated() << '\n';
+        } else if (format == Format::Ndjson) {
+            out << "{\"type\": \"baseline\", \"root\": \"" << core::json_text(reader.root())
+                << "\", \"generated\": \"" << core::json_text(reader.generated()) << "\"}\n";
+        } else {
+            out << "path,sha256,size,mtime\n";
+        }
+    }
+
+    bool ok = true;
+    core::FileEntry entry;
+    while (ok && reader.next(entry)) {
+        if (!prefix.empty() && entry.path.compare(0, prefix.size(), prefix) != 0) {
+            if (result.path_sorted && entry.path > prefix) {
+                break;
+            }
+            continue;
+        }
+        ++result.records;
+
+        switch (format) {
+            case Format::Binary:
+                ok = archive.add(entry);
+                break;
+            case Format::Text:
+                if (result.path_sorted) {
+                    ok = text.add(entry);
+                } else {
+                    out << "file\t" << entry.path << '\t' << entry.hash << '\t'
+                        << entry.size << '\t' << entry.mtime << '\n';
+                }
+                break;
+            case Format::Ndjson:
+                out << "{\"type\": \"entry\", \"path\": \"" << core::json_text(entry.path)
+                    << "\", \"hash\": \"" << core::json_text(entry.hash)
+                    << "\", \"size\": " << entry.size
+                    << ", \"mtime\": " << entry.mtime << "}\n";
+                break;
+            case Format::Csv:
+                out << core::csv_field(entry.path) << ',' << core::csv_field(entry.hash) << ','
+                    << entry.size << ',' << entry.mtime << '\n';
+                break;
+        }
+    }
+
+    if (format == Format::Binary) {
+        baseline_archive::Stats archive_stats;
+        if (!ok || !archive.close(&archive_stats, error)) {
+            fsutil::set_error(error, "failed to write export file: " + destination);
+            return false;
+        }
+        result.bytes_written = archive_stats.stored_bytes;
+    } else {
+        if (format == Format::Text && result.path_sorted) {
+            ok = text.close() && ok;
+        } else {
+            result.bytes_written = out.bytes_written();
+            ok = out.close() && ok;
+        }
+        if (!ok) {
+            std::error_code ec;
+            fs::remove(temp_path, ec);
+            fsutil::set_error(error, "failed to write export file: " + destination);
+            return false;
+        }
+        if (!install_file(temp_path, destination, error)) {
+            return false;
+        }
+        if (format == Format::Text && result.path_sorted) {
+            std::error_code ec;
+            result.bytes_written = static_cast<std::uint64_t>(fs::file_size(destination, ec));
+        }
+    }
+
+    if (stats != nullptr) {
+        *stats = result;
+    }
+    return true;
+}
+
+bool import_baseline(const std::string& source,
+                     Format format,
+                     const std::string& staged_path,
+                     unsigned threads,
+                     Stats* stats,
+                     std::string* error) {
+    Stats result;
+    SourceHeader header;
+    scanner::BaselineWriter writer;
+    bool opened = false;
+
+    const HeaderVisitor remember = [&](const SourceHeader& value) {
+        header = value;
+        opened = writer.open(staged_path, header.root, fsutil::timestamp());
+    };
+    const RecordVisitor stream = [&](core::FileEntry& entry) {
+        if (!opened || !writer.add(entry)) {
+            result.path_sorted = false;
+            return false;
+        }
+        ++result.records;
+        return true;
+    };
+
+    if (!read_source(source, format, threads, remember, stream, error)) {
+        writer.close();
+        std::error_code ec;
+        fs::remove(staged_path, ec);
+        return false;
+    }
+    if (!opened) {
+        fsutil::set_error(error, "failed to open staged baseline: " + staged_path);
+        return false;
+    }
+    if (!writer.close()) {
+        fsutil::set_error(error, "failed to write staged baseline: " + staged_path);
+        return false;
+    }
+
+    if (!result.path_sorted) {
+        // Out-of-order input: read it again through an external sort, which
+        // keeps the last record per path.
+        scanner::ExternalSort sorted(IMPORT_SORT_BUDGET, "import");
+        if (!read_source(source, format, threads, [](const SourceHeader&) {},
+                         [&](core::FileEntry& entry) { return sorted.add(std::move(entry)); },
+                         error)) {
+            if (!sorted.error().empty()) {
+                fsutil::set_error(error, sorted.error());
+            }
+            return false;
+        }
+        if (!sorted.finish()) {
+            fsutil::set_error(error, sorted.error());
+            return false;
+        }
+
+        if (!writer.open(staged_path, header.root, fsutil::timestamp())) {
+            fsutil::set_error(error, "failed to open staged baseline: " + staged_path);
+            return false;
+        }
+        bool added = true;
+        core::FileEntry entry;
+        while (added && sorted.next(entry)) {
+            added = writer.add(entry);
+        }
+        if (!writer.close() || !added || !sorted.error().empty()) {
+            std::error_code ec;
+            fs::remove(staged_path, ec);
+            fsutil::set_error(error, sorted.error().empty() ? "failed to write staged baseline: " + staged_path
+                                                            : sorted.error());
+            return false;
+        }
+        result.records = writer.count();
+    }
+
+    if (stats != nullptr) {
+        *stats = result;
+    }
+    return true;
+}
+
+} // namespace baseline_convert
@@ -0,0 +1,50 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+namespace baseline_convert {
+
+// Interchange formats for --export-baseline / --import-baseline.
+//   text   : native baseline format (root/generated/order headers + file records)
+//   binary : block-compressed .scbc container (see baseline_archive)
+//   ndjson : {"type":"baseline",...} header line, then one {"type":"entry",...} per record
+//   csv    : path,sha256,size,mtime header row, then one row per record (no root)
+enum class Format {
+    Text,
+    Binary,
+    Ndjson,
+    Csv
+};
+
+struct Stats {
+    std::uint64_t records = 0;
+    std::uint64_t bytes_written = 0;
+    bool path_sorted = true;
+};
+
+bool parse_format(const std::string& name, Format& format);
+const char* format_name(Format format);
+// Sniffs the container magic / first line; falls back to text.
+Format detect_format(const std::string& path);
+
+// Streams `baseline_path` into `destination`, keeping only paths that start with
+// `prefix` (empty keeps everything). Binary output compresses on `threads` threads.
+bool export_baseline(const std::string& baseline_path,
+                     const std::string& destination,
+                     Format format,
+                     const std::string& prefix,
+                     unsigned threads,
+                     Stats* stats = nullptr,
+                     std::string* error = nullptr);
+
+// Streams `source` into a path-sorted baseline file at `staged_path`, ready for
+// scanner::install_baseline. Sources that are not in path order are buffered
+// and sorted once; everything else is converted record by record.
+bool import_baseline(const std::string& source,
+                     Format format,
+                     const std::string& staged_path,
+                     unsigned threads,
+                     Stats* stats = nullptr,
+                     std::string* error = nullptr);
+
+} // namespace baseline_convert
@@ -0,0 +1,719 @@
+#include "baseline_index.h"
+#include "baseline_stream.h"
+#include "external_sort.h"
+#include "../core/codec.h"
+#include "../core/config.h"
+#include "../core/fsutil.h"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <queue>
+#include <system_error>
+#include <utility>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// Layout (all integers little-endian):
+//   header   : magic[8] digest[64] records trigrams records_off trigrams_off postings_off (u64 each)
+//   records  : { u64 line_offset, u32 line_length, u32 reserved } per record, path order
+//   trigrams : { u32 key, u32 count, u64 first_posting } sorted by key
+//   postings : u32 record ids, ascending within each trigram
+constexpr char MAGIC[8] = {'S', 'C', 'I', 'D', 'X', '1', '\0', '\0'};
+constexpr std::size_t DIGEST_SIZE = 64;
+constexpr std::uint64_t HEADER_SIZE = sizeof(MAGIC) + DIGEST_SIZE + 5 * 8;
+constexpr std::uint64_t RECORD_SIZE = 16;
+constexpr std::uint64_t TRIGRAM_SIZE = 16;
+// Postings store record ids as u32 and trigram slots count them in a u32, and
+// the build packs (key << 32 | id) into one u64, so a baseline can hold at
+// most this many records to be indexed.
+constexpr std::uint64_t MAX_RECORDS = std::numeric_limits<std::uint32_t>::max();
+
+// Further postings lists are only intersected while they stay within this
+// factor of the current candidate count; beyond that, verifying is cheaper.
+constexpr std::size_t INTERSECT_RATIO = 16;
+
+// Postings are sorted in runs of this many (trigram, record id) pairs, 32 MiB
+// each, so building the index for a large baseline does not hold every pair.
+constexpr std::size_t POSTINGS_RUN_PAIRS = std::size_t{1} << 22;
+// Runs merged at once; more are first merged down into wider runs.
+constexpr std::size_t POSTINGS_FAN_IN = 64;
+// Pairs read from or written to a run per I/O call.
+constexpr std::size_t POSTINGS_BLOCK_PAIRS = 8192;
+
+bool read_exact(std::ifstream& in, std::uint64_t offset, char* data, std::size_t size) {
+    in.clear();
+    in.seekg(static_cast<std::streamoff>(offset));
+    in.read(data, static_cast<std::streamsize>(size));
+    return static_cast<std::size_t>(in.gcount()) == size;
+}
+
+std::uint32_t trigram_key(const std::string& text, std::size_t pos) {
+    return (static_cast<std::uint32_t>(static_cast<unsigned char>(text[pos])) << 16) |
+           (static_cast<std::uint32_t>(static_cast<unsigned char>(text[pos + 1])) << 8) |
+           static_cast<std::uint32_t>(static_cast<unsigned char>(text[pos + 2]));
+}
+
+void collect_trigrams(const std::string& text, std::vector<std::uint32_t>& keys) {
+    for (std::size_t i = 0; i + 3 <= text.size(); ++i) {
+        keys.push_back(trigram_key(text, i));
+    }
+}
+
+std::string record_path(const std::string& line) {
+    const std::size_t start = line.rfind("file\t", 0) == 0 ? 5 : 0;
+    const std::size_t tab = line.find('\t', start);
+    return line.substr(start, tab == std::string::npos ? std::string::npos : tab - start);
+}
+
+// Sorts (trigram << 32 | record id) pairs. While they fit in one run they stay
+// in memory; beyond that full buffers are written as sorted runs under
+// DATA_DIR/spill and for_each() merges them back. Runs are native-endian
+// scratch files, removed with the sorter.
+class PostingSorter {
+public:
+    PostingSorter() { scanner::sweep_stale_spill_runs(); }
+    ~PostingSorter() {
+        std::error_code ec;
+        for (const std::string& path : runs_) {
+            fs::remove(path, ec);
+        }
+    }
+    PostingSorter(const PostingSorter&) = delete;
+    PostingSorter& operator=(const PostingSorter&) = delete;
+
+    bool add(std::uint64_t pair) {
+        buffer_.push_back(pair);
+        return buffer_.size() < POSTINGS_RUN_PAIRS || spill();
+    }
+
+    bool finish() {
+        if (runs_.empty()) {
+            std::sort(buffer_.begin(), buffer_.end());
+            return true;
+        }
+        if (!spill()) {
+            return false;
+        }
+        while (runs_.size() > POSTINGS_FAN_IN) {
+            const std::vector<std::string> group(runs_.begin(), runs_.begin() + POSTINGS_FAN_IN);
+            runs_.erase(runs_.begin(), runs_.begin() + POSTINGS_FAN_IN);
+            const std::string path = run_path();
+            runs_.push_back(path);
+            std::ofstream out(path, std::ios::binary | std::ios::trunc);
+            std::vector<std::uint64_t> block;
+            block.reserve(POSTINGS_BLOCK_PAIRS);
+            const bool merged = merge(group, [&](std::uint64_t pair) {
+                block.push_back(pair);
+                return block.size() < POSTINGS_BLOCK_PAIRS || write_block(out, block);
+            });
+            std::error_code ec;
+            for (const std::string& done : group) {
+                fs::remove(done, ec);
+            }
+            const bool flushed = write_block(out, block);
+            out.close();
+            if (!merged || !flushed || !out) {
+                return fail("failed to merge index postings run: " + path);
+            }
+        }
+        return true;
+    }
+
+    // Visits every pair in ascending order; may be called more than once.
+    template <typename Visit>
+    bool for_each(Visit visit) {
+        if (runs_.empty()) {
+            for (const std::uint64_t pair : buffer_) {
+                if (!visit(pair)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+        bool stopped = false;
+        if (merge(runs_, [&](std::uint64_t pair) {
+                stopped = !visit(pair);
+                return !stopped;
+            })) {
+            return true;
+        }
+        return !stopped && fail("failed to read index postings run");
+    }
+
+    const std::string& error() const { return error_; }
+
+private:
+    struct Run {
+        std::ifstream in;
+        std::vector<std::uint64_t> block;
+        std::size_t next = 0;
+
+        bool pull(std::uint64_t& pair) {
+            if (next == block.size()) {
+                block.resize(POSTINGS_BLOCK_PAIRS);
+                in.read(reinterpret_cast<char*>(block.data()),
+                        static_cast<std::streamsize>(block.size() * sizeof(std::uint64_t)));
+                block.resize(static_cast<std::size_t>(in.gcount()) / sizeof(std::uint64_t));
+                next = 0;
+                if (block.empty()) {
+                    return false;
+                }
+            }
+            pair = block[next++];
+            return true;
+        }
+    };
+
+    static bool write_block(std::ofstream& out, std::vector<std::uint64_t>& block) {
+        out.write(reinterpret_cast<const char*>(block.data()),
+                  static_cast<std::streamsize>(block.size() * sizeof(std::uint64_t)));
+        block.clear();
+        return static_cast<bool>(out);
+    }
+
+    static bool merge(const std::vector<std::string>& paths,
+                      const std::function<bool(std::uint64_t)>& visit) {
+        std::vector<Run> runs(paths.size());
+        using Head = std::pair<std::uint64_t, std::size_t>;
+        std::priority_queue<Head, std::vector<Head>, std::greater<Head>> heap;
+        for (std::size_t i = 0; i < paths.size(); ++i) {
+            runs[i].in.open(paths[i], std::ios::binary);
+            if (!runs[i].in.is_open()) {
+                return false;
+            }
+            std::uint64_t pair = 0;
+            if (runs[i].pull(pair)) {
+                heap.emplace(pair, i);
+            }
+        }
+        while (!heap.empty()) {
+            const Head head = heap.top();
+            heap.pop();
+            if (!visit(head.first)) {
+                return false;
+            }
+            std::uint64_t pair = 0;
+            if (runs[head.second].pull(pair)) {
+                heap.emplace(pair, head.second);
+            }
+        }
+        return true;
+    }
+
+    bool spill() {
+        if (buffer_.empty()) {
+            return true;
+        }
+        std::sort(buffer_.begin(), buffer_.end());
+        const std::string path = run_path();
+        runs_.push_back(path);
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        if (!out.is_open() || !write_block(out, buffer_)) {
+            return fail("failed to write index postings run: " + path);
+        }
+        return true;
+    }
+
+    std::string run_path() {
+        const fs::path directory = fs::path(config::DATA_DIR) / "spill";
+        std::error_code ec;
+        fs::create_directories(directory, ec);
+        return (directory / (config::RUN_ID + "-index-" + std::to_string(runs_written_++) + ".run"))
+            .generic_string();
+    }
+
+    bool fail(const std::string& message) {
+        if (error_.empty()) {
+            error_ = message;
+        }
+        return false;
+    }
+
+    std::vector<std::uint64_t> buffer_;
+    std::vector<std::string> runs_;
+    std::size_t runs_written_ = 0;
+    std::string error_;
+};
+
+std::vector<std::string> glob_literals(const std::string& pattern) {
+    std::vector<std::string> literals;
+    std::string current;
+    for (const char ch : pattern) {
+        if (ch == '*' || ch == '?') {
+            if (!current.empty()) {
+                literals.push_back(current);
+                current.clear();
+            }
+            continue;
+        }
+        current.push_back(ch);
+    }
+    if (!current.empty()) {
+        literals.push_back(current);
+    }
+    return literals;
+}
+
+} // namespace
+
+namespace baseline_index {
+
+bool Index::open(const std::string& baseline_digest, std::string* error) {
+    index_.close();
+    baseline_.close();
+    index_.clear();
+    baseline_.clear();
+
+    index_.open(config::BASELINE_INDEX, std::ios::binary);
+    if (!index_.is_open()) {
+        fsutil::set_error(error, "baseline index not found: " + config::BASELINE_INDEX);
+        return false;
+    }
+
+    std::array<char, HEADER_SIZE> header{};
+    if (!read_exact(index_, 0, header.data(), header.size()) ||
+        std::memcmp(header.data(), MAGIC, sizeof(MAGIC)) != 0) {
+        fsutil::set_error(error, "baseline index is invalid: " + config::BASELINE_INDEX);
+        return false;
+    }
+
+    const std::string digest(header.data() + sizeof(MAGIC), DIGEST_SIZE);
+    if (baseline_digest.empty() || digest != baseline_digest) {
+        fsutil::set_error(error, "baseline index is stale; run --index-baseline to rebuild it");
+        return false;
+    }
+
+    const char* fields = header.data() + sizeof(MAGIC) + DIGEST_SIZE;
+    record_count_ = codec::get_u64(fields);
+    trigram_count_ = codec::get_u64(fields + 8);
+    records_offset_ = codec::get_u64(fields + 16);
+    trigrams_offset_ = codec::get_u64(fields + 24);
+    postings_offset_ = codec::get_u64(fields + 32);
+
+    baseline_.open(config::BASELINE_DB, std::ios::binary);
+    if (!baseline_.is_open()) {
+        fsutil::set_error(error, "Baseline file not found: " + config::BASELINE_DB);
+        return false;
+    }
+    return true;
+}
+
+std::uint64_t Index::offset(std::size_t id) {
+    std::array<char, RECORD_SIZE> slot{};
+    if (!read_exact(index_, records_offset_ + id * RECORD_SIZE, slot.data(), slot.size())) {
+        return 0;
+    }
+    return codec::get_u64(slot.data());
+}
+
+bool Index::read_path(std::size_t id, std::string& path) {
+    core::FileEntry entry;
+    if (!record(id, entry)) {
+        return false;
+    }
+    path = std::move(entry.path);
+    return true;
+}
+
+bool Index::record(std::size_t id, core::FileEntry& entry) {
+    if (id >= record_count_) {
+        return false;
+    }
+
+    std::array<char, RECORD_SIZE> slot{};
+    if (!read_exact(index_, records_offset_ + id * RECORD_SIZE, slot.data(), slot.size())) {
+        return false;
+    }
+
+    std::string line(codec::get_u32(slot.data() + 8), '\0');
+    if (!read_exact(baseline_, codec::get_u64(slot.data()),
+                    line.data(), line.size())) {
+        return false;
+    }
+    if (!line.empty() && line.back() == '\r') {
+        line.pop_back();
+    }
+    return scanner::parse_baseline_record(line, entry);
+}
+
+std::size_t Index::lower_bound(const std::string& path) {
+    std::size_t low = 0;
+    std::size_t high = static_cast<std::size_t>(record_count_);
+    std::string probe;
+    while (low < high) {
+        const std::size_t mid = low + (high - low) / 2;
+        if (!read_path(mid, probe) || probe < path) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+std::optional<std::size_t> Index::find_exact(const std::string& path) {
+    const std::size_t id = lower_bound(path);
+    std::string probe;
+    if (id < record_count_ && read_path(id, probe) && probe == path) {
+        return id;
+    }
+    return std::nullopt;
+}
+
+std::optional<Index::TrigramSlot> Index::find_trigram(std::uint32_t key) {
+    std::uint64_t low = 0;
+    std::uint64_t high = trigram_count_;
+    std::array<char, TRIGRAM_SIZE> slot{};
+    while (low < high) {
+        const std::uint64_t mid = low + (high - low) / 2;
+        if (!read_exact(index_, trigrams_offset_ + mid * TRIGRAM_SIZE, slot.data(), slot.size())) {
+            return std::nullopt;
+        }
+        const std::uint32_t mid_key = codec::get_u32(slot.data());
+        if (mid_key == key) {
+            return TrigramSlot{mid_key, codec::get_u32(slot.data() + 4), codec::get_u64(slot.data() + 8)};
+        }
+        if (mid_key < key) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return std::nullopt;
+}
+
+std::vector<std::uint32_t> Index::postings(const TrigramSlot& slot) {
+    std::vector<char> raw(static_cast<std::size_t>(slot.count) * 4);
+    std::vector<std::uint32_t> ids;
+    if (!read_exact(index_, postings_offset_ + slot.first * 4, raw.data(), raw.size())) {
+        return ids;
+    }
+    ids.reserve(slot.count);
+    for (std::size_t i = 0; i < raw.size(); i += 4) {
+        ids.push_back(codec::get_u32(raw.data() + i));
+    }
+    return ids;
+}
+
+std::vector<std::size_t> Index::candidates(const std::vector<std::string>& literals, bool& usable) {
+    std::vector<std::uint32_t> keys;
+    for (const std::string& literal : literals) {
+        collect_trigrams(literal, keys);
+    }
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+    usable = !keys.empty();
+    std::vector<std::size_t> result;
+    if (!usable) {
+        return result;
+    }
+
+    std::vector<TrigramSlot> slots;
+    for (const std::uint32_t key : keys) {
+        const auto slot = find_trigram(key);
+        if (!slot.has_value()) {
+            return result;
+        }
+        slots.push_back(*slot);
+    }
+    std::sort(slots.begin(), slots.end(), [](const TrigramSlot& left, const TrigramSlot& right) {
+        return left.count < right.count;
+    });
+
+    std::vector<std::uint32_t> current = postings(slots.front());
+    for (std::size_t i = 1; i < slots.size() && !current.empty(); ++i) {
+        if (slots[i].count > current.size() * INTERSECT_RATIO) {
+            break;
+        }
+        const std::vector<std::uint32_t> other = postings(slots[i]);
+        std::vector<std::uint32_t> merged;
+        std::set_intersection(current.begin(), current.end(), other.begin(), other.end(),
+                              std::back_inserter(merged));
+        current.swap(merged);
+    }
+
+    result.assign(current.begin(), current.end());
+    return result;
+}
+
+std::vector<std::size_t> Index::find_substring(const std::string& needle,
+                                               std::size_t max_results,
+                                               std::size_t& total) {
+    total = 0;
+    std::vector<std::size_t> matches;
+    bool usable = false;
+    std::vector<std::size_t> ids = candidates({needle}, usable);
+    std::string path;
+
+    const auto consider = [&](std::size_t id) {
+        if (read_path(id, path) && path.find(needle) != std::string::npos) {
+            ++total;
+            if (matches.size() < max_results) {
+                matches.push_back(id);
+            }
+        }
+    };
+
+    if (usable) {
+        for (const std::size_t id : ids) {
+            consider(id);
+        }
+    } else {
+        // Needles shorter than a trigram cannot use postings.
+        for (std::size_t id = 0; id < record_count_; ++id) {
+            consider(id);
+        }
+    }
+    return matches;
+}
+
+std::vector<std::size_t> Index::find_glob(const std::string& pattern,
+                                          std::size_t max_results,
+                                          std::size_t& total) {
+    total = 0;
+    std::vector<std::size_t> matches;
+    bool usable = false;
+    std::vector<std::size_t> ids = candidates(glob_literals(pattern), usable);
+    std::string path;
+
+    const auto consider = [&](std::size_t id) {
+        if (read_path(id, path) && glob_match(path, pattern)) {
+            ++total;
+            if (matches.size() < max_results) {
+                matches.push_back(id);
+            }
+        }
+    };
+
+    if (usable) {
+        for (const std::size_t id : ids) {
+            consider(id);
+        }
+    } else {
+        for (std::size_t id = 0; id < record_count_; ++id) {
+            consider(id);
+        }
+    }
+    return matches;
+}
+
+bool exists() {
+    std::error_code ec;
+    return fs::exists(config::BASELINE_INDEX, ec);
+}
+
+bool build(const std::string& baseline_digest, std::string* error) {
+    std::ifstream in(config::BASELINE_DB, std::ios::binary);
+    if (!in.is_open()) {
+        fsutil::set_error(error, "Baseline file not found: " + config::BASELINE_DB);
+        return false;
+    }
+
+    const std::string temp_path = config::BASELINE_INDEX + ".tmp";
+    std::ofstream out(temp_path, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        fsutil::set_error(error, "failed to open baseline index for write: " + temp_path);
+        return false;
+    }
+    const auto abandon = [&](const std::string& message) {
+        out.close();
+        std::error_code ec;
+        fs::remove(temp_path, ec);
+        fsutil::set_error(error, message);
+        return false;
+    };
+
+    // The header is written last, once the section sizes are known; the record
+    // table streams out as the baseline is read.
+    out.write(std::string(HEADER_SIZE, '\0').data(), static_cast<std::streamsize>(HEADER_SIZE));
+
+    std::string chunk;
+    chunk.reserve(1 << 20);
+    const auto flush_chunk = [&]() {
+        out.write(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+        chunk.clear();
+    };
+
+    PostingSorter postings;
+    std::uint64_t record_count = 0;
+    std::vector<std::uint32_t> keys;
+    bool path_sorted = false;
+    std::uint64_t offset = 0;
+    std::string line;
+    std::string previous;
+
+    while (std::getline(in, line)) {
+        const std::uint64_t line_offset = offset;
+        offset += line.size() + 1;
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        if (line == "order\tpath") {
+            path_sorted = true;
+            continue;
+        }
+        if (line.rfind("file\t", 0) != 0) {
+            continue;
+        }
+
+        const std::string path = record_path(line);
+        if (!path_sorted || (record_count > 0 && path < previous)) {
+            return abandon("baseline is not path-sorted; run --update once to rewrite it");
+        }
+        previous = path;
+        if (record_count >= MAX_RECORDS) {
+            return abandon("baseline has more than " + std::to_string(MAX_RECORDS) +
+                           " records; the index format cannot address them");
+        }
+
+        const std::uint64_t id = record_count++;
+        codec::put_u64(chunk, line_offset);
+        codec::put_u32(chunk, static_cast<std::uint32_t>(line.size()));
+        codec::put_u32(chunk, 0);
+        if (chunk.size() >= (1 << 20)) {
+            flush_chunk();
+        }
+
+        keys.clear();
+        collect_trigrams(path, keys);
+        std::sort(keys.begin(), keys.end());
+        keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+        for (const std::uint32_t key : keys) {
+            if (!postings.add((static_cast<std::uint64_t>(key) << 32) | id)) {
+                return abandon(postings.error());
+            }
+        }
+    }
+    flush_chunk();
+    if (!postings.finish()) {
+        return abandon(postings.error());
+    }
+
+    // One pass over the sorted pairs lays out the trigram table, a second
+    // writes the postings behind it.
+    std::string trigram_table;
+    std::uint64_t trigram_count = 0;
+    std::uint32_t key = 0;
+    std::uint64_t first = 0;
+    std::uint64_t position = 0;
+    const auto close_trigram = [&]() {
+        codec::put_u32(trigram_table, key);
+        codec::put_u32(trigram_table, static_cast<std::uint32_t>(position - first));
+        codec::put_u64(trigram_table, first);
+        ++trigram_count;
+    };
+    const bool counted = postings.for_each([&](std::uint64_t pair) {
+        const std::uint32_t pair_key = static_cast<std::uint32_t>(pair >> 32);
+        if (position > 0 && pair_key != key) {
+            close_trigram();
+            first = position;
+        }
+        key = pair_key;
+        ++position;
+        return true;
+    });
+    if (!counted) {
+        return abandon(postings.error());
+    }
+    if (position > 0) {
+        close_trigram();
+    }
+    out.write(trigram_table.data(), static_cast<std::streamsize>(trigram_table.size()));
+
+    const bool written = postings.for_each([&](std::uint64_t pair) {
+        codec::put_u32(chunk, static_cast<std::uint32_t>(pair & 0xFFFFFFFFu));
+        if (chunk.size() >= (1 << 20)) {
+            flush_chunk();
+        }
+        return static_cast<bool>(out);
+    });
+    if (!written) {
+        return abandon(postings.error().empty() ? "failed to write baseline index: " + temp_path
+                                                : postings.error());
+    }
+    flush_chunk();
+
+    const std::uint64_t records_offset = HEADER_SIZE;
+    const std::uint64_t trigrams_offset = records_offset + record_count * RECORD_SIZE;
+    const std::uint64_t postings_offset = trigrams_offset + trigram_count * TRIGRAM_SIZE;
+
+    std::string header(MAGIC, sizeof(MAGIC));
+    std::string digest = baseline_digest;
+    digest.resize(DIGEST_SIZE, '\0');
+    header += digest;
+    codec::put_u64(header, record_count);
+    codec::put_u64(header, trigram_count);
+    codec::put_u64(header, records_offset);
+    codec::put_u64(header, trigrams_offset);
+    codec::put_u64(header, postings_offset);
+    out.seekp(0);
+    out.write(header.data(), static_cast<std::streamsize>(header.size()));
+
+    out.close();
+    if (!out) {
+        return abandon("failed to flush baseline index: " + temp_path);
+    }
+
+    std::error_code ec;
+    fs::rename(temp_path, config::BASELINE_INDEX, ec);
+    if (ec) {
+        fs::remove(config::BASELINE_INDEX, ec);
+        ec.clear();
+        fs::rename(temp_path, config::BASELINE_INDEX, ec);
+        if (ec) {
+            fsutil::set_error(error, "failed to install baseline index: " + ec.message());
+            return false;
+        }
+    }
+    fsutil::tighten_file_permissions(config::BASELINE_INDEX);
+    return true;
+}
+
+bool refresh_if_present(const std::string& baseline_digest, std::string* error) {
+    if (!exists()) {
+        return true;
+    }
+    return build(baseline_digest, error);
+}
+
+bool is_glob(const std::string& pattern) {
+    return pattern.find_first_of("*?") != std::string::npos;
+}
+
+bool glob_match(const std::string& text, const std::string& pattern) {
+    std::size_t t = 0;
+    std::size_t p = 0;
+    std::size_t star = std::string::npos;
+    std::size_t resume = 0;
+
+    while (t < text.size()) {
+        if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == text[t])) {
+            ++t;
+            ++p;
+        } else if (p < pattern.size() && pattern[p] == '*') {
+            star = p++;
+            resume = t;
+        } else if (star != std::string::npos) {
+            p = star + 1;
+            t = ++resume;
+        } else {
+            return false;
+        }
+    }
+    while (p < pattern.size() && pattern[p] == '*') {
+        ++p;
+    }
+    return p == pattern.size();
+}
+
+} // namespace baseline_index
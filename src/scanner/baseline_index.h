@@ -0,0 +1,67 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <vector>
+#include "../core/types.h"
+
+namespace baseline_index {
+
+// Optional on-disk index over a path-sorted baseline: a record offset table
+// (exact and range lookups by binary search) plus trigram postings (substring
+// and glob lookups). Stored next to the baseline and bound to its digest.
+class Index {
+public:
+    // Fails when the index is missing or was built for a different baseline.
+    bool open(const std::string& baseline_digest, std::string* error = nullptr);
+
+    std::size_t size() const { return record_count_; }
+    bool record(std::size_t id, core::FileEntry& entry);
+    // Byte offset of a record line inside the baseline file.
+    std::uint64_t offset(std::size_t id);
+
+    std::optional<std::size_t> find_exact(const std::string& path);
+    // First record whose path is not less than `path`.
+    std::size_t lower_bound(const std::string& path);
+    // Record ids in path order; `total` receives the full match count.
+    std::vector<std::size_t> find_substring(const std::string& needle,
+                                            std::size_t max_results,
+                                            std::size_t& total);
+    std::vector<std::size_t> find_glob(const std::string& pattern,
+                                       std::size_t max_results,
+                                       std::size_t& total);
+
+private:
+    struct TrigramSlot {
+        std::uint32_t key = 0;
+        std::uint32_t count = 0;
+        std::uint64_t first = 0;
+    };
+
+    bool read_path(std::size_t id, std::string& path);
+    std::optional<TrigramSlot> find_trigram(std::uint32_t key);
+    std::vector<std::uint32_t> postings(const TrigramSlot& slot);
+    std::vector<std::size_t> candidates(const std::vector<std::string>& literals, bool& usable);
+
+    std::ifstream index_;
+    std::ifstream baseline_;
+    std::uint64_t record_count_ = 0;
+    std::uint64_t trigram_count_ = 0;
+    std::uint64_t records_offset_ = 0;
+    std::uint64_t trigrams_offset_ = 0;
+    std::uint64_t postings_offset_ = 0;
+};
+
+bool exists();
+bool build(const std::string& baseline_digest, std::string* error = nullptr);
+// Rebuilds the index after a baseline save, but only if one was requested before.
+bool refresh_if_present(const std::string& baseline_digest, std::string* error = nullptr);
+
+// Anchored glob over the whole path: '*' spans any characters (including '/'),
+// '?' matches exactly one.
+bool glob_match(const std::string& text, const std::string& pattern);
+bool is_glob(const std::string& pattern);
+
+} // namespace baseline_index
@@ -0,0 +1,58 @@
+#pragma once
+#include <cstddef>
+#include <fstream>
+#include <optional>
+#include <string>
+#include "../core/types.h"
+
+namespace scanner {
+
+// Pull-based reader over a baseline-format file. Records are yielded in file
+// order without building a FileMap, so path-sorted baselines can be merged,
+// diffed or paged in constant memory.
+class BaselineReader {
+public:
+    bool open(const std::string& path);
+    bool next(core::FileEntry& entry);
+
+    const std::string& root() const { return root_; }
+    const std::string& generated() const { return generated_; }
+    bool path_sorted() const { return path_sorted_; }
+    std::optional<std::size_t> count() const { return count_; }
+    bool saw_header() const { return saw_header_; }
+
+private:
+    std::ifstream in_;
+    std::string root_;
+    std::string generated_;
+    std::string pending_;
+    std::optional<std::size_t> count_;
+    bool path_sorted_ = false;
+    bool saw_header_ = false;
+    bool has_pending_ = false;
+};
+
+// Writes a path-sorted baseline-format file record by record. When the total
+// is not known up front the count header is reserved and patched on close.
+class BaselineWriter {
+public:
+    bool open(const std::string& path,
+              const std::string& root,
+              const std::string& generated,
+              std::optional<std::size_t> expected_count = std::nullopt);
+    // Rejects records that would break path order.
+    bool add(const core::FileEntry& entry);
+    bool close();
+
+    std::size_t count() const { return count_; }
+
+private:
+    std::ofstream out_;
+    std::string last_path_;
+    std::streampos count_field_ = -1;
+    std::size_t count_ = 0;
+};
+
+bool parse_baseline_record(const std::string& line, core::FileEntry& entry);
+
+} // namespace scanner
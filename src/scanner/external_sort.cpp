@@ -0,0 +1,266 @@
+#include "external_sort.h"
+#include "../core/config.h"
+#include "../core/trace.h"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <system_error>
+#include <utility>
+
+namespace fs = std::filesystem;
+
+namespace scanner {
+
+namespace {
+
+// Run files untouched for this long belong to a run that died without
+// cleaning up; younger ones may still be in use by a concurrent scan.
+constexpr auto kStaleRunAge = std::chrono::hours(24);
+
+// Heap bytes a buffered record holds, near enough to keep the budget honest.
+std::uint64_t record_bytes(const core::FileEntry& entry) {
+    return sizeof(core::FileEntry) + entry.path.capacity() + entry.hash.capacity();
+}
+
+} // namespace
+
+void sweep_stale_spill_runs() {
+    static bool swept = false;
+    if (swept) {
+        return;
+    }
+    swept = true;
+
+    std::error_code ec;
+    const fs::path directory = fs::path(config::DATA_DIR) / "spill";
+    fs::directory_iterator it(directory, ec);
+    if (ec) {
+        return;
+    }
+    const auto cutoff = fs::file_time_type::clock::now() - kStaleRunAge;
+    for (; it != fs::directory_iterator(); it.increment(ec)) {
+        if (ec) {
+            return;
+        }
+        const fs::path& path = it->path();
+        const std::string name = path.filename().string();
+        if (path.extension() != ".run" || name.rfind(config::RUN_ID + "-", 0) == 0) {
+            continue;
+        }
+        std::error_code stat_ec;
+        const auto written = fs::last_write_time(path, stat_ec);
+        if (!stat_ec && written < cutoff) {
+            fs::remove(path, stat_ec);
+        }
+    }
+}
+
+ExternalSort::ExternalSort(std::uint64_t budget_bytes, std::string tag)
+    : budget_(std::max<std::uint64_t>(budget_bytes, 1)), tag_(std::move(tag)) {
+    sweep_stale_spill_runs();
+}
+
+ExternalSort::~ExternalSort() {
+    sources_.clear();
+    std::error_code ec;
+    for (const std::string& path : run_paths_) {
+        fs::remove(path, ec);
+    }
+}
+
+bool ExternalSort::fail(const std::string& message) {
+    if (error_.empty()) {
+        error_ = message;
+    }
+    return false;
+}
+
+std::string ExternalSort::run_path() {
+    const fs::path directory = fs::path(config::DATA_DIR) / "spill";
+    std::error_code ec;
+    fs::create_directories(directory, ec);
+    return (directory / (config::RUN_ID + "-" + tag_ + "-" + std::to_string(runs_written_) + ".run"))
+        .generic_string();
+}
+
+bool ExternalSort::add(core::FileEntry entry) {
+    if (finished_ || !error_.empty()) {
+        return false;
+    }
+    buffered_bytes_ += record_bytes(entry);
+    buffer_.push_back(std::move(entry));
+    if (buffered_bytes_ >= budget_) {
+        return spill();
+    }
+    return true;
+}
+
+// Writes the buffer as one sorted run. A path added twice keeps its last record.
+bool ExternalSort::spill() {
+    if (buffer_.empty()) {
+        return true;
+    }
+    trace::Span span("spill run", "scan");
+    std::stable_sort(buffer_.begin(), buffer_.end(),
+                     [](const core::FileEntry& left, const core::FileEntry& right) {
+                         return left.path < right.path;
+                     });
+    const std::string path = run_path();
+    BaselineWriter writer;
+    if (!writer.open(path, "", "")) {
+        return fail("Failed to open spill run: " + path);
+    }
+    run_paths_.push_back(path);
+    ++runs_written_;
+    for (std::size_t i = 0; i < buffer_.size(); ++i) {
+        if (i + 1 < buffer_.size() && buffer_[i + 1].path == buffer_[i].path) {
+            continue;
+        }
+        if (!writer.add(buffer_[i])) {
+            writer.close();
+            return fail("Failed to write spill run: " + path);
+        }
+    }
+    if (!writer.close()) {
+        return fail("Failed to write spill run: " + path);
+    }
+    buffer_.clear();
+    buffered_bytes_ = 0;
+    return true;
+}
+
+bool ExternalSort::finish() {
+    if (finished_) {
+        return error_.empty();
+    }
+    finished_ = true;
+    if (!error_.empty()) {
+        return false;
+    }
+    if (run_paths_.empty()) {
+        std::stable_sort(buffer_.begin(), buffer_.end(),
+                         [](const core::FileEntry& left, const core::FileEntry& right) {
+                             return left.path < right.path;
+                         });
+        return true;
+    }
+    if (!spill()) {
+        return false;
+    }
+    std::vector<core::FileEntry>().swap(buffer_);
+    while (run_paths_.size() > kMaxFanIn) {
+        if (!merge_down()) {
+            return false;
+        }
+    }
+    return open_merge(run_paths_);
+}
+
+bool ExternalSort::open_merge(const std::vector<std::string>& paths) {
+    sources_.clear();
+    heap_.clear();
+    for (const std::string& path : paths) {
+        auto source = std::make_unique<Source>();
+        if (!source->reader.open(path)) {
+            return fail("Failed to read spill run: " + path);
+        }
+        if (source->reader.next(source->head)) {
+            heap_.push_back(sources_.size());
+        }
+        sources_.push_back(std::move(source));
+    }
+    std::make_heap(heap_.begin(), heap_.end(), [this](std::size_t a, std::size_t b) { return later(a, b); });
+    return true;
+}
+
+// Heap order: the source whose head should come out after the other's.
+bool ExternalSort::later(std::size_t left, std::size_t right) const {
+    const std::string& a = sources_[left]->head.path;
+    const std::string& b = sources_[right]->head.path;
+    return a > b || (a == b && left < right);
+}
+
+// Smallest path across the open runs. Equal paths come from the most recent
+// run first and the older duplicates are dropped.
+bool ExternalSort::pull(core::FileEntry& entry) {
+    const auto later = [this](std::size_t a, std::size_t b) { return this->later(a, b); };
+    const auto advance = [&](std::size_t index) {
+        if (sources_[index]->reader.next(sources_[index]->head)) {
+            heap_.push_back(index);
+            std::push_heap(heap_.begin(), heap_.end(), later);
+        }
+    };
+
+    if (heap_.empty()) {
+        return false;
+    }
+    std::pop_heap(heap_.begin(), heap_.end(), later);
+    const std::size_t first = heap_.back();
+    heap_.pop_back();
+    entry = std::move(sources_[first]->head);
+    advance(first);
+    while (!heap_.empty() && sources_[heap_.front()]->head.path == entry.path) {
+        std::pop_heap(heap_.begin(), heap_.end(), later);
+        const std::size_t duplicate = heap_.back();
+        heap_.pop_back();
+        advance(duplicate);
+    }
+    return true;
+}
+
+// Merges the oldest kMaxFanIn runs into one, kept first so recency order holds.
+bool ExternalSort::merge_down() {
+    trace::Span span("merge runs", "scan");
+    const std::vector<std::string> inputs(run_paths_.begin(), run_paths_.begin() + kMaxFanIn);
+    if (!open_merge(inputs)) {
+        return false;
+    }
+    const std::string path = run_path();
+    BaselineWriter writer;
+    if (!writer.open(path, "", "")) {
+        std::error_code ec;
+        fs::remove(path, ec);
+        return fail("Failed to open spill run: " + path);
+    }
+    ++runs_written_;
+    bool added = true;
+    core::FileEntry entry;
+    while (added && pull(entry)) {
+        added = writer.add(entry);
+    }
+    sources_.clear();
+    heap_.clear();
+    const bool written = writer.close() && added;
+
+    std::error_code ec;
+    for (const std::string& input : inputs) {
+        fs::remove(input, ec);
+    }
+    run_paths_.erase(run_paths_.begin(), run_paths_.begin() + kMaxFanIn);
+    run_paths_.insert(run_paths_.begin(), path);
+    if (!written) {
+        return fail("Failed to write spill run: " + path);
+    }
+    return true;
+}
+
+bool ExternalSort::next(core::FileEntry& entry) {
+    if (!finished_ || !error_.empty()) {
+        return false;
+    }
+    if (!run_paths_.empty()) {
+        return pull(entry);
+    }
+    while (buffer_next_ < buffer_.size()) {
+        const std::size_t index = buffer_next_++;
+        if (buffer_next_ < buffer_.size() && buffer_[buffer_next_].path == buffer_[index].path) {
+            continue;
+        }
+        entry = std::move(buffer_[index]);
+        return true;
+    }
+    std::vector<core::FileEntry>().swap(buffer_);
+    return false;
+}
+
+} // namespace scanner
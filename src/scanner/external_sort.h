@@ -0,0 +1,67 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "baseline_stream.h"
+#include "../core/types.h"
+
+namespace scanner {
+
+// Removes run files under DATA_DIR/spill left behind by earlier processes that
+// stopped before cleaning up. Runs once per process; sorters call it on start.
+void sweep_stale_spill_runs();
+
+// Sorts FileEntry records by path within a memory budget. Records are
+// buffered until their estimated size reaches the budget, then sorted and
+// written as a baseline-format run under DATA_DIR/spill; next() merges the
+// runs back in path order, one record per path. When nothing was spilled the
+// buffer is merged in place and no file is touched. Run files are removed
+// with the sorter.
+class ExternalSort {
+public:
+    // Runs merged at once; more are first merged down into wider runs.
+    static constexpr std::size_t kMaxFanIn = 64;
+
+    ExternalSort(std::uint64_t budget_bytes, std::string tag);
+    ~ExternalSort();
+    ExternalSort(const ExternalSort&) = delete;
+    ExternalSort& operator=(const ExternalSort&) = delete;
+
+    bool add(core::FileEntry entry);
+    // Writes nothing new after this; prepares the merge.
+    bool finish();
+    bool next(core::FileEntry& entry);
+
+    std::size_t runs() const { return runs_written_; }
+    const std::string& error() const { return error_; }
+
+private:
+    struct Source {
+        BaselineReader reader;
+        core::FileEntry head;
+    };
+
+    bool spill();
+    bool open_merge(const std::vector<std::string>& paths);
+    bool merge_down();
+    bool pull(core::FileEntry& entry);
+    bool later(std::size_t left, std::size_t right) const;
+    std::string run_path();
+    bool fail(const std::string& message);
+
+    std::uint64_t budget_;
+    std::string tag_;
+    std::vector<core::FileEntry> buffer_;
+    std::uint64_t buffered_bytes_ = 0;
+    std::size_t buffer_next_ = 0;
+    std::vector<std::string> run_paths_;
+    std::size_t runs_written_ = 0;
+    std::vector<std::unique_ptr<Source>> sources_;
+    std::vector<std::size_t> heap_;
+    bool finished_ = false;
+    std::string error_;
+};
+
+} // namespace scanner
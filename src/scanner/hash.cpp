@@ -1,6 +1,8 @@
 #include "hash.h"
+#include "../core/profiler.h"
 #include <algorithm>
 #include <array>
+#include <chrono>
 #include <cstdint>
 #include <cstring>
 #include <filesystem>
@@ -163,8 +165,13 @@ std::string finalize(Sha256Context& ctx) {
     return out.str();
 }
 
+double micros_since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+}
+
 std::string sha256_stream(std::ifstream& file,
-                          const std::optional<uintmax_t>& expected_size) {
+                          const std::optional<uintmax_t>& expected_size,
+                          FileTiming* timing = nullptr) {
     if (expected_size.has_value() && *expected_size == 0) {
         return EMPTY_FILE_SHA256;
     }
@@ -184,8 +191,16 @@ std::string sha256_stream(std::ifstream& file,
                   std::min<std::uintmax_t>(chunk.size(), remaining))
             : chunk.size();
 
+        std::chrono::steady_clock::time_point clock;
+        if (timing != nullptr) {
+            clock = std::chrono::steady_clock::now();
+        }
         file.read(chunk.data(), static_cast<std::streamsize>(request_size));
+        profiler::note_syscalls(1);
         const std::streamsize read_bytes = file.gcount();
+        if (timing != nullptr) {
+            timing->read_us += micros_since(clock);
+        }
         if (read_bytes <= 0) {
             break;
         }
@@ -219,7 +234,14 @@ std::optional<uintmax_t> detect_expected_size(const std::string& path) {
 
 } // namespace
 
+std::string sha256_bytes(const void* data, std::size_t size) {
+    Sha256Context ctx;
+    update(ctx, static_cast<const std::uint8_t*>(data), size);
+    return finalize(ctx);
+}
+
 std::string sha256_file(const std::string& path) {
+    profiler::note_syscalls(2);  // Size probe and open.
     std::ifstream file(path, std::ios::binary);
     if (!file.is_open()) {
         return "";
@@ -228,6 +250,7 @@ std::string sha256_file(const std::string& path) {
 }
 
 std::string sha256_file(const std::string& path, uintmax_t expected_size) {
+    profiler::note_syscalls(1);
     std::ifstream file(path, std::ios::binary);
     if (!file.is_open()) {
         return "";
@@ -235,4 +258,35 @@ std::string sha256_file(const std::string& path, uintmax_t expected_size) {
     return sha256_stream(file, expected_size);
 }
 
+std::string sha256_file(const std::string& path, uintmax_t expected_size, FileTiming& timing) {
+    profiler::note_syscalls(1);
+    const auto start = std::chrono::steady_clock::now();
+    std::ifstream file(path, std::ios::binary);
+    timing.open_us += micros_since(start);
+    if (!file.is_open()) {
+        return "";
+    }
+    const double read_before = timing.read_us;
+    const auto hashing = std::chrono::steady_clock::now();
+    std::string digest = sha256_stream(file, expected_size, &timing);
+    // Everything after the open that was not a read is hashing work: the
+    // block updates, padding and hex formatting.
+    const double hashed = micros_since(hashing) - (timing.read_us - read_before);
+    timing.digest_us += std::max(0.0, hashed);
+    return digest;
+}
+
+struct Sha256::Context : Sha256Context {};
+
+Sha256::Sha256() : ctx_(std::make_unique<Context>()) {}
+Sha256::~Sha256() = default;
+
+void Sha256::update(const void* data, std::size_t size) {
+    hash::update(*ctx_, static_cast<const std::uint8_t*>(data), size);
+}
+
+std::string Sha256::finish() {
+    return finalize(*ctx_);
+}
+
 } // namespace hash
@@ -1,8 +1,39 @@
 #pragma once
+#include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <string>
 
 namespace hash {
+
+// Where one sha256_file call spent its time, in microseconds.
+struct FileTiming {
+    double open_us = 0.0;
+    double read_us = 0.0;
+    double digest_us = 0.0;
+};
+
+// Hex digest of an in-memory buffer.
+std::string sha256_bytes(const void* data, std::size_t size);
 std::string sha256_file(const std::string& path);
 std::string sha256_file(const std::string& path, uintmax_t expected_size);
+// Same digest, also timing the open, the reads and the hashing separately.
+std::string sha256_file(const std::string& path, uintmax_t expected_size, FileTiming& timing);
+
+// Incremental digest for bytes the caller is already reading; finish() gives
+// the same hex digest sha256_bytes would for their concatenation.
+class Sha256 {
+public:
+    Sha256();
+    ~Sha256();
+    Sha256(const Sha256&) = delete;
+    Sha256& operator=(const Sha256&) = delete;
+
+    void update(const void* data, std::size_t size);
+    std::string finish();
+
+private:
+    struct Context;
+    std::unique_ptr<Context> ctx_;
+};
 }
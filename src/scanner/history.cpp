@@ -0,0 +1,493 @@
+#include "history.h"
+#include "baseline_stream.h"
+#include "hash.h"
+#include "../core/config.h"
+#include "../core/fsutil.h"
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+#include <utility>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// A new keyframe is written after this many consecutive deltas so that
+// reconstructing any snapshot merges a bounded number of segments.
+constexpr std::size_t KEYFRAME_INTERVAL = 16;
+
+std::string index_path() {
+    return (fs::path(config::HISTORY_DIR) / "index").generic_string();
+}
+
+std::string segment_path(const std::string& file) {
+    return (fs::path(config::HISTORY_DIR) / file).generic_string();
+}
+
+bool parse_index_line(const std::string& line, history::Snapshot& snapshot) {
+    if (line.rfind("snapshot\t", 0) != 0) {
+        return false;
+    }
+
+    std::vector<std::string> fields;
+    std::size_t start = 9;
+    for (int i = 0; i < 5; ++i) {
+        const std::size_t tab = line.find('\t', start);
+        if (tab == std::string::npos) {
+            return false;
+        }
+        fields.push_back(line.substr(start, tab - start));
+        start = tab + 1;
+    }
+    fields.push_back(line.substr(start));
+
+    try {
+        snapshot.seq = static_cast<std::size_t>(std::stoull(fields[0]));
+        snapshot.created = static_cast<std::time_t>(std::stoll(fields[1]));
+    } catch (...) {
+        return false;
+    }
+    snapshot.keyframe = fields[2] == "key";
+    snapshot.file = fields[3];
+    snapshot.digest = fields[4];
+    snapshot.root = fields[5];
+    return !snapshot.file.empty() && !snapshot.digest.empty();
+}
+
+void write_record(std::ofstream& out, char op, const core::FileEntry& entry) {
+    out << op << '\t'
+        << entry.path << '\t'
+        << entry.hash << '\t'
+        << entry.size << '\t'
+        << entry.mtime << "\n";
+}
+
+bool same_record(const core::FileEntry& left, const core::FileEntry& right) {
+    return left.hash == right.hash && left.size == right.size && left.mtime == right.mtime;
+}
+
+// Merges two path-sorted record sources and reports every difference.
+template <typename NextA, typename NextB>
+bool merge_sorted(NextA next_old, NextB next_new, const history::DiffVisitor& visit) {
+    core::FileEntry old_entry;
+    core::FileEntry new_entry;
+    bool have_old = next_old(old_entry);
+    bool have_new = next_new(new_entry);
+
+    while (have_old || have_new) {
+        if (have_old && (!have_new || old_entry.path < new_entry.path)) {
+            if (!visit('-', old_entry, old_entry)) {
+                return false;
+            }
+            have_old = next_old(old_entry);
+            continue;
+        }
+        if (have_new && (!have_old || new_entry.path < old_entry.path)) {
+            if (!visit('+', new_entry, new_entry)) {
+                return false;
+            }
+            have_new = next_new(new_entry);
+            continue;
+        }
+        if (!same_record(old_entry, new_entry) && !visit('~', old_entry, new_entry)) {
+            return false;
+        }
+        have_old = next_old(old_entry);
+        have_new = next_new(new_entry);
+    }
+    return true;
+}
+
+bool append_index(const history::Snapshot& snapshot, std::string* error) {
+    std::error_code ec;
+    const bool fresh = !fs::exists(index_path(), ec);
+    std::ofstream out(index_path(), std::ios::app);
+    if (!out.is_open()) {
+        fsutil::set_error(error, "failed to open history index: " + index_path());
+        return false;
+    }
+    if (fresh) {
+        out << "# Sentinel-C baseline history v1\n";
+    }
+    out << "snapshot\t" << snapshot.seq << '\t'
+        << snapshot.created << '\t'
+        << (snapshot.keyframe ? "key" : "delta") << '\t'
+        << snapshot.file << '\t'
+        << snapshot.digest << '\t'
+        << snapshot.root << "\n";
+    out.close();
+    if (!out) {
+        fsutil::set_error(error, "failed to flush history index: " + index_path());
+        return false;
+    }
+    fsutil::tighten_file_permissions(index_path());
+    return true;
+}
+
+} // namespace
+
+namespace history {
+
+// Segments are hashed as they are replayed and checked against the index
+// digest at end of file, so each replay reads a segment exactly once.
+struct SnapshotCursor::Segment {
+    bool keyframe = false;
+    std::string path;
+    std::string digest;
+    std::ifstream in;
+    hash::Sha256 hasher;
+    bool has = false;
+    bool damaged = false;
+    char op = '=';
+    core::FileEntry entry;
+
+    bool read_line(std::string& line) {
+        if (!std::getline(in, line)) {
+            damaged = hasher.finish() != digest;
+            return false;
+        }
+        hasher.update(line.data(), line.size());
+        if (!in.eof()) {
+            hasher.update("\n", 1);
+        }
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        return true;
+    }
+
+    bool advance() {
+        std::string line;
+        while (read_line(line)) {
+            if (keyframe) {
+                if (line.empty() || line[0] == '#' || line.rfind("root\t", 0) == 0 ||
+                    line.rfind("generated\t", 0) == 0 || line.rfind("order\t", 0) == 0 ||
+                    line.rfind("count\t", 0) == 0) {
+                    continue;
+                }
+                if (scanner::parse_baseline_record(line, entry)) {
+                    op = '=';
+                    has = true;
+                    return true;
+                }
+                continue;
+            }
+
+            if (line.size() < 3 || line[1] != '\t') {
+                continue;
+            }
+            const char kind = line[0];
+            if (kind != '+' && kind != '~' && kind != '-') {
+                continue;
+            }
+            if (scanner::parse_baseline_record(line.substr(2), entry)) {
+                op = kind;
+                has = true;
+                return true;
+            }
+        }
+        has = false;
+        return false;
+    }
+};
+
+SnapshotCursor::SnapshotCursor() = default;
+SnapshotCursor::~SnapshotCursor() = default;
+
+bool SnapshotCursor::open(const Snapshot& snapshot, std::string* error, Verify verify) {
+    segments_.clear();
+    error_.clear();
+
+    std::vector<Snapshot> snapshots;
+    if (!list_snapshots(snapshots, error)) {
+        return false;
+    }
+
+    // Walk back from the requested snapshot to its keyframe.
+    std::vector<const Snapshot*> chain;
+    for (auto it = snapshots.rbegin(); it != snapshots.rend(); ++it) {
+        if (it->seq > snapshot.seq) {
+            continue;
+        }
+        chain.push_back(&*it);
+        if (it->keyframe) {
+            break;
+        }
+    }
+    if (chain.empty() || !chain.back()->keyframe || chain.front()->seq != snapshot.seq) {
+        fsutil::set_error(error, "history chain is incomplete for snapshot #" + std::to_string(snapshot.seq));
+        return false;
+    }
+
+    for (auto it = chain.rbegin(); it != chain.rend(); ++it) {
+        const Snapshot& item = **it;
+        const std::string path = segment_path(item.file);
+        if (verify == Verify::Upfront && hash::sha256_file(path) != item.digest) {
+            fsutil::set_error(error, "history segment failed digest check: " + path);
+            segments_.clear();
+            return false;
+        }
+
+        auto segment = std::make_unique<Segment>();
+        segment->keyframe = item.keyframe;
+        segment->path = path;
+        segment->digest = item.digest;
+        segment->in.open(path, std::ios::binary);
+        if (!segment->in.is_open()) {
+            fsutil::set_error(error, "failed to open history segment: " + path);
+            segments_.clear();
+            return false;
+        }
+        segment->advance();
+        segments_.push_back(std::move(segment));
+    }
+    return true;
+}
+
+bool SnapshotCursor::next(core::FileEntry& entry) {
+    while (true) {
+        for (const auto& segment : segments_) {
+            if (segment->damaged) {
+                error_ = "history segment failed digest check: " + segment->path;
+                return false;
+            }
+        }
+
+        const Segment* lowest = nullptr;
+        for (const auto& segment : segments_) {
+            if (segment->has && (lowest == nullptr || segment->entry.path < lowest->entry.path)) {
+                lowest = segment.get();
+            }
+        }
+        if (lowest == nullptr) {
+            return false;
+        }
+
+        // The newest segment touching a path decides its state.
+        const std::string path = lowest->entry.path;
+        Segment* newest = nullptr;
+        for (const auto& segment : segments_) {
+            if (segment->has && segment->entry.path == path) {
+                newest = segment.get();
+            }
+        }
+
+        const bool deleted = newest->op == '-';
+        if (!deleted) {
+            entry = newest->entry;
+        }
+        for (const auto& segment : segments_) {
+            if (segment->has && segment->entry.path == path) {
+                segment->advance();
+            }
+        }
+        if (!deleted) {
+            return true;
+        }
+    }
+}
+
+bool list_snapshots(std::vector<Snapshot>& snapshots, std::string* error) {
+    snapshots.clear();
+    std::error_code ec;
+    if (!fs::exists(index_path(), ec)) {
+        return true;
+    }
+
+    std::ifstream in(index_path());
+    if (!in.is_open()) {
+        fsutil::set_error(error, "failed to open history index: " + index_path());
+        return false;
+    }
+
+    std::string line;
+    while (std::getline(in, line)) {
+        Snapshot snapshot;
+        if (parse_index_line(line, snapshot)) {
+            snapshots.push_back(std::move(snapshot));
+        }
+    }
+    return true;
+}
+
+bool resolve(const std::string& reference, Snapshot& snapshot, std::string* error) {
+    std::vector<Snapshot> snapshots;
+    if (!list_snapshots(snapshots, error)) {
+        return false;
+    }
+    if (snapshots.empty()) {
+        fsutil::set_error(error, "no baseline history recorded yet; run --init or --update first");
+        return false;
+    }
+
+    if (reference == "latest") {
+        snapshot = snapshots.back();
+        return true;
+    }
+
+    if (!reference.empty() && reference[0] == '#') {
+        std::size_t seq = 0;
+        try {
+            seq = static_cast<std::size_t>(std::stoull(reference.substr(1)));
+        } catch (...) {
+            fsutil::set_error(error, "invalid snapshot id: " + reference);
+            return false;
+        }
+        for (const Snapshot& item : snapshots) {
+            if (item.seq == seq) {
+                snapshot = item;
+                return true;
+            }
+        }
+        fsutil::set_error(error, "snapshot not found: " + reference);
+        return false;
+    }
+
+    std::time_t at = 0;
+    if (!fsutil::parse_time(reference, at)) {
+        fsutil::set_error(error, "invalid timestamp: " + reference +
+                         " (use epoch seconds, YYYY-MM-DD[ HH:MM[:SS]], #<id> or latest)");
+        return false;
+    }
+
+    const Snapshot* found = nullptr;
+    for (const Snapshot& item : snapshots) {
+        if (item.created <= at) {
+            found = &item;
+        }
+    }
+    if (found == nullptr) {
+        fsutil::set_error(error, "no baseline snapshot recorded at or before " + fsutil::format_time(at));
+        return false;
+    }
+    snapshot = *found;
+    return true;
+}
+
+bool diff(const Snapshot& from, const Snapshot& to, const DiffVisitor& visit, std::string* error) {
+    SnapshotCursor old_cursor;
+    SnapshotCursor new_cursor;
+    if (!old_cursor.open(from, error, Verify::Upfront) || !new_cursor.open(to, error, Verify::Upfront)) {
+        return false;
+    }
+    // A segment that changes after the up-front check stops its cursor; the
+    // other cursor's remaining records would then look like changes, so
+    // nothing more is reported once either one fails.
+    const auto damaged = [&]() { return !old_cursor.error().empty() || !new_cursor.error().empty(); };
+    // merge_sorted stops early only when `visit` asks to (the chains were
+    // verified in open()) or once a cursor is damaged. Damage is checked even
+    // after a full merge: a mismatch at the last segment's end only shows as
+    // that cursor running dry.
+    merge_sorted(
+        [&](core::FileEntry& entry) { return old_cursor.next(entry); },
+        [&](core::FileEntry& entry) { return new_cursor.next(entry); },
+        [&](char op, const core::FileEntry& before, const core::FileEntry& after) {
+            return !damaged() && visit(op, before, after);
+        });
+    if (damaged()) {
+        fsutil::set_error(error, !old_cursor.error().empty() ? old_cursor.error() : new_cursor.error());
+        return false;
+    }
+    return true;
+}
+
+bool record_current_baseline(std::string* error) {
+    std::error_code ec;
+    fs::create_directories(config::HISTORY_DIR, ec);
+    if (ec) {
+        fsutil::set_error(error, "failed to create history directory: " + ec.message());
+        return false;
+    }
+
+    std::vector<Snapshot> snapshots;
+    if (!list_snapshots(snapshots, error)) {
+        return false;
+    }
+
+    scanner::BaselineReader current;
+    if (!current.open(config::BASELINE_DB)) {
+        fsutil::set_error(error, "failed to open baseline: " + config::BASELINE_DB);
+        return false;
+    }
+
+    Snapshot snapshot;
+    snapshot.seq = snapshots.empty() ? 1 : snapshots.back().seq + 1;
+    snapshot.created = std::time(nullptr);
+    snapshot.root = current.root();
+
+    std::size_t deltas_since_key = 0;
+    for (auto it = snapshots.rbegin(); it != snapshots.rend() && !it->keyframe; ++it) {
+        ++deltas_since_key;
+    }
+
+    snapshot.keyframe = snapshots.empty() ||
+                        !current.path_sorted() ||
+                        snapshots.back().root != snapshot.root ||
+                        deltas_since_key + 1 >= KEYFRAME_INTERVAL;
+
+    // A broken chain cannot be extended; start over from a keyframe instead.
+    SnapshotCursor previous;
+    if (!snapshot.keyframe && !previous.open(snapshots.back())) {
+        snapshot.keyframe = true;
+    }
+
+    if (!snapshot.keyframe) {
+        snapshot.file = "delta-" + std::to_string(snapshot.seq) + ".delta";
+        const std::string path = segment_path(snapshot.file);
+
+        std::ofstream out(path, std::ios::trunc);
+        if (!out.is_open()) {
+            fsutil::set_error(error, "failed to open history delta for write: " + path);
+            return false;
+        }
+        out << "# Sentinel-C baseline delta v1\n";
+        out << "parent\t" << snapshots.back().seq << "\n";
+
+        std::size_t changes = 0;
+        std::size_t records = 0;
+        merge_sorted([&](core::FileEntry& entry) { return previous.next(entry); },
+                     [&](core::FileEntry& entry) {
+                         const bool ok = current.next(entry);
+                         records += ok ? 1 : 0;
+                         return ok;
+                     },
+                     [&](char op, const core::FileEntry& before, const core::FileEntry& after) {
+                         write_record(out, op, op == '-' ? before : after);
+                         ++changes;
+                         return true;
+                     });
+        out.close();
+        if (!out) {
+            fsutil::set_error(error, "failed to flush history delta: " + path);
+            return false;
+        }
+
+        // A delta against a damaged chain would inherit the damage, and one
+        // larger than half the tree costs more to replay than a keyframe.
+        if (!previous.error().empty() || changes * 2 > records) {
+            fs::remove(path, ec);
+            snapshot.keyframe = true;
+        }
+    }
+
+    if (snapshot.keyframe) {
+        snapshot.file = "key-" + std::to_string(snapshot.seq) + ".base";
+        fs::copy_file(config::BASELINE_DB, segment_path(snapshot.file),
+                      fs::copy_options::overwrite_existing, ec);
+        if (ec) {
+            fsutil::set_error(error, "failed to write history keyframe: " + ec.message());
+            return false;
+        }
+    }
+
+    const std::string path = segment_path(snapshot.file);
+    fsutil::tighten_file_permissions(path);
+    snapshot.digest = hash::sha256_file(path);
+    if (snapshot.digest.empty()) {
+        fsutil::set_error(error, "failed to hash history segment: " + path);
+        return false;
+    }
+    return append_index(snapshot, error);
+}
+
+} // namespace history
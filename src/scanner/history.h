@@ -0,0 +1,70 @@
+#pragma once
+#include <cstddef>
+#include <ctime>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "../core/types.h"
+
+namespace history {
+
+// One entry of the history index. Keyframes are full path-sorted baseline
+// copies; deltas hold only added/modified/deleted records against the
+// previous snapshot.
+struct Snapshot {
+    std::size_t seq = 0;
+    std::time_t created = 0;
+    bool keyframe = false;
+    std::string file;
+    std::string digest;
+    std::string root;
+};
+
+// When SnapshotCursor checks segment digests. Every segment is hashed as it is
+// replayed and checked at its end, where next() stops and error() names it;
+// Upfront also hashes the whole chain in open(), so records are only returned
+// once their segments have passed. Output meant for people needs Upfront.
+enum class Verify {
+    Streaming,
+    Upfront
+};
+
+// Streams the reconstructed state of a snapshot in path order by merging its
+// keyframe with the deltas that follow it. Memory use is one record per
+// segment in the chain.
+class SnapshotCursor {
+public:
+    SnapshotCursor();
+    ~SnapshotCursor();
+    SnapshotCursor(const SnapshotCursor&) = delete;
+    SnapshotCursor& operator=(const SnapshotCursor&) = delete;
+
+    bool open(const Snapshot& snapshot, std::string* error = nullptr,
+              Verify verify = Verify::Streaming);
+    bool next(core::FileEntry& entry);
+    // Empty unless a segment failed its digest check.
+    const std::string& error() const { return error_; }
+
+private:
+    struct Segment;
+    std::vector<std::unique_ptr<Segment>> segments_;
+    std::string error_;
+};
+
+// op is '+', '~' or '-'; `before` is the old record (deleted/modified) and
+// `after` the new one (added/modified). Return false to stop early.
+using DiffVisitor = std::function<bool(char op,
+                                       const core::FileEntry& before,
+                                       const core::FileEntry& after)>;
+
+bool record_current_baseline(std::string* error = nullptr);
+bool list_snapshots(std::vector<Snapshot>& snapshots, std::string* error = nullptr);
+// Accepts "latest", "#<seq>" or a timestamp understood by fsutil::parse_time;
+// timestamps select the newest snapshot taken at or before that time.
+bool resolve(const std::string& reference, Snapshot& snapshot, std::string* error = nullptr);
+// Both chains are verified before the first change reaches `visit`.
+bool diff(const Snapshot& from, const Snapshot& to, const DiffVisitor& visit,
+          std::string* error = nullptr);
+
+} // namespace history
@@ -0,0 +1,175 @@
+#include "rolling_state.h"
+#include "hash.h"
+#include "../core/config.h"
+#include "../core/fsutil.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <system_error>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace scanner {
+
+namespace {
+
+constexpr const char* kStateMagic = "# Sentinel-C rolling state v1";
+
+// SHA-256 of the body, stored as the last line. It only catches truncated or
+// corrupted files; anyone able to edit the state can recompute it.
+std::string checksum_of(const std::string& text) {
+    return hash::sha256_bytes(text.data(), text.size());
+}
+
+bool parse_number(const std::string& text, std::uint64_t& out) {
+    if (text.empty() || text.find_first_not_of("0123456789") != std::string::npos) {
+        return false;
+    }
+    try {
+        out = std::stoull(text);
+    } catch (...) {
+        return false;
+    }
+    return true;
+}
+
+// Fills `state` from the file body (checksum line already checked and cut off).
+bool parse_state(const std::string& body, RollingState& state) {
+    std::istringstream in(body);
+    std::string line;
+    if (!std::getline(in, line) || line != kStateMagic) {
+        return false;
+    }
+    while (std::getline(in, line)) {
+        const std::size_t tab = line.find('\t');
+        const std::string key = line.substr(0, tab);
+        const std::string rest = tab == std::string::npos ? std::string() : line.substr(tab + 1);
+        if (key == "target") {
+            state.target = rest;
+        } else if (key == "cursor") {
+            state.cursor = rest;
+        } else if (key == "lap") {
+            std::istringstream fields(rest);
+            std::string runs, started, last;
+            std::uint64_t value = 0;
+            if (!std::getline(fields, runs, '\t') || !std::getline(fields, started, '\t') ||
+                !std::getline(fields, last, '\t') || !parse_number(runs, state.lap_runs)) {
+                return false;
+            }
+            if (!parse_number(started, value)) {
+                return false;
+            }
+            state.lap_started = static_cast<std::time_t>(value);
+            if (!parse_number(last, value)) {
+                return false;
+            }
+            state.last_lap = static_cast<std::time_t>(value);
+        } else if (key == "verified") {
+            const std::size_t split = rest.find('\t');
+            std::uint64_t when = 0;
+            if (split == std::string::npos || !parse_number(rest.substr(0, split), when)) {
+                return false;
+            }
+            state.verified[rest.substr(split + 1)] = static_cast<std::time_t>(when);
+        } else if (key == "flagged") {
+            state.flagged.insert(rest);
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+bool load_rolling_state(const std::string& target, RollingState& state, std::string* error) {
+    state = RollingState{};
+    state.target = target;
+
+    std::ifstream in(config::ROLLING_STATE, std::ios::binary);
+    if (!in.is_open()) {
+        return true;
+    }
+    std::ostringstream buffer;
+    buffer << in.rdbuf();
+    const std::string text = buffer.str();
+
+    // The last line is a checksum over everything before it.
+    const std::size_t digest_at = text.rfind("\ndigest\t");
+    const std::string body = digest_at == std::string::npos ? std::string() : text.substr(0, digest_at + 1);
+    std::string recorded =
+        digest_at == std::string::npos ? std::string() : text.substr(digest_at + 8);
+    if (!recorded.empty() && recorded.back() == '\n') {
+        recorded.pop_back();
+    }
+    RollingState loaded;
+    if (body.empty() || recorded != checksum_of(body) || !parse_state(body, loaded)) {
+        fsutil::set_error(error, "Rolling scan state failed its checksum; starting a new rotation: " +
+                             config::ROLLING_STATE);
+        return false;
+    }
+    if (loaded.target != target) {
+        fsutil::set_error(error, "Rolling scan state belongs to another target (" + loaded.target +
+                             "); starting a new rotation.");
+        return false;
+    }
+    state = std::move(loaded);
+    return true;
+}
+
+bool save_rolling_state(const RollingState& state, std::string* error) {
+    std::ostringstream out;
+    out << kStateMagic << "\n"
+        << "target\t" << state.target << "\n"
+        << "cursor\t" << state.cursor << "\n"
+        << "lap\t" << state.lap_runs << '\t' << static_cast<std::uint64_t>(std::max<std::time_t>(state.lap_started, 0))
+        << '\t' << static_cast<std::uint64_t>(std::max<std::time_t>(state.last_lap, 0)) << "\n";
+    std::vector<const std::pair<const std::string, std::time_t>*> entries;
+    entries.reserve(state.verified.size());
+    for (const auto& item : state.verified) {
+        entries.push_back(&item);
+    }
+    std::sort(entries.begin(), entries.end(), [](const auto* left, const auto* right) {
+        return left->first < right->first;
+    });
+    for (const auto* item : entries) {
+        out << "verified\t" << static_cast<std::uint64_t>(std::max<std::time_t>(item->second, 0)) << '\t'
+            << item->first << "\n";
+    }
+    std::vector<const std::string*> flagged;
+    flagged.reserve(state.flagged.size());
+    for (const std::string& path : state.flagged) {
+        flagged.push_back(&path);
+    }
+    std::sort(flagged.begin(), flagged.end(), [](const std::string* left, const std::string* right) {
+        return *left < *right;
+    });
+    for (const std::string* path : flagged) {
+        out << "flagged\t" << *path << "\n";
+    }
+    const std::string body = out.str();
+
+    std::error_code ec;
+    fs::create_directories(config::DATA_DIR, ec);
+    const std::string staged = config::ROLLING_STATE + ".tmp";
+    {
+        std::ofstream file(staged, std::ios::binary | std::ios::trunc);
+        file << body << "digest\t" << checksum_of(body) << "\n";
+        if (!file) {
+            fs::remove(staged, ec);
+            fsutil::set_error(error, "Failed to write rolling scan state: " + config::ROLLING_STATE);
+            return false;
+        }
+    }
+    fs::rename(staged, config::ROLLING_STATE, ec);
+    if (ec) {
+        fs::remove(staged, ec);
+        fsutil::set_error(error, "Failed to replace rolling scan state: " + config::ROLLING_STATE);
+        return false;
+    }
+    return true;
+}
+
+} // namespace scanner
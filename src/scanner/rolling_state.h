@@ -0,0 +1,44 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace scanner {
+
+// Progress of time-budgeted scans (--time-budget), kept in
+// config::ROLLING_STATE between runs. A lap is one pass of the rotation over
+// every unchanged file in path order; `cursor` is the last path it verified.
+struct RollingState {
+    std::string target;
+    std::string cursor;
+    std::uint64_t lap_runs = 0;  // Runs that have advanced the current lap.
+    std::time_t lap_started = 0;
+    std::time_t last_lap = 0;    // When a lap last completed.
+    // When each file's digest was last checked against the tree.
+    std::unordered_map<std::string, std::time_t> verified;
+    // Files last found modified; they stay ahead of the rotation until their
+    // digest matches the baseline again.
+    std::unordered_set<std::string> flagged;
+
+    // Filled in by the last scan_compare_rolling() call; not saved.
+    std::size_t queued = 0;    // New, metadata-changed or flagged files hashed first.
+    std::size_t rotated = 0;   // Unchanged files verified from the rotation.
+    std::size_t deferred = 0;  // Unchanged files left for later runs.
+    bool full_pass = false;    // The budget was lifted to finish the lap.
+    bool lap_finished = false;
+    double lap_progress = 0.0;     // Share of the current lap verified, 0..1.
+    std::size_t never_verified = 0;
+    std::time_t oldest_verified = 0;
+};
+
+// Missing state starts a fresh rotation. State for another target, or one
+// whose checksum does not match, is replaced by a fresh rotation and reported
+// through `error`; either way `state` is usable afterwards.
+bool load_rolling_state(const std::string& target, RollingState& state, std::string* error = nullptr);
+// Replaces the state file through a temp file and a rename.
+bool save_rolling_state(const RollingState& state, std::string* error = nullptr);
+
+} // namespace scanner
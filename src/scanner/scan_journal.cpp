@@ -0,0 +1,203 @@
+#include "scan_journal.h"
+#include "baseline_stream.h"
+#include "hash.h"
+#include "../core/config.h"
+#include "../core/fsutil.h"
+#include <filesystem>
+#include <sstream>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace scanner {
+
+namespace {
+
+constexpr const char* kJournalMagic = "# Sentinel-C scan journal v1";
+
+std::string record_line(const core::FileEntry& entry) {
+    std::ostringstream out;
+    out << "file\t" << entry.path << '\t' << entry.hash << '\t' << entry.size << '\t' << entry.mtime << '\n';
+    return out.str();
+}
+
+std::string chain(const std::string& seal, const std::string& lines) {
+    const std::string data = seal + lines;
+    return hash::sha256_bytes(data.data(), data.size());
+}
+
+} // namespace
+
+bool ScanJournal::exists() {
+    std::error_code ec;
+    return fs::exists(config::SCAN_JOURNAL, ec);
+}
+
+bool ScanJournal::open_append(const std::string& path) {
+    out_.open(path, std::ios::binary | std::ios::app);
+    if (!out_.is_open()) {
+        return false;
+    }
+    fsutil::tighten_file_permissions(path);
+    last_checkpoint_ = std::chrono::steady_clock::now();
+    return true;
+}
+
+bool ScanJournal::start(const std::string& target, std::string* error) {
+    std::error_code ec;
+    fs::create_directories(config::DATA_DIR, ec);
+    fs::remove(config::SCAN_JOURNAL, ec);
+
+    const std::string header = std::string(kJournalMagic) + "\ntarget\t" + target + "\nstarted\t" +
+                               fsutil::timestamp() + "\n";
+    if (!open_append(config::SCAN_JOURNAL)) {
+        fsutil::set_error(error, "Failed to create scan journal: " + config::SCAN_JOURNAL);
+        return false;
+    }
+    out_ << header << std::flush;
+    seal_ = chain("", header);
+    carried_.clear();
+    unsealed_.clear();
+    unsealed_records_ = 0;
+    sequence_ = 0;
+    return static_cast<bool>(out_);
+}
+
+bool ScanJournal::resume(const std::string& target, std::string* error) {
+    std::ifstream in(config::SCAN_JOURNAL, std::ios::binary);
+    if (!in.is_open()) {
+        fsutil::set_error(error, "Scan journal not found: " + config::SCAN_JOURNAL);
+        return false;
+    }
+
+    std::string header;
+    std::string line;
+    int header_lines = 0;
+    for (; header_lines < 3 && std::getline(in, line) && !in.eof(); ++header_lines) {
+        header += line + "\n";
+        if (header_lines == 0 && line != kJournalMagic) {
+            fsutil::set_error(error, "Scan journal is not a Sentinel-C journal: " + config::SCAN_JOURNAL);
+            return false;
+        }
+        if (header_lines == 1 && line != "target\t" + target) {
+            fsutil::set_error(error, "Scan journal belongs to another target (" +
+                                 (line.rfind("target\t", 0) == 0 ? line.substr(7) : line) +
+                                 "). Run without --resume to start over.");
+            return false;
+        }
+    }
+    if (header_lines < 3) {
+        // Killed before the header was written; nothing to carry over.
+        in.close();
+        return start(target, error);
+    }
+    std::string seal = chain("", header);
+    std::streamoff sealed_end = in.tellg();
+    std::uint64_t sequence = 0;
+    std::string lines;
+    std::vector<core::FileEntry> pending;
+    FileMap carried;
+
+    while (std::getline(in, line)) {
+        if (line.rfind("file\t", 0) == 0) {
+            core::FileEntry entry;
+            if (parse_baseline_record(line, entry)) {
+                pending.push_back(std::move(entry));
+            }
+            lines += line + "\n";
+            continue;
+        }
+        if (line.rfind("checkpoint\t", 0) != 0) {
+            break;
+        }
+        if (in.eof()) {
+            break;  // Cut off while being written.
+        }
+        // checkpoint <seq> <records> <seal>
+        const std::size_t digest_at = line.rfind('\t');
+        const std::string expected = chain(seal, lines);
+        if (line.substr(digest_at + 1) != expected) {
+            fsutil::set_error(error, "Scan journal seal check failed at checkpoint " + std::to_string(sequence + 1) +
+                                 "; it may have been modified. Run without --resume to start over.");
+            return false;
+        }
+        for (core::FileEntry& entry : pending) {
+            std::string key = entry.path;
+            carried[std::move(key)] = std::move(entry);
+        }
+        pending.clear();
+        lines.clear();
+        seal = expected;
+        ++sequence;
+        sealed_end = in.tellg();
+    }
+    in.close();
+
+    // Records after the last seal were cut off mid-checkpoint; drop them.
+    std::error_code ec;
+    fs::resize_file(config::SCAN_JOURNAL, static_cast<std::uintmax_t>(sealed_end), ec);
+    if (ec || !open_append(config::SCAN_JOURNAL)) {
+        fsutil::set_error(error, "Failed to reopen scan journal: " + config::SCAN_JOURNAL);
+        return false;
+    }
+    carried_ = std::move(carried);
+    seal_ = std::move(seal);
+    unsealed_.clear();
+    unsealed_records_ = 0;
+    sequence_ = sequence;
+    return true;
+}
+
+bool ScanJournal::lookup(const std::string& path,
+                         std::uintmax_t size,
+                         std::time_t mtime,
+                         std::string& digest) const {
+    const auto it = carried_.find(path);
+    if (it == carried_.end() || it->second.size != size || it->second.mtime != mtime) {
+        return false;
+    }
+    digest = it->second.hash;
+    return true;
+}
+
+void ScanJournal::record(const core::FileEntry& entry) {
+    if (!active()) {
+        return;
+    }
+    const std::string line = record_line(entry);
+    out_ << line;
+    unsealed_ += line;
+    ++unsealed_records_;
+    if (unsealed_records_ >= kCheckpointRecords ||
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - last_checkpoint_).count() >=
+            kCheckpointSeconds) {
+        checkpoint();
+    }
+}
+
+bool ScanJournal::checkpoint() {
+    if (!active()) {
+        return false;
+    }
+    if (unsealed_records_ != 0) {
+        seal_ = chain(seal_, unsealed_);
+        ++sequence_;
+        out_ << "checkpoint\t" << sequence_ << '\t' << unsealed_records_ << '\t' << seal_ << '\n';
+        unsealed_.clear();
+        unsealed_records_ = 0;
+    }
+    out_.flush();
+    last_checkpoint_ = std::chrono::steady_clock::now();
+    return static_cast<bool>(out_);
+}
+
+void ScanJournal::discard() {
+    out_.close();
+    carried_.clear();
+    std::error_code ec;
+    fs::remove(config::SCAN_JOURNAL, ec);
+}
+
+} // namespace scanner
@@ -0,0 +1,59 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <fstream>
+#include <string>
+#include "scanner.h"
+
+namespace scanner {
+
+// Checkpoint journal of a snapshot in progress (config::SCAN_JOURNAL), so an
+// interrupted --init or --update can resume without hashing everything again.
+// Records use the baseline record format. Each checkpoint line seals the
+// records since the previous one with SHA-256 over the previous seal plus
+// those lines, the first chained from the header, so resume() trusts only
+// records under an intact seal and drops the unsealed tail.
+class ScanJournal {
+public:
+    static constexpr std::size_t kCheckpointRecords = 10000;
+    static constexpr double kCheckpointSeconds = 10.0;
+
+    ScanJournal() = default;
+    ScanJournal(const ScanJournal&) = delete;
+    ScanJournal& operator=(const ScanJournal&) = delete;
+
+    static bool exists();
+
+    // Starts a new journal for `target`, replacing any earlier one.
+    bool start(const std::string& target, std::string* error = nullptr);
+    // Loads the sealed records of the journal left for `target` and carries
+    // on appending to it. Fails on another target or a broken seal.
+    bool resume(const std::string& target, std::string* error = nullptr);
+
+    bool active() const { return out_.is_open(); }
+    std::size_t carried() const { return carried_.size(); }
+    // Digest recorded for `path` when its size and mtime still match.
+    bool lookup(const std::string& path, std::uintmax_t size, std::time_t mtime, std::string& digest) const;
+
+    // Appends one freshly hashed entry and seals a checkpoint when one is due.
+    // Calls must not overlap.
+    void record(const core::FileEntry& entry);
+    bool checkpoint();
+    // Removes the journal once the snapshot it tracked has been saved.
+    void discard();
+
+private:
+    bool open_append(const std::string& path);
+
+    std::ofstream out_;
+    FileMap carried_;
+    std::string seal_;
+    std::string unsealed_;
+    std::size_t unsealed_records_ = 0;
+    std::uint64_t sequence_ = 0;
+    std::chrono::steady_clock::time_point last_checkpoint_{};
+};
+
+} // namespace scanner
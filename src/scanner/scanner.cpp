@@ -1,14 +1,30 @@
 #include "scanner.h"
+#include "baseline_stream.h"
+#include "external_sort.h"
 #include "hash.h"
 #include "ignore.h"
+#include "rolling_state.h"
+#include "scan_journal.h"
+#include "../core/config.h"
+#include "../core/fsutil.h"
+#include "../core/memory.h"
+#include "../core/profiler.h"
+#include "../core/trace.h"
 #include <algorithm>
 #include <atomic>
 #include <cctype>
 #include <chrono>
+#include <ctime>
 #include <filesystem>
+#include <functional>
+#include <limits>
+#include <memory>
 #include <mutex>
+#include <optional>
 #include <system_error>
 #include <thread>
+#include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -88,144 +104,478 @@ struct PendingFile {
     std::time_t mtime = 0;
 };
 
-} // namespace
-
-namespace scanner {
+using EntryCallback = std::function<void(const core::FileEntry&)>;
 
-FileMap build_snapshot(const std::string& target, core::ScanStats* stats) {
-    if (stats != nullptr) {
-        *stats = core::ScanStats{};
+std::string hash_pending(const PendingFile& item, hash::FileTiming* timing = nullptr) {
+    profiler::Scope scope(core::Phase::Hash);
+    scope.add_files();
+    scope.add_bytes(item.size);
+    std::string digest = timing != nullptr ? hash::sha256_file(item.path, item.size, *timing)
+                                           : hash::sha256_file(item.path, item.size);
+    if (digest.empty()) {
+        scope.add_error();
     }
+    return digest;
+}
 
-    const auto start = std::chrono::steady_clock::now();
-    ignore::load();
+std::string micros_arg(const char* key, double value) {
+    return std::string(",\"") + key + "\":" + std::to_string(static_cast<std::uint64_t>(value));
+}
 
-    FileMap current;
-    std::vector<PendingFile> pending;
-    pending.reserve(4096);
-    const fs::path root_path(target);
-    std::error_code ec;
-    const auto options = fs::directory_options::skip_permission_denied;
-    fs::recursive_directory_iterator it(target, options, ec);
-    fs::recursive_directory_iterator end;
-
-    while (it != end) {
-        if (ec) {
-            ec.clear();
-            it.increment(ec);
-            continue;
-        }
+// Trace spans of one hashing thread. A file of at least trace::kFileSpanBytes
+// gets its own span with a nested "open"; smaller files are folded into one
+// span per run of up to kSmallRun files. Args split each span into open, read
+// and hash time, plus time spent waiting for the change observer.
+class HashTrace {
+public:
+    static constexpr std::uint64_t kSmallRun = 256;
 
-        const fs::directory_entry entry = *it;
-        it.increment(ec);
+    HashTrace() : active_(trace::active()) {}
+    ~HashTrace() { flush(); }
+    HashTrace(const HashTrace&) = delete;
+    HashTrace& operator=(const HashTrace&) = delete;
 
-        if (entry.is_symlink(ec)) {
-            ec.clear();
-            continue;
-        }
+    bool active() const { return active_; }
 
-        if (!entry.is_regular_file(ec)) {
-            ec.clear();
-            continue;
+    std::string hash(const PendingFile& item) {
+        if (!active_) {
+            return hash_pending(item);
         }
+        hash::FileTiming timing;
+        const double start = trace::now();
+        std::string digest = hash_pending(item, &timing);
+        const double end = trace::now();
+        const std::uint64_t errors = digest.empty() ? 1 : 0;
 
-        const std::string path = normalize_path(entry.path());
-        if (should_skip_for_stability(path)) {
-            continue;
+        if (item.size >= trace::kFileSpanBytes) {
+            flush();
+            trace::complete(item.path, "hash", start, end, args(1, item.size, timing, 0.0, errors));
+            trace::complete("open", "io", start, start + timing.open_us);
+            return digest;
         }
+        if (files_ == 0) {
+            run_start_ = start;
+        }
+        run_end_ = end;
+        ++files_;
+        bytes_ += item.size;
+        errors_ += errors;
+        run_.open_us += timing.open_us;
+        run_.read_us += timing.read_us;
+        run_.digest_us += timing.digest_us;
+        if (files_ == kSmallRun) {
+            flush();
+        }
+        return digest;
+    }
 
-        std::error_code rel_ec;
-        const fs::path rel = fs::relative(entry.path(), root_path, rel_ec);
-        const std::string relative_path =
-            rel_ec ? entry.path().filename().generic_string() : rel.generic_string();
-
-        if (ignore::match(path) || ignore::match(relative_path)) {
-            continue;
+    void waited(double start, double end) {
+        wait_us_ += end - start;
+        if (files_ != 0) {
+            run_end_ = end;
         }
+    }
 
-        const uintmax_t size = entry.file_size(ec);
-        if (ec) {
-            ec.clear();
-            continue;
+    void flush() {
+        if (files_ == 0) {
+            return;
         }
+        trace::complete("small files", "hash", run_start_, run_end_, args(files_, bytes_, run_, wait_us_, errors_));
+        files_ = 0;
+        bytes_ = 0;
+        errors_ = 0;
+        wait_us_ = 0.0;
+        run_ = hash::FileTiming{};
+    }
 
-        const fs::file_time_type last_write = entry.last_write_time(ec);
-        if (ec) {
-            ec.clear();
-            continue;
+private:
+    static std::string args(std::uint64_t files,
+                            std::uint64_t bytes,
+                            const hash::FileTiming& timing,
+                            double wait_us,
+                            std::uint64_t errors) {
+        std::string out = "\"files\":" + std::to_string(files) + ",\"bytes\":" + std::to_string(bytes);
+        out += micros_arg("open_us", timing.open_us);
+        out += micros_arg("read_us", timing.read_us);
+        out += micros_arg("hash_us", timing.digest_us);
+        if (wait_us > 0.0) {
+            out += micros_arg("observer_wait_us", wait_us);
+        }
+        if (errors != 0) {
+            out += ",\"errors\":" + std::to_string(errors);
         }
-        pending.push_back(PendingFile{path, size, to_time_t(last_write)});
+        return out;
     }
 
-    if (!pending.empty()) {
-        current.reserve(pending.size());
+    bool active_;
+    std::uint64_t files_ = 0;
+    std::uint64_t bytes_ = 0;
+    std::uint64_t errors_ = 0;
+    double run_start_ = 0.0;
+    double run_end_ = 0.0;
+    double wait_us_ = 0.0;
+    hash::FileTiming run_;
+};
 
-        const unsigned int hw = std::max(1u, std::thread::hardware_concurrency());
-        const std::size_t workers = std::min<std::size_t>(pending.size(), hw);
+// Hashes `item` through `tracer` and, when `distribution` is set, records its
+// latency, size and finish time (seconds since `origin`). Failed files are
+// counted by the profiler only.
+std::string hash_recorded(const PendingFile& item,
+                          HashTrace& tracer,
+                          core::ScanDistribution* distribution,
+                          std::chrono::steady_clock::time_point origin) {
+    if (distribution == nullptr) {
+        return tracer.hash(item);
+    }
+    const auto begun = std::chrono::steady_clock::now();
+    std::string digest = tracer.hash(item);
+    const auto done = std::chrono::steady_clock::now();
+    if (!digest.empty()) {
+        distribution->record(item.path, item.size, std::chrono::duration<double>(done - begun).count(),
+                             std::chrono::duration<double>(done - origin).count());
+    }
+    return digest;
+}
+
+// True when `entry` no longer matches its baseline record `old`.
+bool differs(const core::FileEntry& old, const core::FileEntry& entry, bool consider_mtime) {
+    const bool mtime_changed =
+        consider_mtime && (old.mtime != 0 && entry.mtime != 0 && old.mtime != entry.mtime);
+    return old.hash != entry.hash || old.size != entry.size || mtime_changed;
+}
+
+// Sets `change` and returns true when `entry` differs from its baseline record.
+bool classify(const scanner::FileMap& baseline,
+              const core::FileEntry& entry,
+              bool consider_mtime,
+              scanner::Change& change) {
+    const auto baseline_it = baseline.find(entry.path);
+    if (baseline_it == baseline.end()) {
+        change = scanner::Change::Added;
+        return true;
+    }
+
+    if (differs(baseline_it->second, entry, consider_mtime)) {
+        change = scanner::Change::Modified;
+        return true;
+    }
+    return false;
+}
+
+// Walks `target` and gathers the regular files to hash. fill() stops early
+// once the pending records reach `max_bytes` (0: no limit) and the next call
+// resumes where it left off. Walk time is what fill() spends outside the
+// nested per-file phases.
+class TreeWalk {
+public:
+    explicit TreeWalk(const std::string& target) : target_(target), root_path_(target) {}
 
-        if (workers <= 1 || pending.size() < 64) {
-            for (const PendingFile& item : pending) {
-                core::FileEntry entry;
-                entry.path = item.path;
-                entry.size = item.size;
-                entry.mtime = item.mtime;
-                entry.hash = hash::sha256_file(item.path, item.size);
-                if (entry.hash.empty()) {
+    // Returns true while the tree has more files to offer.
+    bool fill(std::vector<PendingFile>& pending, std::uint64_t max_bytes) {
+        memory::Scope area(memory::Area::Walker);
+        profiler::Scope walk(core::Phase::Walk);
+        if (pending.capacity() == 0) {
+            pending.reserve(4096);
+        }
+        trace::Span walk_span("walk", "scan");
+        if (!started_) {
+            started_ = true;
+            it_ = fs::recursive_directory_iterator(target_, fs::directory_options::skip_permission_denied, ec_);
+        }
+        const fs::recursive_directory_iterator end;
+        std::uint64_t pending_bytes = 0;
+
+        while (it_ != end) {
+            if (max_bytes != 0 && pending_bytes >= max_bytes) {
+                return true;
+            }
+            if (ec_) {
+                walk.add_error();
+                ec_.clear();
+                it_.increment(ec_);
+                continue;
+            }
+
+            const fs::directory_entry entry = *it_;
+            it_.increment(ec_);
+
+            if (entry.is_symlink(ec_)) {
+                ec_.clear();
+                continue;
+            }
+
+            if (!entry.is_regular_file(ec_)) {
+                ec_.clear();
+                continue;
+            }
+            walk.add_files();
+
+            std::string path;
+            {
+                profiler::Scope canonicalize(core::Phase::Canonicalize);
+                canonicalize.add_files();
+                canonicalize.add_syscalls(1);
+                path = normalize_path(entry.path());
+                if (should_skip_for_stability(path)) {
                     continue;
                 }
-                current.emplace(entry.path, std::move(entry));
             }
-        } else {
-            std::atomic<std::size_t> next_index{0};
-            std::mutex map_lock;
-            std::vector<std::thread> pool;
-            pool.reserve(workers);
-
-            for (std::size_t worker = 0; worker < workers; ++worker) {
-                pool.emplace_back([&]() {
-                    std::vector<core::FileEntry> local_entries;
-                    local_entries.reserve(64);
-
-                    while (true) {
-                        const std::size_t index =
-                            next_index.fetch_add(1, std::memory_order_relaxed);
-                        if (index >= pending.size()) {
-                            break;
-                        }
 
-                        const PendingFile& item = pending[index];
-                        const std::string digest = hash::sha256_file(item.path, item.size);
-                        if (digest.empty()) {
-                            continue;
-                        }
+            {
+                profiler::Scope ignore_scope(core::Phase::Ignore);
+                ignore_scope.add_files();
+                std::error_code rel_ec;
+                const fs::path rel = fs::relative(entry.path(), root_path_, rel_ec);
+                const std::string relative_path =
+                    rel_ec ? entry.path().filename().generic_string() : rel.generic_string();
 
-                        core::FileEntry entry;
-                        entry.path = item.path;
-                        entry.size = item.size;
-                        entry.mtime = item.mtime;
-                        entry.hash = digest;
-                        local_entries.push_back(std::move(entry));
+                if (ignore::match(path) || ignore::match(relative_path)) {
+                    continue;
+                }
+            }
+
+            profiler::Scope stat(core::Phase::Stat);
+            stat.add_files();
+            stat.add_syscalls(2);
+            const uintmax_t size = entry.file_size(ec_);
+            if (ec_) {
+                stat.add_error();
+                ec_.clear();
+                continue;
+            }
+
+            const fs::file_time_type last_write = entry.last_write_time(ec_);
+            if (ec_) {
+                stat.add_error();
+                ec_.clear();
+                continue;
+            }
+            stat.add_bytes(size);
+            pending_bytes += sizeof(PendingFile) + path.capacity();
+            pending.push_back(PendingFile{std::move(path), size, to_time_t(last_write)});
+        }
+        return false;
+    }
+
+private:
+    std::string target_;
+    fs::path root_path_;
+    bool started_ = false;
+    std::error_code ec_;
+    fs::recursive_directory_iterator it_;
+};
+
+// Hashes `pending` on up to one thread per core. Entries reach `on_hashed`
+// (serialized) and, when `current` is set, the map. With a `journal`, files it
+// carries over unchanged are not hashed again and fresh digests are recorded
+// in it. `origin` anchors the finish times in the distribution. Returns the
+// number of entries produced.
+std::size_t hash_batch(const std::vector<PendingFile>& pending,
+                       scanner::FileMap* current,
+                       const EntryCallback& on_hashed,
+                       scanner::ScanJournal* journal,
+                       core::ScanStats* stats,
+                       std::chrono::steady_clock::time_point origin) {
+    const unsigned int hw = std::max(1u, std::thread::hardware_concurrency());
+    const std::size_t workers = std::min<std::size_t>(pending.size(), hw);
+
+    trace::Span hash_span("hash", "scan");
+    core::ScanDistribution* distribution = stats != nullptr ? &stats->distribution : nullptr;
+    const auto hash_start = std::chrono::steady_clock::now();
+    const bool serial = workers <= 1 || pending.size() < 64;
+    std::size_t hashed = 0;
+    std::size_t resumed = 0;
+    if (serial) {
+        HashTrace tracer;
+        for (const PendingFile& item : pending) {
+            core::FileEntry entry;
+            entry.path = item.path;
+            entry.size = item.size;
+            entry.mtime = item.mtime;
+            const bool carried = journal != nullptr && journal->lookup(item.path, item.size, item.mtime, entry.hash);
+            if (!carried) {
+                entry.hash = hash_recorded(item, tracer, distribution, origin);
+            }
+            if (entry.hash.empty()) {
+                continue;
+            }
+            ++hashed;
+            if (carried) {
+                ++resumed;
+            } else if (journal != nullptr) {
+                journal->record(entry);
+            }
+            if (on_hashed) {
+                on_hashed(entry);
+            }
+            if (current != nullptr) {
+                current->emplace(entry.path, std::move(entry));
+            }
+        }
+    } else {
+        std::atomic<std::size_t> next_index{0};
+        std::mutex map_lock;
+        std::mutex notify_lock;
+        std::vector<std::thread> pool;
+        pool.reserve(workers);
+        // Viewer id and finish time of each worker, for the idle spans
+        // recorded once the pool has drained.
+        std::vector<std::pair<std::uint32_t, double>> finished(workers);
+
+        for (std::size_t worker = 0; worker < workers; ++worker) {
+            pool.emplace_back([&, worker]() {
+                memory::Scope worker_area(memory::Area::Snapshot);
+                std::vector<core::FileEntry> local_entries;
+                local_entries.reserve(current != nullptr ? 64 : 0);
+                std::size_t local_hashed = 0;
+                std::size_t local_resumed = 0;
+                core::ScanDistribution local_distribution;
+                core::ScanDistribution* recorded = distribution != nullptr ? &local_distribution : nullptr;
+                HashTrace tracer;
+                if (tracer.active()) {
+                    trace::name_thread("hash worker " + std::to_string(worker + 1));
+                }
+
+                while (true) {
+                    const std::size_t index =
+                        next_index.fetch_add(1, std::memory_order_relaxed);
+                    if (index >= pending.size()) {
+                        break;
+                    }
+
+                    const PendingFile& item = pending[index];
+                    std::string digest;
+                    const bool carried = journal != nullptr && journal->lookup(item.path, item.size, item.mtime, digest);
+                    if (!carried) {
+                        digest = hash_recorded(item, tracer, recorded, origin);
+                    }
+                    if (digest.empty()) {
+                        continue;
                     }
 
-                    if (!local_entries.empty()) {
-                        std::lock_guard<std::mutex> guard(map_lock);
-                        for (core::FileEntry& entry : local_entries) {
-                            current.emplace(entry.path, std::move(entry));
+                    core::FileEntry entry;
+                    entry.path = item.path;
+                    entry.size = item.size;
+                    entry.mtime = item.mtime;
+                    entry.hash = std::move(digest);
+                    ++local_hashed;
+                    local_resumed += carried ? 1 : 0;
+                    const bool journaled = journal != nullptr && !carried;
+                    if (on_hashed || journaled) {
+                        const double wait_start = tracer.active() ? trace::now() : 0.0;
+                        std::lock_guard<std::mutex> guard(notify_lock);
+                        if (tracer.active()) {
+                            tracer.waited(wait_start, trace::now());
+                        }
+                        if (journaled) {
+                            journal->record(entry);
+                        }
+                        if (on_hashed) {
+                            on_hashed(entry);
                         }
                     }
-                });
-            }
+                    if (current != nullptr) {
+                        local_entries.push_back(std::move(entry));
+                    }
+                }
+                tracer.flush();
+
+                if (local_hashed != 0) {
+                    const double merge_start = tracer.active() ? trace::now() : 0.0;
+                    std::lock_guard<std::mutex> guard(map_lock);
+                    hashed += local_hashed;
+                    resumed += local_resumed;
+                    for (core::FileEntry& entry : local_entries) {
+                        current->emplace(entry.path, std::move(entry));
+                    }
+                    if (recorded != nullptr) {
+                        distribution->merge(local_distribution);
+                    }
+                    if (tracer.active()) {
+                        trace::complete("merge", "scan", merge_start, trace::now(),
+                                        "\"entries\":" + std::to_string(local_entries.size()));
+                    }
+                }
+                if (tracer.active()) {
+                    finished[worker] = {trace::thread_id(), trace::now()};
+                }
+            });
+        }
 
-            for (std::thread& worker : pool) {
-                if (worker.joinable()) {
-                    worker.join();
+        for (std::thread& worker : pool) {
+            if (worker.joinable()) {
+                worker.join();
+            }
+        }
+        if (trace::active()) {
+            const double joined = trace::now();
+            for (const auto& [tid, done] : finished) {
+                if (tid != 0) {
+                    trace::complete_on(tid, "idle", "scan", done, joined);
                 }
             }
         }
     }
+    if (stats != nullptr) {
+        stats->hash_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - hash_start).count();
+        stats->hash_workers = std::max<std::size_t>(stats->hash_workers, serial ? 1 : workers);
+        stats->resumed += resumed;
+    }
+    return hashed;
+}
 
+// `on_hashed` (optional) sees every entry as soon as its digest is known; calls
+// are serialized, so it may update caller state without its own locking. With
+// `batch_bytes` set, walking and hashing alternate over batches of that many
+// pending bytes, entries only reach `on_hashed` and the returned map is empty.
+// A `journal` is checkpointed once more when hashing ends.
+scanner::FileMap snapshot(const std::string& target,
+                          core::ScanStats* stats,
+                          const EntryCallback& on_hashed,
+                          scanner::ScanJournal* journal = nullptr,
+                          std::uint64_t batch_bytes = 0) {
+    using scanner::FileMap;
     if (stats != nullptr) {
-        stats->scanned = current.size();
+        *stats = core::ScanStats{};
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    ignore::load();
+
+    const bool keep = batch_bytes == 0;
+    FileMap current;
+    std::size_t hashed = 0;
+    std::optional<std::chrono::steady_clock::time_point> origin;
+    std::vector<PendingFile> pending;
+    TreeWalk walk(target);
+    bool more = true;
+    while (more) {
+        more = walk.fill(pending, batch_bytes);
+        if (!pending.empty()) {
+            memory::Scope area(memory::Area::Snapshot);
+            if (!origin.has_value()) {
+                origin = std::chrono::steady_clock::now();
+            }
+            if (keep) {
+                current.reserve(pending.size());
+            }
+            hashed += hash_batch(pending, keep ? &current : nullptr, on_hashed, journal, stats, *origin);
+        }
+        // Hand the pending list back to the walker's account.
+        memory::Scope walker_area(memory::Area::Walker);
+        if (more) {
+            pending.clear();
+        } else {
+            std::vector<PendingFile>().swap(pending);
+        }
+    }
+
+    if (journal != nullptr) {
+        journal->checkpoint();
+    }
+
+    if (stats != nullptr) {
+        stats->scanned = hashed;
     }
 
     if (stats != nullptr) {
@@ -237,7 +587,95 @@ FileMap build_snapshot(const std::string& target, core::ScanStats* stats) {
     return current;
 }
 
+// Counts a hashed entry that differs from the baseline and passes it on.
+// Returns true when it was a change.
+bool note_hashed(const scanner::FileMap& baseline,
+                 const core::FileEntry& entry,
+                 bool consider_mtime,
+                 bool keep_changes,
+                 const scanner::ChangeObserver& observer,
+                 scanner::ScanResult& result) {
+    memory::Scope area(memory::Area::Compare);
+    profiler::Scope scope(core::Phase::Compare);
+    scope.add_files();
+    scanner::Change change;
+    if (!classify(baseline, entry, consider_mtime, change)) {
+        return false;
+    }
+    if (change == scanner::Change::Added) {
+        ++result.stats.added;
+        if (keep_changes) {
+            result.added.emplace(entry.path, entry);
+        }
+    } else {
+        ++result.stats.modified;
+        if (keep_changes) {
+            result.modified.emplace(entry.path, entry);
+        }
+    }
+    if (observer) {
+        observer(change, entry);
+    }
+    return true;
+}
+
+// Reports the baseline records that are missing from `result.current`.
+void note_deleted(const scanner::FileMap& baseline,
+                  bool keep_changes,
+                  const scanner::ChangeObserver& observer,
+                  scanner::ScanResult& result) {
+    memory::Scope area(memory::Area::Compare);
+    profiler::Scope deleted_scope(core::Phase::Compare);
+    trace::Span deleted_span("compare deleted", "scan");
+    deleted_scope.add_files(baseline.size());
+    for (const auto& item : baseline) {
+        if (result.current.find(item.first) != result.current.end()) {
+            continue;
+        }
+        ++result.stats.deleted;
+        if (keep_changes) {
+            result.deleted.emplace(item.first, item.second);
+        }
+        if (observer) {
+            observer(scanner::Change::Deleted, item.second);
+        }
+    }
+}
+
+// Size or mtime no longer matching the baseline puts a file ahead of the
+// --time-budget rotation, as does a digest mismatch found by an earlier run.
+bool metadata_changed(const core::FileEntry& old, const PendingFile& file) {
+    return old.size != file.size || (old.mtime != 0 && file.mtime != 0 && old.mtime != file.mtime);
+}
+
+// First rotation chunk of a --time-budget scan; later chunks are sized from
+// the measured hash throughput to about half the time left.
+constexpr std::uint64_t kFirstRotationBytes = std::uint64_t{8} << 20;
+
+// Budget split of --memory-limit: pending walk records get a quarter, sorted
+// snapshot records half, and an unsorted baseline being re-sorted the other
+// half once the snapshot runs are written.
+std::uint64_t walk_budget(const scanner::BoundedScan& bounds) {
+    return std::max<std::uint64_t>(bounds.memory_limit / 4, 1);
+}
+
+std::uint64_t sort_budget(const scanner::BoundedScan& bounds) {
+    return std::max<std::uint64_t>(bounds.memory_limit / 2, 1);
+}
+
+} // namespace
+
+namespace scanner {
+
+FileMap build_snapshot(const std::string& target, core::ScanStats* stats, ScanJournal* journal) {
+    return snapshot(target, stats, nullptr, journal);
+}
+
 ScanResult compare(const FileMap& baseline, const FileMap& current, bool consider_mtime) {
+    memory::Scope area(memory::Area::Compare);
+    profiler::Scope scope(core::Phase::Compare);
+    trace::Span span("compare", "scan");
+    scope.add_files(current.size() + baseline.size());
     ScanResult result;
     result.current = current;
     result.stats.scanned = current.size();
@@ -246,16 +684,13 @@ ScanResult compare(const FileMap& baseline, const FileMap& current, bool conside
         const std::string& path = item.first;
         const core::FileEntry& entry = item.second;
 
-        const auto baseline_it = baseline.find(path);
-        if (baseline_it == baseline.end()) {
-            result.added[path] = entry;
+        Change change;
+        if (!classify(baseline, entry, consider_mtime, change)) {
             continue;
         }
-
-        const core::FileEntry& old = baseline_it->second;
-        const bool mtime_changed =
-            consider_mtime && (old.mtime != 0 && entry.mtime != 0 && old.mtime != entry.mtime);
-        if (old.hash != entry.hash || old.size != entry.size || mtime_changed) {
+        if (change == Change::Added) {
+            result.added[path] = entry;
+        } else {
             result.modified[path] = entry;
         }
     }
@@ -278,4 +713,350 @@ ScanResult compare(const FileMap& baseline, const FileMap& current) {
     return compare(baseline, current, true);
 }
 
+ScanResult scan_compare(const std::string& target,
+                        const FileMap& baseline,
+                        bool consider_mtime,
+                        const ChangeObserver& observer,
+                        bool keep_changes,
+                        ScanJournal* journal) {
+    ScanResult result;
+    core::ScanStats snapshot_stats;
+    result.current = snapshot(target, &snapshot_stats, [&](const core::FileEntry& entry) {
+        note_hashed(baseline, entry, consider_mtime, keep_changes, observer, result);
+    }, journal);
+    note_deleted(baseline, keep_changes, observer, result);
+
+    result.stats.scanned = result.current.size();
+    result.stats.duration = snapshot_stats.duration;
+    result.stats.distribution = std::move(snapshot_stats.distribution);
+    result.stats.hash_seconds = snapshot_stats.hash_seconds;
+    result.stats.hash_workers = snapshot_stats.hash_workers;
+    return result;
+}
+
+// The whole tree is walked for metadata every run; only the rotation of
+// unchanged files is rationed. A lap ends when the rotation passes the last
+// path, and the cursor then starts over from the first.
+ScanResult scan_compare_rolling(const std::string& target,
+                                const FileMap& baseline,
+                                bool consider_mtime,
+                                const RollingScan& rolling,
+                                RollingState& state,
+                                const ChangeObserver& observer,
+                                bool keep_changes) {
+    using clock = std::chrono::steady_clock;
+    const auto start = clock::now();
+    const auto elapsed = [&] { return std::chrono::duration<double>(clock::now() - start).count(); };
+    const std::time_t now = std::time(nullptr);
+    if (state.lap_started == 0) {
+        state.lap_started = now;
+    }
+
+    ScanResult result;
+    core::ScanStats snapshot_stats;
+    ignore::load();
+
+    std::vector<PendingFile> queued;
+    std::vector<PendingFile> rotation;
+    {
+        std::vector<PendingFile> files;
+        TreeWalk walk(target);
+        walk.fill(files, 0);
+        memory::Scope area(memory::Area::Walker);
+        rotation.reserve(files.size());
+        for (PendingFile& file : files) {
+            const auto it = baseline.find(file.path);
+            if (it == baseline.end() || metadata_changed(it->second, file) ||
+                state.flagged.count(file.path) != 0) {
+                queued.push_back(std::move(file));
+            } else {
+                rotation.push_back(std::move(file));
+            }
+        }
+        std::sort(rotation.begin(), rotation.end(), [](const PendingFile& left, const PendingFile& right) {
+            return left.path < right.path;
+        });
+    }
+
+    memory::Scope area(memory::Area::Snapshot);
+    std::unordered_set<std::string> flagged;
+    const auto on_hashed = [&](const core::FileEntry& entry) {
+        state.verified[entry.path] = now;
+        if (note_hashed(baseline, entry, consider_mtime, keep_changes, observer, result) &&
+            baseline.count(entry.path) != 0) {
+            flagged.insert(entry.path);
+        }
+    };
+    const auto origin = clock::now();
+    result.current.reserve(queued.size() + rotation.size());
+    std::uint64_t hashed_bytes = 0;
+    for (const PendingFile& file : queued) {
+        hashed_bytes += file.size;
+    }
+    // New and metadata-changed files are where changes are; they are always hashed.
+    state.queued = queued.empty() ? 0 : hash_batch(queued, &result.current, on_hashed, nullptr, &snapshot_stats, origin);
+    std::vector<PendingFile>().swap(queued);
+
+    // Then the rotation from the path after the cursor, in chunks, until the
+    // budget is spent. The run --full-every allows last finishes the lap instead.
+    const std::size_t total = rotation.size();
+    std::size_t position = static_cast<std::size_t>(
+        std::upper_bound(rotation.begin(), rotation.end(), state.cursor,
+                         [](const std::string& cursor, const PendingFile& file) { return cursor < file.path; }) -
+        rotation.begin());
+    if (position == total) {
+        position = 0;
+    }
+    state.full_pass = rolling.full_every != 0 && state.lap_runs + 1 >= rolling.full_every;
+    state.lap_finished = false;
+    state.rotated = 0;
+    std::size_t taken = 0;
+    std::string last_taken;
+    std::vector<PendingFile> chunk;
+    while (taken < total && !(state.full_pass && state.lap_finished)) {
+        const double remaining = rolling.time_budget - elapsed();
+        if (!state.full_pass && remaining <= 0.0) {
+            break;
+        }
+        std::uint64_t chunk_bytes = std::numeric_limits<std::uint64_t>::max();
+        if (!state.full_pass) {
+            chunk_bytes = hashed_bytes == 0 || snapshot_stats.hash_seconds <= 0.0
+                              ? kFirstRotationBytes
+                              : static_cast<std::uint64_t>(static_cast<double>(hashed_bytes) /
+                                                           snapshot_stats.hash_seconds * remaining / 2.0);
+        }
+        chunk.clear();
+        std::uint64_t bytes = 0;
+        while (taken < total && (chunk.empty() || bytes < chunk_bytes)) {
+            bytes += rotation[position].size;
+            chunk.push_back(std::move(rotation[position]));
+            ++taken;
+            if (++position == total) {
+                position = 0;
+                state.lap_finished = true;
+                break;
+            }
+        }
+        last_taken = chunk.back().path;
+        hashed_bytes += bytes;
+        state.rotated += hash_batch(chunk, &result.current, on_hashed, nullptr, &snapshot_stats, origin);
+    }
+    std::vector<PendingFile>().swap(chunk);
+    if (taken != 0) {
+        state.cursor = position == 0 ? std::string() : last_taken;
+    }
+
+    // Files the budget did not reach keep their baseline digest.
+    state.deferred = total - taken;
+    for (std::size_t i = 0; i < state.deferred; ++i) {
+        PendingFile& file = rotation[(position + i) % total];
+        core::FileEntry entry;
+        entry.path = file.path;
+        entry.size = file.size;
+        entry.mtime = file.mtime;
+        entry.hash = baseline.at(file.path).hash;
+        result.current.emplace(std::move(file.path), std::move(entry));
+    }
+    std::vector<PendingFile>().swap(rotation);
+    state.flagged.swap(flagged);
+
+    if (state.lap_finished) {
+        state.last_lap = now;
+        state.lap_started = now;
+        state.lap_runs = position == 0 ? 0 : 1;
+    } else {
+        ++state.lap_runs;
+    }
+    state.lap_progress = total == 0 ? 1.0 : static_cast<double>(position) / static_cast<double>(total);
+
+    // Forget files that are gone; find the stalest verification.
+    std::unordered_map<std::string, std::time_t> verified;
+    verified.reserve(result.current.size());
+    state.never_verified = 0;
+    state.oldest_verified = 0;
+    for (const auto& item : result.current) {
+        const auto it = state.verified.find(item.first);
+        if (it == state.verified.end()) {
+            ++state.never_verified;
+            continue;
+        }
+        if (state.oldest_verified == 0 || it->second < state.oldest_verified) {
+            state.oldest_verified = it->second;
+        }
+        verified.emplace(item.first, it->second);
+    }
+    state.verified.swap(verified);
+
+    note_deleted(baseline, keep_changes, observer, result);
+
+    result.stats.scanned = result.current.size();
+    result.stats.duration = elapsed();
+    result.stats.distribution = std::move(snapshot_stats.distribution);
+    result.stats.hash_seconds = snapshot_stats.hash_seconds;
+    result.stats.hash_workers = snapshot_stats.hash_workers;
+    return result;
+}
+
+bool build_snapshot_bounded(const std::string& target,
+                            const BoundedScan& bounds,
+                            core::ScanStats* stats,
+                            std::string* error) {
+    core::ScanStats snapshot_stats;
+    ExternalSort sorted(sort_budget(bounds), "snapshot");
+    snapshot(target, &snapshot_stats, [&](const core::FileEntry& entry) { sorted.add(entry); },
+             nullptr, walk_budget(bounds));
+    if (!sorted.finish()) {
+        fsutil::set_error(error, sorted.error());
+        return false;
+    }
+
+    memory::Scope area(memory::Area::Baseline);
+    profiler::Scope scope(core::Phase::BaselineSave);
+    trace::Span span("baseline save", "baseline");
+    BaselineWriter writer;
+    if (!writer.open(bounds.staged_baseline, bounds.root, fsutil::timestamp())) {
+        fsutil::set_error(error, "Failed to open baseline file for write: " + bounds.staged_baseline);
+        return false;
+    }
+    core::FileEntry entry;
+    while (sorted.next(entry)) {
+        writer.add(entry);
+    }
+    scope.add_files(writer.count());
+    if (!writer.close() || !sorted.error().empty()) {
+        std::error_code ec;
+        std::filesystem::remove(bounds.staged_baseline, ec);
+        fsutil::set_error(error, sorted.error().empty() ? "Failed to flush baseline file: " + bounds.staged_baseline
+                                                : sorted.error());
+        return false;
+    }
+
+    if (stats != nullptr) {
+        *stats = std::move(snapshot_stats);
+        stats->spill_runs = sorted.runs();
+    }
+    return true;
+}
+
+// Both sides are walked in path order, as history::diff does for two
+// baselines, so memory stays flat however large the tree and baseline are.
+bool scan_compare_bounded(const std::string& target,
+                          const BoundedScan& bounds,
+                          bool consider_mtime,
+                          ScanResult& result,
+                          const ChangeObserver& observer,
+                          bool keep_changes,
+                          std::string* error) {
+    result = ScanResult{};
+    core::ScanStats snapshot_stats;
+    ExternalSort current(sort_budget(bounds), "snapshot");
+    snapshot(target, &snapshot_stats, [&](const core::FileEntry& entry) { current.add(entry); },
+             nullptr, walk_budget(bounds));
+    if (!current.finish()) {
+        fsutil::set_error(error, current.error());
+        return false;
+    }
+
+    BaselineReader baseline;
+    if (!baseline.open(config::BASELINE_DB)) {
+        fsutil::set_error(error, "Baseline file not found: " + config::BASELINE_DB);
+        return false;
+    }
+    // Baselines from before path-ordered saves are sorted through the same budget.
+    std::unique_ptr<ExternalSort> resorted;
+    if (!baseline.path_sorted()) {
+        memory::Scope area(memory::Area::Baseline);
+        profiler::Scope scope(core::Phase::BaselineLoad);
+        resorted = std::make_unique<ExternalSort>(sort_budget(bounds), "baseline");
+        core::FileEntry entry;
+        while (baseline.next(entry)) {
+            resorted->add(std::move(entry));
+        }
+        if (!resorted->finish()) {
+            fsutil::set_error(error, resorted->error());
+            return false;
+        }
+    }
+    const auto next_old = [&](core::FileEntry& entry) {
+        return resorted ? resorted->next(entry) : baseline.next(entry);
+    };
+
+    memory::Scope area(memory::Area::Compare);
+    profiler::Scope scope(core::Phase::Compare);
+    trace::Span span("compare", "scan");
+    BaselineWriter writer;
+    const bool stage = !bounds.staged_baseline.empty();
+    if (stage && !writer.open(bounds.staged_baseline, bounds.root, fsutil::timestamp())) {
+        fsutil::set_error(error, "Failed to open baseline file for write: " + bounds.staged_baseline);
+        return false;
+    }
+
+    const auto report = [&](Change change, const core::FileEntry& entry) {
+        FileMap* changes = nullptr;
+        switch (change) {
+            case Change::Added: ++result.stats.added; changes = &result.added; break;
+            case Change::Modified: ++result.stats.modified; changes = &result.modified; break;
+            case Change::Deleted: ++result.stats.deleted; changes = &result.deleted; break;
+        }
+        if (keep_changes) {
+            changes->emplace(entry.path, entry);
+        }
+        if (observer) {
+            observer(change, entry);
+        }
+    };
+
+    std::size_t baseline_records = 0;
+    core::FileEntry old_entry;
+    core::FileEntry new_entry;
+    bool have_old = next_old(old_entry);
+    bool have_new = current.next(new_entry);
+    while (have_old || have_new) {
+        if (have_old && (!have_new || old_entry.path < new_entry.path)) {
+            ++baseline_records;
+            report(Change::Deleted, old_entry);
+            have_old = next_old(old_entry);
+            continue;
+        }
+        ++result.stats.scanned;
+        if (stage) {
+            writer.add(new_entry);
+        }
+        if (have_old && old_entry.path == new_entry.path) {
+            ++baseline_records;
+            if (differs(old_entry, new_entry, consider_mtime)) {
+                report(Change::Modified, new_entry);
+            }
+            have_old = next_old(old_entry);
+        } else {
+            report(Change::Added, new_entry);
+        }
+        have_new = current.next(new_entry);
+    }
+    scope.add_files(result.stats.scanned + baseline_records);
+
+    std::string failure = current.error();
+    if (failure.empty() && resorted) {
+        failure = resorted->error();
+    }
+    if (failure.empty() && stage && !writer.close()) {
+        failure = "Failed to flush baseline file: " + bounds.staged_baseline;
+    }
+    if (!failure.empty()) {
+        if (stage) {
+            std::error_code ec;
+            std::filesystem::remove(bounds.staged_baseline, ec);
+        }
+        fsutil::set_error(error, failure);
+        return false;
+    }
+
+    result.stats.duration = snapshot_stats.duration;
+    result.stats.distribution = std::move(snapshot_stats.distribution);
+    result.stats.hash_seconds = snapshot_stats.hash_seconds;
+    result.stats.hash_workers = snapshot_stats.hash_workers;
+    result.stats.spill_runs = current.runs() + (resorted ? resorted->runs() : 0);
+    return true;
+}
+
 } // namespace scanner
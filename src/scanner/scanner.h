@@ -1,4 +1,6 @@
 #pragma once
+#include <cstdint>
+#include <functional>
 #include <string>
 #include <unordered_map>
 #include "../core/types.h"
@@ -7,6 +9,9 @@ namespace scanner {
 
 using FileMap = std::unordered_map<std::string, core::FileEntry>;
 
+class ScanJournal;
+struct RollingState;
+
 struct ScanResult {
     core::ScanStats stats;
     FileMap current;
@@ -15,11 +20,85 @@ struct ScanResult {
     FileMap deleted;
 };
 
-FileMap build_snapshot(const std::string& target, core::ScanStats* stats = nullptr);
+enum class Change {
+    Added,
+    Modified,
+    Deleted
+};
+
+// Receives each change as soon as it is known. Calls never overlap.
+using ChangeObserver = std::function<void(Change, const core::FileEntry&)>;
+
+// With a `journal`, fresh digests are checkpointed to it and files it carried
+// over from an interrupted run are not hashed again (see scan_journal.h).
+FileMap build_snapshot(const std::string& target,
+                       core::ScanStats* stats = nullptr,
+                       ScanJournal* journal = nullptr);
 ScanResult compare(const FileMap& baseline, const FileMap& current);
 ScanResult compare(const FileMap& baseline, const FileMap& current, bool consider_mtime);
+// Snapshot and compare in one pass: added/modified entries reach `observer`
+// while hashing is still running, deleted entries once the walk is done.
+// With `keep_changes` false the added/modified/deleted maps stay empty and
+// only the stats count them. `journal` works as for build_snapshot().
+ScanResult scan_compare(const std::string& target,
+                        const FileMap& baseline,
+                        bool consider_mtime,
+                        const ChangeObserver& observer = {},
+                        bool keep_changes = true,
+                        ScanJournal* journal = nullptr);
+// Time-budgeted scanning (--time-budget). Every run walks the whole tree;
+// new files, files whose size or mtime no longer match the baseline and files
+// an earlier run found modified are hashed first, always. Unchanged files are
+// then re-verified in path order from `state.cursor` until `time_budget`
+// seconds have passed since the call, and the rest keep their baseline digest
+// in `ScanResult::current`. With `full_every` set, the run that would be the
+// lap's full_every-th finishes the lap whatever the budget. `state` is
+// advanced in place; the caller saves it.
+struct RollingScan {
+    double time_budget = 0.0;
+    std::uint64_t full_every = 0;
+};
+ScanResult scan_compare_rolling(const std::string& target,
+                                const FileMap& baseline,
+                                bool consider_mtime,
+                                const RollingScan& rolling,
+                                RollingState& state,
+                                const ChangeObserver& observer = {},
+                                bool keep_changes = true);
+// Memory-capped scanning (--memory-limit). The walk hands files to the hashers
+// in batches, hashed records spill to sorted runs on disk (ExternalSort) and
+// the baseline file is streamed instead of loaded, so memory stays near
+// `memory_limit` whatever the tree size. Only the change maps are held in
+// memory; `ScanResult::current` stays empty.
+struct BoundedScan {
+    std::uint64_t memory_limit = 0;
+    // When set, the merged snapshot is also written here as a path-sorted
+    // baseline file with `root`, ready for install_baseline().
+    std::string staged_baseline;
+    std::string root;
+};
+// Snapshot written straight to `bounds.staged_baseline`.
+bool build_snapshot_bounded(const std::string& target,
+                            const BoundedScan& bounds,
+                            core::ScanStats* stats = nullptr,
+                            std::string* error = nullptr);
+// Streaming merge of the snapshot against config::BASELINE_DB; changes reach
+// `observer` in path order after hashing. The seal is not checked here (see
+// verify_baseline).
+bool scan_compare_bounded(const std::string& target,
+                          const BoundedScan& bounds,
+                          bool consider_mtime,
+                          ScanResult& result,
+                          const ChangeObserver& observer = {},
+                          bool keep_changes = true,
+                          std::string* error = nullptr);
 bool load_baseline(FileMap& baseline, std::string* baseline_root = nullptr);
+// Seal check without parsing records; `digest` receives the baseline SHA-256.
+bool verify_baseline(std::string* digest = nullptr);
 bool save_baseline(const FileMap& data, const std::string& baseline_root);
+// Installs a path-sorted baseline file (e.g. written by BaselineWriter) as the
+// current baseline: atomic replace, seal, index refresh and history snapshot.
+bool install_baseline(const std::string& staged_path);
 const std::string& baseline_last_error();
 const std::string& baseline_last_warning();
 